@@ -52,6 +52,7 @@ static const GDebugKey panel_debug_keys[] = {
   { "itembar", PANEL_DEBUG_ITEMBAR },
   { "clock", PANEL_DEBUG_CLOCK },
   { "actions", PANEL_DEBUG_ACTIONS },
+  { "stats", PANEL_DEBUG_STATS },
 };
 
 
@@ -50,6 +50,7 @@ typedef enum
   PANEL_DEBUG_ITEMBAR = 1 << 16,
   PANEL_DEBUG_CLOCK = 1 << 17,
   PANEL_DEBUG_ACTIONS = 1 << 18,
+  PANEL_DEBUG_STATS = 1 << 19,
 } PanelDebugFlag;
 
 gboolean
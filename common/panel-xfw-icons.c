@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "panel-private.h"
+#include "panel-xfw-icons.h"
+
+#include "libxfce4panel/libxfce4panel.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/*
+ * Window and application icons in the shared icon cache of libxfce4panel.
+ * Window icons are keyed per window, since windows of the same
+ * application can have different icons, so the tasklist buttons, group
+ * menus and the window menu share a single pixbuf per window, size and
+ * scale factor. Application icons are keyed by the class of the
+ * application. Entries of closed windows are evicted by the cache.
+ */
+static const gchar *
+panel_xfw_icons_window_source (XfwWindow *window)
+{
+  gchar *source;
+
+  /* the address and creation time keep the key unique when a new
+   * window object reuses the memory of a closed one; the key is stored
+   * on the window so all plugin modules in the process agree on it */
+  source = g_object_get_data (G_OBJECT (window), "panel-xfw-icons-source");
+  if (source == NULL)
+    {
+      source = g_strdup_printf ("xfw-window:%p:%" G_GINT64_FORMAT,
+                                window, g_get_monotonic_time ());
+      g_object_set_data_full (G_OBJECT (window), "panel-xfw-icons-source", source, g_free);
+    }
+
+  return source;
+}
+
+
+
+static gchar *
+panel_xfw_icons_source (const gchar *type,
+                        XfwApplication *app)
+{
+  const gchar *class_id;
+
+  if (app == NULL)
+    return NULL;
+
+  class_id = xfw_application_get_class_id (app);
+  if (xfce_str_is_empty (class_id))
+    return NULL;
+
+  return g_strconcat ("xfw-", type, ":", class_id, NULL);
+}
+
+
+
+GdkPixbuf *
+panel_xfw_icons_get_window_icon (XfwWindow *window,
+                                 gint size,
+                                 gint scale_factor)
+{
+  GdkPixbuf *pixbuf;
+  const gchar *source;
+
+  panel_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+
+  source = panel_xfw_icons_window_source (window);
+  pixbuf = xfce_panel_icon_cache_lookup (source, NULL, size, size, scale_factor);
+  if (pixbuf == NULL)
+    {
+      pixbuf = xfw_window_get_icon (window, size, scale_factor);
+      if (pixbuf != NULL)
+        {
+          xfce_panel_icon_cache_insert (source, NULL, size, size, scale_factor, pixbuf);
+          g_object_ref (pixbuf);
+        }
+    }
+
+  return pixbuf;
+}
+
+
+
+GdkPixbuf *
+panel_xfw_icons_get_application_icon (XfwApplication *app,
+                                      gint size,
+                                      gint scale_factor)
+{
+  GdkPixbuf *pixbuf;
+  gchar *source;
+
+  panel_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+
+  source = panel_xfw_icons_source ("application", app);
+  if (source != NULL)
+    {
+      pixbuf = xfce_panel_icon_cache_lookup (source, NULL, size, size, scale_factor);
+      if (pixbuf == NULL)
+        {
+          pixbuf = xfw_application_get_icon (app, size, scale_factor);
+          if (pixbuf != NULL)
+            {
+              xfce_panel_icon_cache_insert (source, NULL, size, size, scale_factor, pixbuf);
+              g_object_ref (pixbuf);
+            }
+        }
+
+      g_free (source);
+    }
+  else
+    {
+      pixbuf = xfw_application_get_icon (app, size, scale_factor);
+      if (pixbuf != NULL)
+        g_object_ref (pixbuf);
+    }
+
+  return pixbuf;
+}
+
+
+
+/*
+ * To be called from the icon-changed signal handlers, the cache does
+ * not connect to the signals itself because plugin modules can be
+ * unloaded.
+ */
+void
+panel_xfw_icons_window_icon_changed (XfwWindow *window)
+{
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  xfce_panel_icon_cache_remove (panel_xfw_icons_window_source (window));
+}
+
+
+
+void
+panel_xfw_icons_application_icon_changed (XfwApplication *app)
+{
+  gchar *source;
+
+  panel_return_if_fail (XFW_IS_APPLICATION (app));
+
+  source = panel_xfw_icons_source ("application", app);
+  if (source != NULL)
+    {
+      xfce_panel_icon_cache_remove (source);
+      g_free (source);
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __PANEL_XFW_ICONS_H__
+#define __PANEL_XFW_ICONS_H__
+
+#include <libxfce4windowing/libxfce4windowing.h>
+
+G_BEGIN_DECLS
+
+GdkPixbuf *
+panel_xfw_icons_get_window_icon (XfwWindow *window,
+                                 gint size,
+                                 gint scale_factor) G_GNUC_WARN_UNUSED_RESULT;
+
+GdkPixbuf *
+panel_xfw_icons_get_application_icon (XfwApplication *app,
+                                      gint size,
+                                      gint scale_factor) G_GNUC_WARN_UNUSED_RESULT;
+
+void
+panel_xfw_icons_window_icon_changed (XfwWindow *window);
+
+void
+panel_xfw_icons_application_icon_changed (XfwApplication *app);
+
+G_END_DECLS
+
+#endif /* !__PANEL_XFW_ICONS_H__ */
@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Loads and scales every image of a set of icon directories to the usual
+ * panel icon sizes, with the gdk-pixbuf scaler and with the area averaging
+ * kernel of the library, and reports the latency of each method and its
+ * mean difference from a GDK_INTERP_HYPER reference.
+ *
+ * Run "pixbuf-bench --help" for the options, by default the hicolor theme
+ * and the pixmaps directory are used.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "libxfce4panel/xfce-panel-convenience-private.h"
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+#include <stdlib.h>
+
+
+
+typedef struct _BenchIcon BenchIcon;
+typedef GdkPixbuf *(*BenchMethodFunc) (BenchIcon *icon,
+                                       gint size);
+
+typedef struct
+{
+  const gchar *name;
+  BenchMethodFunc func;
+} BenchMethod;
+
+struct _BenchIcon
+{
+  gchar *filename;
+
+  /* the fully decoded image */
+  GdkPixbuf *pixbuf;
+};
+
+
+
+static gchar **opt_icons = NULL;
+static gint opt_size = -1;
+static gint opt_rounds = 3;
+
+static const gint sizes[] = { 16, 24, 32, 48, 64 };
+
+static const gchar *default_icons[] = {
+  "/usr/share/icons/hicolor",
+  "/usr/share/pixmaps",
+  NULL
+};
+
+static GOptionEntry option_entries[] = {
+  { "icons", 'i', 0, G_OPTION_ARG_FILENAME_ARRAY, &opt_icons, "Directory with images, can be repeated", "DIR" },
+  { "size", 's', 0, G_OPTION_ARG_INT, &opt_size, "Only scale to this size", "N" },
+  { "rounds", 'r', 0, G_OPTION_ARG_INT, &opt_rounds, "Number of times each image is scaled", "N" },
+  { NULL }
+};
+
+
+
+static void
+bench_get_dest_size (GdkPixbuf *pixbuf,
+                     gint size,
+                     gint *dest_width,
+                     gint *dest_height)
+{
+  gint width = gdk_pixbuf_get_width (pixbuf);
+  gint height = gdk_pixbuf_get_height (pixbuf);
+  gdouble ratio;
+
+  /* same aspect ratio as the library */
+  ratio = MIN ((gdouble) size / (gdouble) width, (gdouble) size / (gdouble) height);
+  *dest_width = MAX ((gint) rint (width * ratio), 1);
+  *dest_height = MAX ((gint) rint (height * ratio), 1);
+}
+
+
+
+static GdkPixbuf *
+bench_scale_simple (BenchIcon *icon,
+                    gint size)
+{
+  gint dest_width, dest_height;
+
+  bench_get_dest_size (icon->pixbuf, size, &dest_width, &dest_height);
+
+  return gdk_pixbuf_scale_simple (icon->pixbuf, dest_width, dest_height, GDK_INTERP_BILINEAR);
+}
+
+
+
+static GdkPixbuf *
+bench_scale_down (BenchIcon *icon,
+                  gint size)
+{
+  gint dest_width, dest_height;
+
+  bench_get_dest_size (icon->pixbuf, size, &dest_width, &dest_height);
+
+  return _xfce_panel_pixbuf_scale_down (icon->pixbuf, dest_width, dest_height);
+}
+
+
+
+static GdkPixbuf *
+bench_load_scale_simple (BenchIcon *icon,
+                         gint size)
+{
+  GdkPixbuf *pixbuf, *scaled;
+  gint dest_width, dest_height;
+
+  /* the pipeline before the decoding at the target size */
+  pixbuf = gdk_pixbuf_new_from_file (icon->filename, NULL);
+  if (pixbuf == NULL)
+    return NULL;
+
+  bench_get_dest_size (pixbuf, size, &dest_width, &dest_height);
+  scaled = gdk_pixbuf_scale_simple (pixbuf, dest_width, dest_height, GDK_INTERP_BILINEAR);
+  g_object_unref (G_OBJECT (pixbuf));
+
+  return scaled;
+}
+
+
+
+static GdkPixbuf *
+bench_load_at_size (BenchIcon *icon,
+                    gint size)
+{
+  return _xfce_panel_pixbuf_new_from_file_at_size (icon->filename, size, size, NULL);
+}
+
+
+
+static const BenchMethod methods[] = {
+  { "scale-simple", bench_scale_simple },
+  { "scale-down", bench_scale_down },
+  { "load-scale-simple", bench_load_scale_simple },
+  { "load-at-size", bench_load_at_size },
+};
+
+
+
+static gdouble
+bench_difference (GdkPixbuf *pixbuf,
+                  GdkPixbuf *reference)
+{
+  const guchar *p, *r;
+  gint width, height, n_channels, x, y;
+  guint64 sum = 0;
+
+  width = gdk_pixbuf_get_width (pixbuf);
+  height = gdk_pixbuf_get_height (pixbuf);
+  n_channels = gdk_pixbuf_get_n_channels (pixbuf);
+
+  /* svgs are rendered by the loader, which can round the size otherwise */
+  if (width != gdk_pixbuf_get_width (reference)
+      || height != gdk_pixbuf_get_height (reference)
+      || n_channels != gdk_pixbuf_get_n_channels (reference))
+    return -1.0;
+
+  for (y = 0; y < height; y++)
+    {
+      p = gdk_pixbuf_get_pixels (pixbuf) + y * gdk_pixbuf_get_rowstride (pixbuf);
+      r = gdk_pixbuf_get_pixels (reference) + y * gdk_pixbuf_get_rowstride (reference);
+      for (x = 0; x < width * n_channels; x++)
+        sum += ABS (p[x] - r[x]);
+    }
+
+  return (gdouble) sum / (width * height * n_channels);
+}
+
+
+
+static void
+bench_collect (const gchar *path,
+               GPtrArray *icons)
+{
+  GDir *dir;
+  const gchar *name;
+  gchar *filename;
+  GdkPixbuf *pixbuf;
+  BenchIcon *icon;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir == NULL)
+    return;
+
+  while ((name = g_dir_read_name (dir)) != NULL)
+    {
+      filename = g_build_filename (path, name, NULL);
+      if (g_file_test (filename, G_FILE_TEST_IS_DIR))
+        {
+          bench_collect (filename, icons);
+          g_free (filename);
+          continue;
+        }
+
+      pixbuf = gdk_pixbuf_new_from_file (filename, NULL);
+      if (pixbuf == NULL)
+        {
+          g_free (filename);
+          continue;
+        }
+
+      icon = g_slice_new (BenchIcon);
+      icon->filename = filename;
+      icon->pixbuf = pixbuf;
+      g_ptr_array_add (icons, icon);
+    }
+
+  g_dir_close (dir);
+}
+
+
+
+static void
+bench_icon_free (gpointer data)
+{
+  BenchIcon *icon = data;
+
+  g_object_unref (G_OBJECT (icon->pixbuf));
+  g_free (icon->filename);
+  g_slice_free (BenchIcon, icon);
+}
+
+
+
+static gint
+bench_compare_gint64 (gconstpointer a,
+                      gconstpointer b)
+{
+  gint64 value_a = *((const gint64 *) a);
+  gint64 value_b = *((const gint64 *) b);
+
+  return value_a < value_b ? -1 : value_a > value_b;
+}
+
+
+
+static void
+bench_run (GPtrArray *icons,
+           const BenchMethod *method,
+           gint size)
+{
+  GArray *latencies;
+  BenchIcon *icon;
+  GdkPixbuf *pixbuf, *reference;
+  gint64 start, elapsed, sum = 0;
+  gint64 *values;
+  gdouble diff, diff_sum = 0.0;
+  guint n, n_diffs = 0, n_values;
+  gint pass, dest_width, dest_height;
+
+  latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  for (n = 0; n < icons->len; n++)
+    {
+      icon = g_ptr_array_index (icons, n);
+
+      /* only images that are reduced */
+      if (gdk_pixbuf_get_width (icon->pixbuf) <= size
+          && gdk_pixbuf_get_height (icon->pixbuf) <= size)
+        continue;
+
+      for (pass = 0; pass < opt_rounds; pass++)
+        {
+          start = g_get_monotonic_time ();
+          pixbuf = method->func (icon, size);
+          elapsed = g_get_monotonic_time () - start;
+
+          if (pixbuf == NULL)
+            break;
+
+          g_array_append_val (latencies, elapsed);
+          sum += elapsed;
+
+          if (pass == 0)
+            {
+              bench_get_dest_size (icon->pixbuf, size, &dest_width, &dest_height);
+              reference = gdk_pixbuf_scale_simple (icon->pixbuf, dest_width, dest_height, GDK_INTERP_HYPER);
+              diff = bench_difference (pixbuf, reference);
+              if (diff >= 0.0)
+                {
+                  diff_sum += diff;
+                  n_diffs++;
+                }
+              g_object_unref (G_OBJECT (reference));
+            }
+
+          g_object_unref (G_OBJECT (pixbuf));
+        }
+    }
+
+  n_values = latencies->len;
+  if (n_values > 0)
+    {
+      g_array_sort (latencies, bench_compare_gint64);
+      values = (gint64 *) (gpointer) latencies->data;
+
+      g_print ("%-20s %4d %6u %8" G_GINT64_FORMAT " %8" G_GINT64_FORMAT " %8" G_GINT64_FORMAT
+               " %8" G_GINT64_FORMAT " %10" G_GINT64_FORMAT " %8.3f\n",
+               method->name, size, n_values, sum / n_values,
+               values[n_values / 2], values[MIN (n_values - 1, n_values * 99 / 100)],
+               values[n_values - 1], sum, n_diffs > 0 ? diff_sum / n_diffs : 0.0);
+    }
+
+  g_array_free (latencies, TRUE);
+}
+
+
+
+gint
+main (gint argc,
+      gchar **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GPtrArray *icons;
+  const gchar *const *dirs;
+  guint n, m;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, option_entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s: %s\n", g_get_prgname (), error->message);
+      g_error_free (error);
+      g_option_context_free (context);
+      return EXIT_FAILURE;
+    }
+  g_option_context_free (context);
+
+  if (opt_rounds < 1 || opt_size == 0 || opt_size < -1)
+    {
+      g_printerr ("%s: Invalid arguments\n", g_get_prgname ());
+      return EXIT_FAILURE;
+    }
+
+  icons = g_ptr_array_new_with_free_func (bench_icon_free);
+  dirs = opt_icons != NULL ? (const gchar *const *) opt_icons : default_icons;
+  for (n = 0; dirs[n] != NULL; n++)
+    bench_collect (dirs[n], icons);
+
+  if (icons->len == 0)
+    {
+      g_printerr ("%s: No images found\n", g_get_prgname ());
+      g_ptr_array_free (icons, TRUE);
+      return EXIT_FAILURE;
+    }
+
+  g_print ("%u images\n", icons->len);
+  g_print ("%-20s %4s %6s %8s %8s %8s %8s %10s %8s\n",
+           "method", "size", "count", "mean-us", "p50-us", "p99-us",
+           "max-us", "total-us", "diff");
+
+  for (n = 0; n < (opt_size > 0 ? 1 : G_N_ELEMENTS (sizes)); n++)
+    for (m = 0; m < G_N_ELEMENTS (methods); m++)
+      bench_run (icons, &methods[m], opt_size > 0 ? opt_size : sizes[n]);
+
+  g_ptr_array_free (icons, TRUE);
+  g_strfreev (opt_icons);
+
+  return EXIT_SUCCESS;
+}
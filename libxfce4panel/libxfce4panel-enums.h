@@ -52,6 +52,22 @@ typedef enum /*<enum,prefix=XFCE_PANEL_PLUGIN_MODE >*/
   XFCE_PANEL_PLUGIN_MODE_DESKBAR
 } XfcePanelPluginMode;
 
+/**
+ * XfcePanelTickInterval
+ * @XFCE_PANEL_TICK_SECOND : Tick at the start of every second
+ * @XFCE_PANEL_TICK_MINUTE : Tick at the start of every minute
+ *
+ * Wall clock boundary on which a callback added with xfce_panel_tick_add()
+ * is called.
+ *
+ * Since: 4.19.4
+ **/
+typedef enum /*<enum,prefix=XFCE_PANEL_TICK >*/
+{
+  XFCE_PANEL_TICK_SECOND,
+  XFCE_PANEL_TICK_MINUTE
+} XfcePanelTickInterval;
+
 /**
  * XfceScreenPosition
  * @XFCE_SCREEN_POSITION_NONE       : No position has been set.
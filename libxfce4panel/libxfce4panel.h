@@ -31,6 +31,7 @@
 #include <libxfce4panel/xfce-panel-image.h>
 #include <libxfce4panel/xfce-panel-macros.h>
 #include <libxfce4panel/xfce-panel-plugin.h>
+#include <libxfce4panel/xfce-panel-tick.h>
 
 #undef _LIBXFCE4PANEL_INSIDE_LIBXFCE4PANEL_H
 
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Image decoding and scaling helpers of the library. They only depend on
+ * gdk-pixbuf, so the pixbuf benchmark in bench/ can build this file too.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "xfce-panel-convenience-private.h"
+
+#ifdef HAVE_MATH_H
+#include <math.h>
+#endif
+
+
+
+#define SCALE_TO_UCHAR(value) ((guchar) CLAMP ((value) + 0.5f, 0.0f, 255.0f))
+
+
+
+/* the source pixels (first, count) that cover each destination pixel and
+ * the fraction of the destination pixel each of them covers */
+static gfloat *
+xfce_panel_pixbuf_scale_weights (gint src_size,
+                                 gint dest_size,
+                                 gint *first,
+                                 gint *count,
+                                 gint *stride)
+{
+  gdouble scale = (gdouble) src_size / (gdouble) dest_size;
+  gdouble start, end, lo, hi;
+  gfloat *weights;
+  gint d, i, last;
+
+  *stride = (gint) ceil (scale) + 1;
+  weights = g_new0 (gfloat, dest_size * *stride);
+
+  for (d = 0; d < dest_size; d++)
+    {
+      start = d * scale;
+      end = (d + 1) * scale;
+      first[d] = (gint) floor (start);
+      last = MIN ((gint) ceil (end), src_size);
+      count[d] = last - first[d];
+
+      for (i = 0; i < count[d]; i++)
+        {
+          lo = MAX (start, first[d] + i);
+          hi = MIN (end, first[d] + i + 1);
+          weights[d * *stride + i] = (hi - lo) / scale;
+        }
+    }
+
+  return weights;
+}
+
+
+
+GdkPixbuf *
+_xfce_panel_pixbuf_scale_down (GdkPixbuf *source,
+                               gint dest_width,
+                               gint dest_height)
+{
+  GdkPixbuf *dest;
+  const guchar *src_pixels, *s;
+  guchar *dest_pixels, *d;
+  gint src_width, src_height, src_stride, dest_stride;
+  gint n_channels, n;
+  gboolean has_alpha;
+  gint *x_first, *x_count, *y_first, *y_count;
+  gint x_stride, y_stride;
+  gfloat *x_weights, *y_weights;
+  gfloat *acc, *p;
+  gfloat w, a, c0, c1, c2, c3;
+  gint x, y, i, k;
+
+  g_return_val_if_fail (GDK_IS_PIXBUF (source), NULL);
+  g_return_val_if_fail (dest_width > 0, NULL);
+  g_return_val_if_fail (dest_height > 0, NULL);
+
+  src_width = gdk_pixbuf_get_width (source);
+  src_height = gdk_pixbuf_get_height (source);
+  n_channels = gdk_pixbuf_get_n_channels (source);
+  has_alpha = gdk_pixbuf_get_has_alpha (source);
+
+  /* only reducing 8 bit rgb(a) images, which are all the loaders return */
+  if (dest_width > src_width
+      || dest_height > src_height
+      || gdk_pixbuf_get_colorspace (source) != GDK_COLORSPACE_RGB
+      || gdk_pixbuf_get_bits_per_sample (source) != 8
+      || n_channels != (has_alpha ? 4 : 3))
+    return gdk_pixbuf_scale_simple (source, dest_width, dest_height, GDK_INTERP_BILINEAR);
+
+  dest = gdk_pixbuf_new (GDK_COLORSPACE_RGB, has_alpha, 8, dest_width, dest_height);
+  if (G_UNLIKELY (dest == NULL))
+    return NULL;
+
+  src_pixels = gdk_pixbuf_get_pixels (source);
+  src_stride = gdk_pixbuf_get_rowstride (source);
+  dest_pixels = gdk_pixbuf_get_pixels (dest);
+  dest_stride = gdk_pixbuf_get_rowstride (dest);
+
+  x_first = g_new (gint, dest_width);
+  x_count = g_new (gint, dest_width);
+  y_first = g_new (gint, dest_height);
+  y_count = g_new (gint, dest_height);
+  x_weights = xfce_panel_pixbuf_scale_weights (src_width, dest_width, x_first, x_count, &x_stride);
+  y_weights = xfce_panel_pixbuf_scale_weights (src_height, dest_height, y_first, y_count, &y_stride);
+
+  /* one row of source pixels summed vertically, the colors premultiplied
+   * with the alpha so transparent pixels don't bleed into the edges */
+  n = src_width * n_channels;
+  acc = g_new (gfloat, n);
+
+  for (y = 0; y < dest_height; y++)
+    {
+      /* vertical pass, these loops have no dependencies between the
+       * iterations, so the compiler can vectorize them */
+      for (i = 0; i < n; i++)
+        acc[i] = 0.0f;
+
+      for (k = 0; k < y_count[y]; k++)
+        {
+          s = src_pixels + (gsize) (y_first[y] + k) * src_stride;
+          w = y_weights[y * y_stride + k];
+
+          if (has_alpha)
+            {
+              for (i = 0; i < n; i += 4)
+                {
+                  a = w * s[i + 3];
+                  acc[i] += a * s[i];
+                  acc[i + 1] += a * s[i + 1];
+                  acc[i + 2] += a * s[i + 2];
+                  acc[i + 3] += a;
+                }
+            }
+          else
+            {
+              for (i = 0; i < n; i++)
+                acc[i] += w * s[i];
+            }
+        }
+
+      /* horizontal pass on the summed row */
+      d = dest_pixels + (gsize) y * dest_stride;
+      for (x = 0; x < dest_width; x++, d += n_channels)
+        {
+          c0 = c1 = c2 = c3 = 0.0f;
+          p = acc + x_first[x] * n_channels;
+          for (k = 0; k < x_count[x]; k++, p += n_channels)
+            {
+              w = x_weights[x * x_stride + k];
+              c0 += w * p[0];
+              c1 += w * p[1];
+              c2 += w * p[2];
+              if (has_alpha)
+                c3 += w * p[3];
+            }
+
+          if (has_alpha)
+            {
+              if (c3 > 0.0f)
+                {
+                  d[0] = SCALE_TO_UCHAR (c0 / c3);
+                  d[1] = SCALE_TO_UCHAR (c1 / c3);
+                  d[2] = SCALE_TO_UCHAR (c2 / c3);
+                }
+              else
+                {
+                  d[0] = d[1] = d[2] = 0;
+                }
+              d[3] = SCALE_TO_UCHAR (c3);
+            }
+          else
+            {
+              d[0] = SCALE_TO_UCHAR (c0);
+              d[1] = SCALE_TO_UCHAR (c1);
+              d[2] = SCALE_TO_UCHAR (c2);
+            }
+        }
+    }
+
+  g_free (acc);
+  g_free (x_weights);
+  g_free (y_weights);
+  g_free (x_first);
+  g_free (x_count);
+  g_free (y_first);
+  g_free (y_count);
+
+  return dest;
+}
+
+
+
+GdkPixbuf *
+_xfce_panel_pixbuf_new_from_file_at_size (const gchar *filename,
+                                          gint dest_width,
+                                          gint dest_height,
+                                          GError **error)
+{
+  GdkPixbufFormat *format;
+  GdkPixbuf *pixbuf, *scaled;
+  gint src_w, src_h;
+  gdouble ratio;
+
+  g_return_val_if_fail (filename != NULL, NULL);
+  g_return_val_if_fail (dest_width > 0, NULL);
+  g_return_val_if_fail (dest_height > 0, NULL);
+
+  /* only read the header to see if the image has to be scaled down */
+  format = gdk_pixbuf_get_file_info (filename, &src_w, &src_h);
+  if (format == NULL
+      || src_w <= 0 || src_h <= 0
+      || (src_w <= dest_width && src_h <= dest_height))
+    return gdk_pixbuf_new_from_file (filename, error);
+
+  /* let the loader render svgs at the target size, so they are sharp,
+   * and jpegs are decoded at a reduced scale */
+  if (gdk_pixbuf_format_is_scalable (format)
+      || g_strcmp0 (gdk_pixbuf_format_get_name (format), "jpeg") == 0)
+    return gdk_pixbuf_new_from_file_at_scale (filename, dest_width, dest_height, TRUE, error);
+
+  /* other loaders decode the full image anyway, reduce it with the
+   * area averaging kernel instead of the generic gdk-pixbuf scaler */
+  pixbuf = gdk_pixbuf_new_from_file (filename, error);
+  if (G_UNLIKELY (pixbuf == NULL))
+    return NULL;
+
+  src_w = gdk_pixbuf_get_width (pixbuf);
+  src_h = gdk_pixbuf_get_height (pixbuf);
+  if (src_w <= dest_width && src_h <= dest_height)
+    return pixbuf;
+
+  ratio = MIN ((gdouble) dest_width / (gdouble) src_w,
+               (gdouble) dest_height / (gdouble) src_h);
+  scaled = _xfce_panel_pixbuf_scale_down (pixbuf,
+                                          MAX ((gint) rint (src_w * ratio), 1),
+                                          MAX ((gint) rint (src_h * ratio), 1));
+  g_object_unref (G_OBJECT (pixbuf));
+
+  return scaled;
+}
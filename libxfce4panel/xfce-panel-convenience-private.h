@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __XFCE_PANEL_CONVENIENCE_PRIVATE_H__
+#define __XFCE_PANEL_CONVENIENCE_PRIVATE_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* not exported, see -export-symbols-regex in Makefile.am */
+GdkPixbuf *
+_xfce_panel_pixbuf_new_from_file_at_size (const gchar *filename,
+                                          gint dest_width,
+                                          gint dest_height,
+                                          GError **error) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
+
+GdkPixbuf *
+_xfce_panel_pixbuf_scale_down (GdkPixbuf *source,
+                               gint dest_width,
+                               gint dest_height) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
+
+G_END_DECLS
+
+#endif /* !__XFCE_PANEL_CONVENIENCE_PRIVATE_H__ */
@@ -22,14 +22,20 @@
 #endif
 
 #include "xfce-panel-convenience.h"
+#include "xfce-panel-convenience-private.h"
 #include "xfce-panel-macros.h"
 #include "libxfce4panel-alias.h"
 
 #include <libxfce4util/libxfce4util.h>
 
+#include <glib/gstdio.h>
+
 #ifdef HAVE_MATH_H
 #include <math.h>
 #endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 
 
 
@@ -172,7 +178,8 @@ xfce_panel_pixbuf_from_source_at_size_and_scale (const gchar *source,
 
   if (G_UNLIKELY (g_path_is_absolute (source)))
     {
-      pixbuf = gdk_pixbuf_new_from_file (source, &error);
+      pixbuf = _xfce_panel_pixbuf_new_from_file_at_size (source, dest_width * scale,
+                                                         dest_height * scale, &error);
       if (G_UNLIKELY (pixbuf == NULL))
         {
           g_message ("Failed to load image \"%s\": %s",
@@ -207,7 +214,8 @@ xfce_panel_pixbuf_from_source_at_size_and_scale (const gchar *source,
 
               if (name != NULL)
                 {
-                  pixbuf = gdk_pixbuf_new_from_file (name, NULL);
+                  pixbuf = _xfce_panel_pixbuf_new_from_file_at_size (name, dest_width * scale,
+                                                                     dest_height * scale, NULL);
                   g_free (name);
                 }
             }
@@ -241,10 +249,9 @@ xfce_panel_pixbuf_from_source_at_size_and_scale (const gchar *source,
           dest_width = rint (src_w * ratio);
           dest_height = rint (src_h * ratio);
 
-          dest = gdk_pixbuf_scale_simple (pixbuf,
-                                          MAX (dest_width, 1),
-                                          MAX (dest_height, 1),
-                                          GDK_INTERP_BILINEAR);
+          dest = _xfce_panel_pixbuf_scale_down (pixbuf,
+                                                MAX (dest_width, 1),
+                                                MAX (dest_height, 1));
 
           g_object_unref (G_OBJECT (pixbuf));
           pixbuf = dest;
@@ -256,6 +263,406 @@ xfce_panel_pixbuf_from_source_at_size_and_scale (const gchar *source,
 
 
 
+/* default memory budget of the shared icon cache, in bytes */
+#define ICON_CACHE_DEFAULT_MAX_SIZE (8 * 1024 * 1024)
+
+/* seconds between checks of the modification time of cached files */
+#define ICON_CACHE_MTIME_INTERVAL (5)
+
+typedef struct _XfcePanelIconCacheEntry XfcePanelIconCacheEntry;
+struct _XfcePanelIconCacheEntry
+{
+  gchar *key;
+  GdkPixbuf *pixbuf;
+  gsize size;
+
+  /* source of the icon, the tail of the key */
+  const gchar *source;
+
+  /* modification time of absolute path sources, and when it was
+   * last compared with the file on disk */
+  gint64 mtime;
+  gint64 mtime_checked;
+
+  /* position in the lru queue */
+  GList link;
+};
+
+static GHashTable *icon_cache = NULL;
+static GQueue icon_cache_lru = G_QUEUE_INIT;
+static gsize icon_cache_size = 0;
+static gsize icon_cache_max_size = ICON_CACHE_DEFAULT_MAX_SIZE;
+static guint icon_cache_theme_generation = 0;
+static GQuark icon_cache_theme_quark = 0;
+
+
+
+static void
+xfce_panel_icon_cache_entry_free (gpointer data)
+{
+  XfcePanelIconCacheEntry *entry = data;
+
+  g_queue_unlink (&icon_cache_lru, &entry->link);
+  icon_cache_size -= entry->size;
+
+  g_object_unref (G_OBJECT (entry->pixbuf));
+  g_free (entry->key);
+  g_slice_free (XfcePanelIconCacheEntry, entry);
+}
+
+
+
+static void
+xfce_panel_icon_cache_theme_changed (GtkIconTheme *icon_theme)
+{
+  /* the generation is part of the key, so entries of the old theme can
+   * never be hit again, drop them right away to release the memory */
+  icon_cache_theme_generation++;
+  xfce_panel_icon_cache_clear ();
+}
+
+
+
+static void
+xfce_panel_icon_cache_theme_finalized (gpointer data,
+                                       GObject *where_the_object_was)
+{
+  /* another theme could be allocated at the same address */
+  xfce_panel_icon_cache_theme_changed (NULL);
+}
+
+
+
+static gint64
+xfce_panel_icon_cache_get_mtime (const gchar *source)
+{
+  GStatBuf st;
+
+  if (!g_path_is_absolute (source))
+    return 0;
+
+  if (g_stat (source, &st) != 0)
+    return -1;
+
+  return st.st_mtime;
+}
+
+
+
+static gchar *
+xfce_panel_icon_cache_key (const gchar *source,
+                           GtkIconTheme *icon_theme,
+                           gint dest_width,
+                           gint dest_height,
+                           gint scale)
+{
+  if (g_path_is_absolute (source))
+    {
+      /* files don't depend on the icon theme */
+      icon_theme = NULL;
+    }
+  else
+    {
+      if (icon_theme == NULL)
+        icon_theme = gtk_icon_theme_get_default ();
+
+      /* watch the theme for changes the first time we see it */
+      if (G_UNLIKELY (icon_cache_theme_quark == 0))
+        icon_cache_theme_quark = g_quark_from_static_string ("xfce-panel-icon-cache-theme");
+      if (g_object_get_qdata (G_OBJECT (icon_theme), icon_cache_theme_quark) == NULL)
+        {
+          g_object_set_qdata (G_OBJECT (icon_theme), icon_cache_theme_quark, GINT_TO_POINTER (TRUE));
+          g_signal_connect (G_OBJECT (icon_theme), "changed",
+                            G_CALLBACK (xfce_panel_icon_cache_theme_changed), NULL);
+          g_object_weak_ref (G_OBJECT (icon_theme), xfce_panel_icon_cache_theme_finalized, NULL);
+        }
+    }
+
+  return g_strdup_printf ("%p:%u:%dx%d@%d:%s", (gpointer) icon_theme,
+                          icon_cache_theme_generation, dest_width,
+                          dest_height, scale, source);
+}
+
+
+
+static void
+xfce_panel_icon_cache_trim (gsize max_size)
+{
+  XfcePanelIconCacheEntry *entry;
+
+  /* drop the least recently used entries until we fit in the budget */
+  while (icon_cache_size > max_size && icon_cache_lru.tail != NULL)
+    {
+      entry = icon_cache_lru.tail->data;
+      g_hash_table_remove (icon_cache, entry->key);
+    }
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_lookup:
+ * @source: string that contains the location of an icon
+ * @icon_theme: (allow-none): icon theme or %NULL to use the default icon theme
+ * @dest_width: the maximum width of the GdkPixbuf
+ * @dest_height: the maximum height of the GdkPixbuf
+ * @scale: desired scale (see gtk_widget_get_scale_factor())
+ *
+ * Look for a pixbuf in the icon cache shared by all plugins running in
+ * the same process, without loading anything on a miss.
+ *
+ * The cache must only be used from the main thread. The returned pixbuf
+ * is shared, so it should never be modified.
+ *
+ * Returns: (transfer full) (nullable): the cached GdkPixbuf or %NULL. The
+ *          value should be released with g_object_unref when no longer used.
+ *
+ * See also: xfce_panel_icon_cache_load
+ *
+ * Since: 4.19.4
+ **/
+GdkPixbuf *
+xfce_panel_icon_cache_lookup (const gchar *source,
+                              GtkIconTheme *icon_theme,
+                              gint dest_width,
+                              gint dest_height,
+                              gint scale)
+{
+  XfcePanelIconCacheEntry *entry;
+  gchar *key;
+  gint64 now;
+
+  g_return_val_if_fail (source != NULL, NULL);
+  g_return_val_if_fail (icon_theme == NULL || GTK_IS_ICON_THEME (icon_theme), NULL);
+
+  if (icon_cache == NULL)
+    return NULL;
+
+  key = xfce_panel_icon_cache_key (source, icon_theme, dest_width, dest_height, scale);
+  entry = g_hash_table_lookup (icon_cache, key);
+  g_free (key);
+
+  if (entry == NULL)
+    return NULL;
+
+  /* reload files that were changed on disk, but don't stat the
+   * file on every lookup */
+  if (entry->mtime != 0)
+    {
+      now = g_get_monotonic_time ();
+      if (now - entry->mtime_checked >= ICON_CACHE_MTIME_INTERVAL * G_USEC_PER_SEC)
+        {
+          if (entry->mtime != xfce_panel_icon_cache_get_mtime (source))
+            {
+              g_hash_table_remove (icon_cache, entry->key);
+              return NULL;
+            }
+
+          entry->mtime_checked = now;
+        }
+    }
+
+  /* move to the front of the lru queue */
+  g_queue_unlink (&icon_cache_lru, &entry->link);
+  g_queue_push_head_link (&icon_cache_lru, &entry->link);
+
+  return g_object_ref (entry->pixbuf);
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_insert:
+ * @source: string that contains the location of an icon
+ * @icon_theme: (allow-none): icon theme or %NULL to use the default icon theme
+ * @dest_width: the maximum width of the GdkPixbuf
+ * @dest_height: the maximum height of the GdkPixbuf
+ * @scale: desired scale (see gtk_widget_get_scale_factor())
+ * @pixbuf: the #GdkPixbuf loaded for this source
+ *
+ * Store a pixbuf in the shared icon cache, so other widgets can use it
+ * with xfce_panel_icon_cache_lookup(). The cache takes a reference on
+ * @pixbuf, which must not be modified afterwards. Pixbufs that are
+ * larger than the cache budget are not stored.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_icon_cache_insert (const gchar *source,
+                              GtkIconTheme *icon_theme,
+                              gint dest_width,
+                              gint dest_height,
+                              gint scale,
+                              GdkPixbuf *pixbuf)
+{
+  XfcePanelIconCacheEntry *entry;
+  gsize size;
+
+  g_return_if_fail (source != NULL);
+  g_return_if_fail (icon_theme == NULL || GTK_IS_ICON_THEME (icon_theme));
+  g_return_if_fail (GDK_IS_PIXBUF (pixbuf));
+
+  size = gdk_pixbuf_get_byte_length (pixbuf);
+  if (size > icon_cache_max_size)
+    return;
+
+  if (G_UNLIKELY (icon_cache == NULL))
+    icon_cache = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                        xfce_panel_icon_cache_entry_free);
+
+  entry = g_slice_new0 (XfcePanelIconCacheEntry);
+  entry->key = xfce_panel_icon_cache_key (source, icon_theme, dest_width, dest_height, scale);
+  entry->source = entry->key + strlen (entry->key) - strlen (source);
+  entry->pixbuf = g_object_ref (pixbuf);
+  entry->size = size;
+  entry->mtime = xfce_panel_icon_cache_get_mtime (source);
+  entry->mtime_checked = g_get_monotonic_time ();
+  entry->link.data = entry;
+
+  /* replaces (and frees) an existing entry with the same key */
+  g_hash_table_replace (icon_cache, entry->key, entry);
+  g_queue_push_head_link (&icon_cache_lru, &entry->link);
+  icon_cache_size += size;
+
+  xfce_panel_icon_cache_trim (icon_cache_max_size);
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_load:
+ * @source: string that contains the location of an icon
+ * @icon_theme: (allow-none): icon theme or %NULL to use the default icon theme
+ * @dest_width: the maximum width of the GdkPixbuf
+ * @dest_height: the maximum height of the GdkPixbuf
+ * @scale: desired scale (see gtk_widget_get_scale_factor())
+ *
+ * Same as xfce_panel_pixbuf_from_source_at_size(), but for a scale factor.
+ * The pixbuf is taken from the shared icon cache if another widget loaded
+ * it before, otherwise it is loaded and added to the cache.
+ *
+ * The cache is bounded in memory (see xfce_panel_icon_cache_set_max_size())
+ * and flushed when the icon theme changes. It must only be used from the
+ * main thread.
+ *
+ * Returns: (transfer full) (nullable): a GdkPixbuf or %NULL if nothing was
+ *          found. The pixbuf is shared, so it should never be modified. The
+ *          value should be released with g_object_unref when no longer used.
+ *
+ * Since: 4.19.4
+ **/
+GdkPixbuf *
+xfce_panel_icon_cache_load (const gchar *source,
+                            GtkIconTheme *icon_theme,
+                            gint dest_width,
+                            gint dest_height,
+                            gint scale)
+{
+  GdkPixbuf *pixbuf;
+
+  g_return_val_if_fail (source != NULL, NULL);
+  g_return_val_if_fail (icon_theme == NULL || GTK_IS_ICON_THEME (icon_theme), NULL);
+  g_return_val_if_fail (dest_width > 0, NULL);
+  g_return_val_if_fail (dest_height > 0, NULL);
+  g_return_val_if_fail (scale > 0, NULL);
+
+  pixbuf = xfce_panel_icon_cache_lookup (source, icon_theme, dest_width, dest_height, scale);
+  if (pixbuf != NULL)
+    return pixbuf;
+
+  pixbuf = xfce_panel_pixbuf_from_source_at_size_and_scale (source, icon_theme, dest_width, dest_height, scale);
+  if (G_LIKELY (pixbuf != NULL))
+    xfce_panel_icon_cache_insert (source, icon_theme, dest_width, dest_height, scale, pixbuf);
+
+  return pixbuf;
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_set_max_size:
+ * @max_size: the memory budget of the cache in bytes
+ *
+ * Set the maximum amount of pixel data kept in the shared icon cache. When
+ * the budget is exceeded, the least recently used pixbufs are dropped. A
+ * value of 0 disables the cache.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_icon_cache_set_max_size (gsize max_size)
+{
+  icon_cache_max_size = max_size;
+
+  if (icon_cache != NULL)
+    xfce_panel_icon_cache_trim (max_size);
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_get_max_size:
+ *
+ * Returns: the memory budget of the shared icon cache in bytes.
+ *
+ * Since: 4.19.4
+ **/
+gsize
+xfce_panel_icon_cache_get_max_size (void)
+{
+  return icon_cache_max_size;
+}
+
+
+
+static gboolean
+xfce_panel_icon_cache_remove_source (gpointer key,
+                                     gpointer value,
+                                     gpointer source)
+{
+  return g_strcmp0 (((XfcePanelIconCacheEntry *) value)->source, source) == 0;
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_remove:
+ * @source : the source of the icon, as passed to xfce_panel_icon_cache_insert().
+ *
+ * Drop the pixbufs of @source from the shared icon cache, for all the sizes
+ * and scale factors. Use this when the icon of a source that is not a file
+ * or an icon name changed, for example the icon of a window.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_icon_cache_remove (const gchar *source)
+{
+  g_return_if_fail (source != NULL);
+
+  if (icon_cache != NULL)
+    g_hash_table_foreach_remove (icon_cache, xfce_panel_icon_cache_remove_source, (gpointer) source);
+}
+
+
+
+/**
+ * xfce_panel_icon_cache_clear:
+ *
+ * Drop all the pixbufs from the shared icon cache. This happens
+ * automatically when an icon theme used by the cache changes.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_icon_cache_clear (void)
+{
+  if (icon_cache != NULL)
+    g_hash_table_remove_all (icon_cache);
+}
+
+
+
 /**
  * xfce_panel_pixbuf_from_source_at_size:
  * @source: string that contains the location of an icon
@@ -274,6 +681,10 @@ xfce_panel_pixbuf_from_source_at_size_and_scale (const gchar *source,
  * If it is when loaded from the disk, the pixbuf is scaled
  * preserving the aspect ratio.
  *
+ * The returned pixbuf comes from the shared icon cache, see
+ * xfce_panel_icon_cache_load(), so it should never be modified. Use
+ * gdk_pixbuf_copy() if you need to change it.
+ *
  * Returns: (transfer full): a GdkPixbuf or %NULL if nothing was found. The value should
  *          be released with g_object_unref when no longer used.
  *
@@ -287,7 +698,7 @@ xfce_panel_pixbuf_from_source_at_size (const gchar *source,
                                        gint dest_width,
                                        gint dest_height)
 {
-  return xfce_panel_pixbuf_from_source_at_size_and_scale (source, icon_theme, dest_width, dest_height, 1);
+  return xfce_panel_icon_cache_load (source, icon_theme, dest_width, dest_height, 1);
 }
 
 
@@ -342,7 +753,7 @@ xfce_panel_set_image_from_source (GtkImage *image,
 
   g_return_if_fail (GTK_IS_IMAGE (image));
 
-  pixbuf = xfce_panel_pixbuf_from_source_at_size_and_scale (source, icon_theme, size, size, scale);
+  pixbuf = xfce_panel_icon_cache_load (source, icon_theme, size, size, scale);
   if (G_LIKELY (pixbuf != NULL))
     {
       cairo_surface_t *surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale, NULL);
@@ -53,6 +53,40 @@ xfce_panel_set_image_from_source (GtkImage *image,
                                   gint size,
                                   gint scale);
 
+GdkPixbuf *
+xfce_panel_icon_cache_load (const gchar *source,
+                            GtkIconTheme *icon_theme,
+                            gint dest_width,
+                            gint dest_height,
+                            gint scale) G_GNUC_WARN_UNUSED_RESULT;
+
+GdkPixbuf *
+xfce_panel_icon_cache_lookup (const gchar *source,
+                              GtkIconTheme *icon_theme,
+                              gint dest_width,
+                              gint dest_height,
+                              gint scale) G_GNUC_WARN_UNUSED_RESULT;
+
+void
+xfce_panel_icon_cache_insert (const gchar *source,
+                              GtkIconTheme *icon_theme,
+                              gint dest_width,
+                              gint dest_height,
+                              gint scale,
+                              GdkPixbuf *pixbuf);
+
+void
+xfce_panel_icon_cache_set_max_size (gsize max_size);
+
+gsize
+xfce_panel_icon_cache_get_max_size (void);
+
+void
+xfce_panel_icon_cache_remove (const gchar *source);
+
+void
+xfce_panel_icon_cache_clear (void);
+
 G_END_DECLS
 
 #endif /* !__XFCE_PANEL_CONVENIENCE_H__ */
@@ -21,6 +21,7 @@
 #endif
 
 #include "xfce-panel-convenience.h"
+#include "xfce-panel-convenience-private.h"
 #include "xfce-panel-image.h"
 #include "xfce-panel-macros.h"
 #include "libxfce4panel-alias.h"
@@ -32,6 +33,9 @@
 #ifdef HAVE_MATH_H
 #include <math.h>
 #endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 
 
 
@@ -63,6 +67,9 @@
 /* design limit for the panel, to reduce the uncached pixbuf size */
 #define MAX_PIXBUF_SIZE (128)
 
+/* number of image files decoded in worker threads at the same time */
+#define MAX_ASYNC_LOADS (2)
+
 #define xfce_panel_image_unref_null(obj) \
   G_STMT_START \
   { \
@@ -99,6 +106,31 @@ struct _XfcePanelImagePrivate
 
   /* idle load timeout */
   guint idle_load_id;
+
+  /* whether icons are decoded in a worker thread */
+  guint load_async : 1;
+
+  /* cancellable and task of the pending asynchronous load, the
+   * task is owned by the queue or the icon info load until it runs */
+  GCancellable *cancellable;
+  GTask *load_task;
+};
+
+typedef struct _XfcePanelImageLoad XfcePanelImageLoad;
+struct _XfcePanelImageLoad
+{
+  /* key in the shared icon cache */
+  gchar *source;
+  GtkIconTheme *icon_theme;
+  gint dest_width;
+  gint dest_height;
+
+  /* file decoded in a worker thread, theme icons are loaded with
+   * gtk_icon_info_load_icon_async() instead */
+  gchar *filename;
+
+  /* whether the task was started or is still queued */
+  gboolean running;
 };
 
 enum
@@ -106,7 +138,8 @@ enum
   PROP_0,
   PROP_SOURCE,
   PROP_PIXBUF,
-  PROP_SIZE
+  PROP_SIZE,
+  PROP_LOAD_ASYNC
 };
 
 
@@ -143,6 +176,13 @@ static gboolean
 xfce_panel_image_load (gpointer data);
 static void
 xfce_panel_image_load_destroy (gpointer data);
+static void
+xfce_panel_image_load_async (XfcePanelImage *image,
+                             GtkIconTheme *icon_theme,
+                             gint dest_width,
+                             gint dest_height);
+static void
+xfce_panel_image_load_cancel (XfcePanelImage *image);
 static GdkPixbuf *
 xfce_panel_image_scale_pixbuf (GdkPixbuf *source,
                                gint dest_width,
@@ -154,6 +194,12 @@ G_DEFINE_TYPE_WITH_PRIVATE (XfcePanelImage, xfce_panel_image, GTK_TYPE_WIDGET)
 
 
 
+/* asynchronous loads waiting for a free worker */
+static GQueue load_queue = G_QUEUE_INIT;
+static guint load_running = 0;
+
+
+
 static void
 xfce_panel_image_class_init (XfcePanelImageClass *klass)
 {
@@ -211,6 +257,23 @@ xfce_panel_image_class_init (XfcePanelImageClass *klass)
                                                      -1, MAX_PIXBUF_SIZE, -1,
                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * XfcePanelImage:load-async:
+   *
+   * Whether icons are decoded outside of the main thread. The
+   * previous image is shown until the new one is ready. Off by default,
+   * since the image is then empty for a moment after it is first shown.
+   *
+   * Since: 4.19.4
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_LOAD_ASYNC,
+                                   g_param_spec_boolean ("load-async",
+                                                         "Load async",
+                                                         "Decode icons in a worker thread",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gtk_widget_class_install_style_property (gtkwidget_class,
                                            g_param_spec_boolean ("force-gtk-icon-sizes",
                                                                  NULL,
@@ -235,6 +298,9 @@ xfce_panel_image_init (XfcePanelImage *image)
   image->priv->width = -1;
   image->priv->height = -1;
   image->priv->force_icon_sizes = FALSE;
+  image->priv->load_async = FALSE;
+  image->priv->cancellable = NULL;
+  image->priv->load_task = NULL;
 }
 
 
@@ -261,6 +327,10 @@ xfce_panel_image_get_property (GObject *object,
       g_value_set_int (value, priv->size);
       break;
 
+    case PROP_LOAD_ASYNC:
+      g_value_set_boolean (value, priv->load_async);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -292,6 +362,10 @@ xfce_panel_image_set_property (GObject *object,
                                  g_value_get_int (value));
       break;
 
+    case PROP_LOAD_ASYNC:
+      XFCE_PANEL_IMAGE (object)->priv->load_async = g_value_get_boolean (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -437,8 +511,13 @@ xfce_panel_image_size_allocate (GtkWidget *widget,
       priv->width = allocation->width;
       priv->height = allocation->height;
 
-      /* free cache */
-      xfce_panel_image_unref_null (priv->cache);
+      /* stop decoding for the old size */
+      xfce_panel_image_load_cancel (XFCE_PANEL_IMAGE (widget));
+
+      /* free cache, when loading asynchronously it is shown until
+       * the icon for the new size is ready */
+      if (!priv->load_async || priv->pixbuf != NULL)
+        xfce_panel_image_unref_null (priv->cache);
 
       if (priv->pixbuf == NULL)
         {
@@ -539,6 +618,31 @@ xfce_panel_image_style_updated (GtkWidget *widget)
 
 
 
+static void
+xfce_panel_image_get_dest_size (XfcePanelImagePrivate *priv,
+                                gint *dest_w,
+                                gint *dest_h)
+{
+  *dest_w = priv->width;
+  *dest_h = priv->height;
+
+  if (G_UNLIKELY (priv->force_icon_sizes && *dest_w < 32 && *dest_w == *dest_h))
+    {
+      /* we use some hardcoded values here for convienence,
+       * above 32 pixels svg icons will kick in */
+      if (*dest_w > 16 && *dest_w < 22)
+        *dest_w = 16;
+      else if (*dest_w > 22 && *dest_w < 24)
+        *dest_w = 22;
+      else if (*dest_w > 24 && *dest_w < 32)
+        *dest_w = 24;
+
+      *dest_h = *dest_w;
+    }
+}
+
+
+
 static gboolean
 xfce_panel_image_load (gpointer data)
 {
@@ -548,22 +652,7 @@ xfce_panel_image_load (gpointer data)
   GtkIconTheme *icon_theme = NULL;
   gint dest_w, dest_h;
 
-  dest_w = priv->width;
-  dest_h = priv->height;
-
-  if (G_UNLIKELY (priv->force_icon_sizes && dest_w < 32 && dest_w == dest_h))
-    {
-      /* we use some hardcoded values here for convienence,
-       * above 32 pixels svg icons will kick in */
-      if (dest_w > 16 && dest_w < 22)
-        dest_w = 16;
-      else if (dest_w > 22 && dest_w < 24)
-        dest_w = 22;
-      else if (dest_w > 24 && dest_w < 32)
-        dest_w = 24;
-
-      dest_h = dest_w;
-    }
+  xfce_panel_image_get_dest_size (priv, &dest_w, &dest_h);
 
   if (priv->pixbuf != NULL)
     {
@@ -583,7 +672,13 @@ xfce_panel_image_load (gpointer data)
       if (G_LIKELY (screen != NULL))
         icon_theme = gtk_icon_theme_get_for_screen (screen);
 
-      priv->cache = xfce_panel_pixbuf_from_source_at_size (priv->source, icon_theme, dest_w, dest_h);
+      if (priv->load_async)
+        {
+          xfce_panel_image_load_async (XFCE_PANEL_IMAGE (data), icon_theme, dest_w, dest_h);
+          return FALSE;
+        }
+
+      priv->cache = xfce_panel_icon_cache_load (priv->source, icon_theme, dest_w, dest_h, 1);
     }
 
   if (G_LIKELY (priv->cache != NULL))
@@ -602,6 +697,314 @@ xfce_panel_image_load_destroy (gpointer data)
 
 
 
+static void
+xfce_panel_image_load_free (gpointer data)
+{
+  XfcePanelImageLoad *load = data;
+
+  g_object_unref (G_OBJECT (load->icon_theme));
+  g_free (load->filename);
+  g_free (load->source);
+  g_slice_free (XfcePanelImageLoad, load);
+}
+
+
+
+static void
+xfce_panel_image_load_thread (GTask *task,
+                              gpointer source_object,
+                              gpointer task_data,
+                              GCancellable *cancellable)
+{
+  XfcePanelImageLoad *load = task_data;
+  GdkPixbuf *pixbuf;
+  GdkPixbuf *scaled;
+  GError *error = NULL;
+
+  pixbuf = _xfce_panel_pixbuf_new_from_file_at_size (load->filename, load->dest_width,
+                                                     load->dest_height, &error);
+
+  if (G_UNLIKELY (pixbuf == NULL))
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+
+  /* don't bother scaling if the size changed in the meantime */
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (G_OBJECT (pixbuf));
+      return;
+    }
+
+  scaled = xfce_panel_image_scale_pixbuf (pixbuf, load->dest_width, load->dest_height);
+  g_object_unref (G_OBJECT (pixbuf));
+
+  g_task_return_pointer (task, scaled, g_object_unref);
+}
+
+
+
+static void
+xfce_panel_image_load_icon_ready (GObject *source_object,
+                                  GAsyncResult *result,
+                                  gpointer user_data)
+{
+  GTask *task = G_TASK (user_data);
+  XfcePanelImageLoad *load = g_task_get_task_data (task);
+  GdkPixbuf *pixbuf;
+  GdkPixbuf *scaled;
+  GError *error = NULL;
+
+  pixbuf = gtk_icon_info_load_icon_finish (GTK_ICON_INFO (source_object), result, &error);
+  if (G_LIKELY (pixbuf != NULL))
+    {
+      scaled = xfce_panel_image_scale_pixbuf (pixbuf, load->dest_width, load->dest_height);
+      g_object_unref (G_OBJECT (pixbuf));
+      g_task_return_pointer (task, scaled, g_object_unref);
+    }
+  else
+    {
+      g_task_return_error (task, error);
+    }
+
+  g_object_unref (G_OBJECT (task));
+}
+
+
+
+static void
+xfce_panel_image_load_queue_run (void)
+{
+  GTask *task;
+  XfcePanelImageLoad *load;
+
+  while (load_running < MAX_ASYNC_LOADS
+         && (task = g_queue_pop_head (&load_queue)) != NULL)
+    {
+      /* loads cancelled while waiting are finished right away */
+      if (!g_task_return_error_if_cancelled (task))
+        {
+          load = g_task_get_task_data (task);
+          load->running = TRUE;
+          load_running++;
+
+          g_task_run_in_thread (task, xfce_panel_image_load_thread);
+        }
+
+      g_object_unref (G_OBJECT (task));
+    }
+}
+
+
+
+static void
+xfce_panel_image_load_ready (GObject *object,
+                             GAsyncResult *result,
+                             gpointer user_data)
+{
+  XfcePanelImagePrivate *priv = XFCE_PANEL_IMAGE (object)->priv;
+  XfcePanelImageLoad *load = g_task_get_task_data (G_TASK (result));
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+  gint dest_w, dest_h;
+
+  if (load->running)
+    {
+      /* start the next queued load */
+      load_running--;
+      xfce_panel_image_load_queue_run ();
+    }
+
+  pixbuf = g_task_propagate_pointer (G_TASK (result), &error);
+  if (pixbuf != NULL)
+    {
+      /* keep the icon in the cache, even if the image does not want it anymore */
+      xfce_panel_icon_cache_insert (load->source, load->icon_theme,
+                                    load->dest_width, load->dest_height,
+                                    1, pixbuf);
+    }
+  else if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      /* a newer load replaced this one */
+      g_error_free (error);
+      return;
+    }
+
+  if (priv->load_task != G_TASK (result))
+    {
+      g_clear_error (&error);
+      if (pixbuf != NULL)
+        g_object_unref (G_OBJECT (pixbuf));
+      return;
+    }
+
+  priv->load_task = NULL;
+  g_clear_object (&priv->cancellable);
+
+  /* the size might have changed without a new load being started yet,
+   * only show the icon if it is still the one the image wants */
+  xfce_panel_image_get_dest_size (priv, &dest_w, &dest_h);
+  if (priv->pixbuf != NULL
+      || g_strcmp0 (priv->source, load->source) != 0
+      || dest_w != load->dest_width
+      || dest_h != load->dest_height)
+    {
+      g_clear_error (&error);
+      if (pixbuf != NULL)
+        g_object_unref (G_OBJECT (pixbuf));
+      return;
+    }
+
+  if (pixbuf == NULL)
+    {
+      /* let the synchronous loader report the error and pick a fallback */
+      g_clear_error (&error);
+      pixbuf = xfce_panel_icon_cache_load (load->source, load->icon_theme,
+                                           load->dest_width, load->dest_height, 1);
+    }
+
+  xfce_panel_image_unref_null (priv->cache);
+  priv->cache = pixbuf;
+
+  gtk_widget_queue_draw (GTK_WIDGET (object));
+}
+
+
+
+static void
+xfce_panel_image_load_async (XfcePanelImage *image,
+                             GtkIconTheme *icon_theme,
+                             gint dest_width,
+                             gint dest_height)
+{
+  XfcePanelImagePrivate *priv = image->priv;
+  XfcePanelImageLoad *load;
+  GtkIconInfo *icon_info = NULL;
+  GdkPixbuf *pixbuf;
+  GTask *task;
+  gchar *name;
+  gchar *p;
+  gint size = MIN (dest_width, dest_height);
+
+  panel_return_if_fail (priv->source != NULL);
+
+  xfce_panel_image_load_cancel (image);
+
+  if (G_UNLIKELY (icon_theme == NULL))
+    icon_theme = gtk_icon_theme_get_default ();
+
+  /* another widget might have decoded this icon already */
+  pixbuf = xfce_panel_icon_cache_lookup (priv->source, icon_theme, dest_width, dest_height, 1);
+  if (pixbuf != NULL)
+    {
+      xfce_panel_image_unref_null (priv->cache);
+      priv->cache = pixbuf;
+      gtk_widget_queue_draw (GTK_WIDGET (image));
+      return;
+    }
+
+  load = g_slice_new0 (XfcePanelImageLoad);
+
+  /* same lookup order as xfce_panel_pixbuf_from_source_at_size(), the
+   * theme lookup is cheap, decoding is done asynchronously */
+  if (G_UNLIKELY (g_path_is_absolute (priv->source)))
+    {
+      load->filename = g_strdup (priv->source);
+    }
+  else
+    {
+      icon_info = gtk_icon_theme_lookup_icon (icon_theme, priv->source, size, 0);
+      if (icon_info == NULL)
+        {
+          p = strrchr (priv->source, '.');
+          if (p != NULL)
+            {
+              name = g_strndup (priv->source, p - priv->source);
+              icon_info = gtk_icon_theme_lookup_icon (icon_theme, name, size, 0);
+              g_free (name);
+            }
+
+          if (icon_info == NULL)
+            {
+              name = g_build_filename ("pixmaps", priv->source, NULL);
+              load->filename = xfce_resource_lookup (XFCE_RESOURCE_DATA, name);
+              g_free (name);
+            }
+        }
+    }
+
+  load->source = g_strdup (priv->source);
+  load->icon_theme = g_object_ref (icon_theme);
+  load->dest_width = dest_width;
+  load->dest_height = dest_height;
+
+  if (icon_info == NULL && load->filename == NULL)
+    {
+      /* nothing to decode, the fallback icon is loaded synchronously */
+      xfce_panel_image_unref_null (priv->cache);
+      priv->cache = xfce_panel_icon_cache_load (priv->source, icon_theme,
+                                                dest_width, dest_height, 1);
+      xfce_panel_image_load_free (load);
+      gtk_widget_queue_draw (GTK_WIDGET (image));
+      return;
+    }
+
+  priv->cancellable = g_cancellable_new ();
+
+  task = g_task_new (image, priv->cancellable, xfce_panel_image_load_ready, NULL);
+  g_task_set_task_data (task, load, xfce_panel_image_load_free);
+  g_task_set_source_tag (task, xfce_panel_image_load_async);
+  priv->load_task = task;
+
+  if (icon_info != NULL)
+    {
+      /* gtk works on its own copy of the icon info in the thread */
+      gtk_icon_info_load_icon_async (icon_info, priv->cancellable,
+                                     xfce_panel_image_load_icon_ready, task);
+      g_object_unref (G_OBJECT (icon_info));
+      return;
+    }
+
+  /* limit the number of worker threads, so a theme change with
+   * many images in the panel doesn't spawn a job for each of them */
+  g_queue_push_tail (&load_queue, task);
+  xfce_panel_image_load_queue_run ();
+}
+
+
+
+static void
+xfce_panel_image_load_cancel (XfcePanelImage *image)
+{
+  XfcePanelImagePrivate *priv = image->priv;
+  XfcePanelImageLoad *load;
+  GTask *task = priv->load_task;
+
+  priv->load_task = NULL;
+
+  if (priv->cancellable != NULL)
+    {
+      g_cancellable_cancel (priv->cancellable);
+      g_object_unref (G_OBJECT (priv->cancellable));
+      priv->cancellable = NULL;
+    }
+
+  /* a load that is still queued does not need to wait for a worker,
+   * take it out of the queue and finish it right away */
+  if (task != NULL)
+    {
+      load = g_task_get_task_data (task);
+      if (!load->running && g_queue_remove (&load_queue, task))
+        {
+          g_task_return_error_if_cancelled (task);
+          g_object_unref (G_OBJECT (task));
+        }
+    }
+}
+
+
+
 static GdkPixbuf *
 xfce_panel_image_scale_pixbuf (GdkPixbuf *source,
                                gint dest_width,
@@ -632,9 +1035,8 @@ xfce_panel_image_scale_pixbuf (GdkPixbuf *source,
   dest_width = rint (source_width * ratio);
   dest_height = rint (source_height * ratio);
 
-  return gdk_pixbuf_scale_simple (source, MAX (dest_width, 1),
-                                  MAX (dest_height, 1),
-                                  GDK_INTERP_BILINEAR);
+  return _xfce_panel_pixbuf_scale_down (source, MAX (dest_width, 1),
+                                        MAX (dest_height, 1));
 }
 
 
@@ -841,6 +1243,8 @@ xfce_panel_image_clear (XfcePanelImage *image)
   if (priv->idle_load_id != 0)
     g_source_remove (priv->idle_load_id);
 
+  xfce_panel_image_load_cancel (image);
+
   if (priv->source != NULL)
     {
       g_free (priv->source);
@@ -31,6 +31,7 @@
 enum
 {
   PROVIDER_SIGNAL,
+  PROVIDER_STATS,
   LAST_SIGNAL
 };
 
@@ -51,6 +52,13 @@ xfce_panel_plugin_provider_default_init (XfcePanelPluginProviderInterface *klass
                                                     0, NULL, NULL,
                                                     g_cclosure_marshal_VOID__UINT,
                                                     G_TYPE_NONE, 1, G_TYPE_UINT);
+
+  provider_signals[PROVIDER_STATS] = g_signal_new (g_intern_static_string ("provider-stats"),
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0, NULL, NULL,
+                                                   g_cclosure_marshal_VOID__VARIANT,
+                                                   G_TYPE_NONE, 1, G_TYPE_VARIANT);
 }
 
 
@@ -165,6 +173,18 @@ xfce_panel_plugin_provider_emit_signal (XfcePanelPluginProvider *provider,
 
 
 
+void
+xfce_panel_plugin_provider_emit_stats (XfcePanelPluginProvider *provider,
+                                       GVariant *stats)
+{
+  panel_return_if_fail (XFCE_IS_PANEL_PLUGIN_PROVIDER (provider));
+  panel_return_if_fail (g_variant_is_of_type (stats, G_VARIANT_TYPE (PROVIDER_STATS_VARIANT_TYPE)));
+
+  g_signal_emit (provider, provider_signals[PROVIDER_STATS], 0, stats);
+}
+
+
+
 gboolean
 xfce_panel_plugin_provider_get_show_configure (XfcePanelPluginProvider *provider)
 {
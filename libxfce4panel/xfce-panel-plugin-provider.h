@@ -95,6 +95,19 @@ typedef enum /*< skip >*/
   PROVIDER_SIGNAL_UNSHRINK_PLUGIN
 } XfcePanelPluginProviderSignal;
 
+/* kinds of performance statistics send from the plugin to the panel */
+typedef enum /*< skip >*/
+{
+  PROVIDER_STATS_COUNTER, /* sum of the added values */
+  PROVIDER_STATS_TIMER, /* durations in microseconds */
+  PROVIDER_STATS_HISTOGRAM /* distribution of recorded values */
+} XfcePanelPluginProviderStatsType;
+
+/* statistics are send as (name, type, count, sum, min, max, buckets), where
+ * bucket i counts the values that need i bits (see g_bit_storage) */
+#define PROVIDER_STATS_VARIANT_TYPE "a(suxxxxat)"
+#define PROVIDER_STATS_N_BUCKETS (32)
+
 /* properties to the plugin; with a value or as an action */
 typedef enum /*< skip >*/
 {
@@ -191,6 +204,10 @@ void
 xfce_panel_plugin_provider_emit_signal (XfcePanelPluginProvider *provider,
                                         XfcePanelPluginProviderSignal provider_signal);
 
+void
+xfce_panel_plugin_provider_emit_stats (XfcePanelPluginProvider *provider,
+                                       GVariant *stats);
+
 gboolean
 xfce_panel_plugin_provider_get_show_configure (XfcePanelPluginProvider *provider);
 
@@ -107,6 +107,8 @@ static void
 xfce_panel_plugin_unregister_menu (GtkMenu *menu,
                                    XfcePanelPlugin *plugin);
 static void
+xfce_panel_plugin_stats_flush (XfcePanelPlugin *plugin);
+static void
 xfce_panel_plugin_set_size (XfcePanelPluginProvider *provider,
                             gint size);
 static void
@@ -227,8 +229,28 @@ struct _XfcePanelPluginPrivate
 
   /* autohide block counter */
   gint panel_lock;
+
+  /* pending save from xfce_panel_plugin_queue_save() */
+  guint save_timeout_id;
+
+  /* queued save that could not be written while blocked or locked */
+  guint save_pending : 1;
+
+  /* performance statistics, only used when enabled */
+  GHashTable *stats;
+  guint stats_timeout_id;
 };
 
+typedef struct
+{
+  XfcePanelPluginProviderStatsType type;
+  gint64 count;
+  gint64 sum;
+  gint64 min;
+  gint64 max;
+  guint64 buckets[PROVIDER_STATS_N_BUCKETS];
+} XfcePanelPluginStat;
+
 
 
 static guint plugin_signals[LAST_SIGNAL];
@@ -742,6 +764,10 @@ xfce_panel_plugin_init (XfcePanelPlugin *plugin)
   plugin->priv->locked = TRUE;
   plugin->priv->menu_items = NULL;
   plugin->priv->nrows = 1;
+  plugin->priv->save_timeout_id = 0;
+  plugin->priv->save_pending = FALSE;
+  plugin->priv->stats = NULL;
+  plugin->priv->stats_timeout_id = 0;
 
   /* bind the text domain of the panel so our strings
    * are properly translated in the old 4.6 panel plugins */
@@ -952,9 +978,31 @@ xfce_panel_plugin_dispose (GObject *object)
 
   if (!PANEL_HAS_FLAG (plugin->priv->flags, PLUGIN_FLAG_DISPOSED))
     {
+      /* write a queued save before the plugin releases its data, also
+       * when the plugin is locked or the menu is blocked, because there
+       * is no later moment to retry it */
+      if (plugin->priv->save_timeout_id != 0)
+        {
+          g_source_remove (plugin->priv->save_timeout_id);
+          plugin->priv->save_pending = TRUE;
+        }
+
+      if (plugin->priv->save_pending)
+        {
+          plugin->priv->save_pending = FALSE;
+          g_signal_emit (G_OBJECT (plugin), plugin_signals[SAVE], 0);
+        }
+
       /* allow the plugin to cleanup */
       g_signal_emit (G_OBJECT (object), plugin_signals[FREE_DATA], 0);
 
+      /* send the remaining statistics */
+      if (plugin->priv->stats_timeout_id != 0)
+        {
+          g_source_remove (plugin->priv->stats_timeout_id);
+          xfce_panel_plugin_stats_flush (plugin);
+        }
+
       /* plugin disposed, don't try this again */
       PANEL_SET_FLAG (plugin->priv->flags, PLUGIN_FLAG_DISPOSED);
     }
@@ -976,6 +1024,11 @@ xfce_panel_plugin_finalize (GObject *object)
   g_free (plugin->priv->property_base);
   g_strfreev (plugin->priv->arguments);
 
+  if (plugin->priv->stats_timeout_id != 0)
+    g_source_remove (plugin->priv->stats_timeout_id);
+  if (plugin->priv->stats != NULL)
+    g_hash_table_destroy (plugin->priv->stats);
+
   (*G_OBJECT_CLASS (xfce_panel_plugin_parent_class)->finalize) (object);
 }
 
@@ -1565,10 +1618,33 @@ xfce_panel_plugin_save (XfcePanelPluginProvider *provider)
 
   panel_return_if_fail (XFCE_IS_PANEL_PLUGIN (provider));
 
-  /* only send the save signal if the plugin is not locked */
+  /* this also writes a queued save */
+  if (plugin->priv->save_timeout_id != 0)
+    {
+      g_source_remove (plugin->priv->save_timeout_id);
+      plugin->priv->save_pending = TRUE;
+    }
+
+  /* only send the save signal if the plugin is not locked, a queued
+   * save is retried once the block is lifted */
   if (XFCE_PANEL_PLUGIN (provider)->priv->menu_blocked == 0
       && !xfce_panel_plugin_get_locked (plugin))
-    g_signal_emit (G_OBJECT (provider), plugin_signals[SAVE], 0);
+    {
+      plugin->priv->save_pending = FALSE;
+      g_signal_emit (G_OBJECT (provider), plugin_signals[SAVE], 0);
+    }
+}
+
+
+
+static void
+xfce_panel_plugin_save_pending (XfcePanelPlugin *plugin)
+{
+  /* write the queued save that was held back */
+  if (plugin->priv->save_pending
+      && plugin->priv->menu_blocked == 0
+      && !xfce_panel_plugin_get_locked (plugin))
+    xfce_panel_plugin_queue_save (plugin);
 }
 
 
@@ -1624,6 +1700,12 @@ xfce_panel_plugin_removed (XfcePanelPluginProvider *provider)
 {
   panel_return_if_fail (XFCE_IS_PANEL_PLUGIN (provider));
 
+  /* flush a queued save, so it doesn't run after the plugin
+   * cleaned up its configuration */
+  if (XFCE_PANEL_PLUGIN (provider)->priv->save_timeout_id != 0
+      || XFCE_PANEL_PLUGIN (provider)->priv->save_pending)
+    xfce_panel_plugin_save (provider);
+
   if (!xfce_panel_plugin_get_locked (XFCE_PANEL_PLUGIN (provider)))
     g_signal_emit (G_OBJECT (provider), plugin_signals[REMOVED], 0);
 }
@@ -1665,6 +1747,8 @@ xfce_panel_plugin_set_locked (XfcePanelPluginProvider *provider,
       /* destroy the menu if it exists */
       if (plugin->priv->locked)
         xfce_panel_plugin_menu_destroy (plugin);
+      else
+        xfce_panel_plugin_save_pending (plugin);
     }
 }
 
@@ -2394,6 +2478,8 @@ xfce_panel_plugin_unblock_menu (XfcePanelPlugin *plugin)
   /* decrease block counter */
   if (G_LIKELY (plugin->priv->menu_blocked > 0))
     plugin->priv->menu_blocked--;
+
+  xfce_panel_plugin_save_pending (plugin);
 }
 
 
@@ -3182,5 +3268,293 @@ xfce_panel_plugin_save_location (XfcePanelPlugin *plugin,
 
 
 
+static gboolean
+xfce_panel_plugin_stats_enabled (void)
+{
+  static gsize inited = 0;
+  static gboolean enabled = FALSE;
+  const gchar *value;
+  const GDebugKey keys[] = { { "stats", 1 } };
+
+  if (g_once_init_enter (&inited))
+    {
+      /* same environment variable and syntax as the panel debug domains */
+      value = g_getenv ("PANEL_DEBUG");
+      if (value != NULL && *value != '\0')
+        enabled = g_parse_debug_string (value, keys, G_N_ELEMENTS (keys)) != 0;
+
+      g_once_init_leave (&inited, 1);
+    }
+
+  return enabled;
+}
+
+
+
+static void
+xfce_panel_plugin_stats_flush (XfcePanelPlugin *plugin)
+{
+  GVariantBuilder builder;
+  GHashTableIter iter;
+  gpointer key, value;
+  XfcePanelPluginStat *stat;
+
+  if (plugin->priv->stats == NULL || g_hash_table_size (plugin->priv->stats) == 0)
+    return;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE (PROVIDER_STATS_VARIANT_TYPE));
+
+  g_hash_table_iter_init (&iter, plugin->priv->stats);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      stat = value;
+      g_variant_builder_add (&builder, "(suxxxx@at)", key, stat->type,
+                             stat->count, stat->sum, stat->min, stat->max,
+                             g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64, stat->buckets,
+                                                        PROVIDER_STATS_N_BUCKETS,
+                                                        sizeof (guint64)));
+    }
+
+  /* the panel aggregates, so we only send the changes since the last flush */
+  g_hash_table_remove_all (plugin->priv->stats);
+
+  xfce_panel_plugin_provider_emit_stats (XFCE_PANEL_PLUGIN_PROVIDER (plugin),
+                                         g_variant_builder_end (&builder));
+}
+
+
+
+static gboolean
+xfce_panel_plugin_stats_timeout (gpointer user_data)
+{
+  xfce_panel_plugin_stats_flush (XFCE_PANEL_PLUGIN (user_data));
+
+  return FALSE;
+}
+
+
+
+static void
+xfce_panel_plugin_stats_timeout_destroyed (gpointer user_data)
+{
+  XFCE_PANEL_PLUGIN (user_data)->priv->stats_timeout_id = 0;
+}
+
+
+
+static void
+xfce_panel_plugin_stats_update (XfcePanelPlugin *plugin,
+                                const gchar *name,
+                                XfcePanelPluginProviderStatsType type,
+                                gint64 value)
+{
+  XfcePanelPluginStat *stat;
+
+  if (G_UNLIKELY (plugin->priv->stats == NULL))
+    plugin->priv->stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  stat = g_hash_table_lookup (plugin->priv->stats, name);
+  if (stat == NULL)
+    {
+      stat = g_new0 (XfcePanelPluginStat, 1);
+      stat->type = type;
+      stat->min = G_MAXINT64;
+      stat->max = G_MININT64;
+      g_hash_table_insert (plugin->priv->stats, g_strdup (name), stat);
+    }
+  else if (G_UNLIKELY (stat->type != type))
+    {
+      g_warning ("Statistic \"%s\" of plugin \"%s-%d\" is used with different types",
+                 name, plugin->priv->name, plugin->priv->unique_id);
+      return;
+    }
+
+  stat->count++;
+  stat->sum += value;
+  stat->min = MIN (stat->min, value);
+  stat->max = MAX (stat->max, value);
+  if (type != PROVIDER_STATS_COUNTER)
+    stat->buckets[MIN (g_bit_storage (MAX (value, 0)), PROVIDER_STATS_N_BUCKETS - 1)]++;
+
+  /* send the statistics to the panel in batches */
+  if (plugin->priv->stats_timeout_id == 0)
+    plugin->priv->stats_timeout_id =
+      g_timeout_add_seconds_full (G_PRIORITY_LOW, 5,
+                                  xfce_panel_plugin_stats_timeout, plugin,
+                                  xfce_panel_plugin_stats_timeout_destroyed);
+}
+
+
+
+static gboolean
+xfce_panel_plugin_queue_save_timeout (gpointer user_data)
+{
+  xfce_panel_plugin_save (XFCE_PANEL_PLUGIN_PROVIDER (user_data));
+
+  return FALSE;
+}
+
+
+
+static void
+xfce_panel_plugin_queue_save_timeout_destroyed (gpointer user_data)
+{
+  XFCE_PANEL_PLUGIN (user_data)->priv->save_timeout_id = 0;
+}
+
+
+
+/**
+ * xfce_panel_plugin_queue_save:
+ * @plugin : an #XfcePanelPlugin.
+ *
+ * Mark the configuration of the plugin as changed. Instead of writing it
+ * right away, the #XfcePanelPlugin::save signal is emitted from a low
+ * priority timeout once the plugin has not been marked for a second, so
+ * a burst of changes results in a single write that doesn't block user
+ * interaction.
+ *
+ * A queued save is written immediately when the plugin is removed, when
+ * the panel saves all plugins (for example on exit) and before the
+ * #XfcePanelPlugin::free-data signal. While the menu is blocked or the
+ * plugin is locked the save is kept pending and written once that is
+ * lifted, or when the plugin is disposed.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_plugin_queue_save (XfcePanelPlugin *plugin)
+{
+  g_return_if_fail (XFCE_IS_PANEL_PLUGIN (plugin));
+
+  /* restart the timeout to coalesce the writes */
+  if (plugin->priv->save_timeout_id != 0)
+    g_source_remove (plugin->priv->save_timeout_id);
+
+  plugin->priv->save_timeout_id =
+    g_timeout_add_seconds_full (G_PRIORITY_LOW, 1,
+                                xfce_panel_plugin_queue_save_timeout, plugin,
+                                xfce_panel_plugin_queue_save_timeout_destroyed);
+}
+
+
+
+/**
+ * xfce_panel_plugin_stats_add:
+ * @plugin : an #XfcePanelPlugin.
+ * @name   : name of the counter.
+ * @delta  : value to add to the counter.
+ *
+ * Add @delta to the performance counter @name of the plugin. The panel
+ * sums the counters of each plugin and prints them in its debug output.
+ *
+ * Performance statistics are only collected when the panel is started
+ * with the environment variable PANEL_DEBUG containing "stats" (or "all"),
+ * otherwise this function returns immediately, so it is safe to leave the
+ * calls in the code. This works for both internal and external plugins.
+ *
+ * See also: xfce_panel_plugin_stats_timer_start() and
+ *           xfce_panel_plugin_stats_record().
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_plugin_stats_add (XfcePanelPlugin *plugin,
+                             const gchar *name,
+                             gint64 delta)
+{
+  if (G_LIKELY (!xfce_panel_plugin_stats_enabled ()))
+    return;
+
+  g_return_if_fail (XFCE_IS_PANEL_PLUGIN (plugin));
+  g_return_if_fail (name != NULL);
+
+  xfce_panel_plugin_stats_update (plugin, name, PROVIDER_STATS_COUNTER, delta);
+}
+
+
+
+/**
+ * xfce_panel_plugin_stats_timer_start:
+ * @plugin : an #XfcePanelPlugin.
+ *
+ * Start measuring the duration of an operation, pass the returned value to
+ * xfce_panel_plugin_stats_timer_stop() when it is finished.
+ *
+ * Returns: the start time in microseconds or 0 when performance statistics
+ *          are disabled.
+ *
+ * Since: 4.19.4
+ **/
+gint64
+xfce_panel_plugin_stats_timer_start (XfcePanelPlugin *plugin)
+{
+  if (G_LIKELY (!xfce_panel_plugin_stats_enabled ()))
+    return 0;
+
+  g_return_val_if_fail (XFCE_IS_PANEL_PLUGIN (plugin), 0);
+
+  return g_get_monotonic_time ();
+}
+
+
+
+/**
+ * xfce_panel_plugin_stats_timer_stop:
+ * @plugin : an #XfcePanelPlugin.
+ * @name   : name of the timer.
+ * @start  : the value returned by xfce_panel_plugin_stats_timer_start().
+ *
+ * Add the time elapsed since @start to the timer @name of the plugin. The
+ * panel reports the number of measurements, the average, minimum and
+ * maximum duration and a rough distribution of the durations.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_plugin_stats_timer_stop (XfcePanelPlugin *plugin,
+                                    const gchar *name,
+                                    gint64 start)
+{
+  if (G_LIKELY (start == 0))
+    return;
+
+  g_return_if_fail (XFCE_IS_PANEL_PLUGIN (plugin));
+  g_return_if_fail (name != NULL);
+
+  xfce_panel_plugin_stats_update (plugin, name, PROVIDER_STATS_TIMER,
+                                  g_get_monotonic_time () - start);
+}
+
+
+
+/**
+ * xfce_panel_plugin_stats_record:
+ * @plugin : an #XfcePanelPlugin.
+ * @name   : name of the histogram.
+ * @value  : the value to record.
+ *
+ * Record @value in the histogram @name of the plugin, for example the
+ * number of items handled in an update. Values are grouped in power of
+ * two buckets.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_plugin_stats_record (XfcePanelPlugin *plugin,
+                                const gchar *name,
+                                gint64 value)
+{
+  if (G_LIKELY (!xfce_panel_plugin_stats_enabled ()))
+    return;
+
+  g_return_if_fail (XFCE_IS_PANEL_PLUGIN (plugin));
+  g_return_if_fail (name != NULL);
+
+  xfce_panel_plugin_stats_update (plugin, name, PROVIDER_STATS_HISTOGRAM, value);
+}
+
+
+
 #define __XFCE_PANEL_PLUGIN_C__
 #include "libxfce4panel-aliasdef.c"
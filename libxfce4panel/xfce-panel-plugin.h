@@ -297,6 +297,27 @@ gchar *
 xfce_panel_plugin_save_location (XfcePanelPlugin *plugin,
                                  gboolean create) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
 
+void
+xfce_panel_plugin_queue_save (XfcePanelPlugin *plugin);
+
+void
+xfce_panel_plugin_stats_add (XfcePanelPlugin *plugin,
+                             const gchar *name,
+                             gint64 delta);
+
+gint64
+xfce_panel_plugin_stats_timer_start (XfcePanelPlugin *plugin);
+
+void
+xfce_panel_plugin_stats_timer_stop (XfcePanelPlugin *plugin,
+                                    const gchar *name,
+                                    gint64 start);
+
+void
+xfce_panel_plugin_stats_record (XfcePanelPlugin *plugin,
+                                const gchar *name,
+                                gint64 value);
+
 G_END_DECLS
 
 #endif /* !__XFCE_PANEL_PLUGIN_H__ */
@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "xfce-panel-tick.h"
+#include "libxfce4panel-alias.h"
+
+#ifdef HAVE_SYS_TIMERFD_H
+#include <glib-unix.h>
+#include <sys/timerfd.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+
+
+/**
+ * SECTION: xfce-panel-tick
+ * @title: Aligned Ticks
+ * @short_description: Shared wall clock timer for panel plugins
+ * @include: libxfce4panel/libxfce4panel.h
+ *
+ * Plugins that update on wall clock boundaries, like clocks or monitors,
+ * can subscribe to second or minute aligned ticks with xfce_panel_tick_add()
+ * instead of running their own timeouts. All the subscribers in a process
+ * share a single timer, so a panel full of plugins wakes up once per second
+ * (or once per minute) instead of once for each plugin.
+ *
+ * Where available, the timer is a timerfd with absolute %CLOCK_REALTIME
+ * deadlines, so ticks stay aligned after a suspend or when the system
+ * time is changed.
+ **/
+
+
+
+typedef struct _XfcePanelTick XfcePanelTick;
+struct _XfcePanelTick
+{
+  XfcePanelTickInterval interval;
+  XfcePanelTickFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+};
+
+
+
+/* subscribers, tick id -> XfcePanelTick */
+static GHashTable *ticks = NULL;
+static guint tick_next_id = 1;
+static guint tick_n_seconds = 0;
+
+/* period of the running timer in seconds, 0 when stopped */
+static guint tick_period = 0;
+static guint tick_source_id = 0;
+static gint64 tick_last_minute = 0;
+#ifdef HAVE_SYS_TIMERFD_H
+static gint tick_fd = -1;
+#endif
+
+
+
+static void
+xfce_panel_tick_free (gpointer data)
+{
+  XfcePanelTick *tick = data;
+
+  if (tick->notify != NULL)
+    tick->notify (tick->user_data);
+
+  g_slice_free (XfcePanelTick, tick);
+}
+
+
+
+static void
+xfce_panel_tick_dispatch (void)
+{
+  XfcePanelTick *tick;
+  GList *ids, *li;
+  gint64 now;
+  gboolean new_minute;
+
+  /* round to the nearest second, the fallback timeout is not exact */
+  now = (g_get_real_time () + G_USEC_PER_SEC / 2) / G_USEC_PER_SEC;
+
+  /* also catches minutes missed during a suspend or a clock change */
+  new_minute = (now / 60 != tick_last_minute);
+  tick_last_minute = now / 60;
+
+  ids = g_hash_table_get_keys (ticks);
+  for (li = ids; li != NULL; li = li->next)
+    {
+      /* the tick could have been removed by a previous callback */
+      tick = g_hash_table_lookup (ticks, li->data);
+      if (tick != NULL
+          && (tick->interval == XFCE_PANEL_TICK_SECOND || new_minute))
+        tick->func (tick->user_data);
+    }
+  g_list_free (ids);
+}
+
+
+
+static guint
+xfce_panel_tick_next_timeout (void)
+{
+  gint64 period = (gint64) tick_period * G_USEC_PER_SEC;
+
+  /* milliseconds to just after the next boundary */
+  return (period - g_get_real_time () % period) / 1000 + 1;
+}
+
+
+
+static gboolean
+xfce_panel_tick_timeout (gpointer user_data)
+{
+  tick_source_id = 0;
+
+  xfce_panel_tick_dispatch ();
+
+  /* schedule the next tick, unless a callback restarted the timer */
+  if (tick_period != 0 && tick_source_id == 0)
+    tick_source_id = g_timeout_add_full (G_PRIORITY_HIGH, xfce_panel_tick_next_timeout (),
+                                         xfce_panel_tick_timeout, NULL, NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+
+#ifdef HAVE_SYS_TIMERFD_H
+static gboolean
+xfce_panel_tick_fd_arm (void)
+{
+  struct itimerspec spec;
+  struct timespec now;
+  gint flags = TFD_TIMER_ABSTIME;
+
+  if (clock_gettime (CLOCK_REALTIME, &now) != 0)
+    return FALSE;
+
+  /* absolute deadlines, so the timer never drifts from the wall clock */
+  spec.it_value.tv_sec = (now.tv_sec / tick_period + 1) * tick_period;
+  spec.it_value.tv_nsec = 0;
+  spec.it_interval.tv_sec = tick_period;
+  spec.it_interval.tv_nsec = 0;
+
+#ifdef TFD_TIMER_CANCEL_ON_SET
+  /* wake up when the system time is changed */
+  flags |= TFD_TIMER_CANCEL_ON_SET;
+#endif
+
+  return timerfd_settime (tick_fd, flags, &spec, NULL) == 0;
+}
+
+
+
+static gboolean
+xfce_panel_tick_fd_ready (gint fd,
+                          GIOCondition condition,
+                          gpointer user_data)
+{
+  guint64 expirations;
+
+  if (read (fd, &expirations, sizeof (expirations)) < 0)
+    {
+#ifdef TFD_TIMER_CANCEL_ON_SET
+      if (errno != ECANCELED)
+        return G_SOURCE_CONTINUE;
+
+      /* the system time was changed, align the timer again */
+      xfce_panel_tick_fd_arm ();
+#else
+      return G_SOURCE_CONTINUE;
+#endif
+    }
+
+  xfce_panel_tick_dispatch ();
+
+  return G_SOURCE_CONTINUE;
+}
+#endif
+
+
+
+static void
+xfce_panel_tick_stop (void)
+{
+  if (tick_source_id != 0)
+    {
+      g_source_remove (tick_source_id);
+      tick_source_id = 0;
+    }
+
+#ifdef HAVE_SYS_TIMERFD_H
+  if (tick_fd != -1)
+    {
+      close (tick_fd);
+      tick_fd = -1;
+    }
+#endif
+}
+
+
+
+static void
+xfce_panel_tick_start (void)
+{
+  tick_last_minute = g_get_real_time () / G_USEC_PER_SEC / 60;
+
+#ifdef HAVE_SYS_TIMERFD_H
+  if (tick_fd == -1)
+    {
+      tick_fd = timerfd_create (CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+      if (G_LIKELY (tick_fd != -1))
+        tick_source_id = g_unix_fd_add_full (G_PRIORITY_HIGH, tick_fd, G_IO_IN,
+                                             xfce_panel_tick_fd_ready, NULL, NULL);
+    }
+
+  /* a period change only re-arms the timer */
+  if (G_LIKELY (tick_fd != -1))
+    {
+      if (xfce_panel_tick_fd_arm ())
+        return;
+
+      g_warning ("Failed to arm the tick timer: %s", g_strerror (errno));
+      xfce_panel_tick_stop ();
+    }
+#endif
+
+  /* fall back to a timeout that is realigned on every tick */
+  if (tick_source_id != 0)
+    g_source_remove (tick_source_id);
+  tick_source_id = g_timeout_add_full (G_PRIORITY_HIGH, xfce_panel_tick_next_timeout (),
+                                       xfce_panel_tick_timeout, NULL, NULL);
+}
+
+
+
+static void
+xfce_panel_tick_update (void)
+{
+  guint period;
+
+  if (g_hash_table_size (ticks) == 0)
+    period = 0;
+  else if (tick_n_seconds > 0)
+    period = 1;
+  else
+    period = 60;
+
+  if (period == tick_period)
+    return;
+
+  tick_period = period;
+
+  if (period == 0)
+    xfce_panel_tick_stop ();
+  else
+    xfce_panel_tick_start ();
+}
+
+
+
+/**
+ * xfce_panel_tick_add:
+ * @interval: whether to tick every second or every minute
+ * @func: (scope notified): function to call on every tick
+ * @user_data: (closure): data to pass to @func
+ * @notify: (allow-none): function to call when the tick is removed, or %NULL
+ *
+ * Call @func at the start of every second or minute of the wall clock,
+ * using a timer shared with all other subscribers in the process. After
+ * a suspend or a change of the system time, minute subscribers are called
+ * as soon as the minute differs from the previous tick.
+ *
+ * This must be called from the main thread.
+ *
+ * Returns: the ID (greater than 0) of the tick, to pass to
+ *          xfce_panel_tick_remove().
+ *
+ * Since: 4.19.4
+ **/
+guint
+xfce_panel_tick_add (XfcePanelTickInterval interval,
+                     XfcePanelTickFunc func,
+                     gpointer user_data,
+                     GDestroyNotify notify)
+{
+  XfcePanelTick *tick;
+  guint tick_id;
+
+  g_return_val_if_fail (func != NULL, 0);
+  g_return_val_if_fail (interval == XFCE_PANEL_TICK_SECOND
+                        || interval == XFCE_PANEL_TICK_MINUTE, 0);
+
+  if (G_UNLIKELY (ticks == NULL))
+    ticks = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                   NULL, xfce_panel_tick_free);
+
+  tick = g_slice_new0 (XfcePanelTick);
+  tick->interval = interval;
+  tick->func = func;
+  tick->user_data = user_data;
+  tick->notify = notify;
+
+  tick_id = tick_next_id++;
+  g_hash_table_insert (ticks, GUINT_TO_POINTER (tick_id), tick);
+
+  if (interval == XFCE_PANEL_TICK_SECOND)
+    tick_n_seconds++;
+
+  xfce_panel_tick_update ();
+
+  return tick_id;
+}
+
+
+
+/**
+ * xfce_panel_tick_remove:
+ * @tick_id: the ID returned by xfce_panel_tick_add()
+ *
+ * Stop calling the function of the tick and call its destroy notify.
+ * The shared timer stops when the last tick is removed.
+ *
+ * Since: 4.19.4
+ **/
+void
+xfce_panel_tick_remove (guint tick_id)
+{
+  XfcePanelTick *tick;
+
+  g_return_if_fail (tick_id > 0);
+
+  tick = ticks != NULL ? g_hash_table_lookup (ticks, GUINT_TO_POINTER (tick_id)) : NULL;
+  g_return_if_fail (tick != NULL);
+
+  if (tick->interval == XFCE_PANEL_TICK_SECOND)
+    tick_n_seconds--;
+
+  g_hash_table_remove (ticks, GUINT_TO_POINTER (tick_id));
+
+  xfce_panel_tick_update ();
+}
+
+
+
+#define __XFCE_PANEL_TICK_C__
+#include "libxfce4panel-aliasdef.c"
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#if !defined(_LIBXFCE4PANEL_INSIDE_LIBXFCE4PANEL_H) && !defined(LIBXFCE4PANEL_COMPILATION)
+#error "Only <libxfce4panel/libxfce4panel.h> can be included directly, this file may disappear or change contents"
+#endif
+
+#ifndef __XFCE_PANEL_TICK_H__
+#define __XFCE_PANEL_TICK_H__
+
+#include <libxfce4panel/libxfce4panel-enums.h>
+
+G_BEGIN_DECLS
+
+/**
+ * XfcePanelTickFunc:
+ * @user_data: the data passed to xfce_panel_tick_add()
+ *
+ * Callback called by the shared tick timer.
+ *
+ * Since: 4.19.4
+ **/
+typedef void (*XfcePanelTickFunc) (gpointer user_data);
+
+guint
+xfce_panel_tick_add (XfcePanelTickInterval interval,
+                     XfcePanelTickFunc func,
+                     gpointer user_data,
+                     GDestroyNotify notify);
+
+void
+xfce_panel_tick_remove (guint tick_id);
+
+G_END_DECLS
+
+#endif /* !__XFCE_PANEL_TICK_H__ */
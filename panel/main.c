@@ -36,6 +36,10 @@
 #include <libxfce4util/libxfce4util.h>
 #include <libxfce4windowing/libxfce4windowing.h>
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 static PanelApplication *application = NULL;
 
 static gint opt_preferences = -1;
@@ -211,6 +215,41 @@ panel_dbus_name_acquired (GDBusConnection *connection,
 
 
 
+static gchar **
+panel_plugin_events_from_stdin (GError **error)
+{
+  GIOChannel *channel;
+  GPtrArray *events;
+  gchar *line;
+  GIOStatus status;
+
+  /* one PLUGIN-NAME:NAME[:TYPE:VALUE] event per line, empty lines
+   * and lines starting with '#' are ignored */
+  events = g_ptr_array_new ();
+  channel = g_io_channel_unix_new (STDIN_FILENO);
+  while ((status = g_io_channel_read_line (channel, &line, NULL, NULL, error)) == G_IO_STATUS_NORMAL)
+    {
+      g_strstrip (line);
+      if (*line != '\0' && *line != '#')
+        g_ptr_array_add (events, line);
+      else
+        g_free (line);
+    }
+  g_io_channel_unref (channel);
+
+  if (status == G_IO_STATUS_ERROR)
+    {
+      g_ptr_array_free (events, TRUE);
+      return NULL;
+    }
+
+  g_ptr_array_add (events, NULL);
+
+  return (gchar **) g_ptr_array_free (events, FALSE);
+}
+
+
+
 gint
 main (gint argc,
       gchar **argv)
@@ -220,6 +259,8 @@ main (gint argc,
   PanelDBusService *dbus_service;
   gboolean succeed = FALSE;
   gboolean remote_succeed;
+  gboolean *remote_succeeds;
+  gchar **plugin_events;
   guint i;
   const gint signums[] = { SIGINT, SIGQUIT, SIGTERM, SIGABRT, SIGUSR1 };
   const gchar *error_msg;
@@ -318,6 +359,30 @@ main (gint argc,
       succeed = panel_dbus_client_terminate (opt_restart, &error);
       goto dbus_return;
     }
+  else if (g_strcmp0 (opt_plugin_event, "-") == 0)
+    {
+      /* send all the plugin events from stdin in one message */
+      plugin_events = panel_plugin_events_from_stdin (&error);
+      if (plugin_events != NULL)
+        {
+          succeed = panel_dbus_client_plugin_events (plugin_events, &remote_succeeds, &error);
+          if (succeed)
+            {
+              /* same as below, but report which events failed */
+              for (i = 0; plugin_events[i] != NULL; i++)
+                if (!remote_succeeds[i])
+                  {
+                    g_printerr ("%s: %s: %s\n", G_LOG_DOMAIN,
+                                _("No suitable plugin found for event"), plugin_events[i]);
+                    succeed = FALSE;
+                  }
+              g_free (remote_succeeds);
+            }
+          g_strfreev (plugin_events);
+        }
+
+      goto dbus_return;
+    }
   else if (opt_plugin_event != NULL)
     {
       /* send the plugin event to the running instance */
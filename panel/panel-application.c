@@ -28,6 +28,7 @@
 #include "panel-itembar.h"
 #include "panel-module-factory.h"
 #include "panel-plugin-external.h"
+#include "panel-plugin-placeholder.h"
 #include "panel-preferences-dialog.h"
 
 #include "common/panel-debug.h"
@@ -55,6 +56,14 @@
 
 #define MIGRATE_BIN HELPERDIR G_DIR_SEPARATOR_S "migrate"
 
+/* cache file with the last known length of the plugins, used to size the
+ * placeholders of plugins whose construction is deferred */
+#define PLUGIN_LENGTHS_RC "xfce4" G_DIR_SEPARATOR_S "panel" G_DIR_SEPARATOR_S "plugin-lengths.rc"
+#define PLUGIN_LENGTHS_GROUP "Lengths"
+
+/* seconds to wait after startup before constructing deferred plugins in idle time */
+#define DEFERRED_LOAD_DELAY (3)
+
 
 
 static void
@@ -100,6 +109,17 @@ panel_application_drag_leave (GtkWidget *window,
                               GdkDragContext *context,
                               guint drag_time,
                               PanelApplication *application);
+static void
+panel_application_plugin_provider_signal (XfcePanelPluginProvider *provider,
+                                          XfcePanelPluginProviderSignal provider_signal,
+                                          PanelApplication *application);
+static void
+panel_application_plugin_provider_stats (XfcePanelPluginProvider *provider,
+                                         GVariant *stats,
+                                         PanelApplication *application);
+static void
+panel_application_window_revealed (PanelWindow *window,
+                                   PanelApplication *application);
 
 
 
@@ -128,6 +148,14 @@ struct _PanelApplication
   /* autohide count at application level */
   gint autohide_block;
 
+  /* deferred construction of plugins on hidden panels */
+  guint lazy_loading : 1;
+  guint deferred_load_id;
+  GKeyFile *plugin_lengths;
+
+  /* aggregated plugin performance statistics (PANEL_DEBUG=stats) */
+  GHashTable *plugin_stats;
+
 #ifdef ENABLE_X11
   guint wait_for_wm_timeout_id;
 #endif
@@ -139,6 +167,16 @@ struct _PanelApplication
   guint drop_index;
 };
 
+typedef struct
+{
+  XfcePanelPluginProviderStatsType type;
+  gint64 count;
+  gint64 sum;
+  gint64 min;
+  gint64 max;
+  guint64 buckets[PROVIDER_STATS_N_BUCKETS];
+} PanelApplicationStat;
+
 #ifdef ENABLE_X11
 typedef struct
 {
@@ -201,6 +239,9 @@ panel_application_init (PanelApplication *application)
   application->drop_data_ready = FALSE;
   application->drop_occurred = FALSE;
   application->autohide_block = 0;
+  application->deferred_load_id = 0;
+  application->plugin_lengths = NULL;
+  application->plugin_stats = NULL;
 
   /* get the xfconf channel (singleton) */
   application->xfconf = xfconf_channel_get (XFCE_PANEL_CHANNEL_NAME);
@@ -222,6 +263,9 @@ panel_application_init (PanelApplication *application)
   else if (xfconf_channel_get_bool (application->xfconf, "/force-all-external", FALSE))
     panel_module_factory_force_run_mode (PANEL_MODULE_RUN_MODE_EXTERNAL);
 
+  /* check if plugins on hidden panels should only be constructed when needed */
+  application->lazy_loading = xfconf_channel_get_bool (application->xfconf, "/lazy-plugin-loading", TRUE);
+
   /* get a factory reference so it never unloads */
   application->factory = panel_module_factory_get ();
 
@@ -261,9 +305,19 @@ panel_application_finalize (GObject *object)
     g_source_remove (application->wait_for_wm_timeout_id);
 #endif
 
+  if (application->deferred_load_id != 0)
+    g_source_remove (application->deferred_load_id);
+
+  if (application->plugin_lengths != NULL)
+    g_key_file_free (application->plugin_lengths);
+
   /* destroy all panels */
   g_slist_free_full (application->windows, (GDestroyNotify) gtk_widget_destroy);
 
+  /* after the windows, plugins send their last statistics when destroyed */
+  if (application->plugin_stats != NULL)
+    g_hash_table_destroy (application->plugin_stats);
+
   g_object_unref (G_OBJECT (application->factory));
 
   /* this is a good reference if all the objects are released */
@@ -374,6 +428,240 @@ panel_application_remove_plugin_dialog (GtkWindow *parent,
 
 
 
+static GKeyFile *
+panel_application_get_plugin_lengths (PanelApplication *application)
+{
+  gchar *filename;
+
+  if (application->plugin_lengths == NULL)
+    {
+      application->plugin_lengths = g_key_file_new ();
+
+      filename = xfce_resource_lookup (XFCE_RESOURCE_CACHE, PLUGIN_LENGTHS_RC);
+      if (filename != NULL)
+        g_key_file_load_from_file (application->plugin_lengths, filename, G_KEY_FILE_NONE, NULL);
+      g_free (filename);
+    }
+
+  return application->plugin_lengths;
+}
+
+
+
+static gint
+panel_application_get_plugin_length (PanelApplication *application,
+                                     gint unique_id)
+{
+  GKeyFile *key_file = panel_application_get_plugin_lengths (application);
+  gchar key[20];
+  gint length;
+  GError *error = NULL;
+
+  g_snprintf (key, sizeof (key), "plugin-%d", unique_id);
+  length = g_key_file_get_integer (key_file, PLUGIN_LENGTHS_GROUP, key, &error);
+  if (error != NULL)
+    {
+      g_error_free (error);
+      return -1;
+    }
+
+  return length;
+}
+
+
+
+static void
+panel_application_set_plugin_length (PanelApplication *application,
+                                     gint unique_id,
+                                     gint length)
+{
+  gchar key[20];
+
+  g_snprintf (key, sizeof (key), "plugin-%d", unique_id);
+  g_key_file_set_integer (panel_application_get_plugin_lengths (application),
+                          PLUGIN_LENGTHS_GROUP, key, length);
+}
+
+
+
+static void
+panel_application_unset_plugin_length (PanelApplication *application,
+                                       gint unique_id)
+{
+  gchar key[20];
+
+  g_snprintf (key, sizeof (key), "plugin-%d", unique_id);
+  g_key_file_remove_key (panel_application_get_plugin_lengths (application),
+                         PLUGIN_LENGTHS_GROUP, key, NULL);
+}
+
+
+
+static void
+panel_application_prune_plugin_lengths (PanelApplication *application,
+                                        GHashTable *unique_ids)
+{
+  GKeyFile *key_file = panel_application_get_plugin_lengths (application);
+  gchar **keys;
+  guint i;
+  gint unique_id;
+
+  /* drop the lengths of plugins that are not in the configuration anymore */
+  keys = g_key_file_get_keys (key_file, PLUGIN_LENGTHS_GROUP, NULL, NULL);
+  if (keys == NULL)
+    return;
+
+  for (i = 0; keys[i] != NULL; i++)
+    if (sscanf (keys[i], "plugin-%d", &unique_id) != 1
+        || !g_hash_table_contains (unique_ids, GINT_TO_POINTER (unique_id)))
+      g_key_file_remove_key (key_file, PLUGIN_LENGTHS_GROUP, keys[i], NULL);
+
+  g_strfreev (keys);
+}
+
+
+
+static void
+panel_application_save_plugin_lengths (PanelApplication *application)
+{
+  gchar *filename;
+  GError *error = NULL;
+
+  if (application->plugin_lengths == NULL)
+    return;
+
+  filename = xfce_resource_save_location (XFCE_RESOURCE_CACHE, PLUGIN_LENGTHS_RC, TRUE);
+  if (filename != NULL
+      && !g_key_file_save_to_file (application->plugin_lengths, filename, &error))
+    {
+      panel_debug (PANEL_DEBUG_APPLICATION, "failed to save %s: %s", filename, error->message);
+      g_error_free (error);
+    }
+  g_free (filename);
+}
+
+
+
+static void
+panel_application_plugin_construct (PanelApplication *application,
+                                    GtkWidget *placeholder)
+{
+  PanelWindow *window;
+  GtkWidget *itembar;
+  gchar *name;
+  gint unique_id;
+  gint position;
+  gchar buf[50];
+
+  panel_return_if_fail (PANEL_IS_APPLICATION (application));
+  panel_return_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (placeholder));
+
+  window = PANEL_WINDOW (gtk_widget_get_toplevel (placeholder));
+  itembar = gtk_bin_get_child (GTK_BIN (window));
+  position = panel_itembar_get_child_index (PANEL_ITEMBAR (itembar), placeholder);
+
+  /* store the placeholder data (lost after destroy) */
+  name = g_strdup (xfce_panel_plugin_provider_get_name (XFCE_PANEL_PLUGIN_PROVIDER (placeholder)));
+  unique_id = xfce_panel_plugin_provider_get_unique_id (XFCE_PANEL_PLUGIN_PROVIDER (placeholder));
+
+  panel_debug (PANEL_DEBUG_APPLICATION, "constructing deferred plugin %s-%d", name, unique_id);
+
+  /* replace the placeholder by the real plugin */
+  if (panel_application_plugin_insert (application, window, name, unique_id, NULL, position))
+    {
+      gtk_container_remove (GTK_CONTAINER (itembar), placeholder);
+    }
+  /* plugin could not be loaded, ask the user what to do */
+  else if (panel_application_remove_plugin_dialog (GTK_WINDOW (window), name))
+    {
+      gtk_container_remove (GTK_CONTAINER (itembar), placeholder);
+      g_snprintf (buf, sizeof (buf), PLUGINS_PROPERTY_BASE, unique_id);
+      if (xfconf_channel_has_property (application->xfconf, buf))
+        xfconf_channel_reset_property (application->xfconf, buf, TRUE);
+      panel_application_unset_plugin_length (application, unique_id);
+      panel_application_save_window (application, window, SAVE_PLUGIN_IDS);
+    }
+  else
+    {
+      /* the session is already running, so skip the plugin for now; the
+       * hidden placeholder keeps it in the configuration for the next start */
+      panel_debug (PANEL_DEBUG_APPLICATION, "skipping plugin %s-%d", name, unique_id);
+      gtk_widget_hide (placeholder);
+    }
+
+  g_free (name);
+}
+
+
+
+static gboolean
+panel_application_load_deferred_idle (gpointer data)
+{
+  PanelApplication *application = PANEL_APPLICATION (data);
+  GSList *li;
+  GList *children, *lp;
+  GtkWidget *placeholder = NULL;
+
+  /* construct one plugin per idle iteration, so the main loop stays responsive */
+  for (li = application->windows; li != NULL && placeholder == NULL; li = li->next)
+    {
+      children = gtk_container_get_children (GTK_CONTAINER (gtk_bin_get_child (GTK_BIN (li->data))));
+      for (lp = children; lp != NULL; lp = lp->next)
+        if (PANEL_IS_PLUGIN_PLACEHOLDER (lp->data) && gtk_widget_get_visible (lp->data))
+          {
+            placeholder = lp->data;
+            break;
+          }
+      g_list_free (children);
+    }
+
+  if (placeholder == NULL)
+    return FALSE;
+
+  panel_application_plugin_construct (application, placeholder);
+
+  return TRUE;
+}
+
+
+
+static void
+panel_application_load_deferred_idle_destroyed (gpointer data)
+{
+  PANEL_APPLICATION (data)->deferred_load_id = 0;
+}
+
+
+
+static gboolean
+panel_application_load_deferred_timeout (gpointer data)
+{
+  PanelApplication *application = PANEL_APPLICATION (data);
+
+  /* the panels have settled, continue when there is nothing else to do */
+  application->deferred_load_id =
+    g_idle_add_full (G_PRIORITY_LOW, panel_application_load_deferred_idle,
+                     application, panel_application_load_deferred_idle_destroyed);
+
+  return FALSE;
+}
+
+
+
+static void
+panel_application_window_revealed (PanelWindow *window,
+                                   PanelApplication *application)
+{
+  panel_return_if_fail (PANEL_IS_WINDOW (window));
+  panel_return_if_fail (PANEL_IS_APPLICATION (application));
+
+  panel_debug (PANEL_DEBUG_APPLICATION, "panel %d revealed", panel_window_get_id (window));
+
+  panel_application_load_deferred (application, window, NULL);
+}
+
+
+
 static void
 panel_application_load_real (PanelApplication *application)
 {
@@ -392,11 +680,17 @@ panel_application_load_real (PanelApplication *application)
   GPtrArray *panels;
   gint panel_id;
   gboolean save_changed_ids = FALSE;
+  gboolean deferred, have_deferred = FALSE;
+  GtkWidget *placeholder;
+  GtkWidget *itembar;
+  GHashTable *unique_ids;
+  gboolean all_ids = TRUE;
 
   panel_return_if_fail (PANEL_IS_APPLICATION (application));
   panel_return_if_fail (XFCONF_IS_CHANNEL (application->xfconf));
 
   display = gdk_display_get_default ();
+  unique_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
 
   if (xfconf_channel_get_property (application->xfconf, PANELS_PROPERTY_PREFIX, &val)
       && (G_VALUE_HOLDS_UINT (&val)
@@ -446,6 +740,7 @@ panel_application_load_real (PanelApplication *application)
 
           /* create a new window */
           window = panel_application_new_window (application, screen, panel_id, FALSE);
+          itembar = gtk_bin_get_child (GTK_BIN (window));
 
           /* walk all the plugins on the panel */
           g_snprintf (buf, sizeof (buf), PLUGIN_IDS_PROPERTY_BASE, panel_id);
@@ -453,19 +748,42 @@ panel_application_load_real (PanelApplication *application)
           if (array == NULL)
             continue;
 
+          /* only put placeholders on panels that are not on screen, the
+           * plugins are constructed when the panel is revealed or in idle time */
+          deferred = application->lazy_loading && !panel_window_get_revealed (window);
+          if (deferred)
+            {
+              panel_debug (PANEL_DEBUG_APPLICATION, "deferring plugins of hidden panel %d", panel_id);
+              g_signal_connect (G_OBJECT (window), "revealed",
+                                G_CALLBACK (panel_application_window_revealed), application);
+              have_deferred = TRUE;
+            }
+
           for (j = 0; j < array->len; j++)
             {
               /* get the plugin id */
               value = g_ptr_array_index (array, j);
               panel_assert (value != NULL);
               unique_id = g_value_get_int (value);
+              g_hash_table_add (unique_ids, GINT_TO_POINTER (unique_id));
 
               /* get the plugin name */
               g_snprintf (buf, sizeof (buf), PLUGINS_PROPERTY_BASE, unique_id);
               name = xfconf_channel_get_string (application->xfconf, buf, NULL);
 
+              if (deferred && unique_id >= 1 && name != NULL)
+                {
+                  /* reserve the space the plugin used last time */
+                  placeholder = panel_plugin_placeholder_new (name, unique_id,
+                                                              panel_application_get_plugin_length (application, unique_id));
+                  g_signal_connect (G_OBJECT (placeholder), "provider-signal",
+                                    G_CALLBACK (panel_application_plugin_provider_signal), application);
+                  panel_itembar_insert (PANEL_ITEMBAR (itembar), placeholder, -1);
+                  panel_window_set_provider_info (window, placeholder, FALSE);
+                  gtk_widget_show (placeholder);
+                }
               /* append the plugin to the panel */
-              if (unique_id < 1 || name == NULL
+              else if (unique_id < 1 || name == NULL
                   || !panel_application_plugin_insert (application, window,
                                                        name, unique_id, NULL, -1))
                 {
@@ -475,10 +793,12 @@ panel_application_load_real (PanelApplication *application)
                       save_changed_ids = TRUE;
                       if (xfconf_channel_has_property (application->xfconf, buf))
                         xfconf_channel_reset_property (application->xfconf, buf, TRUE);
+                      g_hash_table_remove (unique_ids, GINT_TO_POINTER (unique_id));
                     }
                   else
                     {
                       save_changed_ids = FALSE;
+                      all_ids = FALSE;
                       j = array->len;
                       gtk_main_quit ();
                     }
@@ -492,14 +812,26 @@ panel_application_load_real (PanelApplication *application)
 
       /* free xfconf array or uint */
       g_value_unset (&val);
+
+      if (all_ids)
+        panel_application_prune_plugin_lengths (application, unique_ids);
     }
 
+  g_hash_table_destroy (unique_ids);
+
   /* create empty window if everything else failed */
   if (G_UNLIKELY (application->windows == NULL))
     panel_application_new_window (application, NULL, -1, TRUE);
 
   if (save_changed_ids)
     panel_application_save (application, SAVE_PLUGIN_IDS);
+
+  /* construct the deferred plugins once the visible panels have settled */
+  if (have_deferred)
+    application->deferred_load_id =
+      g_timeout_add_seconds_full (G_PRIORITY_LOW, DEFERRED_LOAD_DELAY,
+                                  panel_application_load_deferred_timeout,
+                                  application, NULL);
 }
 
 
@@ -656,6 +988,9 @@ panel_application_plugin_delete_config (PanelApplication *application,
     xfconf_channel_reset_property (application->xfconf, property, TRUE);
   g_free (property);
 
+  /* forget the length of its placeholder */
+  panel_application_unset_plugin_length (application, unique_id);
+
   /* lookup the rc file */
   filename = g_strdup_printf (PANEL_PLUGIN_RC_RELATIVE_PATH, name, unique_id);
   path = xfce_resource_lookup (XFCE_RESOURCE_CONFIG, filename);
@@ -830,6 +1165,106 @@ panel_application_plugin_provider_signal (XfcePanelPluginProvider *provider,
 
 
 
+static gint64
+panel_application_stat_percentile (const PanelApplicationStat *stat,
+                                   gdouble percentile)
+{
+  guint64 seen = 0;
+  guint i;
+
+  /* upper bound of the bucket the percentile falls in */
+  for (i = 0; i < PROVIDER_STATS_N_BUCKETS; i++)
+    {
+      seen += stat->buckets[i];
+      if (seen >= percentile * stat->count)
+        break;
+    }
+
+  return i == 0 ? 0 : (G_GINT64_CONSTANT (1) << MIN (i, 62)) - 1;
+}
+
+
+
+static void
+panel_application_plugin_provider_stats (XfcePanelPluginProvider *provider,
+                                         GVariant *stats,
+                                         PanelApplication *application)
+{
+  GVariantIter iter;
+  GVariant *buckets;
+  const guint64 *values;
+  const gchar *name;
+  gchar *key;
+  gsize n_values, i;
+  guint type;
+  gint64 count, sum, min, max;
+  PanelApplicationStat *stat;
+
+  panel_return_if_fail (PANEL_IS_APPLICATION (application));
+  panel_return_if_fail (XFCE_IS_PANEL_PLUGIN_PROVIDER (provider));
+  panel_return_if_fail (g_variant_is_of_type (stats, G_VARIANT_TYPE (PROVIDER_STATS_VARIANT_TYPE)));
+
+  if (!panel_debug_has_domain (PANEL_DEBUG_STATS))
+    return;
+
+  if (application->plugin_stats == NULL)
+    application->plugin_stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  g_variant_iter_init (&iter, stats);
+  while (g_variant_iter_next (&iter, "(&suxxxx@at)", &name, &type, &count, &sum, &min, &max, &buckets))
+    {
+      key = g_strdup_printf ("%s-%d/%s", xfce_panel_plugin_provider_get_name (provider),
+                             xfce_panel_plugin_provider_get_unique_id (provider), name);
+
+      stat = g_hash_table_lookup (application->plugin_stats, key);
+      if (stat == NULL)
+        {
+          stat = g_new0 (PanelApplicationStat, 1);
+          stat->type = type;
+          stat->min = min;
+          stat->max = max;
+          g_hash_table_insert (application->plugin_stats, key, stat);
+        }
+      else
+        {
+          g_free (key);
+          stat->min = MIN (stat->min, min);
+          stat->max = MAX (stat->max, max);
+        }
+
+      stat->count += count;
+      stat->sum += sum;
+
+      values = g_variant_get_fixed_array (buckets, &n_values, sizeof (guint64));
+      for (i = 0; i < MIN (n_values, PROVIDER_STATS_N_BUCKETS); i++)
+        stat->buckets[i] += values[i];
+      g_variant_unref (buckets);
+
+      if (stat->type == PROVIDER_STATS_COUNTER)
+        {
+          panel_debug (PANEL_DEBUG_STATS, "%s-%d: %s = %" G_GINT64_FORMAT,
+                       xfce_panel_plugin_provider_get_name (provider),
+                       xfce_panel_plugin_provider_get_unique_id (provider),
+                       name, stat->sum);
+        }
+      else
+        {
+          panel_debug (PANEL_DEBUG_STATS,
+                       "%s-%d: %s count=%" G_GINT64_FORMAT ", mean=%.1f%s, min=%" G_GINT64_FORMAT
+                       ", max=%" G_GINT64_FORMAT ", p50<=%" G_GINT64_FORMAT ", p99<=%" G_GINT64_FORMAT,
+                       xfce_panel_plugin_provider_get_name (provider),
+                       xfce_panel_plugin_provider_get_unique_id (provider),
+                       name, stat->count, (gdouble) stat->sum / MAX (stat->count, 1),
+                       stat->type == PROVIDER_STATS_TIMER ? "us" : "",
+                       stat->min, stat->max,
+                       panel_application_stat_percentile (stat, 0.50),
+                       panel_application_stat_percentile (stat, 0.99));
+        }
+    }
+}
+
+
+
 static gboolean
 panel_application_plugin_insert (PanelApplication *application,
                                  PanelWindow *window,
@@ -860,6 +1295,8 @@ panel_application_plugin_insert (PanelApplication *application,
   /* add signal to monitor provider signals */
   g_signal_connect (G_OBJECT (provider), "provider-signal",
                     G_CALLBACK (panel_application_plugin_provider_signal), application);
+  g_signal_connect (G_OBJECT (provider), "provider-stats",
+                    G_CALLBACK (panel_application_plugin_provider_stats), application);
 
   /* add the item to the panel */
   itembar = gtk_bin_get_child (GTK_BIN (window));
@@ -1343,6 +1780,43 @@ panel_application_save (PanelApplication *application,
         g_warning ("Failed to store the number of panels");
       xfconf_array_free (panels);
     }
+
+  if (PANEL_HAS_FLAG (save_types, SAVE_PLUGIN_PROVIDERS))
+    panel_application_save_plugin_lengths (application);
+}
+
+
+
+void
+panel_application_load_deferred (PanelApplication *application,
+                                 PanelWindow *window,
+                                 const gchar *plugin_name)
+{
+  GSList *li;
+  GList *children, *lp;
+
+  panel_return_if_fail (PANEL_IS_APPLICATION (application));
+  panel_return_if_fail (window == NULL || PANEL_IS_WINDOW (window));
+
+  for (li = application->windows; li != NULL; li = li->next)
+    {
+      if (window != NULL && li->data != window)
+        continue;
+
+      /* the panel does not need to report reveals anymore */
+      if (plugin_name == NULL)
+        g_signal_handlers_disconnect_by_func (G_OBJECT (li->data),
+                                              panel_application_window_revealed, application);
+
+      children = gtk_container_get_children (GTK_CONTAINER (gtk_bin_get_child (GTK_BIN (li->data))));
+      for (lp = children; lp != NULL; lp = lp->next)
+        if (PANEL_IS_PLUGIN_PLACEHOLDER (lp->data)
+            && gtk_widget_get_visible (lp->data)
+            && (plugin_name == NULL
+                || g_strcmp0 (xfce_panel_plugin_provider_get_name (lp->data), plugin_name) == 0))
+          panel_application_plugin_construct (application, lp->data);
+      g_list_free (children);
+    }
 }
 
 
@@ -1361,6 +1835,8 @@ panel_application_save_window (PanelApplication *application,
   GValue *value;
   gint plugin_id;
   gint panel_id;
+  GtkAllocation alloc;
+  XfcePanelPluginMode mode;
 
   panel_return_if_fail (PANEL_IS_APPLICATION (application));
   panel_return_if_fail (PANEL_IS_WINDOW (window));
@@ -1380,6 +1856,7 @@ panel_application_save_window (PanelApplication *application,
   /* get the itembar children */
   itembar = gtk_bin_get_child (GTK_BIN (window));
   children = gtk_container_get_children (GTK_CONTAINER (itembar));
+  g_object_get (G_OBJECT (window), "mode", &mode, NULL);
 
   /* only cleanup and continue if there are no children */
   if (PANEL_HAS_FLAG (save_types, SAVE_PLUGIN_IDS))
@@ -1415,9 +1892,23 @@ panel_application_save_window (PanelApplication *application,
           xfconf_channel_set_string (channel, buf, xfce_panel_plugin_provider_get_name (provider));
         }
 
-      /* ask the plugin to save */
       if (PANEL_HAS_FLAG (save_types, SAVE_PLUGIN_PROVIDERS))
-        xfce_panel_plugin_provider_save (provider);
+        {
+          /* ask the plugin to save */
+          xfce_panel_plugin_provider_save (provider);
+
+          /* remember the plugin length for the placeholder on next startup */
+          if (!PANEL_IS_PLUGIN_PLACEHOLDER (provider)
+              && gtk_widget_get_realized (GTK_WIDGET (provider)))
+            {
+              gtk_widget_get_allocation (GTK_WIDGET (provider), &alloc);
+              panel_application_set_plugin_length (application,
+                                                   xfce_panel_plugin_provider_get_unique_id (provider),
+                                                   mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL
+                                                     ? alloc.width
+                                                     : alloc.height);
+            }
+        }
     }
 
   if (array != NULL)
@@ -53,6 +53,11 @@ panel_application_save_window (PanelApplication *application,
                                PanelWindow *window,
                                PanelSaveTypes save_types);
 
+void
+panel_application_load_deferred (PanelApplication *application,
+                                 PanelWindow *window,
+                                 const gchar *plugin_name);
+
 void
 panel_application_take_dialog (PanelApplication *application,
                                GtkWindow *dialog);
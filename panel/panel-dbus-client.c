@@ -184,23 +184,15 @@ panel_dbus_client_gtype_from_string (const gchar *str)
 
 
 
-gboolean
-panel_dbus_client_plugin_event (const gchar *plugin_event,
-                                gboolean *return_succeed,
-                                GError **error)
+static GVariant *
+panel_dbus_client_plugin_event_parse (const gchar *plugin_event,
+                                      GError **error)
 {
-  XfcePanelExportedService *dbus_proxy;
   gchar **tokens;
   GType type;
   guint n_tokens;
-  gboolean result = FALSE;
   GVariant *variant = NULL;
-
-  panel_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-
-  dbus_proxy = panel_dbus_client_get_proxy (error);
-  if (G_UNLIKELY (dbus_proxy == NULL))
-    return FALSE;
+  GVariant *result = NULL;
 
   tokens = g_strsplit (plugin_event, ":", -1);
   n_tokens = g_strv_length (tokens);
@@ -252,17 +244,116 @@ panel_dbus_client_plugin_event (const gchar *plugin_event,
       goto out;
     }
 
+  /* (plugin-name, name, value) tuple, as sent over dbus */
+  panel_return_val_if_fail (variant != NULL, NULL);
+  result = g_variant_new ("(ss@v)", tokens[PLUGIN_NAME], tokens[NAME],
+                          g_variant_new_variant (variant));
+
+out:
+  g_strfreev (tokens);
+
+  return result;
+}
+
+
+
+gboolean
+panel_dbus_client_plugin_event (const gchar *plugin_event,
+                                gboolean *return_succeed,
+                                GError **error)
+{
+  XfcePanelExportedService *dbus_proxy;
+  GVariant *event;
+  const gchar *plugin_name;
+  const gchar *name;
+  GVariant *value;
+  gboolean result;
+
+  panel_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  event = panel_dbus_client_plugin_event_parse (plugin_event, error);
+  if (G_UNLIKELY (event == NULL))
+    return FALSE;
+
+  dbus_proxy = panel_dbus_client_get_proxy (error);
+  if (G_UNLIKELY (dbus_proxy == NULL))
+    {
+      g_variant_unref (g_variant_ref_sink (event));
+      return FALSE;
+    }
+
   /* send value over dbus */
-  panel_return_val_if_fail (variant != NULL, FALSE);
+  g_variant_ref_sink (event);
+  g_variant_get (event, "(&s&s@v)", &plugin_name, &name, &value);
   result = xfce_panel_exported_service_call_plugin_event_sync (dbus_proxy,
-                                                               tokens[PLUGIN_NAME],
-                                                               tokens[NAME],
-                                                               g_variant_new_variant (variant),
+                                                               plugin_name,
+                                                               name,
+                                                               value,
                                                                return_succeed,
                                                                NULL,
                                                                error);
-out:
-  g_strfreev (tokens);
+  g_variant_unref (value);
+  g_variant_unref (event);
+  g_object_unref (G_OBJECT (dbus_proxy));
+
+  return result;
+}
+
+
+
+gboolean
+panel_dbus_client_plugin_events (gchar **plugin_events,
+                                 gboolean **return_succeed,
+                                 GError **error)
+{
+  XfcePanelExportedService *dbus_proxy;
+  GVariantBuilder builder;
+  GVariant *event;
+  GVariant *succeed = NULL;
+  gboolean result;
+  guint i, n_events;
+
+  panel_return_val_if_fail (plugin_events != NULL, FALSE);
+  panel_return_val_if_fail (return_succeed != NULL, FALSE);
+  panel_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  /* parse all the events first, so nothing is sent on a syntax error */
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssv)"));
+  for (i = 0; plugin_events[i] != NULL; i++)
+    {
+      event = panel_dbus_client_plugin_event_parse (plugin_events[i], error);
+      if (G_UNLIKELY (event == NULL))
+        {
+          g_variant_builder_clear (&builder);
+          return FALSE;
+        }
+
+      g_variant_builder_add_value (&builder, event);
+    }
+  n_events = i;
+
+  dbus_proxy = panel_dbus_client_get_proxy (error);
+  if (G_UNLIKELY (dbus_proxy == NULL))
+    {
+      g_variant_builder_clear (&builder);
+      return FALSE;
+    }
+
+  /* send all the events in one round trip */
+  result = xfce_panel_exported_service_call_plugin_events_sync (dbus_proxy,
+                                                                g_variant_builder_end (&builder),
+                                                                &succeed,
+                                                                NULL,
+                                                                error);
+  if (result)
+    {
+      /* one result per event, missing ones count as failed */
+      *return_succeed = g_new0 (gboolean, MAX (n_events, 1));
+      for (i = 0; i < n_events && i < g_variant_n_children (succeed); i++)
+        g_variant_get_child (succeed, i, "b", &(*return_succeed)[i]);
+      g_variant_unref (succeed);
+    }
+
   g_object_unref (G_OBJECT (dbus_proxy));
 
   return result;
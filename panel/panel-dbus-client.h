@@ -45,6 +45,11 @@ panel_dbus_client_plugin_event (const gchar *plugin_event,
                                 gboolean *return_succeed,
                                 GError **error);
 
+gboolean
+panel_dbus_client_plugin_events (gchar **plugin_events,
+                                 gboolean **return_succeed,
+                                 GError **error);
+
 gboolean
 panel_dbus_client_terminate (gboolean restart,
                              GError **error);
@@ -74,6 +74,11 @@ panel_dbus_service_plugin_event (XfcePanelExportedService *skeleton,
                                  GVariant *variant,
                                  PanelDBusService *service);
 static gboolean
+panel_dbus_service_plugin_events (XfcePanelExportedService *skeleton,
+                                  GDBusMethodInvocation *invocation,
+                                  GVariant *events,
+                                  PanelDBusService *service);
+static gboolean
 panel_dbus_service_terminate (XfcePanelExportedService *skeleton,
                               GDBusMethodInvocation *invocation,
                               gboolean restart,
@@ -145,6 +150,8 @@ panel_dbus_service_init (PanelDBusService *service)
                             G_CALLBACK (panel_dbus_service_display_preferences_dialog), service);
           g_signal_connect (service, "handle_plugin_event",
                             G_CALLBACK (panel_dbus_service_plugin_event), service);
+          g_signal_connect (service, "handle_plugin_events",
+                            G_CALLBACK (panel_dbus_service_plugin_events), service);
           g_signal_connect (service, "handle_save",
                             G_CALLBACK (panel_dbus_service_save), service);
           g_signal_connect (service, "handle_terminate",
@@ -271,28 +278,26 @@ panel_dbus_service_add_new_item (XfcePanelExportedService *skeleton,
 
 
 static gboolean
-panel_dbus_service_plugin_event (XfcePanelExportedService *skeleton,
-                                 GDBusMethodInvocation *invocation,
-                                 const gchar *plugin_name,
-                                 const gchar *name,
-                                 GVariant *variant,
-                                 PanelDBusService *service)
+panel_dbus_service_plugin_event_send (PanelDBusService *service,
+                                     PanelModuleFactory *factory,
+                                     const gchar *plugin_name,
+                                     const gchar *name,
+                                     GVariant *variant)
 {
   GSList *plugins, *li, *lnext;
-  PanelModuleFactory *factory;
+  PanelApplication *application;
   PluginEvent *event;
   guint handle;
   gboolean result;
   GValue value = G_VALUE_INIT;
   gboolean plugin_replied = FALSE;
 
-  panel_return_val_if_fail (PANEL_IS_DBUS_SERVICE (service), FALSE);
-  panel_return_val_if_fail (plugin_name != NULL, FALSE);
-  panel_return_val_if_fail (name != NULL, FALSE);
-
   /* send the event to all matching plugins, break if one of the
    * plugins returns TRUE in this remote-event handler */
-  factory = panel_module_factory_get ();
+  application = panel_application_get ();
+  panel_application_load_deferred (application, NULL, plugin_name);
+  g_object_unref (G_OBJECT (application));
+
   plugins = panel_module_factory_get_plugins (factory, plugin_name);
   variant = g_variant_get_variant (variant);
 
@@ -342,6 +347,31 @@ panel_dbus_service_plugin_event (XfcePanelExportedService *skeleton,
     }
 
   g_slist_free (plugins);
+  g_value_unset (&value);
+  g_variant_unref (variant);
+
+  return plugin_replied;
+}
+
+
+
+static gboolean
+panel_dbus_service_plugin_event (XfcePanelExportedService *skeleton,
+                                 GDBusMethodInvocation *invocation,
+                                 const gchar *plugin_name,
+                                 const gchar *name,
+                                 GVariant *variant,
+                                 PanelDBusService *service)
+{
+  PanelModuleFactory *factory;
+  gboolean plugin_replied;
+
+  panel_return_val_if_fail (PANEL_IS_DBUS_SERVICE (service), FALSE);
+  panel_return_val_if_fail (plugin_name != NULL, FALSE);
+  panel_return_val_if_fail (name != NULL, FALSE);
+
+  factory = panel_module_factory_get ();
+  plugin_replied = panel_dbus_service_plugin_event_send (service, factory, plugin_name, name, variant);
   g_object_unref (G_OBJECT (factory));
 
   xfce_panel_exported_service_complete_plugin_event (skeleton, invocation, plugin_replied);
@@ -351,6 +381,46 @@ panel_dbus_service_plugin_event (XfcePanelExportedService *skeleton,
 
 
 
+static gboolean
+panel_dbus_service_plugin_events (XfcePanelExportedService *skeleton,
+                                  GDBusMethodInvocation *invocation,
+                                  GVariant *events,
+                                  PanelDBusService *service)
+{
+  PanelModuleFactory *factory;
+  GVariantBuilder builder;
+  GVariantIter iter;
+  const gchar *plugin_name;
+  const gchar *name;
+  GVariant *variant;
+
+  panel_return_val_if_fail (PANEL_IS_DBUS_SERVICE (service), FALSE);
+  panel_return_val_if_fail (events != NULL, FALSE);
+
+  /* handle the events in order, each like a separate PluginEvent call,
+   * and return all the results in one reply */
+  factory = panel_module_factory_get ();
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("ab"));
+
+  g_variant_iter_init (&iter, events);
+  while (g_variant_iter_next (&iter, "(&s&s@v)", &plugin_name, &name, &variant))
+    {
+      g_variant_builder_add (&builder, "b",
+                             panel_dbus_service_plugin_event_send (service, factory,
+                                                                   plugin_name, name, variant));
+      g_variant_unref (variant);
+    }
+
+  g_object_unref (G_OBJECT (factory));
+
+  xfce_panel_exported_service_complete_plugin_events (skeleton, invocation,
+                                                      g_variant_builder_end (&builder));
+
+  return TRUE;
+}
+
+
+
 static gboolean
 panel_dbus_service_terminate (XfcePanelExportedService *skeleton,
                               GDBusMethodInvocation *invocation,
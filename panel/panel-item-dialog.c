@@ -817,6 +817,11 @@ panel_item_dialog_show (PanelWindow *window)
   if (panel_dialogs_kiosk_warning ())
     return;
 
+  /* the unique plugin checks need all plugins to be constructed */
+  application = panel_application_get ();
+  panel_application_load_deferred (application, NULL, NULL);
+  g_object_unref (G_OBJECT (application));
+
   if (G_LIKELY (dialog_singleton == NULL))
     {
       /* create new dialog singleton */
@@ -88,6 +88,11 @@ panel_plugin_external_wrapper_dbus_remote_event_result (XfcePanelPluginWrapperEx
                                                         guint handle,
                                                         gboolean result,
                                                         PanelPluginExternalWrapper *wrapper);
+static gboolean
+panel_plugin_external_wrapper_dbus_provider_stats (XfcePanelPluginWrapperExported *skeleton,
+                                                   GDBusMethodInvocation *invocation,
+                                                   GVariant *stats,
+                                                   PanelPluginExternalWrapper *wrapper);
 
 
 
@@ -217,6 +222,8 @@ panel_plugin_external_wrapper_constructed (GObject *object)
                             G_CALLBACK (panel_plugin_external_wrapper_dbus_provider_signal), object);
           g_signal_connect (priv->skeleton, "handle_remote_event_result",
                             G_CALLBACK (panel_plugin_external_wrapper_dbus_remote_event_result), object);
+          g_signal_connect (priv->skeleton, "handle_provider_stats",
+                            G_CALLBACK (panel_plugin_external_wrapper_dbus_provider_stats), object);
 
           panel_debug (PANEL_DEBUG_EXTERNAL, "Exported object at path %s", path);
         }
@@ -497,6 +504,25 @@ panel_plugin_external_wrapper_dbus_remote_event_result (XfcePanelPluginWrapperEx
 
 
 
+static gboolean
+panel_plugin_external_wrapper_dbus_provider_stats (XfcePanelPluginWrapperExported *skeleton,
+                                                   GDBusMethodInvocation *invocation,
+                                                   GVariant *stats,
+                                                   PanelPluginExternalWrapper *wrapper)
+{
+  panel_return_val_if_fail (PANEL_IS_PLUGIN_EXTERNAL (wrapper), FALSE);
+  panel_return_val_if_fail (XFCE_IS_PANEL_PLUGIN_PROVIDER (wrapper), FALSE);
+
+  /* aggregated in panel-application.c, like for internal plugins */
+  xfce_panel_plugin_provider_emit_stats (XFCE_PANEL_PLUGIN_PROVIDER (wrapper), stats);
+
+  xfce_panel_plugin_wrapper_exported_complete_provider_stats (skeleton, invocation);
+
+  return G_DBUS_METHOD_INVOCATION_HANDLED;
+}
+
+
+
 GtkWidget *
 panel_plugin_external_wrapper_new (PanelModule *module,
                                    gint unique_id,
@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * A placeholder is put in the itembar instead of a real plugin when the
+ * construction of the plugin is deferred (see panel_application_load_real()).
+ * It only reserves the space the plugin used last time and answers the
+ * provider calls the panel makes, until it is replaced by the plugin.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "panel-plugin-placeholder.h"
+
+#include "common/panel-private.h"
+#include "libxfce4panel/libxfce4panel.h"
+#include "libxfce4panel/xfce-panel-plugin-provider.h"
+
+
+
+static void
+panel_plugin_placeholder_provider_init (XfcePanelPluginProviderInterface *iface);
+static void
+panel_plugin_placeholder_finalize (GObject *object);
+static void
+panel_plugin_placeholder_get_preferred_width (GtkWidget *widget,
+                                              gint *minimum_width,
+                                              gint *natural_width);
+static void
+panel_plugin_placeholder_get_preferred_height (GtkWidget *widget,
+                                               gint *minimum_height,
+                                               gint *natural_height);
+static const gchar *
+panel_plugin_placeholder_get_name (XfcePanelPluginProvider *provider);
+static gint
+panel_plugin_placeholder_get_unique_id (XfcePanelPluginProvider *provider);
+static void
+panel_plugin_placeholder_set_size (XfcePanelPluginProvider *provider,
+                                   gint size);
+static void
+panel_plugin_placeholder_set_icon_size (XfcePanelPluginProvider *provider,
+                                        gint icon_size);
+static void
+panel_plugin_placeholder_set_dark_mode (XfcePanelPluginProvider *provider,
+                                        gboolean dark_mode);
+static void
+panel_plugin_placeholder_set_mode (XfcePanelPluginProvider *provider,
+                                   XfcePanelPluginMode mode);
+static void
+panel_plugin_placeholder_set_nrows (XfcePanelPluginProvider *provider,
+                                    guint rows);
+static void
+panel_plugin_placeholder_set_screen_position (XfcePanelPluginProvider *provider,
+                                              XfceScreenPosition screen_position);
+static void
+panel_plugin_placeholder_save (XfcePanelPluginProvider *provider);
+static gboolean
+panel_plugin_placeholder_get_show_configure (XfcePanelPluginProvider *provider);
+static void
+panel_plugin_placeholder_show_configure (XfcePanelPluginProvider *provider);
+static gboolean
+panel_plugin_placeholder_get_show_about (XfcePanelPluginProvider *provider);
+static void
+panel_plugin_placeholder_show_about (XfcePanelPluginProvider *provider);
+static void
+panel_plugin_placeholder_removed (XfcePanelPluginProvider *provider);
+static gboolean
+panel_plugin_placeholder_remote_event (XfcePanelPluginProvider *provider,
+                                       const gchar *name,
+                                       const GValue *value,
+                                       guint *handle);
+static void
+panel_plugin_placeholder_set_locked (XfcePanelPluginProvider *provider,
+                                     gboolean locked);
+static void
+panel_plugin_placeholder_ask_remove (XfcePanelPluginProvider *provider);
+
+
+
+struct _PanelPluginPlaceholder
+{
+  GtkWidget __parent__;
+
+  gchar *name;
+  gint unique_id;
+
+  /* remembered length of the plugin along the panel, -1 if unknown */
+  gint length;
+
+  /* last values received from the panel */
+  gint size;
+  XfcePanelPluginMode mode;
+};
+
+
+
+G_DEFINE_FINAL_TYPE_WITH_CODE (PanelPluginPlaceholder, panel_plugin_placeholder, GTK_TYPE_WIDGET,
+                               G_IMPLEMENT_INTERFACE (XFCE_TYPE_PANEL_PLUGIN_PROVIDER,
+                                                      panel_plugin_placeholder_provider_init))
+
+
+
+static void
+panel_plugin_placeholder_class_init (PanelPluginPlaceholderClass *klass)
+{
+  GObjectClass *gobject_class;
+  GtkWidgetClass *gtkwidget_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = panel_plugin_placeholder_finalize;
+
+  gtkwidget_class = GTK_WIDGET_CLASS (klass);
+  gtkwidget_class->get_preferred_width = panel_plugin_placeholder_get_preferred_width;
+  gtkwidget_class->get_preferred_height = panel_plugin_placeholder_get_preferred_height;
+}
+
+
+
+static void
+panel_plugin_placeholder_init (PanelPluginPlaceholder *placeholder)
+{
+  placeholder->name = NULL;
+  placeholder->unique_id = -1;
+  placeholder->length = -1;
+  placeholder->size = 0;
+  placeholder->mode = XFCE_PANEL_PLUGIN_MODE_HORIZONTAL;
+
+  gtk_widget_set_has_window (GTK_WIDGET (placeholder), FALSE);
+}
+
+
+
+static void
+panel_plugin_placeholder_provider_init (XfcePanelPluginProviderInterface *iface)
+{
+  iface->get_name = panel_plugin_placeholder_get_name;
+  iface->get_unique_id = panel_plugin_placeholder_get_unique_id;
+  iface->set_size = panel_plugin_placeholder_set_size;
+  iface->set_icon_size = panel_plugin_placeholder_set_icon_size;
+  iface->set_dark_mode = panel_plugin_placeholder_set_dark_mode;
+  iface->set_mode = panel_plugin_placeholder_set_mode;
+  iface->set_nrows = panel_plugin_placeholder_set_nrows;
+  iface->set_screen_position = panel_plugin_placeholder_set_screen_position;
+  iface->save = panel_plugin_placeholder_save;
+  iface->get_show_configure = panel_plugin_placeholder_get_show_configure;
+  iface->show_configure = panel_plugin_placeholder_show_configure;
+  iface->get_show_about = panel_plugin_placeholder_get_show_about;
+  iface->show_about = panel_plugin_placeholder_show_about;
+  iface->removed = panel_plugin_placeholder_removed;
+  iface->remote_event = panel_plugin_placeholder_remote_event;
+  iface->set_locked = panel_plugin_placeholder_set_locked;
+  iface->ask_remove = panel_plugin_placeholder_ask_remove;
+}
+
+
+
+static void
+panel_plugin_placeholder_finalize (GObject *object)
+{
+  PanelPluginPlaceholder *placeholder = PANEL_PLUGIN_PLACEHOLDER (object);
+
+  g_free (placeholder->name);
+
+  (*G_OBJECT_CLASS (panel_plugin_placeholder_parent_class)->finalize) (object);
+}
+
+
+
+static void
+panel_plugin_placeholder_get_preferred_length (PanelPluginPlaceholder *placeholder,
+                                               gboolean horizontal,
+                                               gint *minimum,
+                                               gint *natural)
+{
+  gint length;
+
+  /* the size of the panel across, the remembered length along the panel;
+   * a square is the best guess for a plugin we know nothing about */
+  if (horizontal == (placeholder->mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL)
+      && placeholder->length > 0)
+    length = placeholder->length;
+  else
+    length = placeholder->size;
+
+  if (minimum != NULL)
+    *minimum = length;
+  if (natural != NULL)
+    *natural = length;
+}
+
+
+
+static void
+panel_plugin_placeholder_get_preferred_width (GtkWidget *widget,
+                                              gint *minimum_width,
+                                              gint *natural_width)
+{
+  panel_plugin_placeholder_get_preferred_length (PANEL_PLUGIN_PLACEHOLDER (widget), TRUE,
+                                                 minimum_width, natural_width);
+}
+
+
+
+static void
+panel_plugin_placeholder_get_preferred_height (GtkWidget *widget,
+                                               gint *minimum_height,
+                                               gint *natural_height)
+{
+  panel_plugin_placeholder_get_preferred_length (PANEL_PLUGIN_PLACEHOLDER (widget), FALSE,
+                                                 minimum_height, natural_height);
+}
+
+
+
+static const gchar *
+panel_plugin_placeholder_get_name (XfcePanelPluginProvider *provider)
+{
+  panel_return_val_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (provider), NULL);
+
+  return PANEL_PLUGIN_PLACEHOLDER (provider)->name;
+}
+
+
+
+static gint
+panel_plugin_placeholder_get_unique_id (XfcePanelPluginProvider *provider)
+{
+  panel_return_val_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (provider), -1);
+
+  return PANEL_PLUGIN_PLACEHOLDER (provider)->unique_id;
+}
+
+
+
+static void
+panel_plugin_placeholder_set_size (XfcePanelPluginProvider *provider,
+                                   gint size)
+{
+  PanelPluginPlaceholder *placeholder = PANEL_PLUGIN_PLACEHOLDER (provider);
+
+  panel_return_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (provider));
+
+  if (placeholder->size != size)
+    {
+      placeholder->size = size;
+      gtk_widget_queue_resize (GTK_WIDGET (placeholder));
+    }
+}
+
+
+
+static void
+panel_plugin_placeholder_set_icon_size (XfcePanelPluginProvider *provider,
+                                        gint icon_size)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_set_dark_mode (XfcePanelPluginProvider *provider,
+                                        gboolean dark_mode)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_set_mode (XfcePanelPluginProvider *provider,
+                                   XfcePanelPluginMode mode)
+{
+  PanelPluginPlaceholder *placeholder = PANEL_PLUGIN_PLACEHOLDER (provider);
+
+  panel_return_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (provider));
+
+  if (placeholder->mode != mode)
+    {
+      placeholder->mode = mode;
+      gtk_widget_queue_resize (GTK_WIDGET (placeholder));
+    }
+}
+
+
+
+static void
+panel_plugin_placeholder_set_nrows (XfcePanelPluginProvider *provider,
+                                    guint rows)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_set_screen_position (XfcePanelPluginProvider *provider,
+                                              XfceScreenPosition screen_position)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_save (XfcePanelPluginProvider *provider)
+{
+  /* the plugin never ran, so its configuration is unchanged */
+}
+
+
+
+static gboolean
+panel_plugin_placeholder_get_show_configure (XfcePanelPluginProvider *provider)
+{
+  return FALSE;
+}
+
+
+
+static void
+panel_plugin_placeholder_show_configure (XfcePanelPluginProvider *provider)
+{
+  /* nothing to do */
+}
+
+
+
+static gboolean
+panel_plugin_placeholder_get_show_about (XfcePanelPluginProvider *provider)
+{
+  return FALSE;
+}
+
+
+
+static void
+panel_plugin_placeholder_show_about (XfcePanelPluginProvider *provider)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_removed (XfcePanelPluginProvider *provider)
+{
+  /* nothing to do */
+}
+
+
+
+static gboolean
+panel_plugin_placeholder_remote_event (XfcePanelPluginProvider *provider,
+                                       const gchar *name,
+                                       const GValue *value,
+                                       guint *handle)
+{
+  /* the application constructs the plugin before delivering events */
+  return FALSE;
+}
+
+
+
+static void
+panel_plugin_placeholder_set_locked (XfcePanelPluginProvider *provider,
+                                     gboolean locked)
+{
+  /* nothing to do */
+}
+
+
+
+static void
+panel_plugin_placeholder_ask_remove (XfcePanelPluginProvider *provider)
+{
+  panel_return_if_fail (PANEL_IS_PLUGIN_PLACEHOLDER (provider));
+
+  /* there is no plugin to ask, remove right away */
+  xfce_panel_plugin_provider_emit_signal (provider, PROVIDER_SIGNAL_REMOVE_PLUGIN);
+}
+
+
+
+GtkWidget *
+panel_plugin_placeholder_new (const gchar *name,
+                              gint unique_id,
+                              gint length)
+{
+  PanelPluginPlaceholder *placeholder;
+
+  panel_return_val_if_fail (name != NULL, NULL);
+  panel_return_val_if_fail (unique_id > 0, NULL);
+
+  placeholder = g_object_new (PANEL_TYPE_PLUGIN_PLACEHOLDER, NULL);
+  placeholder->name = g_strdup (name);
+  placeholder->unique_id = unique_id;
+  placeholder->length = length;
+
+  return GTK_WIDGET (placeholder);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __PANEL_PLUGIN_PLACEHOLDER_H__
+#define __PANEL_PLUGIN_PLACEHOLDER_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define PANEL_TYPE_PLUGIN_PLACEHOLDER (panel_plugin_placeholder_get_type ())
+G_DECLARE_FINAL_TYPE (PanelPluginPlaceholder, panel_plugin_placeholder, PANEL, PLUGIN_PLACEHOLDER, GtkWidget)
+
+GtkWidget *
+panel_plugin_placeholder_new (const gchar *name,
+                              gint unique_id,
+                              gint length) G_GNUC_MALLOC;
+
+G_END_DECLS
+
+#endif /* !__PANEL_PLUGIN_PLACEHOLDER_H__ */
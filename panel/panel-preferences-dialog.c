@@ -1836,6 +1836,9 @@ panel_preferences_dialog_show_internal (PanelWindow *active,
       g_object_add_weak_pointer (G_OBJECT (dialog_singleton), (gpointer) &dialog_singleton);
     }
 
+  /* the items of all panels can be edited, so construct the deferred plugins */
+  panel_application_load_deferred (dialog_singleton->application, NULL, NULL);
+
   if (active == NULL)
     {
       /* select first window */
@@ -265,6 +265,12 @@ enum
   PROP_DARK_MODE
 };
 
+enum
+{
+  REVEALED,
+  LAST_SIGNAL
+};
+
 enum _PluginProp
 {
   PLUGIN_PROP_MODE,
@@ -385,6 +391,7 @@ struct _PanelWindow
   gboolean floating;
   guint span_monitors : 1;
   gchar *output_name;
+  guint output_missing : 1;
 
   /* allocated position of the panel */
   GdkRectangle alloc;
@@ -435,6 +442,8 @@ typedef PanelWindowClass XfcePanelWindowClass;
 
 
 
+static guint window_signals[LAST_SIGNAL];
+
 static GdkAtom cardinal_atom = 0;
 static GdkAtom net_wm_strut_partial_atom = 0;
 
@@ -475,6 +484,13 @@ panel_window_class_init (PanelWindowClass *klass)
   gtkwidget_class->style_updated = panel_window_style_updated;
   gtkwidget_class->realize = panel_window_realize;
 
+  window_signals[REVEALED] = g_signal_new (g_intern_static_string ("revealed"),
+                                           G_TYPE_FROM_CLASS (gobject_class),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL,
+                                           g_cclosure_marshal_VOID__VOID,
+                                           G_TYPE_NONE, 0);
+
   g_object_class_install_property (gobject_class,
                                    PROP_ID,
                                    g_param_spec_int ("id", NULL, NULL,
@@ -680,6 +696,7 @@ panel_window_init (PanelWindow *window)
   window->snap_position = SNAP_POSITION_NONE;
   window->floating = TRUE;
   window->span_monitors = FALSE;
+  window->output_missing = FALSE;
   window->position_locked = FALSE;
   window->autohide_behavior = AUTOHIDE_BEHAVIOR_NEVER;
   window->autohide_state = AUTOHIDE_VISIBLE;
@@ -2727,6 +2744,7 @@ panel_window_screen_layout_changed (GdkScreen *screen,
               /* hide the panel if the monitor was not found */
               if (gtk_widget_get_visible (GTK_WIDGET (window)))
                 gtk_widget_hide (GTK_WIDGET (window));
+              window->output_missing = TRUE;
               return;
             }
         }
@@ -2763,6 +2781,13 @@ panel_window_screen_layout_changed (GdkScreen *screen,
 
   if (!gtk_widget_get_visible (GTK_WIDGET (window)))
     gtk_widget_show (GTK_WIDGET (window));
+
+  /* the monitor of the panel (re)appeared */
+  if (window->output_missing)
+    {
+      window->output_missing = FALSE;
+      g_signal_emit (G_OBJECT (window), window_signals[REVEALED], 0);
+    }
 }
 
 
@@ -2786,6 +2811,25 @@ panel_window_active_window_changed (XfwScreen *screen,
 
 
 
+gboolean
+panel_window_get_revealed (PanelWindow *window)
+{
+  panel_return_val_if_fail (PANEL_IS_WINDOW (window), FALSE);
+
+  if (window->output_missing)
+    return FALSE;
+
+  /* a panel that always autohides is only revealed while visible, even when
+   * it is still shown because the initial popdown timeout is running */
+  if (window->autohide_behavior == AUTOHIDE_BEHAVIOR_ALWAYS)
+    return window->autohide_state == AUTOHIDE_VISIBLE;
+
+  return window->autohide_state != AUTOHIDE_HIDDEN
+         && window->autohide_state != AUTOHIDE_POPUP;
+}
+
+
+
 gboolean
 panel_window_pointer_is_outside (PanelWindow *window)
 {
@@ -3138,7 +3182,10 @@ panel_window_autohide_timeout (gpointer user_data)
       || window->autohide_state == AUTOHIDE_POPDOWN_SLOW)
     window->autohide_state = AUTOHIDE_HIDDEN;
   else if (window->autohide_state == AUTOHIDE_POPUP)
-    window->autohide_state = AUTOHIDE_VISIBLE;
+    {
+      window->autohide_state = AUTOHIDE_VISIBLE;
+      g_signal_emit (G_OBJECT (window), window_signals[REVEALED], 0);
+    }
 
   /* needs a recheck when timeout is over on Wayland, see panel_window_pointer_is_outside() */
   if (gtk_layer_is_supported () && window->autohide_state == AUTOHIDE_HIDDEN
@@ -3310,6 +3357,8 @@ panel_window_autohide_queue (PanelWindow *window,
         }
       else
         gtk_widget_queue_resize (GTK_WIDGET (window));
+
+      g_signal_emit (G_OBJECT (window), window_signals[REVEALED], 0);
     }
   else
     {
@@ -85,6 +85,9 @@ panel_window_migrate_old_properties (PanelWindow *window,
 gboolean
 panel_window_pointer_is_outside (PanelWindow *window);
 
+gboolean
+panel_window_get_revealed (PanelWindow *window);
+
 G_END_DECLS
 
 #endif /* !__PANEL_WINDOW_H__ */
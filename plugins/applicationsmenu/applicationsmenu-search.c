@@ -0,0 +1,856 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "applicationsmenu-search.h"
+
+#include "common/panel-debug.h"
+#include "common/panel-private.h"
+
+#include <libxfce4ui/libxfce4ui.h>
+#include <libxfce4util/libxfce4util.h>
+#include <string.h>
+
+
+
+/* maximum number of applications shown for a query */
+#define MAX_RESULTS (12)
+
+/* separator between the fields of the haystack, never part of a trigram */
+#define FIELD_SEPARATOR '\n'
+
+
+
+typedef struct _SearchEntry SearchEntry;
+
+static void
+applications_menu_search_restore (ApplicationsMenuSearch *search);
+
+
+
+struct _ApplicationsMenuSearch
+{
+  GarconGtkMenu *menu;
+
+  /* menu the index was built from, watched for reloads */
+  GarconMenu *garcon_menu;
+  gulong reload_id;
+
+  guint enabled : 1;
+  guint index_valid : 1;
+
+  /* item -> entry, entries are reused when the index is rebuilt */
+  GHashTable *entries;
+  guint generation;
+
+  /* visible entries in menu order and the trigram -> positions table */
+  GPtrArray *index;
+  GHashTable *trigrams;
+
+  /* typed query and the widgets shown for it */
+  GString *query;
+  GtkWidget *header;
+  GSList *results;
+  GSList *hidden;
+
+  /* restore after the activated result handled its signal */
+  guint restore_id;
+};
+
+struct _SearchEntry
+{
+  GarconMenuItem *item;
+  gulong changed_id;
+
+  /* casefolded name and all searched fields, separated by newlines */
+  gchar *name;
+  gchar *haystack;
+  gchar *collate_key;
+
+  /* last rebuild that found the entry in the menu */
+  guint generation;
+
+  /* desktop file changed since the strings were extracted */
+  guint stale : 1;
+};
+
+typedef struct
+{
+  SearchEntry *entry;
+  guint score;
+} SearchResult;
+
+
+
+static void
+applications_menu_search_entry_changed (GarconMenuItem *item,
+                                        SearchEntry *entry)
+{
+  entry->stale = TRUE;
+}
+
+
+
+static void
+applications_menu_search_entry_update (SearchEntry *entry)
+{
+  GString *haystack;
+  const gchar *str;
+  GList *li;
+
+  g_free (entry->name);
+  g_free (entry->haystack);
+  g_free (entry->collate_key);
+
+  str = garcon_menu_item_get_name (entry->item);
+  entry->name = g_utf8_casefold (str != NULL ? str : "", -1);
+  entry->collate_key = g_utf8_collate_key (str != NULL ? str : "", -1);
+
+  haystack = g_string_new (entry->name);
+
+  str = garcon_menu_item_get_generic_name (entry->item);
+  if (!xfce_str_is_empty (str))
+    {
+      g_string_append_c (haystack, FIELD_SEPARATOR);
+      g_string_append (haystack, str);
+    }
+
+  for (li = garcon_menu_item_get_keywords (entry->item); li != NULL; li = li->next)
+    {
+      g_string_append_c (haystack, FIELD_SEPARATOR);
+      g_string_append (haystack, li->data);
+    }
+
+  str = garcon_menu_item_get_command (entry->item);
+  if (!xfce_str_is_empty (str))
+    {
+      g_string_append_c (haystack, FIELD_SEPARATOR);
+      g_string_append (haystack, str);
+    }
+
+  entry->haystack = g_utf8_casefold (haystack->str, haystack->len);
+  g_string_free (haystack, TRUE);
+
+  entry->stale = FALSE;
+}
+
+
+
+static void
+applications_menu_search_entry_free (gpointer data)
+{
+  SearchEntry *entry = data;
+
+  g_signal_handler_disconnect (G_OBJECT (entry->item), entry->changed_id);
+  g_object_unref (G_OBJECT (entry->item));
+  g_free (entry->name);
+  g_free (entry->haystack);
+  g_free (entry->collate_key);
+  g_slice_free (SearchEntry, entry);
+}
+
+
+
+static void
+applications_menu_search_collect (ApplicationsMenuSearch *search,
+                                  GarconMenu *menu,
+                                  GHashTable *desktop_ids,
+                                  guint *n_reused)
+{
+  GList *items, *menus, *li;
+  GarconMenuItem *item;
+  SearchEntry *entry;
+  const gchar *desktop_id;
+
+  items = garcon_menu_get_items (menu);
+  for (li = items; li != NULL; li = li->next)
+    {
+      item = GARCON_MENU_ITEM (li->data);
+
+      if (!garcon_menu_element_get_visible (GARCON_MENU_ELEMENT (item)))
+        continue;
+
+      /* applications listed in multiple categories are found once */
+      desktop_id = garcon_menu_item_get_desktop_id (item);
+      if (desktop_id != NULL)
+        {
+          if (g_hash_table_contains (desktop_ids, desktop_id))
+            continue;
+          g_hash_table_add (desktop_ids, (gpointer) desktop_id);
+        }
+
+      entry = g_hash_table_lookup (search->entries, item);
+      if (entry == NULL)
+        {
+          entry = g_slice_new0 (SearchEntry);
+          entry->item = GARCON_MENU_ITEM (g_object_ref (G_OBJECT (item)));
+          entry->changed_id = g_signal_connect (G_OBJECT (item), "changed",
+                                                G_CALLBACK (applications_menu_search_entry_changed), entry);
+          entry->stale = TRUE;
+          g_hash_table_insert (search->entries, item, entry);
+        }
+      else if (!entry->stale)
+        {
+          *n_reused += 1;
+        }
+
+      if (entry->stale)
+        applications_menu_search_entry_update (entry);
+
+      entry->generation = search->generation;
+      g_ptr_array_add (search->index, entry);
+    }
+  g_list_free (items);
+
+  menus = garcon_menu_get_menus (menu);
+  for (li = menus; li != NULL; li = li->next)
+    if (garcon_menu_element_get_visible (GARCON_MENU_ELEMENT (li->data)))
+      applications_menu_search_collect (search, li->data, desktop_ids, n_reused);
+  g_list_free (menus);
+}
+
+
+
+static gboolean
+applications_menu_search_entry_unused (gpointer key,
+                                       gpointer value,
+                                       gpointer user_data)
+{
+  return ((SearchEntry *) value)->generation != GPOINTER_TO_UINT (user_data);
+}
+
+
+
+static const gchar *
+applications_menu_search_trigram_end (const gchar *p)
+{
+  guint n;
+
+  /* end of the three characters starting at p, or NULL */
+  for (n = 0; n < 3; n++)
+    {
+      if (*p == '\0' || *p == FIELD_SEPARATOR)
+        return NULL;
+      p = g_utf8_next_char (p);
+    }
+
+  return p;
+}
+
+
+
+static void
+applications_menu_search_reload_required (GarconMenu *menu,
+                                          ApplicationsMenuSearch *search)
+{
+  /* garcon-gtk rebuilds the menu widgets, so drop the results as well */
+  applications_menu_search_restore (search);
+  search->index_valid = FALSE;
+}
+
+
+
+static void
+applications_menu_search_rebuild (ApplicationsMenuSearch *search)
+{
+  GarconMenu *menu;
+  GHashTable *desktop_ids;
+  SearchEntry *entry;
+  GArray *positions;
+  const gchar *p, *end;
+  gchar *trigram;
+  guint i, n_reused = 0;
+  gint64 start = g_get_monotonic_time ();
+
+  g_ptr_array_set_size (search->index, 0);
+  g_hash_table_remove_all (search->trigrams);
+  search->generation++;
+
+  menu = garcon_gtk_menu_get_menu (search->menu);
+  if (menu != NULL)
+    {
+      if (search->garcon_menu != menu)
+        {
+          if (search->garcon_menu != NULL)
+            {
+              g_signal_handler_disconnect (G_OBJECT (search->garcon_menu), search->reload_id);
+              g_object_unref (G_OBJECT (search->garcon_menu));
+            }
+
+          search->garcon_menu = GARCON_MENU (g_object_ref (G_OBJECT (menu)));
+          search->reload_id = g_signal_connect (G_OBJECT (menu), "reload-required",
+                                                G_CALLBACK (applications_menu_search_reload_required), search);
+        }
+
+      desktop_ids = g_hash_table_new (g_str_hash, g_str_equal);
+      applications_menu_search_collect (search, menu, desktop_ids, &n_reused);
+      g_hash_table_destroy (desktop_ids);
+      g_object_unref (G_OBJECT (menu));
+    }
+
+  /* forget the applications that are no longer in the menu */
+  g_hash_table_foreach_remove (search->entries, applications_menu_search_entry_unused,
+                               GUINT_TO_POINTER (search->generation));
+
+  for (i = 0; i < search->index->len; i++)
+    {
+      entry = g_ptr_array_index (search->index, i);
+      for (p = entry->haystack; *p != '\0'; p = g_utf8_next_char (p))
+        {
+          end = applications_menu_search_trigram_end (p);
+          if (end == NULL)
+            continue;
+
+          trigram = g_strndup (p, end - p);
+          positions = g_hash_table_lookup (search->trigrams, trigram);
+          if (positions == NULL)
+            {
+              positions = g_array_new (FALSE, FALSE, sizeof (guint));
+              g_hash_table_insert (search->trigrams, trigram, positions);
+            }
+          else
+            {
+              g_free (trigram);
+            }
+
+          /* entries are added in order, so a repeated trigram is the last one */
+          if (positions->len == 0 || g_array_index (positions, guint, positions->len - 1) != i)
+            g_array_append_val (positions, i);
+        }
+    }
+
+  search->index_valid = TRUE;
+
+  panel_debug (PANEL_DEBUG_APPLICATIONSMENU, "search index with %u items (%u reused) and %u trigrams built in %.2f ms",
+               search->index->len, n_reused, g_hash_table_size (search->trigrams),
+               (g_get_monotonic_time () - start) / 1000.0);
+}
+
+
+
+static guint
+applications_menu_search_score (SearchEntry *entry,
+                                const gchar *query)
+{
+  const gchar *match;
+
+  /* lower is better, G_MAXUINT if the entry does not match */
+  if (g_str_has_prefix (entry->name, query))
+    return 0;
+
+  match = strstr (entry->name, query);
+  if (match != NULL)
+    return g_unichar_isalnum (g_utf8_get_char (g_utf8_prev_char (match))) ? 2 : 1;
+
+  if (strstr (entry->haystack, query) != NULL)
+    return 3;
+
+  return G_MAXUINT;
+}
+
+
+
+static gint
+applications_menu_search_compare (gconstpointer a,
+                                  gconstpointer b)
+{
+  const SearchResult *ra = a, *rb = b;
+
+  if (ra->score != rb->score)
+    return ra->score < rb->score ? -1 : 1;
+
+  return strcmp (ra->entry->collate_key, rb->entry->collate_key);
+}
+
+
+
+static GArray *
+applications_menu_search_find (ApplicationsMenuSearch *search,
+                               const gchar *query)
+{
+  GArray *results, *positions, *candidates = NULL;
+  SearchResult result;
+  const gchar *p, *end;
+  gchar *trigram;
+  guint i, n;
+
+  if (!search->index_valid)
+    applications_menu_search_rebuild (search);
+
+  results = g_array_new (FALSE, FALSE, sizeof (SearchResult));
+
+  /* pick the shortest posting list of the query trigrams, shorter
+   * queries are matched against all the entries */
+  for (p = query; *p != '\0'; p = g_utf8_next_char (p))
+    {
+      end = applications_menu_search_trigram_end (p);
+      if (end == NULL)
+        break;
+
+      trigram = g_strndup (p, end - p);
+      positions = g_hash_table_lookup (search->trigrams, trigram);
+      g_free (trigram);
+
+      if (positions == NULL)
+        return results;
+
+      if (candidates == NULL || positions->len < candidates->len)
+        candidates = positions;
+    }
+
+  n = candidates != NULL ? candidates->len : search->index->len;
+  for (i = 0; i < n; i++)
+    {
+      result.entry = g_ptr_array_index (search->index,
+                                        candidates != NULL ? g_array_index (candidates, guint, i) : i);
+      result.score = applications_menu_search_score (result.entry, query);
+      if (result.score != G_MAXUINT)
+        g_array_append_val (results, result);
+    }
+
+  g_array_sort (results, applications_menu_search_compare);
+  if (results->len > MAX_RESULTS)
+    g_array_set_size (results, MAX_RESULTS);
+
+  return results;
+}
+
+
+
+static void
+applications_menu_search_activate (GtkWidget *mi,
+                                   GarconMenuItem *item)
+{
+  GError *error = NULL;
+  gchar **argv;
+  gboolean succeed = FALSE;
+  gchar *command, *uri;
+  const gchar *icon;
+
+  panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
+
+  command = (gchar *) garcon_menu_item_get_command (item);
+  if (xfce_str_is_empty (command))
+    return;
+
+  /* expand the field codes */
+  icon = garcon_menu_item_get_icon_name (item);
+  uri = garcon_menu_item_get_uri (item);
+  command = xfce_expand_desktop_entry_field_codes (command, NULL, icon,
+                                                   garcon_menu_item_get_name (item),
+                                                   uri,
+                                                   garcon_menu_item_requires_terminal (item));
+  g_free (uri);
+
+  if (g_shell_parse_argv (command, NULL, &argv, &error))
+    {
+      succeed = xfce_spawn (gtk_widget_get_screen (mi),
+                            garcon_menu_item_get_path (item),
+                            argv, NULL, G_SPAWN_SEARCH_PATH,
+                            garcon_menu_item_supports_startup_notification (item),
+                            gtk_get_current_event_time (), icon, TRUE, &error);
+
+      g_strfreev (argv);
+    }
+
+  if (G_UNLIKELY (!succeed))
+    {
+      xfce_dialog_show_error (NULL, error, _("Failed to execute command \"%s\"."), command);
+      g_error_free (error);
+    }
+  else
+    {
+      panel_debug (PANEL_DEBUG_APPLICATIONSMENU, "launched \"%s\" from the search results",
+                   garcon_menu_item_get_name (item));
+    }
+
+  g_free (command);
+}
+
+
+
+static GtkWidget *
+applications_menu_search_item_new (ApplicationsMenuSearch *search,
+                                   GarconMenuItem *item)
+{
+  GtkWidget *mi, *box, *image, *label;
+  const gchar *icon_name, *comment;
+  GIcon *gicon;
+
+  mi = gtk_menu_item_new ();
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+  gtk_container_add (GTK_CONTAINER (mi), box);
+
+  icon_name = garcon_menu_item_get_icon_name (item);
+  if (garcon_gtk_menu_get_show_menu_icons (search->menu))
+    {
+      if (!xfce_str_is_empty (icon_name) && g_path_is_absolute (icon_name))
+        {
+          GFile *file = g_file_new_for_path (icon_name);
+          gicon = g_file_icon_new (file);
+          g_object_unref (file);
+        }
+      else
+        {
+          gicon = g_themed_icon_new_with_default_fallbacks (!xfce_str_is_empty (icon_name)
+                                                              ? icon_name : "application-x-executable");
+        }
+
+      image = gtk_image_new_from_gicon (gicon, GTK_ICON_SIZE_MENU);
+      gtk_box_pack_start (GTK_BOX (box), image, FALSE, FALSE, 0);
+      g_object_unref (gicon);
+    }
+
+  label = gtk_label_new (garcon_menu_item_get_name (item));
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+  gtk_box_pack_start (GTK_BOX (box), label, TRUE, TRUE, 0);
+
+  comment = garcon_menu_item_get_comment (item);
+  if (garcon_gtk_menu_get_show_tooltips (search->menu) && !xfce_str_is_empty (comment))
+    gtk_widget_set_tooltip_text (mi, comment);
+
+  g_signal_connect_data (G_OBJECT (mi), "activate",
+                         G_CALLBACK (applications_menu_search_activate),
+                         g_object_ref (G_OBJECT (item)),
+                         (GClosureNotify) (void (*) (void)) g_object_unref, 0);
+
+  gtk_widget_show_all (mi);
+
+  return mi;
+}
+
+
+
+static void
+applications_menu_search_clear_results (ApplicationsMenuSearch *search)
+{
+  g_slist_free_full (search->results, (GDestroyNotify) (void (*) (void)) gtk_widget_destroy);
+  search->results = NULL;
+}
+
+
+
+static void
+applications_menu_search_restore (ApplicationsMenuSearch *search)
+{
+  GSList *li;
+
+  if (search->restore_id != 0)
+    {
+      g_source_remove (search->restore_id);
+      search->restore_id = 0;
+    }
+
+  g_string_truncate (search->query, 0);
+
+  if (search->header == NULL)
+    return;
+
+  applications_menu_search_clear_results (search);
+  gtk_widget_destroy (search->header);
+  search->header = NULL;
+
+  /* show the menu again, unless garcon-gtk replaced the items meanwhile */
+  for (li = search->hidden; li != NULL; li = li->next)
+    if (gtk_widget_get_parent (li->data) == GTK_WIDGET (search->menu))
+      gtk_widget_show (li->data);
+  g_slist_free_full (search->hidden, g_object_unref);
+  search->hidden = NULL;
+}
+
+
+
+static void
+applications_menu_search_update (ApplicationsMenuSearch *search)
+{
+  GtkMenuShell *shell = GTK_MENU_SHELL (search->menu);
+  GList *children, *li;
+  GArray *results;
+  GtkWidget *mi;
+  gchar *query, *text;
+  guint i;
+
+  query = g_utf8_casefold (search->query->str, search->query->len);
+  g_strstrip (query);
+  if (*query == '\0')
+    {
+      applications_menu_search_restore (search);
+      g_free (query);
+      return;
+    }
+
+  if (search->header == NULL)
+    {
+      /* hide the menu while the results are shown */
+      children = gtk_container_get_children (GTK_CONTAINER (shell));
+      for (li = children; li != NULL; li = li->next)
+        if (gtk_widget_get_visible (li->data))
+          {
+            gtk_widget_hide (li->data);
+            search->hidden = g_slist_prepend (search->hidden, g_object_ref (li->data));
+          }
+      g_list_free (children);
+
+      search->header = gtk_menu_item_new_with_label ("");
+      gtk_widget_set_sensitive (search->header, FALSE);
+      gtk_menu_shell_prepend (shell, search->header);
+      gtk_widget_show (search->header);
+    }
+
+  text = g_strdup_printf (_("Search: %s"), search->query->str);
+  gtk_menu_item_set_label (GTK_MENU_ITEM (search->header), text);
+  g_free (text);
+
+  applications_menu_search_clear_results (search);
+
+  results = applications_menu_search_find (search, query);
+  for (i = 0; i < results->len; i++)
+    {
+      mi = applications_menu_search_item_new (search, g_array_index (results, SearchResult, i).entry->item);
+      gtk_menu_shell_insert (shell, mi, i + 1);
+      search->results = g_slist_prepend (search->results, mi);
+    }
+
+  if (results->len > 0)
+    {
+      gtk_menu_shell_select_item (shell, g_slist_last (search->results)->data);
+    }
+  else
+    {
+      mi = gtk_menu_item_new_with_label (_("No applications found"));
+      gtk_widget_set_sensitive (mi, FALSE);
+      gtk_menu_shell_insert (shell, mi, 1);
+      gtk_widget_show (mi);
+      search->results = g_slist_prepend (search->results, mi);
+    }
+
+  g_array_free (results, TRUE);
+  g_free (query);
+}
+
+
+
+static gboolean
+applications_menu_search_key_press (GtkWidget *widget,
+                                    GdkEventKey *event,
+                                    ApplicationsMenuSearch *search)
+{
+  const gchar *prev;
+  gunichar c;
+
+  if (!search->enabled
+      || PANEL_HAS_FLAG (event->state, GDK_CONTROL_MASK)
+      || PANEL_HAS_FLAG (event->state, GDK_MOD1_MASK))
+    return FALSE;
+
+  switch (event->keyval)
+    {
+    case GDK_KEY_BackSpace:
+      if (search->query->len == 0)
+        return FALSE;
+
+      prev = g_utf8_find_prev_char (search->query->str, search->query->str + search->query->len);
+      g_string_truncate (search->query, prev - search->query->str);
+      break;
+
+    case GDK_KEY_Escape:
+      /* the first escape clears the search, the next one closes the menu */
+      if (search->query->len == 0)
+        return FALSE;
+
+      g_string_truncate (search->query, 0);
+      break;
+
+    default:
+      /* space activates the selected item until a search is started */
+      c = gdk_keyval_to_unicode (event->keyval);
+      if (c == 0 || !g_unichar_isprint (c) || (c == ' ' && search->query->len == 0))
+        return FALSE;
+
+      g_string_append_unichar (search->query, c);
+      break;
+    }
+
+  /* the results are shown in the toplevel menu, so close the open submenus */
+  if (widget != GTK_WIDGET (search->menu))
+    gtk_menu_shell_deselect (GTK_MENU_SHELL (search->menu));
+
+  applications_menu_search_update (search);
+
+  return TRUE;
+}
+
+
+
+static void
+applications_menu_search_connect_submenus (ApplicationsMenuSearch *search,
+                                           GtkWidget *menu,
+                                           gboolean connect)
+{
+  GList *children, *li;
+  GtkWidget *submenu;
+
+  children = gtk_container_get_children (GTK_CONTAINER (menu));
+  for (li = children; li != NULL; li = li->next)
+    {
+      if (!GTK_IS_MENU_ITEM (li->data))
+        continue;
+
+      submenu = gtk_menu_item_get_submenu (GTK_MENU_ITEM (li->data));
+      if (submenu == NULL)
+        continue;
+
+      /* garcon-gtk creates new submenus on a reload, watch each of them once */
+      if (connect && g_object_get_data (G_OBJECT (submenu), "applications-menu-search") == NULL)
+        {
+          g_signal_connect (G_OBJECT (submenu), "key-press-event",
+                            G_CALLBACK (applications_menu_search_key_press), search);
+          g_object_set_data (G_OBJECT (submenu), "applications-menu-search", search);
+        }
+      else if (!connect)
+        {
+          g_signal_handlers_disconnect_by_data (G_OBJECT (submenu), search);
+          g_object_set_data (G_OBJECT (submenu), "applications-menu-search", NULL);
+        }
+
+      applications_menu_search_connect_submenus (search, submenu, connect);
+    }
+  g_list_free (children);
+}
+
+
+
+static void
+applications_menu_search_show (ApplicationsMenuSearch *search)
+{
+  /* type-ahead also works while a submenu is open */
+  if (search->enabled)
+    applications_menu_search_connect_submenus (search, GTK_WIDGET (search->menu), TRUE);
+}
+
+
+
+static gboolean
+applications_menu_search_restore_idle (gpointer data)
+{
+  ApplicationsMenuSearch *search = data;
+
+  search->restore_id = 0;
+  applications_menu_search_restore (search);
+
+  return FALSE;
+}
+
+
+
+static void
+applications_menu_search_hide (ApplicationsMenuSearch *search)
+{
+  /* gtk hides the menu before it activates the selected item, so
+   * the result items must outlive this signal */
+  if (search->header != NULL && search->restore_id == 0)
+    search->restore_id = g_idle_add (applications_menu_search_restore_idle, search);
+  else
+    g_string_truncate (search->query, 0);
+}
+
+
+
+ApplicationsMenuSearch *
+applications_menu_search_new (GarconGtkMenu *menu)
+{
+  ApplicationsMenuSearch *search;
+
+  panel_return_val_if_fail (GARCON_GTK_IS_MENU (menu), NULL);
+
+  search = g_slice_new0 (ApplicationsMenuSearch);
+  search->menu = menu;
+  search->entries = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                           applications_menu_search_entry_free);
+  search->index = g_ptr_array_new ();
+  search->trigrams = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                            (GDestroyNotify) g_array_unref);
+  search->query = g_string_new (NULL);
+
+  g_signal_connect (G_OBJECT (menu), "key-press-event",
+                    G_CALLBACK (applications_menu_search_key_press), search);
+  g_signal_connect_swapped (G_OBJECT (menu), "show",
+                            G_CALLBACK (applications_menu_search_show), search);
+  g_signal_connect_swapped (G_OBJECT (menu), "hide",
+                            G_CALLBACK (applications_menu_search_hide), search);
+
+  return search;
+}
+
+
+
+void
+applications_menu_search_free (ApplicationsMenuSearch *search)
+{
+  applications_menu_search_invalidate (search);
+
+  applications_menu_search_connect_submenus (search, GTK_WIDGET (search->menu), FALSE);
+  g_signal_handlers_disconnect_by_data (G_OBJECT (search->menu), search);
+
+  g_hash_table_destroy (search->trigrams);
+  g_ptr_array_free (search->index, TRUE);
+  g_hash_table_destroy (search->entries);
+  g_string_free (search->query, TRUE);
+  g_slice_free (ApplicationsMenuSearch, search);
+}
+
+
+
+void
+applications_menu_search_set_enabled (ApplicationsMenuSearch *search,
+                                      gboolean enabled)
+{
+  if (search->enabled == !!enabled)
+    return;
+
+  search->enabled = !!enabled;
+  if (enabled)
+    return;
+
+  /* release the index while nobody is searching */
+  applications_menu_search_invalidate (search);
+  g_ptr_array_set_size (search->index, 0);
+  g_hash_table_remove_all (search->trigrams);
+  g_hash_table_remove_all (search->entries);
+}
+
+
+
+void
+applications_menu_search_invalidate (ApplicationsMenuSearch *search)
+{
+  applications_menu_search_restore (search);
+
+  if (search->garcon_menu != NULL)
+    {
+      g_signal_handler_disconnect (G_OBJECT (search->garcon_menu), search->reload_id);
+      g_object_unref (G_OBJECT (search->garcon_menu));
+      search->garcon_menu = NULL;
+      search->reload_id = 0;
+    }
+
+  search->index_valid = FALSE;
+}
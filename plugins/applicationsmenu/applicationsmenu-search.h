@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __APPLICATIONS_MENU_SEARCH_H__
+#define __APPLICATIONS_MENU_SEARCH_H__
+
+#include <garcon-gtk/garcon-gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ApplicationsMenuSearch ApplicationsMenuSearch;
+
+ApplicationsMenuSearch *
+applications_menu_search_new (GarconGtkMenu *menu) G_GNUC_MALLOC;
+
+void
+applications_menu_search_free (ApplicationsMenuSearch *search);
+
+void
+applications_menu_search_set_enabled (ApplicationsMenuSearch *search,
+                                      gboolean enabled);
+
+void
+applications_menu_search_invalidate (ApplicationsMenuSearch *search);
+
+G_END_DECLS
+
+#endif /* !__APPLICATIONS_MENU_SEARCH_H__ */
@@ -21,6 +21,7 @@
 #endif
 
 #include "applicationsmenu-dialog_ui.h"
+#include "applicationsmenu-search.h"
 #include "applicationsmenu.h"
 
 #include "common/panel-debug.h"
@@ -41,6 +42,15 @@
 #define DIALOG_ICON_SIZE (48)
 #define DEFAULT_EDITOR "menulibre"
 
+/* seconds to wait for the panel to settle before preparing the menu */
+#define PREWARM_DELAY (10)
+
+/* milliseconds to wait when the panel is busy at the start of the prewarm */
+#define PREWARM_RETRY (500)
+
+/* number of menu widgets visited per idle iteration of the prewarm */
+#define PREWARM_CHUNK (25)
+
 
 
 struct _ApplicationsMenuPlugin
@@ -51,10 +61,17 @@ struct _ApplicationsMenuPlugin
   GtkWidget *box;
   GtkWidget *image;
   GtkWidget *label;
+
+  /* shared with the other plugins showing the same menu file */
   GtkWidget *menu;
 
   guint is_constructed : 1;
 
+  guint show_generic_names : 1;
+  guint show_menu_icons : 1;
+  guint show_tooltips : 1;
+  guint show_search : 1;
+
   guint show_button_title : 1;
   guint small : 1;
   gchar *button_title;
@@ -65,15 +82,39 @@ struct _ApplicationsMenuPlugin
 
   gulong style_updated_id;
   gulong screen_changed_id;
-  gulong theme_changed_id;
 };
 
+typedef struct
+{
+  /* the menu file and the options, plugins only share a menu
+   * if they show it the same way */
+  gchar *key;
+  gchar *filename;
+  GtkWidget *menu;
+  GarconMenu *garcon_menu;
+  guint ref_count;
+
+  /* type-ahead search in the applications of the menu */
+  ApplicationsMenuSearch *search;
+
+  /* idle loading of the menu and its icons before the first popup */
+  guint prewarm_id;
+  GQueue prewarm_queue;
+  GSList *prewarm_icons;
+  gint64 prewarm_time;
+
+  /* debug timing of the popups */
+  gint64 popup_start;
+  guint n_popups;
+} SharedMenu;
+
 enum
 {
   PROP_0,
   PROP_SHOW_GENERIC_NAMES,
   PROP_SHOW_MENU_ICONS,
   PROP_SHOW_TOOLTIPS,
+  PROP_SHOW_SEARCH,
   PROP_SHOW_BUTTON_TITLE,
   PROP_SMALL,
   PROP_BUTTON_TITLE,
@@ -119,12 +160,23 @@ static void
 applications_menu_plugin_menu_popdown (GtkMenuShell *menu,
                                        ApplicationsMenuPlugin *plugin);
 static void
+applications_menu_shared_menu_release (GtkWidget *menu);
+static void
 applications_menu_plugin_set_garcon_menu (ApplicationsMenuPlugin *plugin);
 static void
+applications_menu_plugin_apply_options (ApplicationsMenuPlugin *plugin);
+static void
 applications_menu_button_theme_changed (ApplicationsMenuPlugin *plugin);
 
 
 
+/* menus loaded in this process, keyed by the menu file or an empty
+ * string for the applications menu */
+static GHashTable *shared_menus = NULL;
+static gulong shared_menus_theme_changed_id = 0;
+
+
+
 /* define the plugin */
 XFCE_PANEL_DEFINE_PLUGIN (ApplicationsMenuPlugin, applications_menu_plugin)
 
@@ -168,6 +220,13 @@ applications_menu_plugin_class_init (ApplicationsMenuPluginClass *klass)
                                                          FALSE,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class,
+                                   PROP_SHOW_SEARCH,
+                                   g_param_spec_boolean ("show-search",
+                                                         NULL, NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (gobject_class,
                                    PROP_SHOW_BUTTON_TITLE,
                                    g_param_spec_boolean ("show-button-title",
@@ -223,13 +282,9 @@ applications_menu_plugin_class_init (ApplicationsMenuPluginClass *klass)
 static void
 applications_menu_plugin_init (ApplicationsMenuPlugin *plugin)
 {
-  GtkIconTheme *icon_theme;
-
   /* init garcon environment */
   garcon_set_environment_xdg (GARCON_ENVIRONMENT_XFCE);
 
-  icon_theme = gtk_icon_theme_get_default ();
-
   plugin->button = xfce_panel_create_toggle_button ();
   xfce_panel_plugin_add_action_widget (XFCE_PANEL_PLUGIN (plugin), plugin->button);
   gtk_container_add (GTK_CONTAINER (plugin), plugin->button);
@@ -254,15 +309,15 @@ applications_menu_plugin_init (ApplicationsMenuPlugin *plugin)
   plugin->show_button_title = TRUE;
   gtk_widget_show (plugin->label);
 
-  /* prepare the menu */
-  plugin->menu = garcon_gtk_menu_new (NULL);
+  plugin->show_generic_names = FALSE;
+  plugin->show_menu_icons = TRUE;
+  plugin->show_tooltips = FALSE;
+  plugin->show_search = FALSE;
 
   plugin->style_updated_id = g_signal_connect_swapped (G_OBJECT (plugin->button), "style-updated",
                                                        G_CALLBACK (applications_menu_button_theme_changed), plugin);
   plugin->screen_changed_id = g_signal_connect_swapped (G_OBJECT (plugin->button), "screen-changed",
                                                         G_CALLBACK (applications_menu_button_theme_changed), plugin);
-  plugin->theme_changed_id = g_signal_connect_swapped (G_OBJECT (icon_theme), "changed",
-                                                       G_CALLBACK (applications_menu_plugin_set_garcon_menu), plugin);
 }
 
 
@@ -278,15 +333,19 @@ applications_menu_plugin_get_property (GObject *object,
   switch (prop_id)
     {
     case PROP_SHOW_GENERIC_NAMES:
-      g_value_set_boolean (value, garcon_gtk_menu_get_show_generic_names (GARCON_GTK_MENU (plugin->menu)));
+      g_value_set_boolean (value, plugin->show_generic_names);
       break;
 
     case PROP_SHOW_MENU_ICONS:
-      g_value_set_boolean (value, garcon_gtk_menu_get_show_menu_icons (GARCON_GTK_MENU (plugin->menu)));
+      g_value_set_boolean (value, plugin->show_menu_icons);
       break;
 
     case PROP_SHOW_TOOLTIPS:
-      g_value_set_boolean (value, garcon_gtk_menu_get_show_tooltips (GARCON_GTK_MENU (plugin->menu)));
+      g_value_set_boolean (value, plugin->show_tooltips);
+      break;
+
+    case PROP_SHOW_SEARCH:
+      g_value_set_boolean (value, plugin->show_search);
       break;
 
     case PROP_SHOW_BUTTON_TITLE:
@@ -336,19 +395,28 @@ applications_menu_plugin_set_property (GObject *object,
 
   switch (prop_id)
     {
+    /* the menu options are part of the key of the shared menu, so
+     * switch to the menu that is shown with the new options */
     case PROP_SHOW_GENERIC_NAMES:
-      garcon_gtk_menu_set_show_generic_names (GARCON_GTK_MENU (plugin->menu),
-                                              g_value_get_boolean (value));
+      plugin->show_generic_names = g_value_get_boolean (value);
+      if (plugin->menu != NULL)
+        applications_menu_plugin_set_garcon_menu (plugin);
       break;
 
     case PROP_SHOW_MENU_ICONS:
-      garcon_gtk_menu_set_show_menu_icons (GARCON_GTK_MENU (plugin->menu),
-                                           g_value_get_boolean (value));
+      plugin->show_menu_icons = g_value_get_boolean (value);
+      if (plugin->menu != NULL)
+        applications_menu_plugin_set_garcon_menu (plugin);
       break;
 
     case PROP_SHOW_TOOLTIPS:
-      garcon_gtk_menu_set_show_tooltips (GARCON_GTK_MENU (plugin->menu),
-                                         g_value_get_boolean (value));
+      plugin->show_tooltips = g_value_get_boolean (value);
+      if (plugin->menu != NULL)
+        applications_menu_plugin_set_garcon_menu (plugin);
+      break;
+
+    case PROP_SHOW_SEARCH:
+      plugin->show_search = g_value_get_boolean (value);
       break;
 
     case PROP_SHOW_BUTTON_TITLE:
@@ -434,6 +502,7 @@ applications_menu_plugin_construct (XfcePanelPlugin *panel_plugin)
     { "show-menu-icons", G_TYPE_BOOLEAN },
     { "show-button-title", G_TYPE_BOOLEAN },
     { "show-tooltips", G_TYPE_BOOLEAN },
+    { "show-search", G_TYPE_BOOLEAN },
     { "small", G_TYPE_BOOLEAN },
     { "button-title", G_TYPE_STRING },
     { "button-icon", G_TYPE_STRING },
@@ -468,10 +537,12 @@ static void
 applications_menu_plugin_free_data (XfcePanelPlugin *panel_plugin)
 {
   ApplicationsMenuPlugin *plugin = APPLICATIONS_MENU_PLUGIN (panel_plugin);
-  GtkIconTheme *icon_theme;
 
   if (plugin->menu != NULL)
-    gtk_widget_destroy (plugin->menu);
+    {
+      g_signal_handlers_disconnect_by_data (G_OBJECT (plugin->menu), plugin);
+      applications_menu_shared_menu_release (plugin->menu);
+    }
 
   if (plugin->style_updated_id != 0)
     {
@@ -485,14 +556,6 @@ applications_menu_plugin_free_data (XfcePanelPlugin *panel_plugin)
       plugin->screen_changed_id = 0;
     }
 
-  if (plugin->theme_changed_id != 0)
-    {
-      icon_theme = gtk_icon_theme_get_default ();
-      g_signal_handler_disconnect (G_OBJECT (icon_theme),
-                                   plugin->theme_changed_id);
-      plugin->theme_changed_id = 0;
-    }
-
   g_free (plugin->button_title);
   g_free (plugin->button_icon);
   g_free (plugin->custom_menu_file);
@@ -657,7 +720,8 @@ applications_menu_plugin_configure_plugin (XfcePanelPlugin *panel_plugin)
   guint i;
   gchar *path;
   const gchar *check_names[] = { "show-generic-names", "show-menu-icons",
-                                 "show-tooltips", "show-button-title", "small" };
+                                 "show-tooltips", "show-search",
+                                 "show-button-title", "small" };
 
   /* setup the dialog */
   builder = panel_utils_builder_new (panel_plugin, applicationsmenu_dialog_ui,
@@ -805,28 +869,407 @@ applications_menu_plugin_menu_popdown (GtkMenuShell *menu,
 
 
 
+static void
+applications_menu_shared_menu_prewarm_cancel (SharedMenu *shared)
+{
+  if (shared->prewarm_id != 0)
+    {
+      g_source_remove (shared->prewarm_id);
+      shared->prewarm_id = 0;
+    }
+
+  g_queue_foreach (&shared->prewarm_queue, (GFunc) (void (*) (void)) g_object_unref, NULL);
+  g_queue_clear (&shared->prewarm_queue);
+}
+
+
+
+static void
+applications_menu_shared_menu_prewarm_image (SharedMenu *shared,
+                                             GtkImage *image)
+{
+  GIcon *gicon;
+  const gchar *icon_name;
+  GtkIconSize icon_size;
+  GtkIconInfo *info;
+  GtkIconLookupFlags flags;
+  GdkPixbuf *pixbuf;
+  gint size;
+
+  switch (gtk_image_get_storage_type (image))
+    {
+    case GTK_IMAGE_ICON_NAME:
+      gtk_image_get_icon_name (image, &icon_name, &icon_size);
+      gicon = g_themed_icon_new (icon_name);
+      break;
+
+    case GTK_IMAGE_GICON:
+      gtk_image_get_gicon (image, &gicon, &icon_size);
+      g_object_ref (G_OBJECT (gicon));
+      break;
+
+    default:
+      /* nothing to load */
+      return;
+    }
+
+  /* use the same lookup as the image, so it finds the loaded icon
+   * in the icon theme cache */
+  flags = GTK_ICON_LOOKUP_USE_BUILTIN;
+  size = gtk_image_get_pixel_size (image);
+  if (size > 0)
+    flags |= GTK_ICON_LOOKUP_FORCE_SIZE;
+  else if (!gtk_icon_size_lookup (icon_size, &size, NULL))
+    size = DEFAULT_ICON_SIZE;
+  if (gtk_widget_get_direction (GTK_WIDGET (image)) == GTK_TEXT_DIR_RTL)
+    flags |= GTK_ICON_LOOKUP_DIR_RTL;
+  else
+    flags |= GTK_ICON_LOOKUP_DIR_LTR;
+
+  info = gtk_icon_theme_lookup_by_gicon_for_scale (gtk_icon_theme_get_default (), gicon, size,
+                                                   gtk_widget_get_scale_factor (GTK_WIDGET (image)),
+                                                   flags);
+  if (info != NULL)
+    {
+      /* keep the info alive, it holds the loaded pixbuf */
+      pixbuf = gtk_icon_info_load_icon (info, NULL);
+      if (pixbuf != NULL)
+        {
+          shared->prewarm_icons = g_slist_prepend (shared->prewarm_icons, info);
+          g_object_unref (G_OBJECT (pixbuf));
+        }
+      else
+        g_object_unref (G_OBJECT (info));
+    }
+
+  g_object_unref (G_OBJECT (gicon));
+}
+
+
+
+static gboolean
+applications_menu_shared_menu_prewarm_idle (gpointer data)
+{
+  SharedMenu *shared = data;
+  GtkWidget *widget, *submenu;
+  GList *children, *li;
+  gint64 start;
+  guint n;
+
+  start = g_get_monotonic_time ();
+
+  for (n = 0; n < PREWARM_CHUNK; n++)
+    {
+      widget = g_queue_pop_head (&shared->prewarm_queue);
+      if (widget == NULL)
+        break;
+
+      if (GTK_IS_IMAGE (widget))
+        applications_menu_shared_menu_prewarm_image (shared, GTK_IMAGE (widget));
+
+      if (GTK_IS_MENU_ITEM (widget))
+        {
+          submenu = gtk_menu_item_get_submenu (GTK_MENU_ITEM (widget));
+          if (submenu != NULL)
+            g_queue_push_tail (&shared->prewarm_queue, g_object_ref (G_OBJECT (submenu)));
+        }
+
+      if (GTK_IS_CONTAINER (widget))
+        {
+          children = gtk_container_get_children (GTK_CONTAINER (widget));
+          for (li = children; li != NULL; li = li->next)
+            g_queue_push_tail (&shared->prewarm_queue, g_object_ref (G_OBJECT (li->data)));
+          g_list_free (children);
+        }
+
+      g_object_unref (G_OBJECT (widget));
+    }
+
+  shared->prewarm_time += g_get_monotonic_time () - start;
+
+  if (!g_queue_is_empty (&shared->prewarm_queue))
+    return TRUE;
+
+  panel_debug (PANEL_DEBUG_APPLICATIONSMENU, "prewarmed menu \"%s\" with %u icons in %.2f ms",
+               shared->filename, g_slist_length (shared->prewarm_icons),
+               shared->prewarm_time / 1000.0);
+
+  shared->prewarm_id = 0;
+
+  return FALSE;
+}
+
+
+
+static gboolean
+applications_menu_shared_menu_prewarm_start (gpointer data)
+{
+  SharedMenu *shared = data;
+  gint64 start;
+
+  /* garcon-gtk loads the whole menu in one go, which cannot be interrupted,
+   * so only start when there is no input or other work waiting */
+  if (gtk_events_pending ())
+    {
+      shared->prewarm_id = g_timeout_add_full (G_PRIORITY_LOW, PREWARM_RETRY,
+                                               applications_menu_shared_menu_prewarm_start,
+                                               shared, NULL);
+      return FALSE;
+    }
+
+  start = g_get_monotonic_time ();
+
+  /* garcon-gtk builds the menu when it is shown, this does not map it
+   * since the toplevel of the menu stays hidden; a visible menu is popped
+   * up and thus already loaded */
+  if (!gtk_widget_get_visible (shared->menu))
+    {
+      gtk_widget_show (shared->menu);
+      gtk_widget_hide (shared->menu);
+    }
+
+  shared->prewarm_time = g_get_monotonic_time () - start;
+
+  /* resolve the icons in small steps, so input is handled in between */
+  g_queue_push_tail (&shared->prewarm_queue, g_object_ref (G_OBJECT (shared->menu)));
+  shared->prewarm_id = g_idle_add_full (G_PRIORITY_LOW, applications_menu_shared_menu_prewarm_idle,
+                                        shared, NULL);
+
+  return FALSE;
+}
+
+
+
+static gboolean
+applications_menu_shared_menu_draw (GtkWidget *menu,
+                                    cairo_t *cr,
+                                    SharedMenu *shared)
+{
+  if (shared->popup_start == 0)
+    return FALSE;
+
+  panel_debug (PANEL_DEBUG_APPLICATIONSMENU, "popup %u of menu \"%s\" drawn after %.2f ms (prewarmed: %s)",
+               shared->n_popups, shared->filename,
+               (g_get_monotonic_time () - shared->popup_start) / 1000.0,
+               PANEL_DEBUG_BOOL (shared->prewarm_icons != NULL));
+
+  shared->popup_start = 0;
+
+  return FALSE;
+}
+
+
+
+static void
+applications_menu_shared_menu_prewarm_schedule (SharedMenu *shared)
+{
+  /* prepare the menu in the background once the panel has settled */
+  applications_menu_shared_menu_prewarm_cancel (shared);
+  g_slist_free_full (shared->prewarm_icons, g_object_unref);
+  shared->prewarm_icons = NULL;
+  shared->prewarm_id = g_timeout_add_seconds_full (G_PRIORITY_LOW, PREWARM_DELAY,
+                                                   applications_menu_shared_menu_prewarm_start,
+                                                   shared, NULL);
+}
+
+
+
+static void
+applications_menu_shared_menu_set_garcon_menu (SharedMenu *shared)
+{
+  GarconMenu *menu;
+
+  /* load the custom menu if set, or use the applications menu, this
+   * also respects the XDG_MENU_PREFIX environment variable */
+  if (*shared->filename != '\0')
+    menu = garcon_menu_new_for_path (shared->filename);
+  else
+    menu = garcon_menu_new_applications ();
+
+  /* garcon-gtk parses the menu when it is shown for the first time, and
+   * again when garcon reports changes in the menu files */
+  garcon_gtk_menu_set_menu (GARCON_GTK_MENU (shared->menu), menu);
+  applications_menu_search_invalidate (shared->search);
+
+  /* garcon-gtk rebuilds the menu when the files change, prewarm it again */
+  if (shared->garcon_menu != NULL)
+    {
+      g_signal_handlers_disconnect_by_data (G_OBJECT (shared->garcon_menu), shared);
+      g_object_unref (G_OBJECT (shared->garcon_menu));
+    }
+  shared->garcon_menu = menu;
+  g_signal_connect_swapped (G_OBJECT (menu), "reload-required",
+                            G_CALLBACK (applications_menu_shared_menu_prewarm_schedule), shared);
+
+  applications_menu_shared_menu_prewarm_schedule (shared);
+}
+
+
+
+static void
+applications_menu_shared_menu_theme_changed (GtkIconTheme *icon_theme)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  /* reload the menus for the new icons */
+  g_hash_table_iter_init (&iter, shared_menus);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    applications_menu_shared_menu_set_garcon_menu (value);
+}
+
+
+
+static GtkWidget *
+applications_menu_shared_menu_get (const gchar *filename,
+                                   gboolean show_generic_names,
+                                   gboolean show_menu_icons,
+                                   gboolean show_tooltips)
+{
+  SharedMenu *shared;
+  gchar *key;
+
+  if (filename == NULL)
+    filename = "";
+
+  if (shared_menus == NULL)
+    {
+      shared_menus = g_hash_table_new (g_str_hash, g_str_equal);
+      shared_menus_theme_changed_id =
+        g_signal_connect (G_OBJECT (gtk_icon_theme_get_default ()), "changed",
+                          G_CALLBACK (applications_menu_shared_menu_theme_changed), NULL);
+    }
+
+  key = g_strdup_printf ("%d%d%d%s", !!show_generic_names, !!show_menu_icons,
+                         !!show_tooltips, filename);
+  shared = g_hash_table_lookup (shared_menus, key);
+  if (shared == NULL)
+    {
+      shared = g_slice_new0 (SharedMenu);
+      shared->key = key;
+      shared->filename = g_strdup (filename);
+      shared->menu = g_object_ref_sink (garcon_gtk_menu_new (NULL));
+
+      /* the options never change on a shared menu, since each change
+       * rebuilds it */
+      garcon_gtk_menu_set_show_generic_names (GARCON_GTK_MENU (shared->menu), show_generic_names);
+      garcon_gtk_menu_set_show_menu_icons (GARCON_GTK_MENU (shared->menu), show_menu_icons);
+      garcon_gtk_menu_set_show_tooltips (GARCON_GTK_MENU (shared->menu), show_tooltips);
+
+      shared->search = applications_menu_search_new (GARCON_GTK_MENU (shared->menu));
+      g_queue_init (&shared->prewarm_queue);
+      g_signal_connect_after (G_OBJECT (shared->menu), "draw",
+                              G_CALLBACK (applications_menu_shared_menu_draw), shared);
+      applications_menu_shared_menu_set_garcon_menu (shared);
+      g_hash_table_insert (shared_menus, shared->key, shared);
+    }
+  else
+    {
+      g_free (key);
+    }
+
+  shared->ref_count++;
+
+  return shared->menu;
+}
+
+
+
+static void
+applications_menu_shared_menu_release (GtkWidget *menu)
+{
+  GHashTableIter iter;
+  gpointer value;
+  SharedMenu *shared;
+
+  panel_return_if_fail (shared_menus != NULL);
+
+  g_hash_table_iter_init (&iter, shared_menus);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      shared = value;
+      if (shared->menu != menu || --shared->ref_count > 0)
+        continue;
+
+      g_hash_table_iter_remove (&iter);
+      applications_menu_shared_menu_prewarm_cancel (shared);
+      g_slist_free_full (shared->prewarm_icons, g_object_unref);
+      g_signal_handlers_disconnect_by_data (G_OBJECT (shared->garcon_menu), shared);
+      g_object_unref (G_OBJECT (shared->garcon_menu));
+      applications_menu_search_free (shared->search);
+      g_signal_handlers_disconnect_by_data (G_OBJECT (shared->menu), shared);
+      gtk_widget_destroy (shared->menu);
+      g_object_unref (G_OBJECT (shared->menu));
+      g_free (shared->filename);
+      g_free (shared->key);
+      g_slice_free (SharedMenu, shared);
+      break;
+    }
+
+  /* the module can be unloaded after the last plugin is gone */
+  if (g_hash_table_size (shared_menus) == 0)
+    {
+      g_signal_handler_disconnect (G_OBJECT (gtk_icon_theme_get_default ()),
+                                   shared_menus_theme_changed_id);
+      shared_menus_theme_changed_id = 0;
+      g_hash_table_destroy (shared_menus);
+      shared_menus = NULL;
+    }
+}
+
+
+
+static SharedMenu *
+applications_menu_shared_menu_lookup (GtkWidget *menu)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init (&iter, shared_menus);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    if (((SharedMenu *) value)->menu == menu)
+      return value;
+
+  return NULL;
+}
+
+
+
 static void
 applications_menu_plugin_set_garcon_menu (ApplicationsMenuPlugin *plugin)
 {
-  GarconMenu *menu = NULL;
+  GtkWidget *menu;
 
   panel_return_if_fail (APPLICATIONS_MENU_IS_PLUGIN (plugin));
-  panel_return_if_fail (GARCON_GTK_IS_MENU (plugin->menu));
 
-  /* load the custom menu if set */
-  if (plugin->custom_menu
-      && plugin->custom_menu_file != NULL)
-    menu = garcon_menu_new_for_path (plugin->custom_menu_file);
+  /* acquire the new menu first, so an unchanged menu is not reloaded */
+  menu = applications_menu_shared_menu_get (plugin->custom_menu ? plugin->custom_menu_file : NULL,
+                                            plugin->show_generic_names,
+                                            plugin->show_menu_icons,
+                                            plugin->show_tooltips);
+  if (plugin->menu != NULL)
+    {
+      g_signal_handlers_disconnect_by_data (G_OBJECT (plugin->menu), plugin);
+      applications_menu_shared_menu_release (plugin->menu);
+    }
 
-  /* use the applications menu, this also respects the
-   * XDG_MENU_PREFIX environment variable */
-  if (G_LIKELY (menu == NULL))
-    menu = garcon_menu_new_applications ();
+  plugin->menu = menu;
+
+  applications_menu_plugin_apply_options (plugin);
+}
 
-  /* set the menu */
-  garcon_gtk_menu_set_menu (GARCON_GTK_MENU (plugin->menu), menu);
 
-  g_object_unref (G_OBJECT (menu));
+
+static void
+applications_menu_plugin_apply_options (ApplicationsMenuPlugin *plugin)
+{
+  SharedMenu *shared;
+
+  /* the search does not change the menu items, so plugins that
+   * only differ in that still share the menu */
+  shared = applications_menu_shared_menu_lookup (plugin->menu);
+  panel_assert (shared != NULL);
+  applications_menu_search_set_enabled (shared->search, plugin->show_search);
 }
 
 
@@ -837,6 +1280,7 @@ applications_menu_plugin_menu (GtkWidget *button,
                                ApplicationsMenuPlugin *plugin)
 {
   GdkEvent *free_event = NULL;
+  SharedMenu *shared;
 
   panel_return_val_if_fail (APPLICATIONS_MENU_IS_PLUGIN (plugin), FALSE);
   panel_return_val_if_fail (button == NULL || plugin->button == button, FALSE);
@@ -850,6 +1294,16 @@ applications_menu_plugin_menu (GtkWidget *button,
   if (button != NULL)
     gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), TRUE);
 
+  /* the menu might have been shown by another plugin without search */
+  applications_menu_plugin_apply_options (plugin);
+
+  /* the popup finishes loading the menu if the prewarm did not */
+  shared = applications_menu_shared_menu_lookup (plugin->menu);
+  panel_assert (shared != NULL);
+  applications_menu_shared_menu_prewarm_cancel (shared);
+  shared->popup_start = g_get_monotonic_time ();
+  shared->n_popups++;
+
   /* Panel plugin remote events don't send actual GdkEvents, so construct a minimal one so that
    * gtk_menu_popup_at_pointer/rect can extract a location correctly from a GdkWindow */
   if (event == NULL)
@@ -60,9 +60,7 @@ struct _ClockTime
 struct _ClockTimeTimeout
 {
   guint interval;
-  guint timeout_id;
-  guint timeout_counter;
-  guint restart : 1;
+  guint tick_id;
   ClockTime *time;
   guint time_changed_id;
   ClockSleepMonitor *sleep_monitor;
@@ -268,63 +266,12 @@ clock_time_interval_from_format (const gchar *format)
 
 
 
-static gboolean
-clock_time_timeout_running (gpointer user_data)
-{
-  ClockTimeTimeout *timeout = user_data;
-  GDateTime *time;
-
-  g_signal_emit (G_OBJECT (timeout->time), clock_time_signals[TIME_CHANGED], 0);
-
-  /* check if the timeout still runs in time and sync again if necessary */
-  if (timeout->interval == CLOCK_INTERVAL_MINUTE)
-    {
-      /* accurate to the second */
-      time = clock_time_get_time (timeout->time);
-      timeout->restart = (g_date_time_get_second (time) != 0);
-      g_date_time_unref (time);
-    }
-  else if (++timeout->timeout_counter == 10)
-    {
-      /* accurate to the tenth of a second */
-      time = clock_time_get_time (timeout->time);
-      timeout->restart = (g_date_time_get_microsecond (time) / 100000 != 0);
-      g_date_time_unref (time);
-      timeout->timeout_counter = 0;
-    }
-
-  return !timeout->restart;
-}
-
-
-
 static void
-clock_time_timeout_destroyed (gpointer user_data)
-{
-  ClockTimeTimeout *timeout = user_data;
-
-  timeout->timeout_id = 0;
-
-  if (G_UNLIKELY (timeout->restart))
-    clock_time_timeout_set_interval (timeout, timeout->interval);
-}
-
-
-
-static gboolean
-clock_time_timeout_sync (gpointer user_data)
+clock_time_timeout_tick (gpointer user_data)
 {
   ClockTimeTimeout *timeout = user_data;
 
   g_signal_emit (G_OBJECT (timeout->time), clock_time_signals[TIME_CHANGED], 0);
-
-  /* start the real timeout */
-  timeout->timeout_id = g_timeout_add_full (G_PRIORITY_HIGH, timeout->interval * 1000,
-                                            clock_time_timeout_running, timeout,
-                                            clock_time_timeout_destroyed);
-
-  /* stop the sync timeout */
-  return FALSE;
 }
 
 
@@ -345,8 +292,7 @@ clock_time_timeout_new (guint interval,
 
   timeout = g_slice_new0 (ClockTimeTimeout);
   timeout->interval = 0;
-  timeout->timeout_id = 0;
-  timeout->restart = FALSE;
+  timeout->tick_id = 0;
   timeout->time = time;
 
   timeout->time_changed_id = g_signal_connect_swapped (G_OBJECT (time), "time-changed",
@@ -373,57 +319,25 @@ void
 clock_time_timeout_set_interval (ClockTimeTimeout *timeout,
                                  guint interval)
 {
-  GDateTime *time;
-  guint next_interval;
-  gboolean restart;
-
   panel_return_if_fail (timeout != NULL);
   panel_return_if_fail (interval > 0);
 
-  restart = timeout->restart;
-
-  /* leave if nothing changed and we're not restarting */
-  if (!restart && timeout->interval == interval)
+  /* leave if nothing changed */
+  if (timeout->interval == interval)
     return;
   timeout->interval = interval;
-  timeout->restart = FALSE;
-
-  /* stop running timeout */
-  if (G_LIKELY (timeout->timeout_id != 0))
-    g_source_remove (timeout->timeout_id);
-  timeout->timeout_id = 0;
-  timeout->timeout_counter = 0;
 
-  /* run function when not restarting */
-  if (!restart)
-    g_signal_emit (G_OBJECT (timeout->time), clock_time_signals[TIME_CHANGED], 0);
+  /* stop running tick */
+  if (G_LIKELY (timeout->tick_id != 0))
+    xfce_panel_tick_remove (timeout->tick_id);
 
-  time = clock_time_get_time (timeout->time);
-  if (interval == CLOCK_INTERVAL_MINUTE)
-    {
-      /* get the seconds to the next minute */
-      next_interval = (60 - g_date_time_get_second (time)) * 1000;
-    }
-  else
-    {
-      /* get the milliseconds to the next second */
-      next_interval = 1000 - g_date_time_get_microsecond (time) / 1000;
-    }
-  g_date_time_unref (time);
+  g_signal_emit (G_OBJECT (timeout->time), clock_time_signals[TIME_CHANGED], 0);
 
-  if (next_interval > 0)
-    {
-      /* start the sync timeout */
-      timeout->timeout_id = g_timeout_add_full (G_PRIORITY_HIGH, next_interval,
-                                                clock_time_timeout_sync, timeout, NULL);
-    }
-  else
-    {
-      /* directly start running the normal timeout */
-      timeout->timeout_id = g_timeout_add_full (G_PRIORITY_HIGH, interval * 1000,
-                                                clock_time_timeout_running, timeout,
-                                                clock_time_timeout_destroyed);
-    }
+  /* the shared panel timer keeps the ticks aligned to the wall clock */
+  timeout->tick_id = xfce_panel_tick_add (interval == CLOCK_INTERVAL_MINUTE
+                                            ? XFCE_PANEL_TICK_MINUTE
+                                            : XFCE_PANEL_TICK_SECOND,
+                                          clock_time_timeout_tick, timeout, NULL);
 }
 
 
@@ -433,10 +347,9 @@ clock_time_timeout_restart (ClockTimeTimeout *timeout)
 {
   panel_return_if_fail (timeout != NULL);
 
+  /* the shared timer realigns itself after a suspend, only make
+   * sure the clock is updated right away */
   g_signal_emit (G_OBJECT (timeout->time), clock_time_signals[TIME_CHANGED], 0);
-
-  timeout->restart = 1;
-  clock_time_timeout_set_interval (timeout, timeout->interval);
 }
 
 
@@ -446,8 +359,6 @@ clock_time_timeout_free (ClockTimeTimeout *timeout)
 {
   panel_return_if_fail (timeout != NULL);
 
-  timeout->restart = FALSE;
-
   if (timeout->time != NULL && timeout->time_changed_id != 0)
     g_signal_handler_disconnect (timeout->time, timeout->time_changed_id);
 
@@ -459,8 +370,8 @@ clock_time_timeout_free (ClockTimeTimeout *timeout)
       g_object_unref (G_OBJECT (timeout->sleep_monitor));
     }
 
-  if (G_LIKELY (timeout->timeout_id != 0))
-    g_source_remove (timeout->timeout_id);
+  if (G_LIKELY (timeout->tick_id != 0))
+    xfce_panel_tick_remove (timeout->tick_id);
 
   g_slice_free (ClockTimeTimeout, timeout);
 }
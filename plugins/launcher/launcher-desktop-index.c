@@ -0,0 +1,1006 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "launcher-desktop-index.h"
+
+#include "common/panel-private.h"
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <libxfce4util/libxfce4util.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+/* the index is stored as a serialized GVariant, so it can be loaded
+ * without parsing any desktop file */
+#define CACHE_FILE "xfce4" G_DIR_SEPARATOR_S "panel" G_DIR_SEPARATOR_S "launcher-desktop-ids.cache"
+#define CACHE_VERSION (1)
+#define CACHE_TYPE "(usasa(sxus)a(sssssssuu))"
+
+/* seconds to wait after a change before writing the cache */
+#define CACHE_SAVE_DELAY (5)
+
+#define ENTRY_HIDDEN (1 << 0) /* Hidden=true, shadows the desktop-id */
+#define ENTRY_NO_DISPLAY (1 << 1) /* NoDisplay=true, resolvable but not listed */
+
+
+
+static void
+launcher_desktop_index_finalize (GObject *object);
+static void
+launcher_desktop_index_scan_dir (LauncherDesktopIndex *desktop_index,
+                                 const gchar *path,
+                                 guint base,
+                                 const gchar *prefix);
+static void
+launcher_desktop_index_monitor_dirs (LauncherDesktopIndex *desktop_index);
+
+
+
+typedef struct
+{
+  gchar *path;
+  gchar *name;
+  gchar *comment;
+  gchar *icon_name;
+  gchar *only_show_in;
+  gchar *not_show_in;
+  guint flags;
+
+  /* position of the applications directory in the xdg data dirs,
+   * lower values take precedence */
+  guint base;
+
+  /* created on demand */
+  GarconMenuItem *item;
+} IndexEntry;
+
+typedef struct
+{
+  /* 0 if the directory does not exist */
+  gint64 mtime;
+  guint base;
+
+  /* desktop-id prefix of the files in this directory */
+  gchar *prefix;
+
+  GFileMonitor *monitor;
+} IndexDir;
+
+struct _LauncherDesktopIndex
+{
+  GObject __parent__;
+
+  /* applications directories, in order of precedence */
+  gchar **bases;
+
+  /* desktop-id -> IndexEntry */
+  GHashTable *entries;
+
+  /* path -> IndexDir, for every scanned directory */
+  GHashTable *dirs;
+
+  /* path -> GFileMonitor, nearest existing parents of missing
+   * applications directories */
+  GHashTable *parent_monitors;
+
+  guint save_timeout_id;
+};
+
+
+
+/* shared by all launchers in this process */
+static LauncherDesktopIndex *shared_index = NULL;
+
+
+
+G_DEFINE_FINAL_TYPE (LauncherDesktopIndex, launcher_desktop_index, G_TYPE_OBJECT)
+
+
+
+static void
+launcher_desktop_index_entry_free (gpointer data)
+{
+  IndexEntry *entry = data;
+
+  g_free (entry->path);
+  g_free (entry->name);
+  g_free (entry->comment);
+  g_free (entry->icon_name);
+  g_free (entry->only_show_in);
+  g_free (entry->not_show_in);
+  if (entry->item != NULL)
+    g_object_unref (G_OBJECT (entry->item));
+  g_free (entry);
+}
+
+
+
+static void
+launcher_desktop_index_dir_free (gpointer data)
+{
+  IndexDir *dir = data;
+
+  if (dir->monitor != NULL)
+    {
+      g_file_monitor_cancel (dir->monitor);
+      g_object_unref (G_OBJECT (dir->monitor));
+    }
+  g_free (dir->prefix);
+  g_free (dir);
+}
+
+
+
+static void
+launcher_desktop_index_monitor_free (gpointer data)
+{
+  GFileMonitor *monitor = data;
+
+  g_file_monitor_cancel (monitor);
+  g_object_unref (G_OBJECT (monitor));
+}
+
+
+
+static gint64
+launcher_desktop_index_dir_mtime (const gchar *path)
+{
+  GStatBuf st;
+
+  if (g_stat (path, &st) == 0 && S_ISDIR (st.st_mode))
+    return st.st_mtime;
+
+  return 0;
+}
+
+
+
+static const gchar *
+launcher_desktop_index_locale (void)
+{
+  /* the cached names are translated */
+  return g_get_language_names ()[0];
+}
+
+
+
+static void
+launcher_desktop_index_class_init (LauncherDesktopIndexClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = launcher_desktop_index_finalize;
+}
+
+
+
+static gboolean
+launcher_desktop_index_load_cache (LauncherDesktopIndex *desktop_index)
+{
+  gchar *filename;
+  GMappedFile *mapped;
+  GBytes *bytes;
+  GVariant *cache;
+  GVariant *dirs, *entries;
+  GVariantIter iter;
+  guint version;
+  const gchar *locale;
+  const gchar **bases;
+  const gchar *path, *prefix;
+  const gchar *id, *name, *comment, *icon_name, *only_show_in, *not_show_in;
+  gint64 mtime;
+  guint base, flags;
+  IndexDir *dir;
+  IndexEntry *entry;
+  gboolean valid = FALSE;
+
+  filename = xfce_resource_lookup (XFCE_RESOURCE_CACHE, CACHE_FILE);
+  if (filename == NULL)
+    return FALSE;
+
+  mapped = g_mapped_file_new (filename, FALSE, NULL);
+  g_free (filename);
+  if (mapped == NULL)
+    return FALSE;
+
+  bytes = g_mapped_file_get_bytes (mapped);
+  g_mapped_file_unref (mapped);
+  cache = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_TYPE), bytes, FALSE));
+  g_bytes_unref (bytes);
+
+  g_variant_get (cache, "(u&s^a&s@a(sxus)@a(sssssssuu))",
+                 &version, &locale, &bases, &dirs, &entries);
+
+  /* the cache must match the current data dirs and language */
+  if (version != CACHE_VERSION
+      || g_strcmp0 (locale, launcher_desktop_index_locale ()) != 0
+      || !g_strv_equal (bases, (const gchar *const *) desktop_index->bases))
+    goto out;
+
+  /* no files were added or removed since the cache was written */
+  g_variant_iter_init (&iter, dirs);
+  while (g_variant_iter_next (&iter, "(&sxu&s)", &path, &mtime, &base, &prefix))
+    {
+      if (launcher_desktop_index_dir_mtime (path) != mtime)
+        {
+          g_hash_table_remove_all (desktop_index->dirs);
+          goto out;
+        }
+
+      dir = g_new0 (IndexDir, 1);
+      dir->mtime = mtime;
+      dir->base = base;
+      dir->prefix = g_strdup (prefix);
+      g_hash_table_insert (desktop_index->dirs, g_strdup (path), dir);
+    }
+
+  g_variant_iter_init (&iter, entries);
+  while (g_variant_iter_next (&iter, "(&s&s&s&s&s&s&suu)", &id, &path, &name, &comment,
+                              &icon_name, &only_show_in, &not_show_in, &flags, &base))
+    {
+      entry = g_new0 (IndexEntry, 1);
+      entry->path = g_strdup (path);
+      entry->name = g_strdup (name);
+      entry->comment = *comment != '\0' ? g_strdup (comment) : NULL;
+      entry->icon_name = *icon_name != '\0' ? g_strdup (icon_name) : NULL;
+      entry->only_show_in = *only_show_in != '\0' ? g_strdup (only_show_in) : NULL;
+      entry->not_show_in = *not_show_in != '\0' ? g_strdup (not_show_in) : NULL;
+      entry->flags = flags;
+      entry->base = base;
+      g_hash_table_insert (desktop_index->entries, g_strdup (id), entry);
+    }
+
+  valid = TRUE;
+
+out:
+  g_free (bases);
+  g_variant_unref (dirs);
+  g_variant_unref (entries);
+  g_variant_unref (cache);
+
+  return valid;
+}
+
+
+
+static void
+launcher_desktop_index_save_cache (LauncherDesktopIndex *desktop_index)
+{
+  GVariantBuilder dirs, entries;
+  GHashTableIter iter;
+  gpointer key, value;
+  IndexDir *dir;
+  IndexEntry *entry;
+  GVariant *cache;
+  gchar *filename;
+  GError *error = NULL;
+
+  g_variant_builder_init (&dirs, G_VARIANT_TYPE ("a(sxus)"));
+  g_hash_table_iter_init (&iter, desktop_index->dirs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      dir = value;
+      g_variant_builder_add (&dirs, "(sxus)", key, dir->mtime, dir->base, dir->prefix);
+    }
+
+  g_variant_builder_init (&entries, G_VARIANT_TYPE ("a(sssssssuu)"));
+  g_hash_table_iter_init (&iter, desktop_index->entries);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      entry = value;
+      g_variant_builder_add (&entries, "(sssssssuu)", key, entry->path,
+                             entry->name != NULL ? entry->name : "",
+                             entry->comment != NULL ? entry->comment : "",
+                             entry->icon_name != NULL ? entry->icon_name : "",
+                             entry->only_show_in != NULL ? entry->only_show_in : "",
+                             entry->not_show_in != NULL ? entry->not_show_in : "",
+                             entry->flags, entry->base);
+    }
+
+  cache = g_variant_ref_sink (g_variant_new ("(us^asa(sxus)a(sssssssuu))",
+                                             CACHE_VERSION, launcher_desktop_index_locale (),
+                                             desktop_index->bases, &dirs, &entries));
+
+  filename = xfce_resource_save_location (XFCE_RESOURCE_CACHE, CACHE_FILE, TRUE);
+  if (filename != NULL
+      && !g_file_set_contents (filename, g_variant_get_data (cache),
+                               g_variant_get_size (cache), &error))
+    {
+      g_warning ("Failed to save the desktop-id index: %s", error->message);
+      g_error_free (error);
+    }
+
+  g_free (filename);
+  g_variant_unref (cache);
+}
+
+
+
+static gboolean
+launcher_desktop_index_save_timeout (gpointer data)
+{
+  LauncherDesktopIndex *desktop_index = LAUNCHER_DESKTOP_INDEX (data);
+
+  desktop_index->save_timeout_id = 0;
+  launcher_desktop_index_save_cache (desktop_index);
+
+  return FALSE;
+}
+
+
+
+static void
+launcher_desktop_index_queue_save (LauncherDesktopIndex *desktop_index)
+{
+  if (desktop_index->save_timeout_id == 0)
+    desktop_index->save_timeout_id = g_timeout_add_seconds (CACHE_SAVE_DELAY, launcher_desktop_index_save_timeout, desktop_index);
+}
+
+
+
+static IndexEntry *
+launcher_desktop_index_entry_new (const gchar *filename,
+                                  guint base)
+{
+  GKeyFile *key_file;
+  IndexEntry *entry = NULL;
+  gchar *type;
+
+  key_file = g_key_file_new ();
+  if (!g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, NULL)
+      || !g_key_file_has_group (key_file, G_KEY_FILE_DESKTOP_GROUP))
+    goto out;
+
+  entry = g_new0 (IndexEntry, 1);
+  entry->path = g_strdup (filename);
+  entry->base = base;
+
+  /* a hidden file still shadows the desktop-id in the other directories */
+  if (g_key_file_get_boolean (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_HIDDEN, NULL))
+    {
+      entry->flags = ENTRY_HIDDEN;
+      goto out;
+    }
+
+  type = g_key_file_get_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_TYPE, NULL);
+  entry->name = g_key_file_get_locale_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_NAME, NULL, NULL);
+  if (g_strcmp0 (type, G_KEY_FILE_DESKTOP_TYPE_APPLICATION) != 0 || entry->name == NULL)
+    {
+      g_free (type);
+      launcher_desktop_index_entry_free (entry);
+      entry = NULL;
+      goto out;
+    }
+  g_free (type);
+
+  entry->comment = g_key_file_get_locale_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_COMMENT, NULL, NULL);
+  entry->icon_name = g_key_file_get_locale_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_ICON, NULL, NULL);
+  entry->only_show_in = g_key_file_get_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_ONLY_SHOW_IN, NULL);
+  entry->not_show_in = g_key_file_get_string (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_NOT_SHOW_IN, NULL);
+  if (g_key_file_get_boolean (key_file, G_KEY_FILE_DESKTOP_GROUP, G_KEY_FILE_DESKTOP_KEY_NO_DISPLAY, NULL))
+    entry->flags = ENTRY_NO_DISPLAY;
+
+out:
+  g_key_file_free (key_file);
+
+  return entry;
+}
+
+
+
+static gboolean
+launcher_desktop_index_update_file (LauncherDesktopIndex *desktop_index,
+                                    const gchar *filename,
+                                    guint base,
+                                    const gchar *desktop_id);
+
+
+
+static void
+launcher_desktop_index_resolve (LauncherDesktopIndex *desktop_index,
+                                const gchar *desktop_id)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  IndexDir *dir;
+  gchar *filename;
+  gchar *dirname;
+  GSList *candidates = NULL, *li;
+
+  /* look for another file providing the desktop-id, the precedence
+   * rules in update_file pick the right one */
+  g_hash_table_iter_init (&iter, desktop_index->dirs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      dir = value;
+      if (dir->mtime == 0 || !g_str_has_prefix (desktop_id, dir->prefix))
+        continue;
+
+      filename = g_build_filename (key, desktop_id + strlen (dir->prefix), NULL);
+      if (g_file_test (filename, G_FILE_TEST_IS_REGULAR))
+        candidates = g_slist_prepend (candidates, filename);
+      else
+        g_free (filename);
+    }
+
+  for (li = candidates; li != NULL; li = li->next)
+    {
+      dirname = g_path_get_dirname (li->data);
+      dir = g_hash_table_lookup (desktop_index->dirs, dirname);
+      if (dir != NULL)
+        launcher_desktop_index_update_file (desktop_index, li->data, dir->base, desktop_id);
+      g_free (dirname);
+    }
+
+  g_slist_free_full (candidates, g_free);
+}
+
+
+
+static gboolean
+launcher_desktop_index_remove_file (LauncherDesktopIndex *desktop_index,
+                                    const gchar *filename,
+                                    const gchar *desktop_id)
+{
+  IndexEntry *entry;
+
+  entry = g_hash_table_lookup (desktop_index->entries, desktop_id);
+  if (entry == NULL || g_strcmp0 (entry->path, filename) != 0)
+    return FALSE;
+
+  g_hash_table_remove (desktop_index->entries, desktop_id);
+  launcher_desktop_index_resolve (desktop_index, desktop_id);
+
+  return TRUE;
+}
+
+
+
+static gboolean
+launcher_desktop_index_update_file (LauncherDesktopIndex *desktop_index,
+                                    const gchar *filename,
+                                    guint base,
+                                    const gchar *desktop_id)
+{
+  IndexEntry *entry;
+  IndexEntry *existing;
+
+  /* the first file in the data dirs wins */
+  existing = g_hash_table_lookup (desktop_index->entries, desktop_id);
+  if (existing != NULL
+      && g_strcmp0 (existing->path, filename) != 0
+      && existing->base <= base)
+    return FALSE;
+
+  entry = launcher_desktop_index_entry_new (filename, base);
+  if (entry == NULL)
+    return launcher_desktop_index_remove_file (desktop_index, filename, desktop_id);
+
+  g_hash_table_replace (desktop_index->entries, g_strdup (desktop_id), entry);
+
+  return TRUE;
+}
+
+
+
+static void
+launcher_desktop_index_remove_dir (LauncherDesktopIndex *desktop_index,
+                                   const gchar *path)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  IndexDir *dir;
+  IndexEntry *entry;
+  gchar *prefix;
+  GSList *removed = NULL, *li;
+
+  prefix = g_strconcat (path, G_DIR_SEPARATOR_S, NULL);
+
+  g_hash_table_iter_init (&iter, desktop_index->dirs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      dir = value;
+      if (strcmp (key, path) == 0 && *dir->prefix == '\0')
+        {
+          /* remember the applications directory, it might return */
+          dir->mtime = 0;
+          g_clear_object (&dir->monitor);
+        }
+      else if (strcmp (key, path) == 0 || g_str_has_prefix (key, prefix))
+        {
+          g_hash_table_iter_remove (&iter);
+        }
+    }
+
+  g_hash_table_iter_init (&iter, desktop_index->entries);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      entry = value;
+      if (g_str_has_prefix (entry->path, prefix))
+        {
+          removed = g_slist_prepend (removed, g_strdup (key));
+          g_hash_table_iter_remove (&iter);
+        }
+    }
+
+  for (li = removed; li != NULL; li = li->next)
+    launcher_desktop_index_resolve (desktop_index, li->data);
+
+  g_slist_free_full (removed, g_free);
+  g_free (prefix);
+}
+
+
+
+static void
+launcher_desktop_index_monitor_changed (GFileMonitor *monitor,
+                                        GFile *file,
+                                        GFile *other_file,
+                                        GFileMonitorEvent event_type,
+                                        LauncherDesktopIndex *desktop_index)
+{
+  gchar *filename;
+  gchar *dirname;
+  gchar *basename;
+  gchar *desktop_id = NULL;
+  gchar *prefix;
+  IndexDir *dir;
+
+  panel_return_if_fail (LAUNCHER_IS_DESKTOP_INDEX (desktop_index));
+
+  filename = g_file_get_path (file);
+  if (filename == NULL)
+    return;
+
+  /* a scanned directory disappeared */
+  if (event_type == G_FILE_MONITOR_EVENT_DELETED
+      && g_hash_table_contains (desktop_index->dirs, filename))
+    {
+      launcher_desktop_index_remove_dir (desktop_index, filename);
+      launcher_desktop_index_monitor_dirs (desktop_index);
+      launcher_desktop_index_queue_save (desktop_index);
+      g_free (filename);
+      return;
+    }
+
+  dirname = g_path_get_dirname (filename);
+  basename = g_path_get_basename (filename);
+  dir = g_hash_table_lookup (desktop_index->dirs, dirname);
+  if (dir == NULL)
+    goto out;
+
+  if (g_str_has_suffix (basename, ".desktop"))
+    desktop_id = g_strconcat (dir->prefix, basename, NULL);
+
+  switch (event_type)
+    {
+    case G_FILE_MONITOR_EVENT_CREATED:
+      if (g_file_test (filename, G_FILE_TEST_IS_DIR))
+        {
+          prefix = g_strconcat (dir->prefix, basename, "-", NULL);
+          launcher_desktop_index_scan_dir (desktop_index, filename, dir->base, prefix);
+          launcher_desktop_index_monitor_dirs (desktop_index);
+          g_free (prefix);
+        }
+      else if (desktop_id != NULL)
+        {
+          launcher_desktop_index_update_file (desktop_index, filename, dir->base, desktop_id);
+        }
+      break;
+
+    case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+      if (desktop_id != NULL)
+        launcher_desktop_index_update_file (desktop_index, filename, dir->base, desktop_id);
+      break;
+
+    case G_FILE_MONITOR_EVENT_DELETED:
+      if (desktop_id != NULL)
+        launcher_desktop_index_remove_file (desktop_index, filename, desktop_id);
+      break;
+
+    default:
+      goto out;
+    }
+
+  /* keep the cache valid for the next start */
+  dir->mtime = launcher_desktop_index_dir_mtime (dirname);
+  launcher_desktop_index_queue_save (desktop_index);
+
+out:
+  g_free (desktop_id);
+  g_free (basename);
+  g_free (dirname);
+  g_free (filename);
+}
+
+
+
+static void
+launcher_desktop_index_parent_changed (GFileMonitor *monitor,
+                                       GFile *file,
+                                       GFile *other_file,
+                                       GFileMonitorEvent event_type,
+                                       LauncherDesktopIndex *desktop_index)
+{
+  guint i;
+  IndexDir *dir;
+  gboolean changed = FALSE;
+
+  panel_return_if_fail (LAUNCHER_IS_DESKTOP_INDEX (desktop_index));
+
+  if (event_type != G_FILE_MONITOR_EVENT_CREATED)
+    return;
+
+  /* scan the applications directories that appeared */
+  for (i = 0; desktop_index->bases[i] != NULL; i++)
+    {
+      dir = g_hash_table_lookup (desktop_index->dirs, desktop_index->bases[i]);
+      if (dir == NULL
+          || dir->mtime != 0
+          || launcher_desktop_index_dir_mtime (desktop_index->bases[i]) == 0)
+        continue;
+
+      g_hash_table_remove (desktop_index->dirs, desktop_index->bases[i]);
+      launcher_desktop_index_scan_dir (desktop_index, desktop_index->bases[i], i, "");
+      changed = TRUE;
+    }
+
+  /* a parent might have appeared, move the watches closer; the
+   * signal emission holds a reference on this monitor */
+  g_hash_table_remove_all (desktop_index->parent_monitors);
+  launcher_desktop_index_monitor_dirs (desktop_index);
+
+  if (changed)
+    launcher_desktop_index_queue_save (desktop_index);
+}
+
+
+
+static void
+launcher_desktop_index_monitor_parent (LauncherDesktopIndex *desktop_index,
+                                       const gchar *path)
+{
+  gchar *parent, *dirname;
+  GFile *file;
+  GFileMonitor *monitor;
+
+  /* find the nearest existing parent */
+  parent = g_path_get_dirname (path);
+  while (launcher_desktop_index_dir_mtime (parent) == 0)
+    {
+      dirname = g_path_get_dirname (parent);
+      if (strcmp (dirname, parent) == 0)
+        {
+          g_free (dirname);
+          break;
+        }
+
+      g_free (parent);
+      parent = dirname;
+    }
+
+  if (g_hash_table_contains (desktop_index->parent_monitors, parent))
+    {
+      g_free (parent);
+      return;
+    }
+
+  file = g_file_new_for_path (parent);
+  monitor = g_file_monitor_directory (file, G_FILE_MONITOR_NONE, NULL, NULL);
+  g_object_unref (G_OBJECT (file));
+
+  if (monitor != NULL)
+    {
+      g_signal_connect (G_OBJECT (monitor), "changed",
+                        G_CALLBACK (launcher_desktop_index_parent_changed), desktop_index);
+      g_hash_table_insert (desktop_index->parent_monitors, parent, monitor);
+    }
+  else
+    {
+      g_free (parent);
+    }
+}
+
+
+
+static void
+launcher_desktop_index_monitor_dirs (LauncherDesktopIndex *desktop_index)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  IndexDir *dir;
+  GFile *file;
+
+  g_hash_table_iter_init (&iter, desktop_index->dirs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      dir = value;
+      if (dir->monitor != NULL)
+        continue;
+
+      /* wait for missing applications directories to appear, removed
+       * subdirectories are noticed by the monitor of their parent */
+      if (dir->mtime == 0)
+        {
+          if (*dir->prefix == '\0')
+            launcher_desktop_index_monitor_parent (desktop_index, key);
+          continue;
+        }
+
+      file = g_file_new_for_path (key);
+      dir->monitor = g_file_monitor_directory (file, G_FILE_MONITOR_NONE, NULL, NULL);
+      if (dir->monitor != NULL)
+        g_signal_connect (G_OBJECT (dir->monitor), "changed",
+                          G_CALLBACK (launcher_desktop_index_monitor_changed), desktop_index);
+      g_object_unref (G_OBJECT (file));
+    }
+}
+
+
+
+static void
+launcher_desktop_index_scan_dir (LauncherDesktopIndex *desktop_index,
+                                 const gchar *path,
+                                 guint base,
+                                 const gchar *prefix)
+{
+  IndexDir *dir;
+  GDir *gdir;
+  const gchar *name;
+  gchar *filename;
+  gchar *desktop_id;
+  gchar *sub_prefix;
+
+  /* the same directory can be in the data dirs more than once */
+  if (g_hash_table_contains (desktop_index->dirs, path))
+    return;
+
+  dir = g_new0 (IndexDir, 1);
+  dir->mtime = launcher_desktop_index_dir_mtime (path);
+  dir->base = base;
+  dir->prefix = g_strdup (prefix);
+  g_hash_table_insert (desktop_index->dirs, g_strdup (path), dir);
+
+  if (dir->mtime == 0)
+    return;
+
+  gdir = g_dir_open (path, 0, NULL);
+  if (gdir == NULL)
+    return;
+
+  while ((name = g_dir_read_name (gdir)) != NULL)
+    {
+      filename = g_build_filename (path, name, NULL);
+
+      if (g_file_test (filename, G_FILE_TEST_IS_DIR))
+        {
+          /* files in subdirectories get a prefixed desktop-id */
+          sub_prefix = g_strconcat (prefix, name, "-", NULL);
+          launcher_desktop_index_scan_dir (desktop_index, filename, base, sub_prefix);
+          g_free (sub_prefix);
+        }
+      else if (g_str_has_suffix (name, ".desktop"))
+        {
+          desktop_id = g_strconcat (prefix, name, NULL);
+          launcher_desktop_index_update_file (desktop_index, filename, base, desktop_id);
+          g_free (desktop_id);
+        }
+
+      g_free (filename);
+    }
+
+  g_dir_close (gdir);
+}
+
+
+
+static void
+launcher_desktop_index_init (LauncherDesktopIndex *desktop_index)
+{
+  const gchar *const *data_dirs;
+  guint n, i;
+
+  data_dirs = g_get_system_data_dirs ();
+  n = g_strv_length ((gchar **) data_dirs);
+
+  desktop_index->bases = g_new0 (gchar *, n + 2);
+  desktop_index->bases[0] = g_build_filename (g_get_user_data_dir (), "applications", NULL);
+  for (i = 0; i < n; i++)
+    desktop_index->bases[i + 1] = g_build_filename (data_dirs[i], "applications", NULL);
+
+  desktop_index->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                                  launcher_desktop_index_entry_free);
+  desktop_index->dirs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                               launcher_desktop_index_dir_free);
+  desktop_index->parent_monitors = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                                          launcher_desktop_index_monitor_free);
+
+  if (!launcher_desktop_index_load_cache (desktop_index))
+    {
+      for (i = 0; desktop_index->bases[i] != NULL; i++)
+        launcher_desktop_index_scan_dir (desktop_index, desktop_index->bases[i], i, "");
+
+      launcher_desktop_index_queue_save (desktop_index);
+    }
+
+  /* keep the index up to date while it is used */
+  launcher_desktop_index_monitor_dirs (desktop_index);
+}
+
+
+
+static void
+launcher_desktop_index_finalize (GObject *object)
+{
+  LauncherDesktopIndex *desktop_index = LAUNCHER_DESKTOP_INDEX (object);
+
+  /* write pending changes */
+  if (desktop_index->save_timeout_id != 0)
+    {
+      g_source_remove (desktop_index->save_timeout_id);
+      launcher_desktop_index_save_cache (desktop_index);
+    }
+
+  g_hash_table_destroy (desktop_index->parent_monitors);
+  g_hash_table_destroy (desktop_index->dirs);
+  g_hash_table_destroy (desktop_index->entries);
+  g_strfreev (desktop_index->bases);
+
+  G_OBJECT_CLASS (launcher_desktop_index_parent_class)->finalize (object);
+}
+
+
+
+static gboolean
+launcher_desktop_index_show_in (IndexEntry *entry)
+{
+  const gchar *environment;
+  gchar **envs;
+  gboolean show = TRUE;
+
+  environment = garcon_get_environment ();
+  if (environment == NULL)
+    return TRUE;
+
+  if (entry->only_show_in != NULL)
+    {
+      envs = g_strsplit (entry->only_show_in, ";", -1);
+      show = g_strv_contains ((const gchar *const *) envs, environment);
+      g_strfreev (envs);
+    }
+
+  if (show && entry->not_show_in != NULL)
+    {
+      envs = g_strsplit (entry->not_show_in, ";", -1);
+      show = !g_strv_contains ((const gchar *const *) envs, environment);
+      g_strfreev (envs);
+    }
+
+  return show;
+}
+
+
+
+/**
+ * launcher_desktop_index_get:
+ *
+ * Returns a new reference to the desktop-id index shared by all the
+ * launchers in the process. The index is loaded from the cache when
+ * none of the applications directories changed, and scanned otherwise.
+ **/
+LauncherDesktopIndex *
+launcher_desktop_index_get (void)
+{
+  if (shared_index != NULL)
+    return g_object_ref (shared_index);
+
+  shared_index = g_object_new (LAUNCHER_TYPE_DESKTOP_INDEX, NULL);
+  g_object_add_weak_pointer (G_OBJECT (shared_index), (gpointer *) &shared_index);
+
+  return shared_index;
+}
+
+
+
+/**
+ * launcher_desktop_index_lookup:
+ *
+ * Returns the path of the desktop file for @desktop_id, or %NULL.
+ **/
+const gchar *
+launcher_desktop_index_lookup (LauncherDesktopIndex *desktop_index,
+                               const gchar *desktop_id)
+{
+  IndexEntry *entry;
+
+  panel_return_val_if_fail (LAUNCHER_IS_DESKTOP_INDEX (desktop_index), NULL);
+  panel_return_val_if_fail (desktop_id != NULL, NULL);
+
+  entry = g_hash_table_lookup (desktop_index->entries, desktop_id);
+  if (entry == NULL || PANEL_HAS_FLAG (entry->flags, ENTRY_HIDDEN))
+    return NULL;
+
+  return entry->path;
+}
+
+
+
+/**
+ * launcher_desktop_index_get_item:
+ *
+ * Returns a new reference to the menu item for @desktop_id, or %NULL.
+ * The items are only loaded when requested and kept until their file
+ * changes.
+ **/
+GarconMenuItem *
+launcher_desktop_index_get_item (LauncherDesktopIndex *desktop_index,
+                                 const gchar *desktop_id)
+{
+  IndexEntry *entry;
+
+  panel_return_val_if_fail (LAUNCHER_IS_DESKTOP_INDEX (desktop_index), NULL);
+  panel_return_val_if_fail (desktop_id != NULL, NULL);
+
+  entry = g_hash_table_lookup (desktop_index->entries, desktop_id);
+  if (entry == NULL || PANEL_HAS_FLAG (entry->flags, ENTRY_HIDDEN))
+    return NULL;
+
+  if (entry->item == NULL)
+    entry->item = garcon_menu_item_new_for_path (entry->path);
+
+  return entry->item != NULL ? g_object_ref (entry->item) : NULL;
+}
+
+
+
+/**
+ * launcher_desktop_index_foreach:
+ *
+ * Calls @func for every application that would be visible in the
+ * applications menu of the current environment.
+ **/
+void
+launcher_desktop_index_foreach (LauncherDesktopIndex *desktop_index,
+                                LauncherDesktopIndexFunc func,
+                                gpointer user_data)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  IndexEntry *entry;
+
+  panel_return_if_fail (LAUNCHER_IS_DESKTOP_INDEX (desktop_index));
+  panel_return_if_fail (func != NULL);
+
+  g_hash_table_iter_init (&iter, desktop_index->entries);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      entry = value;
+      if (entry->flags != 0 || !launcher_desktop_index_show_in (entry))
+        continue;
+
+      func (key, entry->name, entry->comment, entry->icon_name, user_data);
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __LAUNCHER_DESKTOP_INDEX_H__
+#define __LAUNCHER_DESKTOP_INDEX_H__
+
+#include <garcon/garcon.h>
+
+G_BEGIN_DECLS
+
+typedef void (*LauncherDesktopIndexFunc) (const gchar *desktop_id,
+                                          const gchar *name,
+                                          const gchar *comment,
+                                          const gchar *icon_name,
+                                          gpointer user_data);
+
+#define LAUNCHER_TYPE_DESKTOP_INDEX (launcher_desktop_index_get_type ())
+G_DECLARE_FINAL_TYPE (LauncherDesktopIndex, launcher_desktop_index, LAUNCHER, DESKTOP_INDEX, GObject)
+
+LauncherDesktopIndex *
+launcher_desktop_index_get (void);
+
+const gchar *
+launcher_desktop_index_lookup (LauncherDesktopIndex *desktop_index,
+                               const gchar *desktop_id);
+
+GarconMenuItem *
+launcher_desktop_index_get_item (LauncherDesktopIndex *desktop_index,
+                                 const gchar *desktop_id);
+
+void
+launcher_desktop_index_foreach (LauncherDesktopIndex *desktop_index,
+                                LauncherDesktopIndexFunc func,
+                                gpointer user_data);
+
+G_END_DECLS
+
+#endif /* !__LAUNCHER_DESKTOP_INDEX_H__ */
@@ -20,6 +20,7 @@
 #include "config.h"
 #endif
 
+#include "launcher-desktop-index.h"
 #include "launcher-dialog.h"
 #include "launcher-dialog_ui.h"
 
@@ -41,6 +42,7 @@ typedef struct
   GtkBuilder *builder;
   guint idle_populate_id;
   GSList *items;
+  LauncherDesktopIndex *desktop_index;
 } LauncherPluginDialog;
 
 typedef struct
@@ -55,11 +57,15 @@ enum
   COL_NAME,
   COL_ITEM,
   COL_TOOLTIP,
-  COL_SEARCH /* only in add-store */
+  COL_SEARCH, /* only in add-store */
+  COL_DESKTOP_ID /* only in add-store */
 };
 
 
 
+static gchar *
+launcher_dialog_item_markup (const gchar *name,
+                             const gchar *comment);
 static void
 launcher_dialog_items_set_item (GtkTreeModel *model,
                                 GtkTreeIter *iter,
@@ -169,19 +175,58 @@ launcher_dialog_add_visible_function (GtkTreeModel *model,
 
 
 static void
-launcher_dialog_add_store_insert (gpointer key,
-                                  gpointer value,
+launcher_dialog_add_store_insert (const gchar *desktop_id,
+                                  const gchar *name,
+                                  const gchar *comment,
+                                  const gchar *icon_name,
                                   gpointer user_data)
 {
+  LauncherPluginDialog *dialog = user_data;
+  GObject *store;
   GtkTreeIter iter;
-  GarconMenuItem *item = GARCON_MENU_ITEM (value);
-  GtkTreeModel *model = GTK_TREE_MODEL (user_data);
+  gchar *markup;
+  GIcon *icon;
+  gchar *tooltip;
 
-  panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
-  panel_return_if_fail (GTK_IS_LIST_STORE (model));
+  panel_return_if_fail (GTK_IS_BUILDER (dialog->builder));
+
+  /* the menu item is only loaded when the application is added */
+  markup = launcher_dialog_item_markup (name, comment);
+  icon = launcher_plugin_tooltip_icon (icon_name);
+  tooltip = g_filename_display_name (launcher_desktop_index_lookup (dialog->desktop_index, desktop_id));
+
+  store = gtk_builder_get_object (dialog->builder, "add-store");
+  gtk_list_store_insert_with_values (GTK_LIST_STORE (store), &iter, -1,
+                                     COL_ICON, icon,
+                                     COL_NAME, markup,
+                                     COL_TOOLTIP, tooltip,
+                                     COL_DESKTOP_ID, desktop_id,
+                                     -1);
 
-  gtk_list_store_append (GTK_LIST_STORE (model), &iter);
-  launcher_dialog_items_set_item (model, &iter, item, NULL);
+  if (G_LIKELY (icon != NULL))
+    g_object_unref (G_OBJECT (icon));
+  g_free (markup);
+  g_free (tooltip);
+}
+
+
+
+static GarconMenuItem *
+launcher_dialog_add_get_item (LauncherPluginDialog *dialog,
+                              GtkTreeModel *model,
+                              GtkTreeIter *iter)
+{
+  GarconMenuItem *item;
+  gchar *desktop_id;
+
+  gtk_tree_model_get (model, iter, COL_DESKTOP_ID, &desktop_id, -1);
+  if (G_UNLIKELY (desktop_id == NULL))
+    return NULL;
+
+  item = launcher_desktop_index_get_item (dialog->desktop_index, desktop_id);
+  g_free (desktop_id);
+
+  return item;
 }
 
 
@@ -190,19 +235,15 @@ static gboolean
 launcher_dialog_add_populate_model_idle (gpointer user_data)
 {
   LauncherPluginDialog *dialog = user_data;
-  GObject *store;
-  GHashTable *pool;
 
   panel_return_val_if_fail (GTK_IS_BUILDER (dialog->builder), FALSE);
 
-  /* load the item pool */
-  pool = launcher_plugin_garcon_menu_pool ();
+  /* the index is kept while the dialog is open */
+  if (dialog->desktop_index == NULL)
+    dialog->desktop_index = launcher_desktop_index_get ();
 
-  /* insert the items in the store */
-  store = gtk_builder_get_object (dialog->builder, "add-store");
-  g_hash_table_foreach (pool, launcher_dialog_add_store_insert, store);
-
-  g_hash_table_destroy (pool);
+  /* insert the applications in the store */
+  launcher_desktop_index_foreach (dialog->desktop_index, launcher_dialog_add_store_insert, dialog);
 
   return FALSE;
 }
@@ -268,7 +309,7 @@ launcher_dialog_add_drag_data_get (GtkWidget *treeview,
       if (!gtk_tree_model_get_iter (model, &iter, li->data))
         continue;
 
-      gtk_tree_model_get (model, &iter, COL_ITEM, &item, -1);
+      item = launcher_dialog_add_get_item (dialog, model, &iter);
       if (G_UNLIKELY (item == NULL))
         continue;
 
@@ -373,7 +414,7 @@ launcher_dialog_add_response (GtkWidget *widget,
         {
           /* get the selected file in the add dialog */
           gtk_tree_model_get_iter (add_model, &tmp, li->data);
-          gtk_tree_model_get (add_model, &tmp, COL_ITEM, &item, -1);
+          item = launcher_dialog_add_get_item (dialog, add_model, &tmp);
 
           /* insert the item in the item store */
           if (G_LIKELY (item != NULL))
@@ -948,6 +989,9 @@ launcher_dialog_response (GtkWidget *widget,
       /* destroy the dialog */
       gtk_widget_destroy (widget);
 
+      if (dialog->desktop_index != NULL)
+        g_object_unref (G_OBJECT (dialog->desktop_index));
+
       g_slice_free (LauncherPluginDialog, dialog);
     }
 }
@@ -1025,13 +1069,24 @@ launcher_dialog_tree_row_changed (GtkTreeModel *model,
 
 
 
+static gchar *
+launcher_dialog_item_markup (const gchar *name,
+                             const gchar *comment)
+{
+  if (!xfce_str_is_empty (comment))
+    return g_markup_printf_escaped ("<b>%s</b>\n%s", name, comment);
+  else
+    return g_markup_printf_escaped ("<b>%s</b>", name);
+}
+
+
+
 static void
 launcher_dialog_items_set_item (GtkTreeModel *model,
                                 GtkTreeIter *iter,
                                 GarconMenuItem *item,
                                 LauncherPluginDialog *dialog)
 {
-  const gchar *name, *comment;
   gchar *markup;
   GIcon *icon;
   gchar *tooltip;
@@ -1040,13 +1095,8 @@ launcher_dialog_items_set_item (GtkTreeModel *model,
   panel_return_if_fail (GTK_IS_LIST_STORE (model));
   panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
 
-  name = garcon_menu_item_get_name (item);
-  comment = garcon_menu_item_get_comment (item);
-
-  if (!xfce_str_is_empty (comment))
-    markup = g_markup_printf_escaped ("<b>%s</b>\n%s", name, comment);
-  else
-    markup = g_markup_printf_escaped ("<b>%s</b>", name);
+  markup = launcher_dialog_item_markup (garcon_menu_item_get_name (item),
+                                        garcon_menu_item_get_comment (item));
 
   icon = launcher_plugin_tooltip_icon (garcon_menu_item_get_icon_name (item));
 
@@ -1160,7 +1210,8 @@ launcher_dialog_show (LauncherPlugin *plugin)
                               "mi-application", "mi-link", "mi-add",
                               "mi-move-up", "mi-move-down" };
   const gchar *binding_names[] = { "disable-tooltips", "show-label",
-                                   "move-first", "arrow-position" };
+                                   "move-first", "arrow-position",
+                                   "prefetch" };
 
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
 
@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "launcher-prefetch.h"
+
+#include "common/panel-private.h"
+
+#include <fcntl.h>
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <libxfce4util/libxfce4util.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_LINK_H
+#include <link.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+/* seconds to wait after the items changed before the idle prefetch */
+#define PREFETCH_DELAY (30)
+
+/* seconds after which the page cache might have dropped a prefetched
+ * program, so hovering the button advises the kernel again */
+#define PREFETCH_EXPIRE (600)
+
+/* limits on the libraries followed and the ELF data read per file */
+#define PREFETCH_MAX_DEPTH (8)
+#define PREFETCH_MAX_PHDRS (64)
+#define PREFETCH_MAX_DYNAMIC (64 * 1024)
+#define PREFETCH_MAX_STRTAB (1024 * 1024)
+
+
+
+typedef struct
+{
+  /* programs to prefetch, as written in the Exec key */
+  GPtrArray *programs;
+
+  /* library search path and the libraries already mapped by the panel */
+  GPtrArray *lib_dirs;
+  GHashTable *loaded;
+
+  /* files advised in this job */
+  GHashTable *visited;
+  guint n_files;
+  guint64 n_bytes;
+
+  gint64 start;
+} PrefetchJob;
+
+struct _LauncherPrefetch
+{
+  GObject __parent__;
+
+  /* weak pointer, for the statistics */
+  XfcePanelPlugin *plugin;
+
+  /* program -> time of the last prefetch in seconds, 0 while it runs */
+  GHashTable *programs;
+
+  /* programs waiting for the idle prefetch */
+  GPtrArray *scheduled;
+  guint schedule_id;
+};
+
+
+
+static void
+launcher_prefetch_finalize (GObject *object);
+static void
+launcher_prefetch_file (PrefetchJob *job,
+                        const gchar *path,
+                        guint depth);
+
+
+
+G_DEFINE_FINAL_TYPE (LauncherPrefetch, launcher_prefetch, G_TYPE_OBJECT)
+
+
+
+static void
+launcher_prefetch_class_init (LauncherPrefetchClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = launcher_prefetch_finalize;
+}
+
+
+
+static void
+launcher_prefetch_init (LauncherPrefetch *prefetch)
+{
+  prefetch->programs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+
+
+static void
+launcher_prefetch_finalize (GObject *object)
+{
+  LauncherPrefetch *prefetch = LAUNCHER_PREFETCH (object);
+
+  if (prefetch->schedule_id != 0)
+    g_source_remove (prefetch->schedule_id);
+  if (prefetch->scheduled != NULL)
+    g_ptr_array_unref (prefetch->scheduled);
+
+  if (prefetch->plugin != NULL)
+    g_object_remove_weak_pointer (G_OBJECT (prefetch->plugin), (gpointer *) &prefetch->plugin);
+
+  g_hash_table_destroy (prefetch->programs);
+
+  G_OBJECT_CLASS (launcher_prefetch_parent_class)->finalize (object);
+}
+
+
+
+static guint
+launcher_prefetch_now (void)
+{
+  /* monotonic seconds, never 0 so it can be stored in the hash table */
+  return g_get_monotonic_time () / G_USEC_PER_SEC + 1;
+}
+
+
+
+static void
+launcher_prefetch_job_free (gpointer data)
+{
+  PrefetchJob *job = data;
+
+  g_ptr_array_unref (job->programs);
+  g_ptr_array_unref (job->lib_dirs);
+  g_hash_table_destroy (job->loaded);
+  g_hash_table_destroy (job->visited);
+  g_slice_free (PrefetchJob, job);
+}
+
+
+
+static void
+launcher_prefetch_add_lib_dir (PrefetchJob *job,
+                               const gchar *dir)
+{
+  guint i;
+
+  if (xfce_str_is_empty (dir))
+    return;
+
+  for (i = 0; i < job->lib_dirs->len; i++)
+    if (g_strcmp0 (g_ptr_array_index (job->lib_dirs, i), dir) == 0)
+      return;
+
+  g_ptr_array_add (job->lib_dirs, g_strdup (dir));
+}
+
+
+
+#ifdef HAVE_LINK_H
+static gint
+launcher_prefetch_loaded_cb (struct dl_phdr_info *info,
+                             gsize size,
+                             gpointer data)
+{
+  PrefetchJob *job = data;
+  gchar *dir;
+
+  if (info->dlpi_name == NULL || !g_path_is_absolute (info->dlpi_name))
+    return 0;
+
+  /* the panel has these mapped, so they are in the page cache already,
+   * and their directories are a good guess for the library path */
+  g_hash_table_add (job->loaded, g_path_get_basename (info->dlpi_name));
+  dir = g_path_get_dirname (info->dlpi_name);
+  launcher_prefetch_add_lib_dir (job, dir);
+  g_free (dir);
+
+  return 0;
+}
+
+
+
+static gboolean
+launcher_prefetch_library_in (PrefetchJob *job,
+                              const gchar *dir,
+                              const gchar *origin,
+                              const gchar *name,
+                              guint depth)
+{
+  gchar *expanded = NULL;
+  gchar *path;
+  gchar **parts;
+  gboolean found;
+
+  /* the dynamic linker replaces $ORIGIN by the directory of the object */
+  if (strstr (dir, "ORIGIN") != NULL)
+    {
+      parts = g_strsplit (dir, "${ORIGIN}", -1);
+      expanded = g_strjoinv (origin, parts);
+      g_strfreev (parts);
+      parts = g_strsplit (expanded, "$ORIGIN", -1);
+      g_free (expanded);
+      expanded = g_strjoinv (origin, parts);
+      g_strfreev (parts);
+      dir = expanded;
+    }
+
+  path = g_build_filename (dir, name, NULL);
+  found = g_file_test (path, G_FILE_TEST_IS_REGULAR);
+  if (found)
+    launcher_prefetch_file (job, path, depth);
+
+  g_free (path);
+  g_free (expanded);
+
+  return found;
+}
+
+
+
+static void
+launcher_prefetch_library (PrefetchJob *job,
+                           const gchar *name,
+                           const gchar *search_path,
+                           const gchar *origin,
+                           guint depth)
+{
+  gchar **dirs;
+  guint i;
+  gboolean found = FALSE;
+
+  if (strchr (name, G_DIR_SEPARATOR) != NULL)
+    {
+      launcher_prefetch_file (job, name, depth);
+      return;
+    }
+
+  if (g_hash_table_contains (job->loaded, name))
+    return;
+
+  if (search_path != NULL)
+    {
+      dirs = g_strsplit (search_path, G_SEARCHPATH_SEPARATOR_S, -1);
+      for (i = 0; !found && dirs[i] != NULL; i++)
+        if (*dirs[i] != '\0')
+          found = launcher_prefetch_library_in (job, dirs[i], origin, name, depth);
+      g_strfreev (dirs);
+    }
+
+  for (i = 0; !found && i < job->lib_dirs->len; i++)
+    found = launcher_prefetch_library_in (job, g_ptr_array_index (job->lib_dirs, i),
+                                          origin, name, depth);
+}
+
+
+
+static gboolean
+launcher_prefetch_read (gint fd,
+                        gpointer buf,
+                        gsize count,
+                        gsize offset)
+{
+  return pread (fd, buf, count, offset) == (gssize) count;
+}
+
+
+
+static void
+launcher_prefetch_elf (PrefetchJob *job,
+                       gint fd,
+                       const gchar *path,
+                       guint depth)
+{
+  ElfW (Ehdr) ehdr;
+  ElfW (Phdr) *phdrs = NULL, *dynamic = NULL;
+  ElfW (Dyn) *dyn = NULL;
+  ElfW (Addr) strtab_addr = 0;
+  gsize strtab_size = 0, strtab_offset = 0, n_dyn, i, offset;
+  gboolean strtab_found = FALSE;
+  gchar *strtab = NULL, *origin;
+  const gchar *search_path = NULL;
+  GArray *needed;
+
+  /* only objects the dynamic linker of this architecture could load */
+  if (!launcher_prefetch_read (fd, &ehdr, sizeof (ehdr), 0)
+      || ehdr.e_ident[EI_CLASS] != (sizeof (gpointer) == 8 ? ELFCLASS64 : ELFCLASS32)
+      || ehdr.e_ident[EI_DATA] != (G_BYTE_ORDER == G_LITTLE_ENDIAN ? ELFDATA2LSB : ELFDATA2MSB)
+      || ehdr.e_phentsize != sizeof (ElfW (Phdr))
+      || ehdr.e_phnum == 0 || ehdr.e_phnum > PREFETCH_MAX_PHDRS)
+    return;
+
+  phdrs = g_new (ElfW (Phdr), ehdr.e_phnum);
+  if (!launcher_prefetch_read (fd, phdrs, ehdr.e_phnum * sizeof (ElfW (Phdr)), ehdr.e_phoff))
+    goto out;
+
+  for (i = 0; i < ehdr.e_phnum; i++)
+    if (phdrs[i].p_type == PT_DYNAMIC)
+      dynamic = &phdrs[i];
+
+  if (dynamic == NULL
+      || dynamic->p_filesz == 0
+      || dynamic->p_filesz > PREFETCH_MAX_DYNAMIC)
+    goto out;
+
+  n_dyn = dynamic->p_filesz / sizeof (ElfW (Dyn));
+  dyn = g_new (ElfW (Dyn), n_dyn);
+  if (!launcher_prefetch_read (fd, dyn, n_dyn * sizeof (ElfW (Dyn)), dynamic->p_offset))
+    goto out;
+
+  needed = g_array_new (FALSE, FALSE, sizeof (gsize));
+  for (i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++)
+    {
+      if (dyn[i].d_tag == DT_NEEDED)
+        {
+          offset = dyn[i].d_un.d_val;
+          g_array_append_val (needed, offset);
+        }
+      else if (dyn[i].d_tag == DT_STRTAB)
+        strtab_addr = dyn[i].d_un.d_ptr;
+      else if (dyn[i].d_tag == DT_STRSZ)
+        strtab_size = dyn[i].d_un.d_val;
+    }
+
+  /* the string table is addressed in memory, find it in the file */
+  for (i = 0; i < ehdr.e_phnum; i++)
+    if (phdrs[i].p_type == PT_LOAD
+        && strtab_addr >= phdrs[i].p_vaddr
+        && strtab_addr + strtab_size <= phdrs[i].p_vaddr + phdrs[i].p_filesz)
+      {
+        strtab_offset = strtab_addr - phdrs[i].p_vaddr + phdrs[i].p_offset;
+        strtab_found = TRUE;
+        break;
+      }
+
+  if (strtab_found && strtab_size > 0 && strtab_size <= PREFETCH_MAX_STRTAB)
+    {
+      strtab = g_malloc (strtab_size + 1);
+      if (launcher_prefetch_read (fd, strtab, strtab_size, strtab_offset))
+        {
+          strtab[strtab_size] = '\0';
+
+          /* DT_RUNPATH takes precedence over the deprecated DT_RPATH */
+          for (i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++)
+            if ((dyn[i].d_tag == DT_RUNPATH || (dyn[i].d_tag == DT_RPATH && search_path == NULL))
+                && dyn[i].d_un.d_val < strtab_size)
+              search_path = strtab + dyn[i].d_un.d_val;
+
+          origin = g_path_get_dirname (path);
+          for (i = 0; i < needed->len; i++)
+            if (g_array_index (needed, gsize, i) < strtab_size)
+              launcher_prefetch_library (job, strtab + g_array_index (needed, gsize, i),
+                                         search_path, origin, depth + 1);
+          g_free (origin);
+        }
+    }
+
+  g_array_free (needed, TRUE);
+
+out:
+  g_free (strtab);
+  g_free (dyn);
+  g_free (phdrs);
+}
+#endif
+
+
+
+static void
+launcher_prefetch_script (PrefetchJob *job,
+                          gchar *header,
+                          guint depth)
+{
+  gchar **argv;
+  gchar *interpreter = NULL;
+  gchar *end;
+
+  /* the interpreter of a script, possibly behind "/usr/bin/env" */
+  end = strchr (header, '\n');
+  if (end == NULL)
+    return;
+  *end = '\0';
+
+  argv = g_strsplit_set (g_strstrip (header + 2), " \t", 3);
+  if (argv[0] == NULL)
+    {
+      g_strfreev (argv);
+      return;
+    }
+
+  if (g_str_has_suffix (argv[0], "/env") && argv[1] != NULL)
+    {
+      launcher_prefetch_file (job, argv[0], depth + 1);
+      interpreter = g_find_program_in_path (argv[1]);
+    }
+  else
+    {
+      interpreter = g_strdup (argv[0]);
+    }
+
+  if (interpreter != NULL)
+    launcher_prefetch_file (job, interpreter, depth + 1);
+
+  g_free (interpreter);
+  g_strfreev (argv);
+}
+
+
+
+static void
+launcher_prefetch_file (PrefetchJob *job,
+                        const gchar *path,
+                        guint depth)
+{
+  struct stat st;
+  gchar header[256];
+  gssize n;
+  gint fd;
+
+  if (depth > PREFETCH_MAX_DEPTH
+      || !g_hash_table_add (job->visited, g_strdup (path)))
+    return;
+
+  fd = g_open (path, O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0)
+    return;
+
+  if (fstat (fd, &st) == 0 && S_ISREG (st.st_mode))
+    {
+#ifdef HAVE_POSIX_FADVISE
+      /* ask the kernel to read the file in the background */
+      if (posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED) == 0)
+        {
+          job->n_files++;
+          job->n_bytes += st.st_size;
+        }
+#endif
+
+      n = pread (fd, header, sizeof (header) - 1, 0);
+      if (n > 2 && header[0] == '#' && header[1] == '!')
+        {
+          header[n] = '\0';
+          launcher_prefetch_script (job, header, depth);
+        }
+#ifdef HAVE_LINK_H
+      else if (n >= SELFMAG && memcmp (header, ELFMAG, SELFMAG) == 0)
+        {
+          launcher_prefetch_elf (job, fd, path, depth);
+        }
+#endif
+    }
+
+  close (fd);
+}
+
+
+
+static void
+launcher_prefetch_thread (GTask *task,
+                          gpointer source_object,
+                          gpointer task_data,
+                          GCancellable *cancellable)
+{
+  PrefetchJob *job = task_data;
+  const gchar *env;
+  gchar **dirs;
+  gchar *path;
+  guint i;
+
+  /* same order as the dynamic linker, except for its cache */
+  env = g_getenv ("LD_LIBRARY_PATH");
+  if (env != NULL)
+    {
+      dirs = g_strsplit (env, G_SEARCHPATH_SEPARATOR_S, -1);
+      for (i = 0; dirs[i] != NULL; i++)
+        launcher_prefetch_add_lib_dir (job, dirs[i]);
+      g_strfreev (dirs);
+    }
+
+#ifdef HAVE_LINK_H
+  dl_iterate_phdr (launcher_prefetch_loaded_cb, job);
+#endif
+
+  launcher_prefetch_add_lib_dir (job, "/lib");
+  launcher_prefetch_add_lib_dir (job, "/usr/lib");
+  launcher_prefetch_add_lib_dir (job, "/usr/local/lib");
+
+  for (i = 0; i < job->programs->len; i++)
+    {
+      path = g_find_program_in_path (g_ptr_array_index (job->programs, i));
+      if (path != NULL)
+        launcher_prefetch_file (job, path, 0);
+      g_free (path);
+    }
+
+  g_task_return_boolean (task, TRUE);
+}
+
+
+
+static void
+launcher_prefetch_finished (GObject *source_object,
+                            GAsyncResult *result,
+                            gpointer user_data)
+{
+  LauncherPrefetch *prefetch = LAUNCHER_PREFETCH (source_object);
+  PrefetchJob *job = g_task_get_task_data (G_TASK (result));
+  guint now = launcher_prefetch_now ();
+  guint i;
+
+  if (!g_task_propagate_boolean (G_TASK (result), NULL))
+    return;
+
+  for (i = 0; i < job->programs->len; i++)
+    g_hash_table_insert (prefetch->programs, g_strdup (g_ptr_array_index (job->programs, i)),
+                         GUINT_TO_POINTER (now));
+
+  if (prefetch->plugin != NULL)
+    {
+      xfce_panel_plugin_stats_timer_stop (prefetch->plugin, "prefetch", job->start);
+      xfce_panel_plugin_stats_record (prefetch->plugin, "prefetch-files", job->n_files);
+      xfce_panel_plugin_stats_record (prefetch->plugin, "prefetch-kib", job->n_bytes / 1024);
+    }
+}
+
+
+
+static gchar *
+launcher_prefetch_program (GarconMenuItem *item)
+{
+  const gchar *command;
+  gchar **argv;
+  gchar *program = NULL;
+  guint i = 0;
+
+  command = garcon_menu_item_get_command (item);
+  if (xfce_str_is_empty (command)
+      || !g_shell_parse_argv (command, NULL, &argv, NULL))
+    return NULL;
+
+  /* skip the "env NAME=VALUE" wrapper used by some desktop files */
+  if (g_strcmp0 (argv[0], "env") == 0)
+    for (i = 1; argv[i] != NULL && (*argv[i] == '-' || strchr (argv[i], '=') != NULL); i++)
+      ;
+
+  if (argv[i] != NULL && *argv[i] != '%')
+    program = g_strdup (argv[i]);
+
+  g_strfreev (argv);
+
+  return program;
+}
+
+
+
+static void
+launcher_prefetch_programs (LauncherPrefetch *prefetch,
+                            GPtrArray *programs)
+{
+  PrefetchJob *job;
+  GTask *task;
+  gpointer value;
+  guint now = launcher_prefetch_now ();
+  const gchar *program;
+  guint i;
+
+  job = g_slice_new0 (PrefetchJob);
+  job->programs = g_ptr_array_new_with_free_func (g_free);
+  job->lib_dirs = g_ptr_array_new_with_free_func (g_free);
+  job->loaded = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  job->visited = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  /* skip programs being prefetched or prefetched recently */
+  for (i = 0; i < programs->len; i++)
+    {
+      program = g_ptr_array_index (programs, i);
+      if (g_hash_table_lookup_extended (prefetch->programs, program, NULL, &value)
+          && (value == NULL || now - GPOINTER_TO_UINT (value) < PREFETCH_EXPIRE))
+        continue;
+
+      g_hash_table_insert (prefetch->programs, g_strdup (program), NULL);
+      g_ptr_array_add (job->programs, g_strdup (program));
+    }
+
+  if (job->programs->len == 0)
+    {
+      launcher_prefetch_job_free (job);
+      return;
+    }
+
+  if (prefetch->plugin != NULL)
+    job->start = xfce_panel_plugin_stats_timer_start (prefetch->plugin);
+
+  task = g_task_new (prefetch, NULL, launcher_prefetch_finished, NULL);
+  g_task_set_task_data (task, job, launcher_prefetch_job_free);
+  g_task_set_priority (task, G_PRIORITY_LOW);
+  g_task_run_in_thread (task, launcher_prefetch_thread);
+  g_object_unref (task);
+}
+
+
+
+static GPtrArray *
+launcher_prefetch_items_programs (GSList *items)
+{
+  GPtrArray *programs;
+  gchar *program;
+  GSList *li;
+
+  programs = g_ptr_array_new_with_free_func (g_free);
+  for (li = items; li != NULL; li = li->next)
+    {
+      program = launcher_prefetch_program (GARCON_MENU_ITEM (li->data));
+      if (program != NULL)
+        g_ptr_array_add (programs, program);
+    }
+
+  return programs;
+}
+
+
+
+static gboolean
+launcher_prefetch_schedule_timeout (gpointer user_data)
+{
+  LauncherPrefetch *prefetch = LAUNCHER_PREFETCH (user_data);
+
+  prefetch->schedule_id = 0;
+
+  launcher_prefetch_programs (prefetch, prefetch->scheduled);
+  g_ptr_array_unref (prefetch->scheduled);
+  prefetch->scheduled = NULL;
+
+  return FALSE;
+}
+
+
+
+LauncherPrefetch *
+launcher_prefetch_new (XfcePanelPlugin *plugin)
+{
+  LauncherPrefetch *prefetch;
+
+  panel_return_val_if_fail (XFCE_IS_PANEL_PLUGIN (plugin), NULL);
+
+  prefetch = g_object_new (LAUNCHER_TYPE_PREFETCH, NULL);
+  prefetch->plugin = plugin;
+  g_object_add_weak_pointer (G_OBJECT (plugin), (gpointer *) &prefetch->plugin);
+
+  return prefetch;
+}
+
+
+
+/**
+ * launcher_prefetch_schedule:
+ * @prefetch : a #LauncherPrefetch.
+ * @items    : list of #GarconMenuItem.
+ *
+ * Prefetch the programs of @items once the panel is idle, replacing the
+ * items of an earlier call that did not run yet.
+ **/
+void
+launcher_prefetch_schedule (LauncherPrefetch *prefetch,
+                            GSList *items)
+{
+  panel_return_if_fail (LAUNCHER_IS_PREFETCH (prefetch));
+
+  if (prefetch->scheduled != NULL)
+    g_ptr_array_unref (prefetch->scheduled);
+  prefetch->scheduled = launcher_prefetch_items_programs (items);
+
+  if (prefetch->schedule_id == 0)
+    prefetch->schedule_id = g_timeout_add_seconds_full (G_PRIORITY_LOW, PREFETCH_DELAY,
+                                                        launcher_prefetch_schedule_timeout,
+                                                        prefetch, NULL);
+}
+
+
+
+/**
+ * launcher_prefetch_items:
+ * @prefetch : a #LauncherPrefetch.
+ * @items    : list of #GarconMenuItem.
+ *
+ * Prefetch the programs of @items and their libraries right away, unless
+ * this was done recently. The files are read by the kernel in the
+ * background, so this can be used when the pointer enters the button.
+ **/
+void
+launcher_prefetch_items (LauncherPrefetch *prefetch,
+                         GSList *items)
+{
+  GPtrArray *programs;
+
+  panel_return_if_fail (LAUNCHER_IS_PREFETCH (prefetch));
+
+  programs = launcher_prefetch_items_programs (items);
+  launcher_prefetch_programs (prefetch, programs);
+  g_ptr_array_unref (programs);
+}
+
+
+
+/**
+ * launcher_prefetch_launched:
+ * @prefetch : a #LauncherPrefetch.
+ * @item     : the #GarconMenuItem that is going to be executed.
+ *
+ * Count whether the program of @item was prefetched in time.
+ **/
+void
+launcher_prefetch_launched (LauncherPrefetch *prefetch,
+                            GarconMenuItem *item)
+{
+  gchar *program;
+  gpointer value;
+  gboolean hit;
+
+  panel_return_if_fail (LAUNCHER_IS_PREFETCH (prefetch));
+  panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
+
+  if (prefetch->plugin == NULL)
+    return;
+
+  program = launcher_prefetch_program (item);
+  if (program == NULL)
+    return;
+
+  value = g_hash_table_lookup (prefetch->programs, program);
+  hit = value != NULL && launcher_prefetch_now () - GPOINTER_TO_UINT (value) < PREFETCH_EXPIRE;
+  xfce_panel_plugin_stats_add (prefetch->plugin, hit ? "prefetch-hits" : "prefetch-misses", 1);
+
+  g_free (program);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __LAUNCHER_PREFETCH_H__
+#define __LAUNCHER_PREFETCH_H__
+
+#include <garcon/garcon.h>
+#include <libxfce4panel/libxfce4panel.h>
+
+G_BEGIN_DECLS
+
+#define LAUNCHER_TYPE_PREFETCH (launcher_prefetch_get_type ())
+G_DECLARE_FINAL_TYPE (LauncherPrefetch, launcher_prefetch, LAUNCHER, PREFETCH, GObject)
+
+LauncherPrefetch *
+launcher_prefetch_new (XfcePanelPlugin *plugin) G_GNUC_MALLOC;
+
+void
+launcher_prefetch_schedule (LauncherPrefetch *prefetch,
+                            GSList *items);
+
+void
+launcher_prefetch_items (LauncherPrefetch *prefetch,
+                         GSList *items);
+
+void
+launcher_prefetch_launched (LauncherPrefetch *prefetch,
+                            GarconMenuItem *item);
+
+G_END_DECLS
+
+#endif /* !__LAUNCHER_PREFETCH_H__ */
@@ -20,7 +20,9 @@
 #include "config.h"
 #endif
 
+#include "launcher-desktop-index.h"
 #include "launcher-dialog.h"
+#include "launcher-prefetch.h"
 #include "launcher.h"
 
 #include "common/panel-private.h"
@@ -34,6 +36,8 @@
 
 #define ARROW_BUTTON_SIZE (12)
 #define MENU_POPUP_DELAY (225)
+#define CONFIG_MONITOR_DELAY (250) /* ms to collect config monitor events */
+#define MENU_RELEASE_TIMEOUT (300) /* s before an unused menu is released */
 #define NO_ARROW_INSIDE_BUTTON(plugin) ((plugin)->arrow_position != LAUNCHER_ARROW_INTERNAL \
                                         || LIST_HAS_ONE_OR_NO_ENTRIES ((plugin)->items))
 #define ARROW_INSIDE_BUTTON(plugin) (!NO_ARROW_INSIDE_BUTTON (plugin))
@@ -61,10 +65,8 @@ static gboolean
 launcher_plugin_remote_event (XfcePanelPlugin *panel_plugin,
                               const gchar *name,
                               const GValue *value);
-static gboolean
-launcher_plugin_save_delayed_timeout (gpointer user_data);
 static void
-launcher_plugin_save_delayed (LauncherPlugin *plugin);
+launcher_plugin_save (XfcePanelPlugin *panel_plugin);
 static void
 launcher_plugin_mode_changed (XfcePanelPlugin *panel_plugin,
                               XfcePanelPluginMode mode);
@@ -80,10 +82,20 @@ static LauncherArrowType
 launcher_plugin_default_arrow_type (LauncherPlugin *plugin);
 static void
 launcher_plugin_pack_widgets (LauncherPlugin *plugin);
+static gchar *
+launcher_plugin_icon_file_source (const gchar *filename);
+static GdkPixbuf *
+launcher_plugin_pixbuf_from_file (const gchar *filename,
+                                  gint icon_size,
+                                  gint scale_factor);
 static void
 launcher_plugin_tooltip_icon_invalidate (GObject *object);
 static void
 launcher_plugin_icon_invalidate (LauncherPlugin *plugin);
+static gboolean
+launcher_plugin_menu_release (gpointer user_data);
+static void
+launcher_plugin_menu_release_destroyed (gpointer user_data);
 static void
 launcher_plugin_menu_deactivate (GtkWidget *menu,
                                  LauncherPlugin *plugin);
@@ -102,6 +114,17 @@ launcher_plugin_menu_item_drag_data_received (GtkWidget *widget,
 static void
 launcher_plugin_menu_construct (LauncherPlugin *plugin);
 static void
+launcher_plugin_menu_item_update (LauncherPlugin *plugin,
+                                  GtkWidget *mi,
+                                  GarconMenuItem *item);
+static void
+launcher_plugin_menu_item_insert (LauncherPlugin *plugin,
+                                  GarconMenuItem *item);
+static void
+launcher_plugin_menu_sync (LauncherPlugin *plugin);
+static void
+launcher_plugin_menu_icons_update (LauncherPlugin *plugin);
+static void
 launcher_plugin_menu_popup_destroyed (gpointer user_data);
 static gboolean
 launcher_plugin_menu_popup (gpointer user_data);
@@ -124,6 +147,10 @@ launcher_plugin_button_release_event (GtkWidget *button,
                                       GdkEventButton *event,
                                       LauncherPlugin *plugin);
 static gboolean
+launcher_plugin_button_enter_notify_event (GtkWidget *button,
+                                           GdkEventCrossing *event,
+                                           LauncherPlugin *plugin);
+static gboolean
 launcher_plugin_button_query_tooltip (GtkWidget *widget,
                                       gint x,
                                       gint y,
@@ -169,6 +196,10 @@ launcher_plugin_arrow_press_event (GtkWidget *button,
                                    GdkEventButton *event,
                                    LauncherPlugin *plugin);
 static gboolean
+launcher_plugin_arrow_enter_notify_event (GtkWidget *button,
+                                          GdkEventCrossing *event,
+                                          LauncherPlugin *plugin);
+static gboolean
 launcher_plugin_arrow_drag_motion (GtkWidget *widget,
                                    GdkDragContext *context,
                                    gint x,
@@ -203,6 +234,8 @@ launcher_plugin_item_exec_from_clipboard (GarconMenuItem *item,
                                           GdkScreen *screen);
 static GSList *
 launcher_plugin_uri_list_extract (GtkSelectionData *data);
+static void
+launcher_plugin_prefetch_schedule (LauncherPlugin *plugin);
 
 
 
@@ -217,8 +250,20 @@ struct _LauncherPlugin
   GtkWidget *menu;
   GtkWidget *action_menu;
 
+  /* item -> menu item in the menu, while the menu exists */
+  GHashTable *menu_items;
+  GCancellable *menu_cancellable;
+  gint menu_icon_size;
+
+  /* seconds an unused menu is kept around, 0 to keep it */
+  guint menu_release_timeout;
+  guint menu_release_timeout_id;
+
   GSList *items;
 
+  /* file -> item, for the lookups of the config monitor */
+  GHashTable *items_by_file;
+
   cairo_surface_t *surface;
   gchar *icon_name;
 
@@ -234,9 +279,23 @@ struct _LauncherPlugin
   GFile *config_directory;
   GFileMonitor *config_monitor;
 
-  guint save_timeout_id;
+  /* files reported by the monitor, handled in one batch */
+  GHashTable *changed_files;
+  guint changed_files_timeout_id;
+
+  /* page cache prefetch of the programs, NULL when disabled */
+  LauncherPrefetch *prefetch;
 };
 
+/* icon file of a menu item, loaded in a thread */
+typedef struct
+{
+  gchar *filename;
+  gint icon_size;
+  gint scale_factor;
+}
+LauncherIconFile;
+
 enum
 {
   PROP_0,
@@ -244,7 +303,9 @@ enum
   PROP_DISABLE_TOOLTIPS,
   PROP_MOVE_FIRST,
   PROP_SHOW_LABEL,
-  PROP_ARROW_POSITION
+  PROP_ARROW_POSITION,
+  PROP_PREFETCH,
+  PROP_MENU_RELEASE_TIMEOUT
 };
 
 enum
@@ -293,6 +354,7 @@ launcher_plugin_class_init (LauncherPluginClass *klass)
   plugin_class->configure_plugin = launcher_plugin_configure_plugin;
   plugin_class->screen_position_changed = launcher_plugin_screen_position_changed;
   plugin_class->removed = launcher_plugin_removed;
+  plugin_class->save = launcher_plugin_save;
   plugin_class->remote_event = launcher_plugin_remote_event;
 
   g_object_class_install_property (gobject_class,
@@ -332,6 +394,21 @@ launcher_plugin_class_init (LauncherPluginClass *klass)
                                                       LAUNCHER_ARROW_DEFAULT,
                                                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class,
+                                   PROP_PREFETCH,
+                                   g_param_spec_boolean ("prefetch",
+                                                         NULL, NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_MENU_RELEASE_TIMEOUT,
+                                   g_param_spec_uint ("menu-release-timeout",
+                                                      NULL, NULL,
+                                                      0, G_MAXUINT,
+                                                      MENU_RELEASE_TIMEOUT,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   launcher_signals[ITEMS_CHANGED] = g_signal_new (g_intern_static_string ("items-changed"),
                                                   G_TYPE_FROM_CLASS (klass),
                                                   G_SIGNAL_RUN_FIRST,
@@ -359,11 +436,16 @@ launcher_plugin_init (LauncherPlugin *plugin)
   plugin->menu = NULL;
   plugin->action_menu = NULL;
   plugin->items = NULL;
+  plugin->items_by_file = g_hash_table_new_full (g_file_hash, (GEqualFunc) g_file_equal,
+                                                 g_object_unref, NULL);
+  plugin->changed_files = g_hash_table_new_full (g_file_hash, (GEqualFunc) g_file_equal,
+                                                 g_object_unref, NULL);
   plugin->child = NULL;
   plugin->surface = NULL;
   plugin->icon_name = NULL;
   plugin->menu_timeout_id = 0;
-  plugin->save_timeout_id = 0;
+  plugin->menu_release_timeout = MENU_RELEASE_TIMEOUT;
+  plugin->prefetch = NULL;
 
   /* create the panel widgets */
   plugin->box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
@@ -378,6 +460,8 @@ launcher_plugin_init (LauncherPlugin *plugin)
                     G_CALLBACK (launcher_plugin_button_press_event), plugin);
   g_signal_connect (G_OBJECT (plugin->button), "button-release-event",
                     G_CALLBACK (launcher_plugin_button_release_event), plugin);
+  g_signal_connect (G_OBJECT (plugin->button), "enter-notify-event",
+                    G_CALLBACK (launcher_plugin_button_enter_notify_event), plugin);
   g_signal_connect (G_OBJECT (plugin->button), "query-tooltip",
                     G_CALLBACK (launcher_plugin_button_query_tooltip), plugin);
   g_signal_connect (G_OBJECT (plugin->button), "drag-data-received",
@@ -398,7 +482,9 @@ launcher_plugin_init (LauncherPlugin *plugin)
   g_signal_connect (plugin, "notify::scale-factor",
                     G_CALLBACK (launcher_plugin_icon_invalidate), NULL);
   g_signal_connect (plugin, "notify::scale-factor",
-                    G_CALLBACK (launcher_plugin_menu_destroy), NULL);
+                    G_CALLBACK (launcher_plugin_menu_icons_update), NULL);
+  g_signal_connect_object (gtk_icon_theme_get_default (), "changed",
+                           G_CALLBACK (launcher_plugin_menu_icons_update), plugin, G_CONNECT_SWAPPED);
 
   /* Make sure there aren't any constraints set on buttons by themes (Adwaita sets those minimum sizes) */
   context = gtk_widget_get_style_context (plugin->button);
@@ -421,6 +507,8 @@ launcher_plugin_init (LauncherPlugin *plugin)
   gtk_widget_set_name (plugin->button, "launcher-arrow");
   g_signal_connect (G_OBJECT (plugin->arrow), "button-press-event",
                     G_CALLBACK (launcher_plugin_arrow_press_event), plugin);
+  g_signal_connect (G_OBJECT (plugin->arrow), "enter-notify-event",
+                    G_CALLBACK (launcher_plugin_arrow_enter_notify_event), plugin);
   g_signal_connect (G_OBJECT (plugin->arrow), "drag-motion",
                     G_CALLBACK (launcher_plugin_arrow_drag_motion), plugin);
   g_signal_connect (G_OBJECT (plugin->button), "drag-drop",
@@ -504,6 +592,14 @@ launcher_plugin_get_property (GObject *object,
       g_value_set_uint (value, plugin->arrow_position);
       break;
 
+    case PROP_PREFETCH:
+      g_value_set_boolean (value, plugin->prefetch != NULL);
+      break;
+
+    case PROP_MENU_RELEASE_TIMEOUT:
+      g_value_set_uint (value, plugin->menu_release_timeout);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -517,6 +613,7 @@ launcher_plugin_item_changed (GarconMenuItem *item,
                               LauncherPlugin *plugin)
 {
   GSList *li;
+  GtkWidget *mi;
 
   panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
@@ -525,14 +622,22 @@ launcher_plugin_item_changed (GarconMenuItem *item,
   li = g_slist_find (plugin->items, item);
   if (G_LIKELY (li != NULL))
     {
-      /* update the button or destroy the menu */
+      /* update the button and the menu item of this item */
       if (plugin->items == li)
         {
           launcher_plugin_button_update (plugin);
           launcher_plugin_button_update_action_menu (plugin);
         }
-      else
-        launcher_plugin_menu_destroy (plugin);
+
+      if (plugin->menu != NULL)
+        {
+          mi = g_hash_table_lookup (plugin->menu_items, item);
+          if (mi != NULL)
+            launcher_plugin_menu_item_update (plugin, mi, item);
+        }
+
+      /* the command might have changed */
+      launcher_plugin_prefetch_schedule (plugin);
     }
   else
     {
@@ -591,7 +696,6 @@ launcher_plugin_item_load (LauncherPlugin *plugin,
 {
   GFile *src_file, *dst_file;
   gchar *src_path, *dst_path;
-  GSList *li, *lnext;
   GarconMenuItem *item = NULL;
   GError *error = NULL;
 
@@ -664,16 +768,13 @@ launcher_plugin_item_load (LauncherPlugin *plugin,
 
   /* maybe we have this file in the launcher configuration, then we don't
    * have to load it again from the harddisk */
-  for (li = plugin->items; item == NULL && li != NULL; li = lnext)
+  item = g_hash_table_lookup (plugin->items_by_file, src_file);
+  if (item != NULL)
     {
-      lnext = li->next;
-      dst_file = garcon_menu_item_get_file (GARCON_MENU_ITEM (li->data));
-      if (g_file_equal (src_file, dst_file))
-        {
-          item = GARCON_MENU_ITEM (li->data);
-          plugin->items = g_slist_delete_link (plugin->items, li);
-        }
-      g_object_unref (G_OBJECT (dst_file));
+      g_hash_table_remove (plugin->items_by_file, src_file);
+      plugin->items = g_slist_remove (plugin->items, item);
+      g_signal_handlers_disconnect_by_func (G_OBJECT (item),
+                                            G_CALLBACK (launcher_plugin_item_changed), plugin);
     }
 
   /* load the file from the disk */
@@ -717,6 +818,23 @@ launcher_plugin_items_delete_configs (LauncherPlugin *plugin)
 
 
 
+static void
+launcher_plugin_items_free (LauncherPlugin *plugin)
+{
+  GSList *li;
+
+  /* the items might be shared with the desktop-id index */
+  for (li = plugin->items; li != NULL; li = li->next)
+    g_signal_handlers_disconnect_by_func (G_OBJECT (li->data),
+                                          G_CALLBACK (launcher_plugin_item_changed), plugin);
+
+  g_slist_free_full (plugin->items, (GDestroyNotify) g_object_unref);
+  plugin->items = NULL;
+  g_hash_table_remove_all (plugin->items_by_file);
+}
+
+
+
 static void
 launcher_plugin_items_load (LauncherPlugin *plugin,
                             GPtrArray *array)
@@ -725,9 +843,9 @@ launcher_plugin_items_load (LauncherPlugin *plugin,
   const GValue *value;
   const gchar *str;
   GarconMenuItem *item;
-  GarconMenuItem *pool_item;
-  GSList *items = NULL;
-  GHashTable *pool = NULL;
+  GSList *items = NULL, *li;
+  LauncherDesktopIndex *desktop_index = NULL;
+  const gchar *path;
   gboolean desktop_id;
   gchar *uri;
   gboolean items_modified = FALSE;
@@ -753,32 +871,32 @@ launcher_plugin_items_load (LauncherPlugin *plugin,
       if (G_LIKELY (item == NULL))
         {
           /* str did not look like a desktop-id, so no need to look
-           * for it in the application pool */
+           * for it in the desktop-id index */
           if (!desktop_id)
             continue;
 
-          /* we are going to load an desktop_id from the item pool,
+          /* we are going to load an desktop_id from the index,
            * even if this failes, save the new item list, so we don't
            * try this again in the future */
           items_modified = TRUE;
 
-          /* load the pool with desktop items */
-          if (pool == NULL)
-            pool = launcher_plugin_garcon_menu_pool ();
+          if (desktop_index == NULL)
+            desktop_index = launcher_desktop_index_get ();
 
-          /* lookup the item in the item pool */
-          pool_item = g_hash_table_lookup (pool, str);
-          if (pool_item != NULL)
+          /* lookup the desktop file in the index */
+          path = launcher_desktop_index_lookup (desktop_index, str);
+          if (path != NULL)
             {
               /* we want an editable file, so try to make a copy */
-              uri = garcon_menu_item_get_uri (pool_item);
-              item = launcher_plugin_item_load (plugin, uri, NULL, NULL);
+              uri = g_filename_to_uri (path, NULL, NULL);
+              if (uri != NULL)
+                item = launcher_plugin_item_load (plugin, uri, NULL, NULL);
               g_free (uri);
 
-              /* if something failed, use the pool item, but this one
+              /* if something failed, use the indexed item, but this one
                * won't be editable in the dialog */
               if (G_UNLIKELY (item == NULL))
-                item = GARCON_MENU_ITEM (g_object_ref (G_OBJECT (pool_item)));
+                item = launcher_desktop_index_get_item (desktop_index, str);
             }
 
           /* skip this item if still not found */
@@ -797,19 +915,21 @@ launcher_plugin_items_load (LauncherPlugin *plugin,
                         G_CALLBACK (launcher_plugin_item_changed), plugin);
     }
 
-  if (G_UNLIKELY (pool != NULL))
-    g_hash_table_destroy (pool);
+  if (G_UNLIKELY (desktop_index != NULL))
+    g_object_unref (G_OBJECT (desktop_index));
 
   /* remove config files of items not in the new config */
   launcher_plugin_items_delete_configs (plugin);
 
   /* release the old menu items and set new one */
-  g_slist_free_full (plugin->items, (GDestroyNotify) g_object_unref);
+  launcher_plugin_items_free (plugin);
   plugin->items = items;
+  for (li = items; li != NULL; li = li->next)
+    g_hash_table_insert (plugin->items_by_file, garcon_menu_item_get_file (li->data), li->data);
 
   /* store the new item list */
   if (items_modified)
-    launcher_plugin_save_delayed (plugin);
+    xfce_panel_plugin_queue_save (XFCE_PANEL_PLUGIN (plugin));
 }
 
 
@@ -825,9 +945,6 @@ launcher_plugin_set_property (GObject *object,
 
   panel_return_if_fail (G_IS_FILE (plugin->config_directory));
 
-  /* destroy the menu, all the setting changes need this */
-  launcher_plugin_menu_destroy (plugin);
-
   switch (prop_id)
     {
     case PROP_ITEMS:
@@ -840,8 +957,7 @@ launcher_plugin_set_property (GObject *object,
       else
         {
           launcher_plugin_items_delete_configs (plugin);
-          g_slist_free_full (plugin->items, (GDestroyNotify) g_object_unref);
-          plugin->items = NULL;
+          launcher_plugin_items_free (plugin);
         }
 
       /* emit signal */
@@ -851,6 +967,8 @@ launcher_plugin_set_property (GObject *object,
       launcher_plugin_button_update (plugin);
       launcher_plugin_button_update_action_menu (plugin);
 
+      launcher_plugin_prefetch_schedule (plugin);
+
       /* update the widget packing */
       goto update_arrow;
       break;
@@ -858,6 +976,9 @@ launcher_plugin_set_property (GObject *object,
     case PROP_DISABLE_TOOLTIPS:
       plugin->disable_tooltips = g_value_get_boolean (value);
       gtk_widget_set_has_tooltip (plugin->button, !plugin->disable_tooltips);
+
+      /* the tooltips are connected when the menu items are created */
+      launcher_plugin_menu_destroy (plugin);
       break;
 
     case PROP_MOVE_FIRST:
@@ -887,6 +1008,26 @@ launcher_plugin_set_property (GObject *object,
       launcher_plugin_button_update (plugin);
       break;
 
+    case PROP_PREFETCH:
+      if (g_value_get_boolean (value) == (plugin->prefetch != NULL))
+        break;
+
+      if (plugin->prefetch != NULL)
+        {
+          g_object_unref (G_OBJECT (plugin->prefetch));
+          plugin->prefetch = NULL;
+        }
+      else
+        {
+          plugin->prefetch = launcher_prefetch_new (XFCE_PANEL_PLUGIN (plugin));
+          launcher_plugin_prefetch_schedule (plugin);
+        }
+      break;
+
+    case PROP_MENU_RELEASE_TIMEOUT:
+      plugin->menu_release_timeout = g_value_get_uint (value);
+      break;
+
     case PROP_ARROW_POSITION:
       plugin->arrow_position = g_value_get_uint (value);
 
@@ -897,6 +1038,9 @@ update_arrow:
       /* repack the widgets */
       launcher_plugin_pack_widgets (plugin);
 
+      /* the first item is not in the menu when the arrow is visible */
+      launcher_plugin_menu_sync (plugin);
+
       /* update the plugin size */
       launcher_plugin_size_changed (XFCE_PANEL_PLUGIN (plugin),
                                     xfce_panel_plugin_get_size (XFCE_PANEL_PLUGIN (plugin)));
@@ -910,95 +1054,134 @@ update_arrow:
 
 
 
-static void
-launcher_plugin_file_changed (GFileMonitor *monitor,
-                              GFile *changed_file,
-                              GFile *other_file,
-                              GFileMonitorEvent event_type,
-                              LauncherPlugin *plugin)
+static gboolean
+launcher_plugin_file_changed_timeout (gpointer user_data)
 {
-  GSList *li, *lnext;
+  LauncherPlugin *plugin = LAUNCHER_PLUGIN (user_data);
+  GHashTableIter iter;
+  GFile *changed_file;
   GarconMenuItem *item;
-  GFile *item_file;
-  gboolean found;
+  GarconMenuItem *first_item;
   GError *error = NULL;
-  gchar *base_name;
-  gboolean result;
-  gboolean exists;
   gboolean update_plugin = FALSE;
 
-  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
-  panel_return_if_fail (plugin->config_monitor == monitor);
-
-  /* waited until all events are proccessed */
-  if (event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT
-      && event_type != G_FILE_MONITOR_EVENT_DELETED
-      && event_type != G_FILE_MONITOR_EVENT_CREATED)
-    return;
-
-  /* we only act on desktop files */
-  base_name = g_file_get_basename (changed_file);
-  result = g_str_has_suffix (base_name, ".desktop");
-  g_free (base_name);
-  if (!result)
-    return;
+  panel_return_val_if_fail (LAUNCHER_IS_PLUGIN (plugin), FALSE);
 
-  exists = g_file_query_exists (changed_file, NULL);
+  first_item = plugin->items != NULL ? plugin->items->data : NULL;
 
-  /* lookup the file in the menu items */
-  for (li = plugin->items, found = FALSE; !found && li != NULL; li = lnext)
+  g_hash_table_iter_init (&iter, plugin->changed_files);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &changed_file, NULL))
     {
-      lnext = li->next;
-      item = GARCON_MENU_ITEM (li->data);
-      item_file = garcon_menu_item_get_file (item);
-      found = g_file_equal (changed_file, item_file);
-      if (found)
+      item = g_hash_table_lookup (plugin->items_by_file, changed_file);
+
+      if (g_file_query_exists (changed_file, NULL))
         {
-          if (exists)
+          if (item != NULL)
             {
-              /* reload the file */
+              /* reload the file, the changed signal updates the widgets */
               if (!garcon_menu_item_reload (item, NULL, &error))
                 {
                   g_critical ("Failed to reload menu item: %s", error->message);
-                  g_error_free (error);
+                  g_clear_error (&error);
                 }
             }
           else
             {
-              /* remove from the list */
-              plugin->items = g_slist_delete_link (plugin->items, li);
-              g_object_unref (G_OBJECT (item));
-              update_plugin = TRUE;
+              /* add the new file to the config */
+              item = garcon_menu_item_new (changed_file);
+              if (G_LIKELY (item != NULL))
+                {
+                  plugin->items = g_slist_append (plugin->items, item);
+                  g_hash_table_insert (plugin->items_by_file, g_object_ref (changed_file), item);
+                  g_signal_connect (G_OBJECT (item), "changed",
+                                    G_CALLBACK (launcher_plugin_item_changed), plugin);
+                  update_plugin = TRUE;
+                }
             }
         }
-      g_object_unref (G_OBJECT (item_file));
-    }
-
-  if (!found && exists)
-    {
-      /* add the new file to the config */
-      item = garcon_menu_item_new (changed_file);
-      if (G_LIKELY (item != NULL))
+      else if (item != NULL)
         {
-          plugin->items = g_slist_append (plugin->items, item);
-          g_signal_connect (G_OBJECT (item), "changed",
-                            G_CALLBACK (launcher_plugin_item_changed), plugin);
+          /* remove from the list */
+          g_signal_handlers_disconnect_by_func (G_OBJECT (item),
+                                                G_CALLBACK (launcher_plugin_item_changed), plugin);
+          g_hash_table_remove (plugin->items_by_file, changed_file);
+          plugin->items = g_slist_remove (plugin->items, item);
+          g_object_unref (G_OBJECT (item));
           update_plugin = TRUE;
         }
+
+      g_hash_table_iter_remove (&iter);
     }
 
   if (update_plugin)
     {
-      launcher_plugin_button_update (plugin);
-      launcher_plugin_menu_destroy (plugin);
-      launcher_plugin_button_update_action_menu (plugin);
+      /* the button shows the first item */
+      if (first_item != (plugin->items != NULL ? plugin->items->data : NULL))
+        {
+          launcher_plugin_button_update (plugin);
+          launcher_plugin_button_update_action_menu (plugin);
+        }
+
+      launcher_plugin_menu_sync (plugin);
+
+      launcher_plugin_prefetch_schedule (plugin);
 
       /* save the new config */
-      launcher_plugin_save_delayed (plugin);
+      xfce_panel_plugin_queue_save (XFCE_PANEL_PLUGIN (plugin));
 
       /* update the dialog */
       g_signal_emit (G_OBJECT (plugin), launcher_signals[ITEMS_CHANGED], 0);
     }
+
+  return FALSE;
+}
+
+
+
+static void
+launcher_plugin_file_changed_timeout_destroyed (gpointer user_data)
+{
+  LAUNCHER_PLUGIN (user_data)->changed_files_timeout_id = 0;
+}
+
+
+
+static void
+launcher_plugin_file_changed (GFileMonitor *monitor,
+                              GFile *changed_file,
+                              GFile *other_file,
+                              GFileMonitorEvent event_type,
+                              LauncherPlugin *plugin)
+{
+  gchar *base_name;
+  gboolean result;
+
+  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
+  panel_return_if_fail (plugin->config_monitor == monitor);
+
+  /* waited until all events are proccessed */
+  if (event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT
+      && event_type != G_FILE_MONITOR_EVENT_DELETED
+      && event_type != G_FILE_MONITOR_EVENT_CREATED)
+    return;
+
+  /* we only act on desktop files */
+  base_name = g_file_get_basename (changed_file);
+  result = g_str_has_suffix (base_name, ".desktop");
+  g_free (base_name);
+  if (!result)
+    return;
+
+  /* editors and the dialog touch a file several times in a row, so
+   * collect the events and handle each file once */
+  g_hash_table_add (plugin->changed_files, g_object_ref (changed_file));
+  if (plugin->changed_files_timeout_id == 0)
+    {
+      plugin->changed_files_timeout_id =
+        g_timeout_add_full (G_PRIORITY_DEFAULT_IDLE, CONFIG_MONITOR_DELAY,
+                            launcher_plugin_file_changed_timeout, plugin,
+                            launcher_plugin_file_changed_timeout_destroyed);
+    }
 }
 
 
@@ -1019,6 +1202,8 @@ launcher_plugin_construct (XfcePanelPlugin *panel_plugin)
     { "disable-tooltips", G_TYPE_BOOLEAN },
     { "move-first", G_TYPE_BOOLEAN },
     { "arrow-position", G_TYPE_UINT },
+    { "prefetch", G_TYPE_BOOLEAN },
+    { "menu-release-timeout", G_TYPE_UINT },
     { NULL }
   };
 
@@ -1105,16 +1290,18 @@ launcher_plugin_free_data (XfcePanelPlugin *panel_plugin)
       g_object_unref (G_OBJECT (plugin->config_monitor));
     }
 
-  if (plugin->save_timeout_id != 0)
-    {
-      g_source_remove (plugin->save_timeout_id);
-      launcher_plugin_save_delayed_timeout (plugin);
-    }
+  if (plugin->changed_files_timeout_id != 0)
+    g_source_remove (plugin->changed_files_timeout_id);
+  g_hash_table_destroy (plugin->changed_files);
 
   /* destroy the menu and timeout */
   launcher_plugin_menu_destroy (plugin);
 
-  g_slist_free_full (plugin->items, (GDestroyNotify) g_object_unref);
+  launcher_plugin_items_free (plugin);
+  g_hash_table_destroy (plugin->items_by_file);
+
+  if (plugin->prefetch != NULL)
+    g_object_unref (G_OBJECT (plugin->prefetch));
 
   if (plugin->config_directory != NULL)
     g_object_unref (G_OBJECT (plugin->config_directory));
@@ -1202,33 +1389,10 @@ launcher_plugin_remote_event (XfcePanelPlugin *panel_plugin,
 
 
 static void
-launcher_plugin_save_delayed_timeout_destroyed (gpointer user_data)
-{
-  LAUNCHER_PLUGIN (user_data)->save_timeout_id = 0;
-}
-
-
-
-static gboolean
-launcher_plugin_save_delayed_timeout (gpointer user_data)
+launcher_plugin_save (XfcePanelPlugin *panel_plugin)
 {
   /* make sure the items are stored */
-  g_object_notify (G_OBJECT (user_data), "items");
-
-  return FALSE;
-}
-
-
-
-static void
-launcher_plugin_save_delayed (LauncherPlugin *plugin)
-{
-  if (plugin->save_timeout_id != 0)
-    g_source_remove (plugin->save_timeout_id);
-
-  plugin->save_timeout_id = gdk_threads_add_timeout_seconds_full (G_PRIORITY_LOW, 1,
-                                                                  launcher_plugin_save_delayed_timeout, plugin,
-                                                                  launcher_plugin_save_delayed_timeout_destroyed);
+  g_object_notify (G_OBJECT (panel_plugin), "items");
 }
 
 
@@ -1323,10 +1487,7 @@ launcher_plugin_size_changed (XfcePanelPlugin *panel_plugin,
           cairo_surface_destroy (plugin->surface);
           plugin->surface = NULL;
           scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
-          pixbuf = gdk_pixbuf_new_from_file_at_size (plugin->icon_name,
-                                                     icon_size * scale_factor,
-                                                     icon_size * scale_factor,
-                                                     NULL);
+          pixbuf = launcher_plugin_pixbuf_from_file (plugin->icon_name, icon_size, scale_factor);
           if (pixbuf != NULL)
             {
               plugin->surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
@@ -1340,8 +1501,10 @@ launcher_plugin_size_changed (XfcePanelPlugin *panel_plugin,
         gtk_image_set_pixel_size (GTK_IMAGE (plugin->child), icon_size);
     }
 
-  /* destroy the menu to update its size */
-  launcher_plugin_menu_destroy (plugin);
+  /* reload the menu icons at the new size */
+  if (plugin->menu != NULL
+      && plugin->menu_icon_size != xfce_panel_plugin_get_icon_size (panel_plugin))
+    launcher_plugin_menu_icons_update (plugin);
 
   return TRUE;
 }
@@ -1367,8 +1530,8 @@ launcher_plugin_screen_position_changed (XfcePanelPlugin *panel_plugin,
   xfce_arrow_button_set_arrow_type (XFCE_ARROW_BUTTON (plugin->arrow),
                                     xfce_panel_plugin_arrow_type (panel_plugin));
 
-  /* destroy the menu to update sort order */
-  launcher_plugin_menu_destroy (plugin);
+  /* update the sort order of the menu */
+  launcher_plugin_menu_sync (plugin);
 }
 
 
@@ -1457,6 +1620,15 @@ launcher_plugin_menu_deactivate (GtkWidget *menu,
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
   panel_return_if_fail (plugin->menu == menu);
 
+  /* release the menu when it is not used for a while */
+  if (plugin->menu_release_timeout > 0 && plugin->menu_release_timeout_id == 0)
+    {
+      plugin->menu_release_timeout_id =
+        g_timeout_add_seconds_full (G_PRIORITY_LOW, plugin->menu_release_timeout,
+                                    launcher_plugin_menu_release, plugin,
+                                    launcher_plugin_menu_release_destroyed);
+    }
+
   /* deactivate the arrow button */
   if (plugin->arrow_position != LAUNCHER_ARROW_INTERNAL)
     {
@@ -1505,6 +1677,9 @@ launcher_plugin_menu_item_activate (GtkMenuItem *widget,
   plugin = g_object_get_qdata (G_OBJECT (widget), launcher_plugin_quark);
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
 
+  if (plugin->prefetch != NULL)
+    launcher_prefetch_launched (plugin->prefetch, item);
+
   /* move the item to the first position if enabled */
   if (G_UNLIKELY (plugin->move_first))
     {
@@ -1512,8 +1687,8 @@ launcher_plugin_menu_item_activate (GtkMenuItem *widget,
       plugin->items = g_slist_remove (plugin->items, item);
       plugin->items = g_slist_prepend (plugin->items, item);
 
-      /* destroy the menu and update the icon */
-      launcher_plugin_menu_destroy (plugin);
+      /* update the menu and the icon */
+      launcher_plugin_menu_sync (plugin);
       launcher_plugin_button_update (plugin);
     }
 }
@@ -1574,111 +1749,353 @@ launcher_plugin_menu_item_drag_data_received (GtkWidget *widget,
 
 
 static void
-launcher_plugin_menu_construct (LauncherPlugin *plugin)
+launcher_plugin_menu_icon_set (GtkWidget *image,
+                               GdkPixbuf *pixbuf)
 {
-  GtkArrowType arrow_type;
-  guint n;
-  GarconMenuItem *item;
-  GtkWidget *mi, *box, *label, *image;
+  cairo_surface_t *surface;
+
+  surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, gtk_widget_get_scale_factor (image), NULL);
+  gtk_image_set_from_surface (GTK_IMAGE (image), surface);
+  cairo_surface_destroy (surface);
+}
+
+
+
+static void
+launcher_plugin_menu_icon_loaded (GObject *source_object,
+                                  GAsyncResult *result,
+                                  gpointer user_data)
+{
+  GtkWidget *image = GTK_WIDGET (user_data);
+  GdkPixbuf *pixbuf;
+
+  pixbuf = gtk_icon_info_load_icon_finish (GTK_ICON_INFO (source_object), result, NULL);
+  if (pixbuf != NULL)
+    {
+      launcher_plugin_menu_icon_set (image, pixbuf);
+      g_object_unref (pixbuf);
+    }
+
+  g_object_unref (image);
+}
+
+
+
+static void
+launcher_plugin_menu_icon_file_free (gpointer data)
+{
+  LauncherIconFile *icon_file = data;
+
+  g_free (icon_file->filename);
+  g_slice_free (LauncherIconFile, icon_file);
+}
+
+
+
+static void
+launcher_plugin_menu_icon_file_thread (GTask *task,
+                                       gpointer source_object,
+                                       gpointer task_data,
+                                       GCancellable *cancellable)
+{
+  LauncherIconFile *icon_file = task_data;
   GdkPixbuf *pixbuf;
+  GError *error = NULL;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  pixbuf = gdk_pixbuf_new_from_file_at_size (icon_file->filename,
+                                             icon_file->icon_size * icon_file->scale_factor,
+                                             icon_file->icon_size * icon_file->scale_factor,
+                                             &error);
+  if (pixbuf != NULL)
+    g_task_return_pointer (task, pixbuf, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
+
+
+
+static void
+launcher_plugin_menu_icon_file_loaded (GObject *source_object,
+                                       GAsyncResult *result,
+                                       gpointer user_data)
+{
+  LauncherIconFile *icon_file = g_task_get_task_data (G_TASK (result));
+  GdkPixbuf *pixbuf;
+  gchar *source;
+
+  pixbuf = g_task_propagate_pointer (G_TASK (result), NULL);
+  if (pixbuf != NULL)
+    {
+      /* the icon cache is not thread safe, so insert it here */
+      source = launcher_plugin_icon_file_source (icon_file->filename);
+      xfce_panel_icon_cache_insert (source, NULL, icon_file->icon_size,
+                                    icon_file->icon_size, icon_file->scale_factor, pixbuf);
+      g_free (source);
+
+      launcher_plugin_menu_icon_set (GTK_WIDGET (source_object), pixbuf);
+      g_object_unref (pixbuf);
+    }
+}
+
+
+
+static void
+launcher_plugin_menu_icon_load (LauncherPlugin *plugin,
+                                GtkWidget *image,
+                                const gchar *icon_name)
+{
+  GtkIconInfo *info;
+  GdkPixbuf *pixbuf;
+  LauncherIconFile *icon_file;
+  GTask *task;
+  gint scale_factor;
+  gchar *source;
+
+  scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
+
+  if (g_path_is_absolute (icon_name))
+    {
+      /* use the decoded image if another launcher already loaded it */
+      source = launcher_plugin_icon_file_source (icon_name);
+      pixbuf = xfce_panel_icon_cache_lookup (source, NULL, plugin->menu_icon_size,
+                                             plugin->menu_icon_size, scale_factor);
+      g_free (source);
+      if (pixbuf != NULL)
+        {
+          launcher_plugin_menu_icon_set (image, pixbuf);
+          g_object_unref (pixbuf);
+          return;
+        }
+
+      icon_file = g_slice_new0 (LauncherIconFile);
+      icon_file->filename = g_strdup (icon_name);
+      icon_file->icon_size = plugin->menu_icon_size;
+      icon_file->scale_factor = scale_factor;
+
+      task = g_task_new (image, plugin->menu_cancellable, launcher_plugin_menu_icon_file_loaded, NULL);
+      g_task_set_task_data (task, icon_file, launcher_plugin_menu_icon_file_free);
+      g_task_run_in_thread (task, launcher_plugin_menu_icon_file_thread);
+      g_object_unref (task);
+    }
+  else
+    {
+      info = gtk_icon_theme_lookup_icon_for_scale (gtk_icon_theme_get_default (), icon_name,
+                                                   plugin->menu_icon_size, scale_factor,
+                                                   GTK_ICON_LOOKUP_FORCE_SIZE);
+      if (info != NULL)
+        {
+          gtk_icon_info_load_icon_async (info, plugin->menu_cancellable,
+                                         launcher_plugin_menu_icon_loaded, g_object_ref (image));
+          g_object_unref (info);
+        }
+    }
+}
+
+
+
+static void
+launcher_plugin_menu_item_update (LauncherPlugin *plugin,
+                                  GtkWidget *mi,
+                                  GarconMenuItem *item)
+{
+  GtkWidget *box, *label, *image, *child;
   const gchar *name, *icon_name;
+
+  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
+  panel_return_if_fail (GTK_IS_MENU_ITEM (mi));
+  panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
+
+  /* drop the old contents and the cached tooltip icon */
+  child = gtk_bin_get_child (GTK_BIN (mi));
+  if (child != NULL)
+    gtk_widget_destroy (child);
+  launcher_plugin_tooltip_icon_invalidate (G_OBJECT (mi));
+
+  name = garcon_menu_item_get_name (item);
+  label = gtk_label_new (xfce_str_is_empty (name) ? _("Unnamed Item") : name);
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0);
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 4);
+  gtk_box_pack_end (GTK_BOX (box), label, TRUE, TRUE, 0);
+  gtk_container_add (GTK_CONTAINER (mi), box);
+
+  /* start with an empty placeholder of the right size, the icon
+   * is loaded in the background so the menu pops up right away */
+  image = gtk_image_new_from_icon_name ("", GTK_ICON_SIZE_DND);
+  gtk_image_set_pixel_size (GTK_IMAGE (image), plugin->menu_icon_size);
+  gtk_widget_set_size_request (image, plugin->menu_icon_size, plugin->menu_icon_size);
+
+  icon_name = garcon_menu_item_get_icon_name (item);
+  if (!xfce_str_is_empty (icon_name))
+    launcher_plugin_menu_icon_load (plugin, image, icon_name);
+
+  gtk_box_pack_start (GTK_BOX (box), image, FALSE, TRUE, 3);
+  gtk_widget_show_all (box);
+}
+
+
+
+static void
+launcher_plugin_menu_item_insert (LauncherPlugin *plugin,
+                                  GarconMenuItem *item)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
+  panel_return_if_fail (GTK_IS_MENU (plugin->menu));
+  panel_return_if_fail (GARCON_IS_MENU_ITEM (item));
+
+  /* create the menu item */
+  mi = gtk_menu_item_new ();
+  launcher_plugin_menu_item_update (plugin, mi, item);
+  g_object_set_qdata (G_OBJECT (mi), launcher_plugin_quark, plugin);
+  gtk_widget_show (mi);
+  gtk_drag_dest_set (mi, GTK_DEST_DEFAULT_ALL, drop_targets,
+                     G_N_ELEMENTS (drop_targets), GDK_ACTION_COPY);
+  g_signal_connect (G_OBJECT (mi), "activate",
+                    G_CALLBACK (launcher_plugin_menu_item_activate), item);
+  g_signal_connect (G_OBJECT (mi), "drag-data-received",
+                    G_CALLBACK (launcher_plugin_menu_item_drag_data_received), item);
+  g_signal_connect (G_OBJECT (mi), "drag-leave",
+                    G_CALLBACK (launcher_plugin_arrow_drag_leave), plugin);
+
+  /* only connect the tooltip signal if tips are enabled */
+  if (!plugin->disable_tooltips)
+    {
+      gtk_widget_set_has_tooltip (mi, TRUE);
+      g_signal_connect (G_OBJECT (mi), "query-tooltip",
+                        G_CALLBACK (launcher_plugin_item_query_tooltip), item);
+
+      /* invalidate tooltip icon when needed */
+      g_signal_connect_object (gtk_icon_theme_get_default (), "changed",
+                               G_CALLBACK (launcher_plugin_tooltip_icon_invalidate), mi, G_CONNECT_SWAPPED);
+    }
+
+  /* the menu item keeps the item alive for its signal handlers */
+  gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), mi);
+  g_hash_table_insert (plugin->menu_items, g_object_ref (item), mi);
+}
+
+
+
+static void
+launcher_plugin_menu_sync (LauncherPlugin *plugin)
+{
+  GHashTableIter iter;
+  gpointer item, mi;
   GSList *li;
-  gint icon_size;
+  gboolean skip_first;
+  gboolean reversed;
+  gint position;
+
+  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
+
+  if (plugin->menu == NULL)
+    return;
+
+  /* skip the first entry when the arrow is visible */
+  skip_first = plugin->arrow_position != LAUNCHER_ARROW_INTERNAL;
+
+  /* remove the menu items of items that are no longer in the menu */
+  g_hash_table_iter_init (&iter, plugin->menu_items);
+  while (g_hash_table_iter_next (&iter, &item, &mi))
+    {
+      li = g_slist_find (plugin->items, item);
+      if (li == NULL || (skip_first && li == plugin->items))
+        {
+          gtk_widget_destroy (GTK_WIDGET (mi));
+          g_hash_table_iter_remove (&iter);
+        }
+    }
+
+  /* depending on the menu position the items are in reversed order */
+  reversed = xfce_arrow_button_get_arrow_type (XFCE_ARROW_BUTTON (plugin->arrow)) == GTK_ARROW_UP;
+
+  /* add the missing items and put everything in the order of the list */
+  for (li = skip_first && plugin->items != NULL ? plugin->items->next : plugin->items, position = 0;
+       li != NULL;
+       li = li->next, position++)
+    {
+      mi = g_hash_table_lookup (plugin->menu_items, li->data);
+      if (mi == NULL)
+        {
+          launcher_plugin_menu_item_insert (plugin, GARCON_MENU_ITEM (li->data));
+          mi = g_hash_table_lookup (plugin->menu_items, li->data);
+        }
+
+      gtk_menu_reorder_child (GTK_MENU (plugin->menu), GTK_WIDGET (mi),
+                              G_UNLIKELY (reversed) ? 0 : position);
+    }
+}
+
+
+
+static void
+launcher_plugin_menu_icons_update (LauncherPlugin *plugin)
+{
+  GHashTableIter iter;
+  gpointer item, mi;
 
+  panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
+
+  if (plugin->menu == NULL)
+    return;
+
+  /* forget the icons that are still loading at the old size */
+  g_cancellable_cancel (plugin->menu_cancellable);
+  g_object_unref (plugin->menu_cancellable);
+  plugin->menu_cancellable = g_cancellable_new ();
+
+  plugin->menu_icon_size = xfce_panel_plugin_get_icon_size (XFCE_PANEL_PLUGIN (plugin));
+
+  g_hash_table_iter_init (&iter, plugin->menu_items);
+  while (g_hash_table_iter_next (&iter, &item, &mi))
+    launcher_plugin_menu_item_update (plugin, GTK_WIDGET (mi), GARCON_MENU_ITEM (item));
+}
+
+
+
+static void
+launcher_plugin_menu_construct (LauncherPlugin *plugin)
+{
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
   panel_return_if_fail (plugin->menu == NULL);
 
-  icon_size = xfce_panel_plugin_get_icon_size (XFCE_PANEL_PLUGIN (plugin));
   /* create a new menu */
   plugin->menu = gtk_menu_new ();
+  plugin->menu_items = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+  plugin->menu_cancellable = g_cancellable_new ();
+  plugin->menu_icon_size = xfce_panel_plugin_get_icon_size (XFCE_PANEL_PLUGIN (plugin));
   gtk_menu_set_reserve_toggle_size (GTK_MENU (plugin->menu), FALSE);
   gtk_menu_attach_to_widget (GTK_MENU (plugin->menu), GTK_WIDGET (plugin), NULL);
   g_signal_connect (G_OBJECT (plugin->menu), "deactivate",
                     G_CALLBACK (launcher_plugin_menu_deactivate), plugin);
 
-  /* get the arrow type of the plugin */
-  arrow_type = xfce_arrow_button_get_arrow_type (XFCE_ARROW_BUTTON (plugin->arrow));
+  /* add the menu items */
+  launcher_plugin_menu_sync (plugin);
+}
 
-  /* walk through the menu entries */
-  for (li = plugin->items, n = 0; li != NULL; li = li->next, n++)
-    {
-      /* skip the first entry when the arrow is visible */
-      if (n == 0 && plugin->arrow_position != LAUNCHER_ARROW_INTERNAL)
-        continue;
 
-      /* get the item data */
-      item = GARCON_MENU_ITEM (li->data);
-
-      /* create the menu item */
-      name = garcon_menu_item_get_name (item);
-      mi = gtk_menu_item_new ();
-      label = gtk_label_new (xfce_str_is_empty (name) ? _("Unnamed Item") : name);
-      gtk_label_set_xalign (GTK_LABEL (label), 0.0);
-      box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 4);
-      gtk_box_pack_end (GTK_BOX (box), label, TRUE, TRUE, 0);
-      gtk_container_add (GTK_CONTAINER (mi), box);
-      g_object_set_qdata (G_OBJECT (mi), launcher_plugin_quark, plugin);
-      gtk_widget_show_all (mi);
-      gtk_drag_dest_set (mi, GTK_DEST_DEFAULT_ALL, drop_targets,
-                         G_N_ELEMENTS (drop_targets), GDK_ACTION_COPY);
-      g_signal_connect (G_OBJECT (mi), "activate",
-                        G_CALLBACK (launcher_plugin_menu_item_activate), item);
-      g_signal_connect (G_OBJECT (mi), "drag-data-received",
-                        G_CALLBACK (launcher_plugin_menu_item_drag_data_received), item);
-      g_signal_connect (G_OBJECT (mi), "drag-leave",
-                        G_CALLBACK (launcher_plugin_arrow_drag_leave), plugin);
-
-      /* only connect the tooltip signal if tips are enabled */
-      if (!plugin->disable_tooltips)
-        {
-          gtk_widget_set_has_tooltip (mi, TRUE);
-          g_signal_connect (G_OBJECT (mi), "query-tooltip",
-                            G_CALLBACK (launcher_plugin_item_query_tooltip), item);
 
-          /* invalidate tooltip icon when needed */
-          g_signal_connect_object (gtk_icon_theme_get_default (), "changed",
-                                   G_CALLBACK (launcher_plugin_tooltip_icon_invalidate), mi, G_CONNECT_SWAPPED);
-        }
+static gboolean
+launcher_plugin_menu_release (gpointer user_data)
+{
+  LauncherPlugin *plugin = LAUNCHER_PLUGIN (user_data);
 
-      /* depending on the menu position we prepend or append */
-      if (G_UNLIKELY (arrow_type == GTK_ARROW_UP))
-        gtk_menu_shell_prepend (GTK_MENU_SHELL (plugin->menu), mi);
-      else
-        gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), mi);
+  /* the menu is not visible, otherwise the timeout was removed */
+  launcher_plugin_menu_destroy (plugin);
 
-      /* set the icon if one is set */
-      icon_name = garcon_menu_item_get_icon_name (item);
+  return FALSE;
+}
 
-      if (xfce_str_is_empty (icon_name))
-        {
-          /* use an empty placeholder icon */
-          image = gtk_image_new_from_icon_name ("", GTK_ICON_SIZE_DND);
-        }
-      else if (g_path_is_absolute (icon_name))
-        {
-          gint scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
-          pixbuf = gdk_pixbuf_new_from_file_at_size (icon_name,
-                                                     icon_size * scale_factor,
-                                                     icon_size * scale_factor,
-                                                     NULL);
-          image = gtk_image_new_from_surface (NULL);
-          if (pixbuf != NULL)
-            {
-              cairo_surface_t *surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
-              gtk_image_set_from_surface (GTK_IMAGE (image), surface);
-              cairo_surface_destroy (surface);
-              g_object_unref (pixbuf);
-            }
-        }
-      else
-        {
-          image = gtk_image_new_from_icon_name (icon_name, GTK_ICON_SIZE_DND);
-        }
-      gtk_image_set_pixel_size (GTK_IMAGE (image), icon_size);
 
-      gtk_box_pack_start (GTK_BOX (box), image, FALSE, TRUE, 3);
-      gtk_widget_show (image);
-    }
+
+static void
+launcher_plugin_menu_release_destroyed (gpointer user_data)
+{
+  LAUNCHER_PLUGIN (user_data)->menu_release_timeout_id = 0;
 }
 
 
@@ -1703,6 +2120,8 @@ launcher_plugin_menu_popup (gpointer user_data)
   /* construct the menu if needed */
   if (plugin->menu == NULL)
     launcher_plugin_menu_construct (plugin);
+  else if (plugin->menu_release_timeout_id != 0)
+    g_source_remove (plugin->menu_release_timeout_id);
 
   /* toggle the arrow button */
   if (plugin->arrow_position != LAUNCHER_ARROW_INTERNAL)
@@ -1755,15 +2174,23 @@ launcher_plugin_menu_destroy (LauncherPlugin *plugin)
 {
   panel_return_if_fail (LAUNCHER_IS_PLUGIN (plugin));
 
-  /* stop pending timeout */
+  /* stop pending timeouts */
   if (plugin->menu_timeout_id != 0)
     g_source_remove (plugin->menu_timeout_id);
+  if (plugin->menu_release_timeout_id != 0)
+    g_source_remove (plugin->menu_release_timeout_id);
 
   if (plugin->menu != NULL)
     {
+      /* stop loading icons */
+      g_cancellable_cancel (plugin->menu_cancellable);
+      g_clear_object (&plugin->menu_cancellable);
+
       /* destroy the menu */
       gtk_widget_destroy (plugin->menu);
       plugin->menu = NULL;
+      g_hash_table_destroy (plugin->menu_items);
+      plugin->menu_items = NULL;
 
       /* deactivate the toggle button */
       if (plugin->arrow_position != LAUNCHER_ARROW_INTERNAL)
@@ -1832,10 +2259,7 @@ launcher_plugin_button_update (LauncherPlugin *plugin)
               g_free (plugin->icon_name);
               plugin->icon_name = g_strdup (icon_name);
               scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
-              pixbuf = gdk_pixbuf_new_from_file_at_size (icon_name,
-                                                         icon_size * scale_factor,
-                                                         icon_size * scale_factor,
-                                                         NULL);
+              pixbuf = launcher_plugin_pixbuf_from_file (icon_name, icon_size, scale_factor);
               if (pixbuf != NULL)
                 {
                   plugin->surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
@@ -1998,6 +2422,9 @@ launcher_plugin_button_release_event (GtkWidget *button,
   item = GARCON_MENU_ITEM (plugin->items->data);
   screen = gtk_widget_get_screen (button);
 
+  if (plugin->prefetch != NULL && (event->button == 1 || event->button == 2))
+    launcher_prefetch_launched (plugin->prefetch, item);
+
   /* launcher the entry */
   if (event->button == 1)
     launcher_plugin_item_exec (item, event->time, screen, NULL);
@@ -2011,6 +2438,28 @@ launcher_plugin_button_release_event (GtkWidget *button,
 
 
 
+static gboolean
+launcher_plugin_button_enter_notify_event (GtkWidget *button,
+                                           GdkEventCrossing *event,
+                                           LauncherPlugin *plugin)
+{
+  GSList fake;
+
+  panel_return_val_if_fail (LAUNCHER_IS_PLUGIN (plugin), FALSE);
+
+  /* a click is likely, so read the program of the button ahead */
+  if (plugin->prefetch != NULL && plugin->items != NULL)
+    {
+      fake.data = plugin->items->data;
+      fake.next = NULL;
+      launcher_prefetch_items (plugin->prefetch, &fake);
+    }
+
+  return FALSE;
+}
+
+
+
 static gboolean
 launcher_plugin_button_query_tooltip (GtkWidget *widget,
                                       gint x,
@@ -2276,6 +2725,22 @@ launcher_plugin_arrow_press_event (GtkWidget *button,
 
 
 
+static gboolean
+launcher_plugin_arrow_enter_notify_event (GtkWidget *button,
+                                          GdkEventCrossing *event,
+                                          LauncherPlugin *plugin)
+{
+  panel_return_val_if_fail (LAUNCHER_IS_PLUGIN (plugin), FALSE);
+
+  /* the menu is likely to be opened, read all the programs ahead */
+  if (plugin->prefetch != NULL)
+    launcher_prefetch_items (plugin->prefetch, plugin->items);
+
+  return FALSE;
+}
+
+
+
 static gboolean
 launcher_plugin_arrow_drag_motion (GtkWidget *widget,
                                    GdkDragContext *context,
@@ -2385,6 +2850,44 @@ launcher_plugin_arrow_drag_leave (GtkWidget *widget,
 
 
 
+static gchar *
+launcher_plugin_icon_file_source (const gchar *filename)
+{
+  /* icon files are scaled up to the icon size, unlike the pixbufs that
+   * xfce_panel_icon_cache_load() stores for the same path, so they get
+   * their own key in the shared cache */
+  return g_strconcat ("launcher-icon-file:", filename, NULL);
+}
+
+
+
+static GdkPixbuf *
+launcher_plugin_pixbuf_from_file (const gchar *filename,
+                                  gint icon_size,
+                                  gint scale_factor)
+{
+  GdkPixbuf *pixbuf;
+  gchar *source;
+
+  /* share the decoded image with the other launchers using it */
+  source = launcher_plugin_icon_file_source (filename);
+  pixbuf = xfce_panel_icon_cache_lookup (source, NULL, icon_size, icon_size, scale_factor);
+  if (pixbuf == NULL)
+    {
+      pixbuf = gdk_pixbuf_new_from_file_at_size (filename,
+                                                 icon_size * scale_factor,
+                                                 icon_size * scale_factor,
+                                                 NULL);
+      if (pixbuf != NULL)
+        xfce_panel_icon_cache_insert (source, NULL, icon_size, icon_size, scale_factor, pixbuf);
+    }
+  g_free (source);
+
+  return pixbuf;
+}
+
+
+
 static void
 launcher_plugin_tooltip_icon_invalidate (GObject *object)
 {
@@ -2642,6 +3145,15 @@ launcher_plugin_uri_list_extract (GtkSelectionData *data)
 
 
 
+static void
+launcher_plugin_prefetch_schedule (LauncherPlugin *plugin)
+{
+  if (plugin->prefetch != NULL)
+    launcher_prefetch_schedule (plugin->prefetch, plugin->items);
+}
+
+
+
 GSList *
 launcher_plugin_get_items (LauncherPlugin *plugin)
 {
@@ -2675,83 +3187,6 @@ launcher_plugin_unique_filename (LauncherPlugin *plugin)
 
 
 
-static void
-launcher_plugin_garcon_menu_pool_add (GarconMenu *menu,
-                                      GHashTable *pool)
-{
-  GList *li, *items;
-  GList *menus;
-  GarconMenuItem *item;
-  const gchar *desktop_id;
-
-  panel_return_if_fail (GARCON_IS_MENU (menu));
-
-  items = garcon_menu_get_items (menu);
-  for (li = items; li != NULL; li = li->next)
-    {
-      item = GARCON_MENU_ITEM (li->data);
-      panel_assert (GARCON_IS_MENU_ITEM (item));
-
-      /* skip invisible items */
-      if (!garcon_menu_element_get_visible (GARCON_MENU_ELEMENT (item)))
-        continue;
-
-      /* skip duplicates */
-      desktop_id = garcon_menu_item_get_desktop_id (item);
-      if (g_hash_table_lookup (pool, desktop_id) != NULL)
-        continue;
-
-      /* insert the item */
-      g_hash_table_insert (pool, g_strdup (desktop_id),
-                           g_object_ref (G_OBJECT (item)));
-    }
-  g_list_free (items);
-
-  menus = garcon_menu_get_menus (menu);
-  for (li = menus; li != NULL; li = li->next)
-    launcher_plugin_garcon_menu_pool_add (li->data, pool);
-  g_list_free (menus);
-}
-
-
-
-GHashTable *
-launcher_plugin_garcon_menu_pool (void)
-{
-  GHashTable *pool;
-  GarconMenu *menu;
-  GError *error = NULL;
-
-  /* always return a hash table, even if it's empty */
-  pool = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                (GDestroyNotify) g_free,
-                                (GDestroyNotify) g_object_unref);
-
-  menu = garcon_menu_new_applications ();
-  if (G_LIKELY (menu != NULL))
-    {
-      if (garcon_menu_load (menu, NULL, &error))
-        {
-          launcher_plugin_garcon_menu_pool_add (menu, pool);
-        }
-      else
-        {
-          g_warning ("Failed to load the applications menu: %s.", error->message);
-          g_error_free (error);
-        }
-
-      g_object_unref (G_OBJECT (menu));
-    }
-  else
-    {
-      g_warning ("Failed to create the applications menu");
-    }
-
-  return pool;
-}
-
-
-
 gboolean
 launcher_plugin_item_is_editable (LauncherPlugin *plugin,
                                   GarconMenuItem *item,
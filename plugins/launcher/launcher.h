@@ -47,9 +47,6 @@ launcher_plugin_get_items (LauncherPlugin *plugin);
 gchar *
 launcher_plugin_unique_filename (LauncherPlugin *plugin);
 
-GHashTable *
-launcher_plugin_garcon_menu_pool (void);
-
 gboolean
 launcher_plugin_item_is_editable (LauncherPlugin *plugin,
                                   GarconMenuItem *item,
@@ -73,8 +73,12 @@ struct _PagerButtons
 {
   GtkGrid __parent__;
 
+  /* workspace buttons in workspace order */
   GSList *buttons;
 
+  /* viewport buttons in viewport order */
+  GSList *viewport_buttons;
+
   guint rebuild_id;
 
   XfwScreen *xfw_screen;
@@ -154,6 +158,7 @@ pager_buttons_init (PagerButtons *pager)
   pager->orientation = GTK_ORIENTATION_HORIZONTAL;
   pager->numbering = FALSE;
   pager->buttons = NULL;
+  pager->viewport_buttons = NULL;
   pager->rebuild_id = 0;
 
   /* although I'd prefer normal allocation, the homogeneous setting
@@ -267,6 +272,7 @@ pager_buttons_finalize (GObject *object)
     }
 
   g_slist_free (pager->buttons);
+  g_slist_free (pager->viewport_buttons);
 
   (*G_OBJECT_CLASS (pager_buttons_parent_class)->finalize) (object);
 }
@@ -294,15 +300,130 @@ pager_buttons_button_press_event (GtkWidget *button,
 
 
 
+static void
+pager_buttons_button_attach (PagerButtons *pager,
+                             GtkWidget *button,
+                             gint n,
+                             gint cols)
+{
+  gint row, col;
+  gint left, top;
+
+  if (pager->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      row = n % cols;
+      col = n / cols;
+    }
+  else
+    {
+      row = n / cols;
+      col = n % cols;
+    }
+
+  if (gtk_widget_get_parent (button) == NULL)
+    {
+      gtk_grid_attach (GTK_GRID (pager), button,
+                       row, col, 1, 1);
+      return;
+    }
+
+  /* only move the button if the layout changed */
+  gtk_container_child_get (GTK_CONTAINER (pager), button,
+                           "left-attach", &left, "top-attach", &top, NULL);
+  if (left != row || top != col)
+    gtk_container_child_set (GTK_CONTAINER (pager), button,
+                             "left-attach", row, "top-attach", col, NULL);
+}
+
+
+
+static void
+pager_buttons_button_label (PagerButtons *pager,
+                            GtkWidget *button,
+                            const gchar *text)
+{
+  GtkWidget *label;
+
+  label = gtk_bin_get_child (GTK_BIN (button));
+  gtk_label_set_angle (GTK_LABEL (label),
+                       pager->orientation == GTK_ORIENTATION_HORIZONTAL ? 0 : 270);
+
+  if (text != NULL && g_strcmp0 (gtk_label_get_text (GTK_LABEL (label)), text) != 0)
+    gtk_label_set_text (GTK_LABEL (label), text);
+}
+
+
+
+static GtkWidget *
+pager_buttons_viewport_button_new (PagerButtons *pager,
+                                   GtkWidget *panel_plugin)
+{
+  GtkWidget *button;
+  GtkWidget *label;
+
+  button = xfce_panel_create_toggle_button ();
+  gtk_widget_add_events (GTK_WIDGET (button), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+  g_signal_connect (G_OBJECT (button), "toggled",
+                    G_CALLBACK (pager_buttons_viewport_button_toggled), pager);
+  g_signal_connect (G_OBJECT (button), "button-press-event",
+                    G_CALLBACK (pager_buttons_button_press_event), NULL);
+  xfce_panel_plugin_add_action_widget (XFCE_PANEL_PLUGIN (panel_plugin), button);
+  gtk_widget_show (button);
+
+  g_object_set_data_full (G_OBJECT (button), "viewport-info",
+                          g_new0 (gint, N_INFOS), (GDestroyNotify) g_free);
+
+  label = gtk_label_new (NULL);
+  gtk_container_add (GTK_CONTAINER (button), label);
+  gtk_widget_show (label);
+
+  return button;
+}
+
+
+
+static GtkWidget *
+pager_buttons_workspace_button_new (PagerButtons *pager,
+                                    XfwWorkspace *workspace,
+                                    gboolean active,
+                                    GtkWidget *panel_plugin)
+{
+  GtkWidget *button;
+  GtkWidget *label;
+
+  button = xfce_panel_create_toggle_button ();
+  gtk_widget_add_events (GTK_WIDGET (button), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+  if (active)
+    gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), TRUE);
+  g_signal_connect (G_OBJECT (button), "toggled",
+                    G_CALLBACK (pager_buttons_workspace_button_toggled), workspace);
+  g_signal_connect (G_OBJECT (button), "button-press-event",
+                    G_CALLBACK (pager_buttons_button_press_event), NULL);
+  xfce_panel_plugin_add_action_widget (XFCE_PANEL_PLUGIN (panel_plugin), button);
+  gtk_widget_show (button);
+
+  g_object_set_data (G_OBJECT (button), "workspace", workspace);
+
+  label = gtk_label_new (NULL);
+  g_signal_connect_object (G_OBJECT (workspace), "name-changed",
+                           G_CALLBACK (pager_buttons_workspace_button_label), label, 0);
+  gtk_container_add (GTK_CONTAINER (button), label);
+  gtk_widget_show (label);
+
+  return button;
+}
+
+
+
 static gboolean
 pager_buttons_rebuild_idle (gpointer user_data)
 {
   PagerButtons *pager = PAGER_BUTTONS (user_data);
   GList *li, *workspaces;
+  GSList *lp, *buttons = NULL;
   XfwWorkspace *active_ws;
   gint n, n_workspaces;
   gint rows, cols;
-  gint row, col;
   GtkWidget *button;
   XfwWorkspace *workspace = NULL;
   GtkWidget *panel_plugin;
@@ -315,20 +436,26 @@ pager_buttons_rebuild_idle (gpointer user_data)
   GdkRectangle *rect = NULL;
   GdkScreen *screen;
   guint scale_factor;
+  GHashTable *workspace_buttons;
+  GHashTableIter iter;
 
   panel_return_val_if_fail (PAGER_IS_BUTTONS (pager), FALSE);
   panel_return_val_if_fail (XFW_IS_SCREEN (pager->xfw_screen), FALSE);
 
-  gtk_container_foreach (GTK_CONTAINER (pager),
-                         (GtkCallback) (void (*) (void)) gtk_widget_destroy, NULL);
-
-  g_slist_free (pager->buttons);
-  pager->buttons = NULL;
-
   active_ws = xfw_workspace_group_get_active_workspace (pager->workspace_group);
   workspaces = xfw_workspace_group_list_workspaces (pager->workspace_group);
   if (workspaces == NULL)
-    goto leave;
+    {
+      gtk_container_foreach (GTK_CONTAINER (pager),
+                             (GtkCallback) (void (*) (void)) gtk_widget_destroy, NULL);
+
+      g_slist_free (pager->buttons);
+      pager->buttons = NULL;
+      g_slist_free (pager->viewport_buttons);
+      pager->viewport_buttons = NULL;
+
+      goto leave;
+    }
 
   n_workspaces = g_list_length (workspaces);
 
@@ -380,99 +507,99 @@ workspace_layout:
 
   panel_plugin = gtk_widget_get_ancestor (GTK_WIDGET (pager), XFCE_TYPE_PANEL_PLUGIN);
 
+  /* the existing buttons are reused, only the buttons of the other
+   * mode and of workspaces or viewports that are gone are destroyed */
   if (G_UNLIKELY (viewport_mode))
     {
       panel_return_val_if_fail (XFW_IS_WORKSPACE (workspace), FALSE);
 
-      for (n = 0; n < n_viewports; n++)
-        {
-          vp_info = g_new0 (gint, N_INFOS);
-          vp_info[VIEWPORT_X] = (n % (rect->height / screen_height)) * screen_width;
-          vp_info[VIEWPORT_Y] = (n / (rect->height / screen_height)) * screen_height;
-
-          button = xfce_panel_create_toggle_button ();
-          gtk_widget_add_events (GTK_WIDGET (button), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
-          if (rect->x >= vp_info[VIEWPORT_X] && rect->x < vp_info[VIEWPORT_X] + screen_width
-              && rect->y >= vp_info[VIEWPORT_Y] && rect->y < vp_info[VIEWPORT_Y] + screen_height)
-            gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), TRUE);
-          g_signal_connect (G_OBJECT (button), "toggled",
-                            G_CALLBACK (pager_buttons_viewport_button_toggled), pager);
-          g_signal_connect (G_OBJECT (button), "button-press-event",
-                            G_CALLBACK (pager_buttons_button_press_event), NULL);
-          xfce_panel_plugin_add_action_widget (XFCE_PANEL_PLUGIN (panel_plugin), button);
-          gtk_widget_show (button);
-
-          g_object_set_data_full (G_OBJECT (button), "viewport-info", vp_info,
-                                  (GDestroyNotify) g_free);
+      g_slist_free_full (pager->buttons, (GDestroyNotify) gtk_widget_destroy);
+      pager->buttons = NULL;
 
-          g_snprintf (text, sizeof (text), "%d", n + 1);
-          label = gtk_label_new (text);
-          gtk_label_set_angle (GTK_LABEL (label),
-                               pager->orientation == GTK_ORIENTATION_HORIZONTAL ? 0 : 270);
-          gtk_container_add (GTK_CONTAINER (button), label);
-          gtk_widget_show (label);
-
-          if (pager->orientation == GTK_ORIENTATION_HORIZONTAL)
+      for (n = 0, lp = pager->viewport_buttons; n < n_viewports; n++)
+        {
+          if (lp != NULL)
             {
-              row = n % cols;
-              col = n / cols;
+              button = GTK_WIDGET (lp->data);
+              lp = lp->next;
             }
           else
             {
-              row = n / cols;
-              col = n % cols;
+              button = pager_buttons_viewport_button_new (pager, panel_plugin);
             }
 
-          gtk_grid_attach (GTK_GRID (pager), button,
-                           row, col, 1, 1);
+          vp_info = g_object_get_data (G_OBJECT (button), "viewport-info");
+          vp_info[VIEWPORT_X] = (n % (rect->height / screen_height)) * screen_width;
+          vp_info[VIEWPORT_Y] = (n / (rect->height / screen_height)) * screen_height;
+
+          /* do not move the viewport when syncing the button state */
+          g_signal_handlers_block_by_func (G_OBJECT (button),
+                                           G_CALLBACK (pager_buttons_viewport_button_toggled), pager);
+          gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button),
+                                        rect->x >= vp_info[VIEWPORT_X] && rect->x < vp_info[VIEWPORT_X] + screen_width
+                                        && rect->y >= vp_info[VIEWPORT_Y] && rect->y < vp_info[VIEWPORT_Y] + screen_height);
+          g_signal_handlers_unblock_by_func (G_OBJECT (button),
+                                             G_CALLBACK (pager_buttons_viewport_button_toggled), pager);
+
+          g_snprintf (text, sizeof (text), "%d", n + 1);
+          pager_buttons_button_label (pager, button, text);
+          pager_buttons_button_attach (pager, button, n, cols);
+
+          buttons = g_slist_prepend (buttons, button);
         }
+
+      /* destroy the buttons of viewports that are gone */
+      for (; lp != NULL; lp = lp->next)
+        gtk_widget_destroy (GTK_WIDGET (lp->data));
+
+      g_slist_free (pager->viewport_buttons);
+      pager->viewport_buttons = g_slist_reverse (buttons);
     }
   else
     {
+      g_slist_free_full (pager->viewport_buttons, (GDestroyNotify) gtk_widget_destroy);
+      pager->viewport_buttons = NULL;
+
+      workspace_buttons = g_hash_table_new (g_direct_hash, g_direct_equal);
+      for (lp = pager->buttons; lp != NULL; lp = lp->next)
+        g_hash_table_insert (workspace_buttons,
+                             g_object_get_data (G_OBJECT (lp->data), "workspace"), lp->data);
+
       for (li = workspaces, n = 0; li != NULL; li = li->next, n++)
         {
           workspace = XFW_WORKSPACE (li->data);
 
-          button = xfce_panel_create_toggle_button ();
-          gtk_widget_add_events (GTK_WIDGET (button), GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
-          if (workspace == active_ws)
-            gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), TRUE);
-          g_signal_connect (G_OBJECT (button), "toggled",
-                            G_CALLBACK (pager_buttons_workspace_button_toggled), workspace);
-          g_signal_connect (G_OBJECT (button), "button-press-event",
-                            G_CALLBACK (pager_buttons_button_press_event), NULL);
-          xfce_panel_plugin_add_action_widget (XFCE_PANEL_PLUGIN (panel_plugin), button);
-          gtk_widget_show (button);
-
-          label = gtk_label_new (NULL);
-          g_object_set_data (G_OBJECT (label), "numbering", GINT_TO_POINTER (pager->numbering));
-          g_signal_connect_object (G_OBJECT (workspace), "name-changed",
-                                   G_CALLBACK (pager_buttons_workspace_button_label), label, 0);
-          pager_buttons_workspace_button_label (workspace, label);
-          gtk_label_set_angle (GTK_LABEL (label),
-                               pager->orientation == GTK_ORIENTATION_HORIZONTAL ? 0 : 270);
-          gtk_container_add (GTK_CONTAINER (button), label);
-          gtk_widget_show (label);
-
-          pager->buttons = g_slist_prepend (pager->buttons, button);
-
-          if (pager->orientation == GTK_ORIENTATION_HORIZONTAL)
+          button = g_hash_table_lookup (workspace_buttons, workspace);
+          if (button != NULL)
             {
-              row = n % cols;
-              col = n / cols;
+              g_hash_table_remove (workspace_buttons, workspace);
+              gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (button), workspace == active_ws);
             }
           else
             {
-              row = n / cols;
-              col = n % cols;
+              button = pager_buttons_workspace_button_new (pager, workspace, workspace == active_ws,
+                                                           panel_plugin);
             }
 
-          gtk_grid_attach (GTK_GRID (pager), button,
-                           row, col, 1, 1);
+          /* the label contains the workspace number, which might have changed */
+          label = gtk_bin_get_child (GTK_BIN (button));
+          g_object_set_data (G_OBJECT (label), "numbering", GINT_TO_POINTER (pager->numbering));
+          pager_buttons_workspace_button_label (workspace, label);
+          pager_buttons_button_label (pager, button, NULL);
+          pager_buttons_button_attach (pager, button, n, cols);
+
+          buttons = g_slist_prepend (buttons, button);
         }
-    }
 
-  pager->buttons = g_slist_reverse (pager->buttons);
+      /* destroy the buttons of workspaces that are gone */
+      g_hash_table_iter_init (&iter, workspace_buttons);
+      while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &button))
+        gtk_widget_destroy (button);
+      g_hash_table_destroy (workspace_buttons);
+
+      g_slist_free (pager->buttons);
+      pager->buttons = g_slist_reverse (buttons);
+    }
 
 leave:
 
@@ -601,7 +728,9 @@ pager_buttons_workspace_button_label (XfwWorkspace *workspace,
                                        xfw_workspace_get_number (workspace) + 1,
                                        name);
 
-  gtk_label_set_text (GTK_LABEL (label), name);
+  /* avoid a relayout if the name did not change */
+  if (g_strcmp0 (gtk_label_get_text (GTK_LABEL (label)), name) != 0)
+    gtk_label_set_text (GTK_LABEL (label), name);
 
   g_free (utf8);
   g_free (name_fallback);
@@ -0,0 +1,890 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pager-miniatures.h"
+
+#include "common/panel-private.h"
+#include "common/panel-xfw-icons.h"
+
+#include <math.h>
+
+
+
+#define MINIATURE_ICON_SIZE (16)
+
+
+
+/*
+ * Miniature view of the workspaces that keeps the rendering of each
+ * workspace in a surface. Window and workspace signals only mark the
+ * workspaces they affect as damaged and queue a redraw of their area,
+ * the damaged surfaces are rendered again once per frame in the draw
+ * handler, so a burst of geometry changes costs a single rendering.
+ */
+typedef struct
+{
+  XfwWorkspace *workspace;
+  cairo_surface_t *surface;
+  guint damaged : 1;
+}
+PagerMiniature;
+
+
+
+static void
+pager_miniatures_get_property (GObject *object,
+                               guint prop_id,
+                               GValue *value,
+                               GParamSpec *pspec);
+static void
+pager_miniatures_set_property (GObject *object,
+                               guint prop_id,
+                               const GValue *value,
+                               GParamSpec *pspec);
+static void
+pager_miniatures_finalize (GObject *object);
+static gboolean
+pager_miniatures_draw (GtkWidget *widget,
+                       cairo_t *cr);
+static gboolean
+pager_miniatures_button_press_event (GtkWidget *widget,
+                                     GdkEventButton *event);
+static gboolean
+pager_miniatures_button_release_event (GtkWidget *widget,
+                                       GdkEventButton *event);
+static gboolean
+pager_miniatures_motion_notify_event (GtkWidget *widget,
+                                      GdkEventMotion *event);
+static gboolean
+pager_miniatures_leave_notify_event (GtkWidget *widget,
+                                     GdkEventCrossing *event);
+static void
+pager_miniatures_style_updated (GtkWidget *widget);
+static void
+pager_miniatures_workspaces_changed (PagerMiniatures *pager);
+static void
+pager_miniatures_active_workspace_changed (XfwWorkspaceGroup *group,
+                                           XfwWorkspace *previous_workspace,
+                                           PagerMiniatures *pager);
+static void
+pager_miniatures_active_window_changed (XfwScreen *screen,
+                                        XfwWindow *previous_window,
+                                        PagerMiniatures *pager);
+static void
+pager_miniatures_stacking_changed (XfwScreen *screen,
+                                   PagerMiniatures *pager);
+static void
+pager_miniatures_window_damage (PagerMiniatures *pager,
+                                XfwWindow *window);
+static void
+pager_miniatures_window_connect (PagerMiniatures *pager,
+                                 XfwWindow *window);
+
+
+
+struct _PagerMiniatures
+{
+  GtkDrawingArea __parent__;
+
+  XfwScreen *xfw_screen;
+  XfwWorkspaceGroup *workspace_group;
+
+  /* PagerMiniature of each workspace, in workspace order */
+  GPtrArray *miniatures;
+
+  gint rows;
+  GtkOrientation orientation;
+
+  XfwWorkspace *hover_workspace;
+  XfwWorkspace *pressed_workspace;
+};
+
+enum
+{
+  PROP_0,
+  PROP_SCREEN,
+  PROP_ROWS,
+  PROP_ORIENTATION
+};
+
+
+
+G_DEFINE_FINAL_TYPE (PagerMiniatures, pager_miniatures, GTK_TYPE_DRAWING_AREA)
+
+
+
+static void
+pager_miniatures_class_init (PagerMiniaturesClass *klass)
+{
+  GObjectClass *gobject_class;
+  GtkWidgetClass *widget_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->get_property = pager_miniatures_get_property;
+  gobject_class->set_property = pager_miniatures_set_property;
+  gobject_class->finalize = pager_miniatures_finalize;
+
+  widget_class = GTK_WIDGET_CLASS (klass);
+  widget_class->draw = pager_miniatures_draw;
+  widget_class->button_press_event = pager_miniatures_button_press_event;
+  widget_class->button_release_event = pager_miniatures_button_release_event;
+  widget_class->motion_notify_event = pager_miniatures_motion_notify_event;
+  widget_class->leave_notify_event = pager_miniatures_leave_notify_event;
+  widget_class->style_updated = pager_miniatures_style_updated;
+
+  gtk_widget_class_set_css_name (widget_class, "pager-miniatures");
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_SCREEN,
+                                   g_param_spec_object ("screen", NULL, NULL,
+                                                        XFW_TYPE_SCREEN,
+                                                        G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS
+                                                          | G_PARAM_CONSTRUCT_ONLY));
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_ROWS,
+                                   g_param_spec_int ("rows", NULL, NULL,
+                                                     1, 100, 1,
+                                                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_ORIENTATION,
+                                   g_param_spec_enum ("orientation", NULL, NULL,
+                                                      GTK_TYPE_ORIENTATION,
+                                                      GTK_ORIENTATION_HORIZONTAL,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+
+
+static void
+pager_miniature_free (gpointer data)
+{
+  PagerMiniature *miniature = data;
+
+  if (miniature->surface != NULL)
+    cairo_surface_destroy (miniature->surface);
+
+  g_slice_free (PagerMiniature, miniature);
+}
+
+
+
+static void
+pager_miniatures_init (PagerMiniatures *pager)
+{
+  pager->rows = 1;
+  pager->xfw_screen = NULL;
+  pager->orientation = GTK_ORIENTATION_HORIZONTAL;
+  pager->miniatures = g_ptr_array_new_with_free_func (pager_miniature_free);
+  pager->hover_workspace = NULL;
+  pager->pressed_workspace = NULL;
+
+  gtk_widget_add_events (GTK_WIDGET (pager), GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK
+                                               | GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK
+                                               | GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+}
+
+
+
+static void
+pager_miniatures_get_property (GObject *object,
+                               guint prop_id,
+                               GValue *value,
+                               GParamSpec *pspec)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (object);
+
+  switch (prop_id)
+    {
+    case PROP_ROWS:
+      g_value_set_int (value, pager->rows);
+      break;
+
+    case PROP_ORIENTATION:
+      g_value_set_enum (value, pager->orientation);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+pager_miniatures_set_property (GObject *object,
+                               guint prop_id,
+                               const GValue *value,
+                               GParamSpec *pspec)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (object);
+  XfwWorkspaceManager *manager;
+  GList *li;
+
+  switch (prop_id)
+    {
+    case PROP_SCREEN:
+      pager->xfw_screen = g_value_dup_object (value);
+      panel_return_if_fail (XFW_IS_SCREEN (pager->xfw_screen));
+      manager = xfw_screen_get_workspace_manager (pager->xfw_screen);
+      pager->workspace_group = xfw_workspace_manager_list_workspace_groups (manager)->data;
+
+      g_signal_connect_object (G_OBJECT (pager->workspace_group), "active-workspace-changed",
+                               G_CALLBACK (pager_miniatures_active_workspace_changed), pager, 0);
+      g_signal_connect_object (G_OBJECT (pager->workspace_group), "workspace-added",
+                               G_CALLBACK (pager_miniatures_workspaces_changed), pager, G_CONNECT_SWAPPED);
+      g_signal_connect_object (G_OBJECT (pager->workspace_group), "workspace-removed",
+                               G_CALLBACK (pager_miniatures_workspaces_changed), pager, G_CONNECT_SWAPPED);
+      g_signal_connect_object (G_OBJECT (pager->workspace_group), "viewports-changed",
+                               G_CALLBACK (pager_miniatures_workspaces_changed), pager, G_CONNECT_SWAPPED);
+
+      g_signal_connect_object (G_OBJECT (pager->xfw_screen), "window-opened",
+                               G_CALLBACK (pager_miniatures_window_connect), pager, G_CONNECT_SWAPPED);
+      g_signal_connect_object (G_OBJECT (pager->xfw_screen), "window-closed",
+                               G_CALLBACK (pager_miniatures_window_damage), pager, G_CONNECT_SWAPPED);
+      g_signal_connect_object (G_OBJECT (pager->xfw_screen), "active-window-changed",
+                               G_CALLBACK (pager_miniatures_active_window_changed), pager, 0);
+      g_signal_connect_object (G_OBJECT (pager->xfw_screen), "window-stacking-changed",
+                               G_CALLBACK (pager_miniatures_stacking_changed), pager, 0);
+
+      for (li = xfw_screen_get_windows (pager->xfw_screen); li != NULL; li = li->next)
+        pager_miniatures_window_connect (pager, li->data);
+
+      pager_miniatures_workspaces_changed (pager);
+      break;
+
+    case PROP_ROWS:
+      pager_miniatures_set_n_rows (pager, g_value_get_int (value));
+      break;
+
+    case PROP_ORIENTATION:
+      pager_miniatures_set_orientation (pager, g_value_get_enum (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+pager_miniatures_finalize (GObject *object)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (object);
+
+  g_ptr_array_free (pager->miniatures, TRUE);
+
+  if (G_LIKELY (pager->xfw_screen != NULL))
+    g_object_unref (G_OBJECT (pager->xfw_screen));
+
+  (*G_OBJECT_CLASS (pager_miniatures_parent_class)->finalize) (object);
+}
+
+
+
+static void
+pager_miniatures_get_layout (PagerMiniatures *pager,
+                             gint *rows,
+                             gint *cols)
+{
+  gint n_workspaces = MAX (1, (gint) pager->miniatures->len);
+
+  *rows = CLAMP (pager->rows, 1, n_workspaces);
+  *cols = n_workspaces / *rows;
+  if (*cols * *rows < n_workspaces)
+    (*cols)++;
+}
+
+
+
+static void
+pager_miniatures_get_cell (PagerMiniatures *pager,
+                           guint n,
+                           GdkRectangle *cell)
+{
+  GtkAllocation alloc;
+  gint rows, cols;
+  gint x, y;
+
+  gtk_widget_get_allocation (GTK_WIDGET (pager), &alloc);
+  pager_miniatures_get_layout (pager, &rows, &cols);
+
+  /* same layout as the buttons view */
+  if (pager->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      x = n % cols;
+      y = n / cols;
+      cell->x = alloc.width * x / cols;
+      cell->y = alloc.height * y / rows;
+      cell->width = alloc.width * (x + 1) / cols - cell->x;
+      cell->height = alloc.height * (y + 1) / rows - cell->y;
+    }
+  else
+    {
+      x = n / cols;
+      y = n % cols;
+      cell->x = alloc.width * x / rows;
+      cell->y = alloc.height * y / cols;
+      cell->width = alloc.width * (x + 1) / rows - cell->x;
+      cell->height = alloc.height * (y + 1) / cols - cell->y;
+    }
+}
+
+
+
+static XfwWorkspace *
+pager_miniatures_get_workspace_at (PagerMiniatures *pager,
+                                   gdouble x,
+                                   gdouble y)
+{
+  PagerMiniature *miniature;
+  GdkRectangle cell;
+  guint n;
+
+  for (n = 0; n < pager->miniatures->len; n++)
+    {
+      pager_miniatures_get_cell (pager, n, &cell);
+      if (x >= cell.x && x < cell.x + cell.width
+          && y >= cell.y && y < cell.y + cell.height)
+        {
+          miniature = g_ptr_array_index (pager->miniatures, n);
+          return miniature->workspace;
+        }
+    }
+
+  return NULL;
+}
+
+
+
+static void
+pager_miniatures_damage (PagerMiniatures *pager,
+                         XfwWorkspace *workspace)
+{
+  PagerMiniature *miniature;
+  GdkRectangle cell;
+  guint n;
+
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  if (workspace == NULL)
+    return;
+
+  for (n = 0; n < pager->miniatures->len; n++)
+    {
+      miniature = g_ptr_array_index (pager->miniatures, n);
+      if (miniature->workspace == workspace)
+        {
+          miniature->damaged = TRUE;
+          pager_miniatures_get_cell (pager, n, &cell);
+          gtk_widget_queue_draw_area (GTK_WIDGET (pager), cell.x, cell.y, cell.width, cell.height);
+          break;
+        }
+    }
+}
+
+
+
+static void
+pager_miniatures_damage_all (PagerMiniatures *pager)
+{
+  PagerMiniature *miniature;
+  guint n;
+
+  for (n = 0; n < pager->miniatures->len; n++)
+    {
+      miniature = g_ptr_array_index (pager->miniatures, n);
+      miniature->damaged = TRUE;
+    }
+
+  gtk_widget_queue_draw (GTK_WIDGET (pager));
+}
+
+
+
+static void
+pager_miniatures_active_workspace_changed (XfwWorkspaceGroup *group,
+                                           XfwWorkspace *previous_workspace,
+                                           PagerMiniatures *pager)
+{
+  panel_return_if_fail (XFW_IS_WORKSPACE_GROUP (group));
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  pager_miniatures_damage (pager, previous_workspace);
+  pager_miniatures_damage (pager, xfw_workspace_group_get_active_workspace (group));
+}
+
+
+
+static void
+pager_miniatures_window_damage (PagerMiniatures *pager,
+                                XfwWindow *window)
+{
+  PagerMiniature *miniature;
+  GdkRectangle cell;
+  guint n;
+
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  /* all the workspaces the window is visible on, more than one if pinned */
+  for (n = 0; n < pager->miniatures->len; n++)
+    {
+      miniature = g_ptr_array_index (pager->miniatures, n);
+      if (xfw_window_is_on_workspace (window, miniature->workspace))
+        {
+          miniature->damaged = TRUE;
+          pager_miniatures_get_cell (pager, n, &cell);
+          gtk_widget_queue_draw_area (GTK_WIDGET (pager), cell.x, cell.y, cell.width, cell.height);
+        }
+    }
+}
+
+
+
+static void
+pager_miniatures_active_window_changed (XfwScreen *screen,
+                                        XfwWindow *previous_window,
+                                        PagerMiniatures *pager)
+{
+  XfwWindow *window;
+
+  panel_return_if_fail (XFW_IS_SCREEN (screen));
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  if (previous_window != NULL)
+    pager_miniatures_window_damage (pager, previous_window);
+
+  window = xfw_screen_get_active_window (screen);
+  if (window != NULL)
+    pager_miniatures_window_damage (pager, window);
+}
+
+
+
+static void
+pager_miniatures_stacking_changed (XfwScreen *screen,
+                                   PagerMiniatures *pager)
+{
+  panel_return_if_fail (XFW_IS_SCREEN (screen));
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  /* restacking happens almost always on the visible workspace */
+  pager_miniatures_damage (pager, xfw_workspace_group_get_active_workspace (pager->workspace_group));
+}
+
+
+
+static void
+pager_miniatures_window_state_changed (XfwWindow *window,
+                                       XfwWindowState changed_mask,
+                                       XfwWindowState new_state,
+                                       PagerMiniatures *pager)
+{
+  pager_miniatures_window_damage (pager, window);
+}
+
+
+
+static void
+pager_miniatures_window_icon_changed (PagerMiniatures *pager,
+                                      XfwWindow *window)
+{
+  panel_xfw_icons_window_icon_changed (window);
+  pager_miniatures_window_damage (pager, window);
+}
+
+
+
+static void
+pager_miniatures_window_connect (PagerMiniatures *pager,
+                                 XfwWindow *window)
+{
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  g_signal_connect_object (G_OBJECT (window), "geometry-changed",
+                           G_CALLBACK (pager_miniatures_window_damage), pager, G_CONNECT_SWAPPED);
+  g_signal_connect_object (G_OBJECT (window), "state-changed",
+                           G_CALLBACK (pager_miniatures_window_state_changed), pager, 0);
+  g_signal_connect_object (G_OBJECT (window), "icon-changed",
+                           G_CALLBACK (pager_miniatures_window_icon_changed), pager, G_CONNECT_SWAPPED);
+
+  /* the previous workspace of the window is unknown */
+  g_signal_connect_object (G_OBJECT (window), "workspace-changed",
+                           G_CALLBACK (pager_miniatures_damage_all), pager, G_CONNECT_SWAPPED);
+
+  pager_miniatures_window_damage (pager, window);
+}
+
+
+
+static void
+pager_miniatures_workspaces_changed (PagerMiniatures *pager)
+{
+  GPtrArray *miniatures;
+  PagerMiniature *miniature;
+  GList *li;
+  guint n;
+  gint rows, cols;
+
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  /* keep the surfaces of the workspaces that still exist */
+  miniatures = g_ptr_array_new_with_free_func (pager_miniature_free);
+  for (li = xfw_workspace_group_list_workspaces (pager->workspace_group); li != NULL; li = li->next)
+    {
+      miniature = NULL;
+      for (n = 0; n < pager->miniatures->len; n++)
+        {
+          if (((PagerMiniature *) g_ptr_array_index (pager->miniatures, n))->workspace == li->data)
+            {
+              miniature = g_ptr_array_steal_index (pager->miniatures, n);
+              break;
+            }
+        }
+
+      if (miniature == NULL)
+        {
+          miniature = g_slice_new0 (PagerMiniature);
+          miniature->workspace = li->data;
+        }
+
+      g_ptr_array_add (miniatures, miniature);
+    }
+
+  g_ptr_array_free (pager->miniatures, TRUE);
+  pager->miniatures = miniatures;
+
+  pager->hover_workspace = NULL;
+  pager->pressed_workspace = NULL;
+
+  /* set workspace layout so changing workspace and moving windows between workspaces
+   * via keyboard shortcuts work correctly in all directions */
+  if (miniatures->len > 0)
+    {
+      pager_miniatures_get_layout (pager, &rows, &cols);
+      xfw_workspace_group_set_layout (pager->workspace_group, rows, 0, NULL);
+    }
+
+  /* the cells moved, so render everything again */
+  pager_miniatures_damage_all (pager);
+  gtk_widget_queue_resize (GTK_WIDGET (pager));
+}
+
+
+
+static void
+pager_miniatures_render (PagerMiniatures *pager,
+                         PagerMiniature *miniature,
+                         gint width,
+                         gint height)
+{
+  GtkWidget *widget = GTK_WIDGET (pager);
+  GtkStyleContext *context;
+  GtkStateFlags state;
+  GdkRGBA fg;
+  GdkRectangle *ws_rect, *win_rect;
+  XfwWindow *window;
+  GdkPixbuf *pixbuf;
+  cairo_surface_t *icon;
+  cairo_t *cr;
+  GList *li;
+  gdouble sx, sy, x, y, w, h;
+  gint offset_x = 0, offset_y = 0;
+  gint icon_size, scale_factor;
+
+  cr = cairo_create (miniature->surface);
+  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+
+  /* workspace background, the same style nodes as the wnck pager */
+  state = gtk_widget_get_state_flags (widget) & ~(GTK_STATE_FLAG_PRELIGHT | GTK_STATE_FLAG_SELECTED);
+  if (miniature->workspace == xfw_workspace_group_get_active_workspace (pager->workspace_group))
+    state |= GTK_STATE_FLAG_SELECTED;
+  else if (miniature->workspace == pager->hover_workspace)
+    state |= GTK_STATE_FLAG_PRELIGHT;
+
+  context = gtk_widget_get_style_context (widget);
+  gtk_style_context_save (context);
+  gtk_style_context_set_state (context, state);
+  gtk_render_background (context, cr, 0, 0, width, height);
+  gtk_style_context_get_color (context, state, &fg);
+  gtk_style_context_restore (context);
+
+  ws_rect = xfw_workspace_get_geometry (miniature->workspace);
+  if (ws_rect == NULL || ws_rect->width <= 0 || ws_rect->height <= 0)
+    goto leave;
+
+  sx = (gdouble) width / ws_rect->width;
+  sy = (gdouble) height / ws_rect->height;
+
+  /* window positions are relative to the visible viewport */
+  if (xfw_workspace_get_state (miniature->workspace) & XFW_WORKSPACE_STATE_VIRTUAL)
+    {
+      offset_x = ws_rect->x;
+      offset_y = ws_rect->y;
+    }
+
+  scale_factor = gtk_widget_get_scale_factor (widget);
+
+  /* draw the windows from bottom to top */
+  for (li = xfw_screen_get_windows_stacked (pager->xfw_screen); li != NULL; li = li->next)
+    {
+      window = XFW_WINDOW (li->data);
+      if (!xfw_window_is_on_workspace (window, miniature->workspace)
+          || xfw_window_is_minimized (window)
+          || xfw_window_is_skip_pager (window))
+        continue;
+
+      win_rect = xfw_window_get_geometry (window);
+      x = floor ((win_rect->x + offset_x) * sx) + 0.5;
+      y = floor ((win_rect->y + offset_y) * sy) + 0.5;
+      w = MAX (floor (win_rect->width * sx) - 1.0, 1.0);
+      h = MAX (floor (win_rect->height * sy) - 1.0, 1.0);
+
+      cairo_rectangle (cr, x, y, w, h);
+      cairo_set_source_rgba (cr, fg.red, fg.green, fg.blue,
+                             fg.alpha * (xfw_window_is_active (window) ? 0.5 : 0.25));
+      cairo_fill_preserve (cr);
+      cairo_set_source_rgba (cr, fg.red, fg.green, fg.blue, fg.alpha * 0.8);
+      cairo_set_line_width (cr, 1.0);
+      cairo_stroke (cr);
+
+      /* the icon is shared with the tasklist and the window menu */
+      icon_size = MIN (MINIATURE_ICON_SIZE, (gint) MIN (w, h) - 2);
+      if (icon_size < MINIATURE_ICON_SIZE / 2)
+        continue;
+
+      pixbuf = panel_xfw_icons_get_window_icon (window, icon_size, scale_factor);
+      if (pixbuf == NULL)
+        continue;
+
+      icon = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
+      cairo_set_source_surface (cr, icon,
+                                floor (x + (w - icon_size) / 2.0),
+                                floor (y + (h - icon_size) / 2.0));
+      cairo_paint (cr);
+      cairo_surface_destroy (icon);
+      g_object_unref (pixbuf);
+    }
+
+leave:
+
+  cairo_destroy (cr);
+  miniature->damaged = FALSE;
+}
+
+
+
+static gboolean
+pager_miniatures_draw (GtkWidget *widget,
+                       cairo_t *cr)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (widget);
+  PagerMiniature *miniature;
+  GdkRectangle clip, cell;
+  gint scale_factor;
+  guint n;
+
+  if (!gdk_cairo_get_clip_rectangle (cr, &clip))
+    return FALSE;
+
+  scale_factor = gtk_widget_get_scale_factor (widget);
+
+  for (n = 0; n < pager->miniatures->len; n++)
+    {
+      pager_miniatures_get_cell (pager, n, &cell);
+      if (cell.width <= 0 || cell.height <= 0
+          || !gdk_rectangle_intersect (&clip, &cell, NULL))
+        continue;
+
+      miniature = g_ptr_array_index (pager->miniatures, n);
+
+      /* the cell size changed, start over */
+      if (miniature->surface != NULL
+          && (cairo_image_surface_get_width (miniature->surface) != cell.width * scale_factor
+              || cairo_image_surface_get_height (miniature->surface) != cell.height * scale_factor))
+        {
+          cairo_surface_destroy (miniature->surface);
+          miniature->surface = NULL;
+        }
+
+      if (miniature->surface == NULL)
+        {
+          miniature->surface = gdk_window_create_similar_image_surface (gtk_widget_get_window (widget),
+                                                                        CAIRO_FORMAT_ARGB32,
+                                                                        cell.width * scale_factor,
+                                                                        cell.height * scale_factor,
+                                                                        scale_factor);
+          miniature->damaged = TRUE;
+        }
+
+      if (miniature->damaged)
+        pager_miniatures_render (pager, miniature, cell.width, cell.height);
+
+      cairo_set_source_surface (cr, miniature->surface, cell.x, cell.y);
+      cairo_paint (cr);
+    }
+
+  return FALSE;
+}
+
+
+
+static gboolean
+pager_miniatures_button_press_event (GtkWidget *widget,
+                                     GdkEventButton *event)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (widget);
+
+  if (event->button != 1 || event->type != GDK_BUTTON_PRESS)
+    return FALSE;
+
+  pager->pressed_workspace = pager_miniatures_get_workspace_at (pager, event->x, event->y);
+
+  return pager->pressed_workspace != NULL;
+}
+
+
+
+static gboolean
+pager_miniatures_button_release_event (GtkWidget *widget,
+                                       GdkEventButton *event)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (widget);
+  XfwWorkspace *workspace;
+
+  if (event->button != 1 || pager->pressed_workspace == NULL)
+    return FALSE;
+
+  workspace = pager_miniatures_get_workspace_at (pager, event->x, event->y);
+  if (workspace == pager->pressed_workspace
+      && workspace != xfw_workspace_group_get_active_workspace (pager->workspace_group))
+    xfw_workspace_activate (workspace, NULL);
+
+  pager->pressed_workspace = NULL;
+
+  return TRUE;
+}
+
+
+
+static gboolean
+pager_miniatures_motion_notify_event (GtkWidget *widget,
+                                      GdkEventMotion *event)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (widget);
+  XfwWorkspace *workspace, *previous;
+
+  workspace = pager_miniatures_get_workspace_at (pager, event->x, event->y);
+  if (workspace != pager->hover_workspace)
+    {
+      previous = pager->hover_workspace;
+      pager->hover_workspace = workspace;
+      if (previous != NULL)
+        pager_miniatures_damage (pager, previous);
+      if (workspace != NULL)
+        pager_miniatures_damage (pager, workspace);
+    }
+
+  return FALSE;
+}
+
+
+
+static gboolean
+pager_miniatures_leave_notify_event (GtkWidget *widget,
+                                     GdkEventCrossing *event)
+{
+  PagerMiniatures *pager = PAGER_MINIATURES (widget);
+  XfwWorkspace *previous;
+
+  if (pager->hover_workspace != NULL)
+    {
+      previous = pager->hover_workspace;
+      pager->hover_workspace = NULL;
+      pager_miniatures_damage (pager, previous);
+    }
+
+  return FALSE;
+}
+
+
+
+static void
+pager_miniatures_style_updated (GtkWidget *widget)
+{
+  (*GTK_WIDGET_CLASS (pager_miniatures_parent_class)->style_updated) (widget);
+
+  /* colors are part of the cached surfaces */
+  pager_miniatures_damage_all (PAGER_MINIATURES (widget));
+}
+
+
+
+GtkWidget *
+pager_miniatures_new (XfwScreen *screen)
+{
+  panel_return_val_if_fail (XFW_IS_SCREEN (screen), NULL);
+
+  return g_object_new (PAGER_TYPE_MINIATURES,
+                       "screen", screen, NULL);
+}
+
+
+
+void
+pager_miniatures_set_orientation (PagerMiniatures *pager,
+                                  GtkOrientation orientation)
+{
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  if (pager->orientation == orientation)
+    return;
+
+  pager->orientation = orientation;
+  pager_miniatures_damage_all (pager);
+}
+
+
+
+void
+pager_miniatures_set_n_rows (PagerMiniatures *pager,
+                             gint rows)
+{
+  panel_return_if_fail (PAGER_IS_MINIATURES (pager));
+
+  if (pager->rows == rows)
+    return;
+
+  pager->rows = rows;
+
+  /* this updates the workspace layout and renders everything again */
+  if (pager->xfw_screen != NULL)
+    pager_miniatures_workspaces_changed (pager);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __PAGER_MINIATURES_H__
+#define __PAGER_MINIATURES_H__
+
+#include <gtk/gtk.h>
+#include <libxfce4windowing/libxfce4windowing.h>
+
+G_BEGIN_DECLS
+
+#define PAGER_TYPE_MINIATURES (pager_miniatures_get_type ())
+G_DECLARE_FINAL_TYPE (PagerMiniatures, pager_miniatures, PAGER, MINIATURES, GtkDrawingArea)
+
+GtkWidget *
+pager_miniatures_new (XfwScreen *screen) G_GNUC_MALLOC;
+
+void
+pager_miniatures_set_orientation (PagerMiniatures *pager,
+                                  GtkOrientation orientation);
+
+void
+pager_miniatures_set_n_rows (PagerMiniatures *pager,
+                             gint rows);
+
+G_END_DECLS
+
+#endif /* !__PAGER_MINIATURES_H__ */
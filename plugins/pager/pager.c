@@ -23,6 +23,7 @@
 
 #include "pager-buttons.h"
 #include "pager-dialog_ui.h"
+#include "pager-miniatures.h"
 #include "pager.h"
 
 #include "common/panel-debug.h"
@@ -131,6 +132,7 @@ struct _PagerPlugin
   guint scrolling : 1;
   guint wrap_workspaces : 1;
   guint miniature_view : 1;
+  guint cached_miniatures : 1;
   guint rows;
   gboolean numbering;
   gfloat ratio;
@@ -146,6 +148,7 @@ enum
   PROP_WORKSPACE_SCROLLING,
   PROP_WRAP_WORKSPACES,
   PROP_MINIATURE_VIEW,
+  PROP_CACHED_MINIATURES,
   PROP_ROWS,
   PROP_NUMBERING
 };
@@ -204,6 +207,13 @@ pager_plugin_class_init (PagerPluginClass *klass)
                                                          TRUE,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class,
+                                   PROP_CACHED_MINIATURES,
+                                   g_param_spec_boolean ("cached-miniatures",
+                                                         NULL, NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (gobject_class,
                                    PROP_ROWS,
                                    g_param_spec_uint ("rows",
@@ -230,6 +240,7 @@ pager_plugin_init (PagerPlugin *plugin)
   plugin->scrolling = TRUE;
   plugin->wrap_workspaces = FALSE;
   plugin->miniature_view = WINDOWING_IS_X11 ();
+  plugin->cached_miniatures = FALSE;
   plugin->numbering = FALSE;
   plugin->ratio = 1.0;
   plugin->pager = NULL;
@@ -275,6 +286,10 @@ pager_plugin_get_property (GObject *object,
       g_value_set_boolean (value, plugin->miniature_view);
       break;
 
+    case PROP_CACHED_MINIATURES:
+      g_value_set_boolean (value, plugin->cached_miniatures);
+      break;
+
     case PROP_ROWS:
       g_value_set_uint (value, plugin->rows);
       break;
@@ -316,6 +331,12 @@ pager_plugin_set_property (GObject *object,
         pager_plugin_screen_layout_changed (plugin, NULL);
       break;
 
+    case PROP_CACHED_MINIATURES:
+      plugin->cached_miniatures = g_value_get_boolean (value);
+      if (plugin->xfw_screen != NULL && plugin->miniature_view)
+        pager_plugin_screen_layout_changed (plugin, NULL);
+      break;
+
     case PROP_ROWS:
       rows = g_value_get_uint (value);
       if (rows == plugin->rows)
@@ -330,11 +351,13 @@ pager_plugin_set_property (GObject *object,
         {
           /* set n_rows for master plugin and consequently workspace layout:
            * this is delayed in both cases */
+          if (PAGER_IS_MINIATURES (plugin->pager))
+            pager_miniatures_set_n_rows (PAGER_MINIATURES (plugin->pager), plugin->rows);
 #ifdef ENABLE_X11
-          if (plugin->miniature_view)
+          else if (plugin->miniature_view)
             wnck_pager_set_n_rows (WNCK_PAGER (plugin->pager), plugin->rows);
-          else
 #endif
+          else
             pager_buttons_set_n_rows (PAGER_BUTTONS (plugin->pager), plugin->rows);
 
           /* set n_rows for other plugins: this will queue a pager re-creation */
@@ -393,9 +416,9 @@ pager_plugin_style_updated (GtkWidget *pager,
                          &bg_color, NULL);
   color_string = gdk_rgba_to_string (bg_color);
   // FIXME: The shade value only works well visually for bright themes/panels
-  css_string = g_strdup_printf ("wnck-pager { background: %s; }"
-                                "wnck-pager:selected { background: shade(%s, 0.7); }"
-                                "wnck-pager:hover { background: shade(%s, 0.9); }",
+  css_string = g_strdup_printf ("wnck-pager, pager-miniatures { background: %s; }"
+                                "wnck-pager:selected, pager-miniatures:selected { background: shade(%s, 0.7); }"
+                                "wnck-pager:hover, pager-miniatures:hover { background: shade(%s, 0.9); }",
                                 color_string, color_string, color_string);
   context = gtk_widget_get_style_context (pager);
   gtk_css_provider_load_from_data (provider, css_string, -1, NULL);
@@ -598,8 +621,21 @@ pager_plugin_screen_layout_changed (PagerPlugin *plugin,
   orientation = (mode != XFCE_PANEL_PLUGIN_MODE_VERTICAL) ? GTK_ORIENTATION_HORIZONTAL
                                                           : GTK_ORIENTATION_VERTICAL;
 
+  if (plugin->miniature_view && plugin->cached_miniatures)
+    {
 #ifdef ENABLE_X11
-  if (plugin->miniature_view)
+      pager_plugin_set_ratio (plugin);
+#endif
+
+      plugin->pager = pager_miniatures_new (plugin->xfw_screen);
+      g_signal_connect_swapped (G_OBJECT (plugin->pager), "scroll-event",
+                                G_CALLBACK (pager_plugin_scroll_event), plugin);
+      pager_miniatures_set_n_rows (PAGER_MINIATURES (plugin->pager), plugin->rows);
+      pager_miniatures_set_orientation (PAGER_MINIATURES (plugin->pager), orientation);
+      gtk_container_add (GTK_CONTAINER (plugin), plugin->pager);
+    }
+#ifdef ENABLE_X11
+  else if (plugin->miniature_view)
     {
       pager_plugin_set_ratio (plugin);
 
@@ -693,6 +729,7 @@ pager_plugin_construct (XfcePanelPlugin *panel_plugin)
     { "workspace-scrolling", G_TYPE_BOOLEAN },
     { "wrap-workspaces", G_TYPE_BOOLEAN },
     { "miniature-view", G_TYPE_BOOLEAN },
+    { "cached-miniatures", G_TYPE_BOOLEAN },
     { "rows", G_TYPE_UINT },
     { "numbering", G_TYPE_BOOLEAN },
     { NULL }
@@ -769,11 +806,13 @@ pager_plugin_mode_changed (XfcePanelPlugin *panel_plugin,
   orientation = (mode != XFCE_PANEL_PLUGIN_MODE_VERTICAL) ? GTK_ORIENTATION_HORIZONTAL
                                                           : GTK_ORIENTATION_VERTICAL;
 
+  if (PAGER_IS_MINIATURES (plugin->pager))
+    pager_miniatures_set_orientation (PAGER_MINIATURES (plugin->pager), orientation);
 #ifdef ENABLE_X11
-  if (plugin->miniature_view)
+  else if (plugin->miniature_view)
     wnck_pager_set_orientation (WNCK_PAGER (plugin->pager), orientation);
-  else
 #endif
+  else
     pager_buttons_set_orientation (PAGER_BUTTONS (plugin->pager), orientation);
 }
 
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Stand-in for libxfce4windowing used by the tasklist benchmark. It only
+ * provides the part of the API the tasklist uses, and the windows are plain
+ * objects scripted with the xfw_mock_*() functions at the bottom.
+ */
+
+#ifndef __XFW_MOCK_H__
+#define __XFW_MOCK_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef enum
+{
+  XFW_WINDOWING_UNKNOWN = 0,
+  XFW_WINDOWING_X11,
+  XFW_WINDOWING_WAYLAND,
+} XfwWindowing;
+
+typedef enum
+{
+  XFW_WINDOW_STATE_NONE = 0,
+  XFW_WINDOW_STATE_ACTIVE = 1 << 0,
+  XFW_WINDOW_STATE_MINIMIZED = 1 << 1,
+  XFW_WINDOW_STATE_MAXIMIZED = 1 << 2,
+  XFW_WINDOW_STATE_FULLSCREEN = 1 << 3,
+  XFW_WINDOW_STATE_SKIP_PAGER = 1 << 4,
+  XFW_WINDOW_STATE_SKIP_TASKLIST = 1 << 5,
+  XFW_WINDOW_STATE_PINNED = 1 << 6,
+  XFW_WINDOW_STATE_SHADED = 1 << 7,
+  XFW_WINDOW_STATE_ABOVE = 1 << 8,
+  XFW_WINDOW_STATE_BELOW = 1 << 9,
+  XFW_WINDOW_STATE_URGENT = 1 << 10,
+} XfwWindowState;
+
+typedef enum
+{
+  XFW_WORKSPACE_STATE_NONE = 0,
+  XFW_WORKSPACE_STATE_ACTIVE = 1 << 0,
+  XFW_WORKSPACE_STATE_URGENT = 1 << 1,
+  XFW_WORKSPACE_STATE_HIDDEN = 1 << 2,
+  XFW_WORKSPACE_STATE_VIRTUAL = 1 << 3,
+} XfwWorkspaceState;
+
+typedef struct _XfwApplicationInstance XfwApplicationInstance;
+
+#define XFW_TYPE_SCREEN (xfw_screen_get_type ())
+G_DECLARE_FINAL_TYPE (XfwScreen, xfw_screen, XFW, SCREEN, GObject)
+
+#define XFW_TYPE_WORKSPACE_MANAGER (xfw_workspace_manager_get_type ())
+G_DECLARE_FINAL_TYPE (XfwWorkspaceManager, xfw_workspace_manager, XFW, WORKSPACE_MANAGER, GObject)
+
+#define XFW_TYPE_WORKSPACE_GROUP (xfw_workspace_group_get_type ())
+G_DECLARE_FINAL_TYPE (XfwWorkspaceGroup, xfw_workspace_group, XFW, WORKSPACE_GROUP, GObject)
+
+#define XFW_TYPE_WORKSPACE (xfw_workspace_get_type ())
+G_DECLARE_FINAL_TYPE (XfwWorkspace, xfw_workspace, XFW, WORKSPACE, GObject)
+
+#define XFW_TYPE_MONITOR (xfw_monitor_get_type ())
+G_DECLARE_FINAL_TYPE (XfwMonitor, xfw_monitor, XFW, MONITOR, GObject)
+
+#define XFW_TYPE_APPLICATION (xfw_application_get_type ())
+G_DECLARE_FINAL_TYPE (XfwApplication, xfw_application, XFW, APPLICATION, GObject)
+
+#define XFW_TYPE_WINDOW (xfw_window_get_type ())
+G_DECLARE_FINAL_TYPE (XfwWindow, xfw_window, XFW, WINDOW, GObject)
+
+XfwWindowing
+xfw_windowing_get (void);
+
+/* screen */
+XfwScreen *
+xfw_screen_get_default (void);
+
+XfwWorkspaceManager *
+xfw_screen_get_workspace_manager (XfwScreen *screen);
+
+GList *
+xfw_screen_get_windows (XfwScreen *screen);
+
+XfwWindow *
+xfw_screen_get_active_window (XfwScreen *screen);
+
+/* workspaces */
+GList *
+xfw_workspace_manager_list_workspace_groups (XfwWorkspaceManager *manager);
+
+GList *
+xfw_workspace_group_list_workspaces (XfwWorkspaceGroup *group);
+
+XfwWorkspace *
+xfw_workspace_group_get_active_workspace (XfwWorkspaceGroup *group);
+
+gboolean
+xfw_workspace_group_move_viewport (XfwWorkspaceGroup *group,
+                                   gint x,
+                                   gint y,
+                                   GError **error);
+
+guint
+xfw_workspace_get_number (XfwWorkspace *workspace);
+
+XfwWorkspaceState
+xfw_workspace_get_state (XfwWorkspace *workspace);
+
+GdkRectangle *
+xfw_workspace_get_geometry (XfwWorkspace *workspace);
+
+gboolean
+xfw_workspace_activate (XfwWorkspace *workspace,
+                        GError **error);
+
+/* monitors */
+GdkMonitor *
+xfw_monitor_get_gdk_monitor (XfwMonitor *monitor);
+
+/* applications */
+const gchar *
+xfw_application_get_class_id (XfwApplication *app);
+
+const gchar *
+xfw_application_get_name (XfwApplication *app);
+
+GdkPixbuf *
+xfw_application_get_icon (XfwApplication *app,
+                          gint size,
+                          gint scale);
+
+XfwApplicationInstance *
+xfw_application_get_instance (XfwApplication *app,
+                              XfwWindow *window);
+
+gint
+xfw_application_instance_get_pid (XfwApplicationInstance *instance);
+
+/* windows */
+XfwScreen *
+xfw_window_get_screen (XfwWindow *window);
+
+XfwApplication *
+xfw_window_get_application (XfwWindow *window);
+
+const gchar *
+xfw_window_get_name (XfwWindow *window);
+
+GdkPixbuf *
+xfw_window_get_icon (XfwWindow *window,
+                     gint size,
+                     gint scale);
+
+XfwWorkspace *
+xfw_window_get_workspace (XfwWindow *window);
+
+GList *
+xfw_window_get_monitors (XfwWindow *window);
+
+GdkRectangle *
+xfw_window_get_geometry (XfwWindow *window);
+
+gboolean
+xfw_window_is_active (XfwWindow *window);
+
+gboolean
+xfw_window_is_minimized (XfwWindow *window);
+
+gboolean
+xfw_window_is_shaded (XfwWindow *window);
+
+gboolean
+xfw_window_is_pinned (XfwWindow *window);
+
+gboolean
+xfw_window_is_urgent (XfwWindow *window);
+
+gboolean
+xfw_window_is_skip_tasklist (XfwWindow *window);
+
+gboolean
+xfw_window_is_on_workspace (XfwWindow *window,
+                            XfwWorkspace *workspace);
+
+gboolean
+xfw_window_is_in_viewport (XfwWindow *window,
+                           XfwWorkspace *workspace);
+
+gboolean
+xfw_window_activate (XfwWindow *window,
+                     guint64 event_timestamp,
+                     GError **error);
+
+gboolean
+xfw_window_close (XfwWindow *window,
+                  guint64 event_timestamp,
+                  GError **error);
+
+gboolean
+xfw_window_set_minimized (XfwWindow *window,
+                          gboolean is_minimized,
+                          GError **error);
+
+gboolean
+xfw_window_set_maximized (XfwWindow *window,
+                          gboolean is_maximized,
+                          GError **error);
+
+gboolean
+xfw_window_set_geometry (XfwWindow *window,
+                         const GdkRectangle *rect,
+                         GError **error);
+
+gboolean
+xfw_window_set_button_geometry (XfwWindow *window,
+                                GdkWindow *relative_to,
+                                const GdkRectangle *rect,
+                                GError **error);
+
+/* scripting the mock from the benchmark */
+XfwApplication *
+xfw_mock_application_new (const gchar *class_id,
+                          const gchar *name);
+
+void
+xfw_mock_application_set_name (XfwApplication *app,
+                               const gchar *name);
+
+XfwWindow *
+xfw_mock_window_open (XfwApplication *app,
+                      const gchar *name,
+                      guint workspace);
+
+void
+xfw_mock_window_close (XfwWindow *window);
+
+void
+xfw_mock_window_set_name (XfwWindow *window,
+                          const gchar *name);
+
+void
+xfw_mock_window_set_state (XfwWindow *window,
+                           XfwWindowState state);
+
+XfwWindowState
+xfw_mock_window_get_state (XfwWindow *window);
+
+void
+xfw_mock_window_set_workspace (XfwWindow *window,
+                               guint workspace);
+
+void
+xfw_mock_window_icon_changed (XfwWindow *window);
+
+void
+xfw_mock_screen_set_active_window (XfwWindow *window);
+
+guint
+xfw_mock_get_n_workspaces (void);
+
+G_END_DECLS
+
+#endif /* !__XFW_MOCK_H__ */
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __XFW_MOCK_UI_H__
+#define __XFW_MOCK_UI_H__
+
+#include <libxfce4windowing/libxfce4windowing.h>
+
+G_BEGIN_DECLS
+
+GtkWidget *
+xfw_window_action_menu_new (XfwWindow *window);
+
+G_END_DECLS
+
+#endif /* !__XFW_MOCK_UI_H__ */
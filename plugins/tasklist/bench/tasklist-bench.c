@@ -0,0 +1,486 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Drives the tasklist widget in an offscreen window with scripted window
+ * storms from the windowing stand-in, and reports the per-event latency,
+ * the number of relayouts and the memory use for each sort order, with
+ * grouping on and off and in both orientations.
+ *
+ * It needs a display but shows nothing, run "tasklist-bench --help" for the
+ * size of the storms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "libxfce4panel/xfce-panel-plugin-provider.h"
+#include "plugins/tasklist/tasklist-widget.h"
+
+#include <libxfce4windowing/libxfce4windowing.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+
+
+/* time to let the rate limited updates of the tasklist run, in ms */
+#define SETTLE_TIME (300)
+#define PANEL_SIZE (48)
+#define PANEL_LENGTH (1920)
+
+
+
+typedef struct _BenchRun BenchRun;
+typedef void (*BenchEventFunc) (BenchRun *run,
+                                guint n);
+
+typedef struct
+{
+  const gchar *name;
+  BenchEventFunc func;
+} BenchStorm;
+
+struct _BenchRun
+{
+  GtkWidget *window;
+  GtkWidget *tasklist;
+
+  /* the windows of the run, in opening order */
+  GPtrArray *windows;
+  XfwApplication **apps;
+
+  GRand *rand;
+  guint relayouts;
+};
+
+
+
+static gint opt_windows = 200;
+static gint opt_apps = 20;
+static gint opt_seed = 42;
+static gint opt_sort_order = -1;
+
+static const gchar *sort_order_names[] = {
+  "timestamp",
+  "group-timestamp",
+  "title",
+  "group-title",
+  "dnd",
+};
+
+static GOptionEntry option_entries[] = {
+  { "windows", 'w', 0, G_OPTION_ARG_INT, &opt_windows, "Number of windows in each storm", "N" },
+  { "apps", 'a', 0, G_OPTION_ARG_INT, &opt_apps, "Number of applications the windows belong to", "N" },
+  { "seed", 's', 0, G_OPTION_ARG_INT, &opt_seed, "Seed of the event scripts", "N" },
+  { "sort-order", 'o', 0, G_OPTION_ARG_INT, &opt_sort_order, "Only run this sort order (0-4)", "N" },
+  { NULL }
+};
+
+
+
+static void
+bench_open (BenchRun *run,
+            guint n)
+{
+  XfwApplication *app;
+  gchar *name;
+
+  app = run->apps[g_rand_int_range (run->rand, 0, opt_apps)];
+  name = g_strdup_printf ("%s - document %u", xfw_application_get_name (app), n);
+  g_ptr_array_add (run->windows,
+                   xfw_mock_window_open (app, name, g_rand_int_range (run->rand, 0, xfw_mock_get_n_workspaces ())));
+  g_free (name);
+}
+
+
+
+static void
+bench_rename (BenchRun *run,
+              guint n)
+{
+  gchar *name;
+
+  name = g_strdup_printf ("renamed document %u", g_rand_int (run->rand));
+  xfw_mock_window_set_name (g_ptr_array_index (run->windows, n), name);
+  g_free (name);
+}
+
+
+
+static void
+bench_icon (BenchRun *run,
+            guint n)
+{
+  xfw_mock_window_icon_changed (g_ptr_array_index (run->windows, n));
+}
+
+
+
+static void
+bench_urgent (BenchRun *run,
+              guint n)
+{
+  XfwWindow *window = g_ptr_array_index (run->windows, n);
+
+  xfw_mock_window_set_state (window, xfw_mock_window_get_state (window) ^ XFW_WINDOW_STATE_URGENT);
+}
+
+
+
+static void
+bench_minimize (BenchRun *run,
+                guint n)
+{
+  XfwWindow *window = g_ptr_array_index (run->windows, n);
+
+  xfw_mock_window_set_state (window, xfw_mock_window_get_state (window) ^ XFW_WINDOW_STATE_MINIMIZED);
+}
+
+
+
+static void
+bench_activate (BenchRun *run,
+                guint n)
+{
+  xfw_mock_screen_set_active_window (g_ptr_array_index (run->windows, n));
+}
+
+
+
+static void
+bench_workspace_move (BenchRun *run,
+                      guint n)
+{
+  xfw_mock_window_set_workspace (g_ptr_array_index (run->windows, n),
+                                 g_rand_int_range (run->rand, 0, xfw_mock_get_n_workspaces ()));
+}
+
+
+
+static void
+bench_workspace_switch (BenchRun *run,
+                        guint n)
+{
+  XfwScreen *screen;
+  XfwWorkspaceGroup *group;
+  GList *workspaces;
+
+  screen = xfw_screen_get_default ();
+  group = xfw_workspace_manager_list_workspace_groups (xfw_screen_get_workspace_manager (screen))->data;
+  workspaces = xfw_workspace_group_list_workspaces (group);
+
+  /* cycle through the workspaces, the storm ends on the first one */
+  xfw_workspace_activate (g_list_nth_data (workspaces, (n + 1) % g_list_length (workspaces)), NULL);
+
+  g_object_unref (screen);
+}
+
+
+
+static void
+bench_app_rename (BenchRun *run,
+                  guint n)
+{
+  XfwApplication *app = run->apps[n % opt_apps];
+  gchar *name;
+
+  name = g_strdup_printf ("Application %u", g_rand_int (run->rand));
+  xfw_mock_application_set_name (app, name);
+  g_free (name);
+}
+
+
+
+static void
+bench_close (BenchRun *run,
+             guint n)
+{
+  XfwWindow *window;
+
+  /* close in a random order, the last window of the array is moved into
+   * the hole so the indexes of the storm stay valid */
+  n = g_rand_int_range (run->rand, 0, run->windows->len);
+  window = g_ptr_array_index (run->windows, n);
+  g_ptr_array_remove_index_fast (run->windows, n);
+  xfw_mock_window_close (window);
+}
+
+
+
+static const BenchStorm storms[] = {
+  { "open", bench_open },
+  { "rename", bench_rename },
+  { "icon", bench_icon },
+  { "urgent", bench_urgent },
+  { "minimize", bench_minimize },
+  { "activate", bench_activate },
+  { "workspace-move", bench_workspace_move },
+  { "workspace-switch", bench_workspace_switch },
+  { "app-rename", bench_app_rename },
+  { "close", bench_close },
+};
+
+
+
+static gint64
+bench_get_rss (void)
+{
+  gchar *contents;
+  gchar **fields;
+  gint64 rss = -1;
+
+  /* resident set size in KiB, Linux only */
+  if (g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL))
+    {
+      fields = g_strsplit (contents, " ", -1);
+      if (g_strv_length (fields) > 1)
+        rss = g_ascii_strtoll (fields[1], NULL, 10) * sysconf (_SC_PAGESIZE) / 1024;
+      g_strfreev (fields);
+      g_free (contents);
+    }
+
+  return rss;
+}
+
+
+
+static gboolean
+bench_settle_timeout (gpointer user_data)
+{
+  *((gboolean *) user_data) = TRUE;
+
+  return FALSE;
+}
+
+
+
+static void
+bench_flush (BenchRun *run)
+{
+  /* run the queued relayout, as the frame clock would */
+  gtk_container_check_resize (GTK_CONTAINER (run->window));
+
+  while (g_main_context_iteration (NULL, FALSE))
+    ;
+}
+
+
+
+static void
+bench_settle (BenchRun *run)
+{
+  gboolean done = FALSE;
+
+  /* let the deferred updates of the tasklist run */
+  g_timeout_add (SETTLE_TIME, bench_settle_timeout, &done);
+  while (!done)
+    {
+      g_main_context_iteration (NULL, TRUE);
+      gtk_container_check_resize (GTK_CONTAINER (run->window));
+    }
+}
+
+
+
+static gint
+bench_compare_gint64 (gconstpointer a,
+                      gconstpointer b)
+{
+  gint64 value_a = *((const gint64 *) a);
+  gint64 value_b = *((const gint64 *) b);
+
+  return value_a < value_b ? -1 : value_a > value_b;
+}
+
+
+
+static void
+bench_size_allocate (GtkWidget *widget,
+                     GtkAllocation *allocation,
+                     BenchRun *run)
+{
+  run->relayouts++;
+}
+
+
+
+static void
+bench_run_storm (BenchRun *run,
+                 const gchar *config,
+                 const BenchStorm *storm)
+{
+  GArray *latencies;
+  guint n, n_events;
+  gint64 start, elapsed, sum = 0, rss;
+  gint64 *values;
+
+  if (storm->func == bench_open)
+    n_events = opt_windows;
+  else if (storm->func == bench_workspace_switch)
+    n_events = xfw_mock_get_n_workspaces () * 4;
+  else if (storm->func == bench_app_rename)
+    n_events = opt_apps;
+  else
+    n_events = run->windows->len;
+  if (n_events == 0)
+    return;
+
+  latencies = g_array_sized_new (FALSE, FALSE, sizeof (gint64), n_events);
+  run->relayouts = 0;
+
+  for (n = 0; n < n_events; n++)
+    {
+      start = g_get_monotonic_time ();
+      storm->func (run, n);
+      bench_flush (run);
+      elapsed = g_get_monotonic_time () - start;
+
+      g_array_append_val (latencies, elapsed);
+      sum += elapsed;
+    }
+
+  bench_settle (run);
+  rss = bench_get_rss ();
+
+  g_array_sort (latencies, bench_compare_gint64);
+  values = (gint64 *) (gpointer) latencies->data;
+
+  g_print ("%-36s %-16s %6u %8" G_GINT64_FORMAT " %8" G_GINT64_FORMAT " %8" G_GINT64_FORMAT
+           " %8" G_GINT64_FORMAT " %9u %9" G_GINT64_FORMAT "\n",
+           config, storm->name, n_events, sum / n_events,
+           values[n_events / 2], values[MIN (n_events - 1, n_events * 99 / 100)],
+           values[n_events - 1], run->relayouts, rss);
+
+  g_array_free (latencies, TRUE);
+}
+
+
+
+static void
+bench_run (XfcePanelPluginMode mode,
+           gboolean grouping,
+           guint sort_order)
+{
+  BenchRun run;
+  GtkWidget *plugin;
+  gchar *config;
+  gchar *class_id, *name;
+  guint n;
+
+  run.rand = g_rand_new_with_seed (opt_seed);
+  run.windows = g_ptr_array_new ();
+  run.apps = g_new (XfwApplication *, opt_apps);
+  for (n = 0; n < (guint) opt_apps; n++)
+    {
+      class_id = g_strdup_printf ("application-%u", n);
+      name = g_strdup_printf ("Application %u", n);
+      run.apps[n] = xfw_mock_application_new (class_id, name);
+      g_free (class_id);
+      g_free (name);
+    }
+
+  /* the tasklist needs a plugin parent for its icon size and menus */
+  plugin = g_object_new (XFCE_TYPE_PANEL_PLUGIN,
+                         "name", "tasklist",
+                         "unique-id", 1,
+                         NULL);
+  xfce_panel_plugin_provider_set_mode (XFCE_PANEL_PLUGIN_PROVIDER (plugin), mode);
+  xfce_panel_plugin_provider_set_size (XFCE_PANEL_PLUGIN_PROVIDER (plugin), PANEL_SIZE);
+  xfce_panel_plugin_provider_set_nrows (XFCE_PANEL_PLUGIN_PROVIDER (plugin), 1);
+
+  run.tasklist = g_object_new (XFCE_TYPE_TASKLIST,
+                               "grouping", grouping,
+                               "sort-order", sort_order,
+                               "include-all-monitors", TRUE,
+                               NULL);
+  xfce_tasklist_set_mode (XFCE_TASKLIST (run.tasklist), mode);
+  xfce_tasklist_set_size (XFCE_TASKLIST (run.tasklist), PANEL_SIZE);
+  xfce_tasklist_set_nrows (XFCE_TASKLIST (run.tasklist), 1);
+  g_signal_connect_after (G_OBJECT (run.tasklist), "size-allocate",
+                          G_CALLBACK (bench_size_allocate), &run);
+  gtk_container_add (GTK_CONTAINER (plugin), run.tasklist);
+
+  /* realizing the tasklist connects it to the mock screen */
+  run.window = gtk_offscreen_window_new ();
+  if (mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL)
+    gtk_widget_set_size_request (run.window, PANEL_LENGTH, PANEL_SIZE);
+  else
+    gtk_widget_set_size_request (run.window, PANEL_SIZE, PANEL_LENGTH);
+  gtk_container_add (GTK_CONTAINER (run.window), plugin);
+  gtk_widget_show_all (run.window);
+  bench_flush (&run);
+
+  config = g_strdup_printf ("%s/%s/%s",
+                            mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL ? "horizontal" : "vertical",
+                            grouping ? "grouped" : "ungrouped",
+                            sort_order_names[sort_order]);
+
+  for (n = 0; n < G_N_ELEMENTS (storms); n++)
+    bench_run_storm (&run, config, &storms[n]);
+
+  gtk_widget_destroy (run.window);
+  while (g_main_context_iteration (NULL, FALSE))
+    ;
+
+  for (n = 0; n < (guint) opt_apps; n++)
+    g_object_unref (run.apps[n]);
+  g_free (run.apps);
+  g_ptr_array_free (run.windows, TRUE);
+  g_rand_free (run.rand);
+  g_free (config);
+}
+
+
+
+gint
+main (gint argc,
+      gchar **argv)
+{
+  GError *error = NULL;
+  guint sort_order;
+  gint grouping, vertical;
+
+  if (!gtk_init_with_args (&argc, &argv, NULL, option_entries, NULL, &error))
+    {
+      g_printerr ("%s: %s\n", g_get_prgname (), error != NULL ? error->message : "Unable to initialize GTK+");
+      g_clear_error (&error);
+      return EXIT_FAILURE;
+    }
+
+  if (opt_windows < 1 || opt_apps < 1
+      || opt_sort_order >= (gint) G_N_ELEMENTS (sort_order_names))
+    {
+      g_printerr ("%s: Invalid arguments\n", g_get_prgname ());
+      return EXIT_FAILURE;
+    }
+
+  g_print ("%-36s %-16s %6s %8s %8s %8s %8s %9s %9s\n",
+           "configuration", "event", "count", "mean-us", "p50-us", "p99-us",
+           "max-us", "relayouts", "rss-kib");
+
+  for (vertical = 0; vertical < 2; vertical++)
+    for (grouping = 0; grouping < 2; grouping++)
+      for (sort_order = 0; sort_order < G_N_ELEMENTS (sort_order_names); sort_order++)
+        if (opt_sort_order < 0 || sort_order == (guint) opt_sort_order)
+          bench_run (vertical ? XFCE_PANEL_PLUGIN_MODE_VERTICAL : XFCE_PANEL_PLUGIN_MODE_HORIZONTAL,
+                     grouping, sort_order);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1075 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <libxfce4windowing/libxfce4windowing.h>
+#include <libxfce4windowing/xfw-x11.h>
+#include <libxfce4windowingui/libxfce4windowingui.h>
+
+
+
+#define N_WORKSPACES (4)
+#define SCREEN_WIDTH (1920)
+#define SCREEN_HEIGHT (1080)
+
+
+
+enum
+{
+  SCREEN_WINDOW_OPENED,
+  SCREEN_WINDOW_CLOSED,
+  SCREEN_ACTIVE_WINDOW_CHANGED,
+  SCREEN_LAST_SIGNAL
+};
+
+enum
+{
+  GROUP_ACTIVE_WORKSPACE_CHANGED,
+  GROUP_VIEWPORTS_CHANGED,
+  GROUP_LAST_SIGNAL
+};
+
+enum
+{
+  APPLICATION_ICON_CHANGED,
+  APPLICATION_LAST_SIGNAL
+};
+
+enum
+{
+  WINDOW_NAME_CHANGED,
+  WINDOW_ICON_CHANGED,
+  WINDOW_STATE_CHANGED,
+  WINDOW_WORKSPACE_CHANGED,
+  WINDOW_GEOMETRY_CHANGED,
+  WINDOW_LAST_SIGNAL
+};
+
+enum
+{
+  PROP_0,
+  PROP_NAME
+};
+
+enum
+{
+  PROP_WINDOW_0,
+  PROP_MONITORS
+};
+
+
+
+struct _XfwApplicationInstance
+{
+  gint pid;
+};
+
+struct _XfwScreen
+{
+  GObject __parent__;
+
+  XfwWorkspaceManager *manager;
+
+  /* the open windows, in stacking order */
+  GList *windows;
+  XfwWindow *active_window;
+};
+
+struct _XfwWorkspaceManager
+{
+  GObject __parent__;
+
+  GList *groups;
+};
+
+struct _XfwWorkspaceGroup
+{
+  GObject __parent__;
+
+  GList *workspaces;
+  XfwWorkspace *active_workspace;
+};
+
+struct _XfwWorkspace
+{
+  GObject __parent__;
+
+  guint number;
+  GdkRectangle geometry;
+};
+
+struct _XfwMonitor
+{
+  GObject __parent__;
+};
+
+struct _XfwApplication
+{
+  GObject __parent__;
+
+  gchar *class_id;
+  gchar *name;
+  GdkPixbuf *icon;
+  XfwApplicationInstance instance;
+};
+
+struct _XfwWindow
+{
+  GObject __parent__;
+
+  XfwScreen *screen;
+  XfwApplication *app;
+  gchar *name;
+  XfwWindowState state;
+  XfwWorkspace *workspace;
+  GdkRectangle geometry;
+
+  /* a flat colored icon, regenerated when it changes */
+  GdkPixbuf *icon;
+  guint icon_serial;
+};
+
+
+
+static guint screen_signals[SCREEN_LAST_SIGNAL];
+static guint group_signals[GROUP_LAST_SIGNAL];
+static guint application_signals[APPLICATION_LAST_SIGNAL];
+static guint window_signals[WINDOW_LAST_SIGNAL];
+
+static XfwScreen *mock_screen = NULL;
+
+
+
+G_DEFINE_FINAL_TYPE (XfwScreen, xfw_screen, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwWorkspaceManager, xfw_workspace_manager, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwWorkspaceGroup, xfw_workspace_group, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwWorkspace, xfw_workspace, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwMonitor, xfw_monitor, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwApplication, xfw_application, G_TYPE_OBJECT)
+G_DEFINE_FINAL_TYPE (XfwWindow, xfw_window, G_TYPE_OBJECT)
+
+
+
+static void
+xfw_screen_class_init (XfwScreenClass *klass)
+{
+  screen_signals[SCREEN_WINDOW_OPENED] =
+    g_signal_new (g_intern_static_string ("window-opened"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 1, XFW_TYPE_WINDOW);
+
+  screen_signals[SCREEN_WINDOW_CLOSED] =
+    g_signal_new (g_intern_static_string ("window-closed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 1, XFW_TYPE_WINDOW);
+
+  screen_signals[SCREEN_ACTIVE_WINDOW_CHANGED] =
+    g_signal_new (g_intern_static_string ("active-window-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 1, XFW_TYPE_WINDOW);
+}
+
+
+
+static void
+xfw_screen_init (XfwScreen *screen)
+{
+}
+
+
+
+static void
+xfw_workspace_manager_class_init (XfwWorkspaceManagerClass *klass)
+{
+}
+
+
+
+static void
+xfw_workspace_manager_init (XfwWorkspaceManager *manager)
+{
+}
+
+
+
+static void
+xfw_workspace_group_class_init (XfwWorkspaceGroupClass *klass)
+{
+  group_signals[GROUP_ACTIVE_WORKSPACE_CHANGED] =
+    g_signal_new (g_intern_static_string ("active-workspace-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 1, XFW_TYPE_WORKSPACE);
+
+  group_signals[GROUP_VIEWPORTS_CHANGED] =
+    g_signal_new (g_intern_static_string ("viewports-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
+
+
+
+static void
+xfw_workspace_group_init (XfwWorkspaceGroup *group)
+{
+}
+
+
+
+static void
+xfw_workspace_class_init (XfwWorkspaceClass *klass)
+{
+}
+
+
+
+static void
+xfw_workspace_init (XfwWorkspace *workspace)
+{
+}
+
+
+
+static void
+xfw_monitor_class_init (XfwMonitorClass *klass)
+{
+}
+
+
+
+static void
+xfw_monitor_init (XfwMonitor *monitor)
+{
+}
+
+
+
+static void
+xfw_application_get_property (GObject *object,
+                              guint prop_id,
+                              GValue *value,
+                              GParamSpec *pspec)
+{
+  XfwApplication *app = XFW_APPLICATION (object);
+
+  switch (prop_id)
+    {
+    case PROP_NAME:
+      g_value_set_string (value, app->name);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+xfw_application_finalize (GObject *object)
+{
+  XfwApplication *app = XFW_APPLICATION (object);
+
+  g_free (app->class_id);
+  g_free (app->name);
+  if (app->icon != NULL)
+    g_object_unref (app->icon);
+
+  (*G_OBJECT_CLASS (xfw_application_parent_class)->finalize) (object);
+}
+
+
+
+static void
+xfw_application_class_init (XfwApplicationClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->get_property = xfw_application_get_property;
+  gobject_class->finalize = xfw_application_finalize;
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_NAME,
+                                   g_param_spec_string ("name", NULL, NULL,
+                                                        NULL,
+                                                        G_PARAM_READABLE
+                                                          | G_PARAM_STATIC_STRINGS));
+
+  application_signals[APPLICATION_ICON_CHANGED] =
+    g_signal_new (g_intern_static_string ("icon-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
+
+
+
+static void
+xfw_application_init (XfwApplication *app)
+{
+}
+
+
+
+static void
+xfw_window_get_property (GObject *object,
+                         guint prop_id,
+                         GValue *value,
+                         GParamSpec *pspec)
+{
+  switch (prop_id)
+    {
+    case PROP_MONITORS:
+      g_value_set_pointer (value, NULL);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+xfw_window_finalize (GObject *object)
+{
+  XfwWindow *window = XFW_WINDOW (object);
+
+  g_free (window->name);
+  g_object_unref (window->app);
+  if (window->icon != NULL)
+    g_object_unref (window->icon);
+
+  (*G_OBJECT_CLASS (xfw_window_parent_class)->finalize) (object);
+}
+
+
+
+static void
+xfw_window_class_init (XfwWindowClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->get_property = xfw_window_get_property;
+  gobject_class->finalize = xfw_window_finalize;
+
+  g_object_class_install_property (gobject_class,
+                                   PROP_MONITORS,
+                                   g_param_spec_pointer ("monitors", NULL, NULL,
+                                                         G_PARAM_READABLE
+                                                           | G_PARAM_STATIC_STRINGS));
+
+  window_signals[WINDOW_NAME_CHANGED] =
+    g_signal_new (g_intern_static_string ("name-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+
+  window_signals[WINDOW_ICON_CHANGED] =
+    g_signal_new (g_intern_static_string ("icon-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+
+  window_signals[WINDOW_STATE_CHANGED] =
+    g_signal_new (g_intern_static_string ("state-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_UINT);
+
+  window_signals[WINDOW_WORKSPACE_CHANGED] =
+    g_signal_new (g_intern_static_string ("workspace-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+
+  window_signals[WINDOW_GEOMETRY_CHANGED] =
+    g_signal_new (g_intern_static_string ("geometry-changed"),
+                  G_TYPE_FROM_CLASS (klass), G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+}
+
+
+
+static void
+xfw_window_init (XfwWindow *window)
+{
+  window->geometry.width = 800;
+  window->geometry.height = 600;
+}
+
+
+
+static GdkPixbuf *
+xfw_mock_icon_new (GdkPixbuf **icon,
+                   const gchar *seed,
+                   guint serial,
+                   gint size)
+{
+  guint32 color;
+
+  if (*icon != NULL && gdk_pixbuf_get_width (*icon) == size)
+    return *icon;
+
+  if (*icon != NULL)
+    g_object_unref (*icon);
+
+  /* a flat color that changes with the seed and serial, enough to
+   * exercise the icon cache and the image widgets */
+  color = (g_str_hash (seed) + serial * 0x9e3779b9) | 0xff;
+  *icon = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, size, size);
+  gdk_pixbuf_fill (*icon, color);
+
+  return *icon;
+}
+
+
+
+XfwWindowing
+xfw_windowing_get (void)
+{
+  /* not X11, so the tasklist never talks to the X server about our windows */
+  return XFW_WINDOWING_UNKNOWN;
+}
+
+
+
+XfwScreen *
+xfw_screen_get_default (void)
+{
+  XfwWorkspaceGroup *group;
+  XfwWorkspace *workspace;
+  guint n;
+
+  if (G_UNLIKELY (mock_screen == NULL))
+    {
+      mock_screen = g_object_new (XFW_TYPE_SCREEN, NULL);
+      mock_screen->manager = g_object_new (XFW_TYPE_WORKSPACE_MANAGER, NULL);
+
+      group = g_object_new (XFW_TYPE_WORKSPACE_GROUP, NULL);
+      mock_screen->manager->groups = g_list_append (NULL, group);
+
+      for (n = 0; n < N_WORKSPACES; n++)
+        {
+          workspace = g_object_new (XFW_TYPE_WORKSPACE, NULL);
+          workspace->number = n;
+          workspace->geometry.width = SCREEN_WIDTH;
+          workspace->geometry.height = SCREEN_HEIGHT;
+          group->workspaces = g_list_append (group->workspaces, workspace);
+        }
+
+      group->active_workspace = group->workspaces->data;
+    }
+
+  return g_object_ref (mock_screen);
+}
+
+
+
+XfwWorkspaceManager *
+xfw_screen_get_workspace_manager (XfwScreen *screen)
+{
+  g_return_val_if_fail (XFW_IS_SCREEN (screen), NULL);
+  return screen->manager;
+}
+
+
+
+GList *
+xfw_screen_get_windows (XfwScreen *screen)
+{
+  g_return_val_if_fail (XFW_IS_SCREEN (screen), NULL);
+  return screen->windows;
+}
+
+
+
+XfwWindow *
+xfw_screen_get_active_window (XfwScreen *screen)
+{
+  g_return_val_if_fail (XFW_IS_SCREEN (screen), NULL);
+  return screen->active_window;
+}
+
+
+
+GList *
+xfw_workspace_manager_list_workspace_groups (XfwWorkspaceManager *manager)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE_MANAGER (manager), NULL);
+  return manager->groups;
+}
+
+
+
+GList *
+xfw_workspace_group_list_workspaces (XfwWorkspaceGroup *group)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE_GROUP (group), NULL);
+  return group->workspaces;
+}
+
+
+
+XfwWorkspace *
+xfw_workspace_group_get_active_workspace (XfwWorkspaceGroup *group)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE_GROUP (group), NULL);
+  return group->active_workspace;
+}
+
+
+
+gboolean
+xfw_workspace_group_move_viewport (XfwWorkspaceGroup *group,
+                                   gint x,
+                                   gint y,
+                                   GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE_GROUP (group), FALSE);
+  return TRUE;
+}
+
+
+
+guint
+xfw_workspace_get_number (XfwWorkspace *workspace)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE (workspace), 0);
+  return workspace->number;
+}
+
+
+
+XfwWorkspaceState
+xfw_workspace_get_state (XfwWorkspace *workspace)
+{
+  XfwWorkspaceGroup *group;
+
+  g_return_val_if_fail (XFW_IS_WORKSPACE (workspace), XFW_WORKSPACE_STATE_NONE);
+
+  group = mock_screen->manager->groups->data;
+
+  return group->active_workspace == workspace ? XFW_WORKSPACE_STATE_ACTIVE : XFW_WORKSPACE_STATE_NONE;
+}
+
+
+
+GdkRectangle *
+xfw_workspace_get_geometry (XfwWorkspace *workspace)
+{
+  g_return_val_if_fail (XFW_IS_WORKSPACE (workspace), NULL);
+  return &workspace->geometry;
+}
+
+
+
+gboolean
+xfw_workspace_activate (XfwWorkspace *workspace,
+                        GError **error)
+{
+  XfwWorkspaceGroup *group;
+  XfwWorkspace *previous;
+
+  g_return_val_if_fail (XFW_IS_WORKSPACE (workspace), FALSE);
+
+  group = mock_screen->manager->groups->data;
+  if (group->active_workspace != workspace)
+    {
+      previous = group->active_workspace;
+      group->active_workspace = workspace;
+      g_signal_emit (group, group_signals[GROUP_ACTIVE_WORKSPACE_CHANGED], 0, previous);
+    }
+
+  return TRUE;
+}
+
+
+
+GdkMonitor *
+xfw_monitor_get_gdk_monitor (XfwMonitor *monitor)
+{
+  g_return_val_if_fail (XFW_IS_MONITOR (monitor), NULL);
+  return NULL;
+}
+
+
+
+const gchar *
+xfw_application_get_class_id (XfwApplication *app)
+{
+  g_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+  return app->class_id;
+}
+
+
+
+const gchar *
+xfw_application_get_name (XfwApplication *app)
+{
+  g_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+  return app->name;
+}
+
+
+
+GdkPixbuf *
+xfw_application_get_icon (XfwApplication *app,
+                          gint size,
+                          gint scale)
+{
+  g_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+  return xfw_mock_icon_new (&app->icon, app->class_id, 0, size * scale);
+}
+
+
+
+XfwApplicationInstance *
+xfw_application_get_instance (XfwApplication *app,
+                              XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+  return &app->instance;
+}
+
+
+
+gint
+xfw_application_instance_get_pid (XfwApplicationInstance *instance)
+{
+  g_return_val_if_fail (instance != NULL, 0);
+  return instance->pid;
+}
+
+
+
+XfwScreen *
+xfw_window_get_screen (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return window->screen;
+}
+
+
+
+XfwApplication *
+xfw_window_get_application (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return window->app;
+}
+
+
+
+const gchar *
+xfw_window_get_name (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return window->name;
+}
+
+
+
+GdkPixbuf *
+xfw_window_get_icon (XfwWindow *window,
+                     gint size,
+                     gint scale)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return xfw_mock_icon_new (&window->icon, window->app->class_id, window->icon_serial, size * scale);
+}
+
+
+
+XfwWorkspace *
+xfw_window_get_workspace (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return window->workspace;
+}
+
+
+
+GList *
+xfw_window_get_monitors (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return NULL;
+}
+
+
+
+GdkRectangle *
+xfw_window_get_geometry (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return &window->geometry;
+}
+
+
+
+gboolean
+xfw_window_is_active (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return window->screen->active_window == window;
+}
+
+
+
+gboolean
+xfw_window_is_minimized (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return (window->state & XFW_WINDOW_STATE_MINIMIZED) != 0;
+}
+
+
+
+gboolean
+xfw_window_is_shaded (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return (window->state & XFW_WINDOW_STATE_SHADED) != 0;
+}
+
+
+
+gboolean
+xfw_window_is_pinned (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return (window->state & XFW_WINDOW_STATE_PINNED) != 0;
+}
+
+
+
+gboolean
+xfw_window_is_urgent (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return (window->state & XFW_WINDOW_STATE_URGENT) != 0;
+}
+
+
+
+gboolean
+xfw_window_is_skip_tasklist (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return (window->state & XFW_WINDOW_STATE_SKIP_TASKLIST) != 0;
+}
+
+
+
+gboolean
+xfw_window_is_on_workspace (XfwWindow *window,
+                            XfwWorkspace *workspace)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return window->workspace == NULL || window->workspace == workspace;
+}
+
+
+
+gboolean
+xfw_window_is_in_viewport (XfwWindow *window,
+                           XfwWorkspace *workspace)
+{
+  return xfw_window_is_on_workspace (window, workspace);
+}
+
+
+
+gboolean
+xfw_window_activate (XfwWindow *window,
+                     guint64 event_timestamp,
+                     GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  xfw_mock_screen_set_active_window (window);
+  return TRUE;
+}
+
+
+
+gboolean
+xfw_window_close (XfwWindow *window,
+                  guint64 event_timestamp,
+                  GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  xfw_mock_window_close (window);
+  return TRUE;
+}
+
+
+
+gboolean
+xfw_window_set_minimized (XfwWindow *window,
+                          gboolean is_minimized,
+                          GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+
+  if (is_minimized)
+    xfw_mock_window_set_state (window, window->state | XFW_WINDOW_STATE_MINIMIZED);
+  else
+    xfw_mock_window_set_state (window, window->state & ~XFW_WINDOW_STATE_MINIMIZED);
+
+  return TRUE;
+}
+
+
+
+gboolean
+xfw_window_set_maximized (XfwWindow *window,
+                          gboolean is_maximized,
+                          GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+
+  if (is_maximized)
+    xfw_mock_window_set_state (window, window->state | XFW_WINDOW_STATE_MAXIMIZED);
+  else
+    xfw_mock_window_set_state (window, window->state & ~XFW_WINDOW_STATE_MAXIMIZED);
+
+  return TRUE;
+}
+
+
+
+gboolean
+xfw_window_set_geometry (XfwWindow *window,
+                         const GdkRectangle *rect,
+                         GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  g_return_val_if_fail (rect != NULL, FALSE);
+
+  window->geometry = *rect;
+  g_signal_emit (window, window_signals[WINDOW_GEOMETRY_CHANGED], 0);
+
+  return TRUE;
+}
+
+
+
+gboolean
+xfw_window_set_button_geometry (XfwWindow *window,
+                                GdkWindow *relative_to,
+                                const GdkRectangle *rect,
+                                GError **error)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), FALSE);
+  return TRUE;
+}
+
+
+
+gulong
+xfw_window_x11_get_xid (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), 0);
+  return 0;
+}
+
+
+
+GtkWidget *
+xfw_window_action_menu_new (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  return gtk_menu_new ();
+}
+
+
+
+XfwApplication *
+xfw_mock_application_new (const gchar *class_id,
+                          const gchar *name)
+{
+  XfwApplication *app;
+
+  g_return_val_if_fail (class_id != NULL, NULL);
+
+  app = g_object_new (XFW_TYPE_APPLICATION, NULL);
+  app->class_id = g_strdup (class_id);
+  app->name = g_strdup (name != NULL ? name : class_id);
+
+  return app;
+}
+
+
+
+void
+xfw_mock_application_set_name (XfwApplication *app,
+                               const gchar *name)
+{
+  g_return_if_fail (XFW_IS_APPLICATION (app));
+
+  g_free (app->name);
+  app->name = g_strdup (name);
+  g_object_notify (G_OBJECT (app), "name");
+}
+
+
+
+XfwWindow *
+xfw_mock_window_open (XfwApplication *app,
+                      const gchar *name,
+                      guint workspace)
+{
+  XfwScreen *screen;
+  XfwWorkspaceGroup *group;
+  XfwWindow *window;
+
+  g_return_val_if_fail (XFW_IS_APPLICATION (app), NULL);
+
+  /* the default screen keeps its own reference */
+  screen = xfw_screen_get_default ();
+  g_object_unref (screen);
+  group = screen->manager->groups->data;
+
+  window = g_object_new (XFW_TYPE_WINDOW, NULL);
+  window->screen = screen;
+  window->app = g_object_ref (app);
+  window->name = g_strdup (name);
+  window->workspace = g_list_nth_data (group->workspaces, workspace % N_WORKSPACES);
+
+  /* the screen owns the window until it is closed */
+  screen->windows = g_list_append (screen->windows, window);
+  g_signal_emit (screen, screen_signals[SCREEN_WINDOW_OPENED], 0, window);
+
+  return window;
+}
+
+
+
+void
+xfw_mock_window_close (XfwWindow *window)
+{
+  XfwScreen *screen;
+
+  g_return_if_fail (XFW_IS_WINDOW (window));
+
+  screen = window->screen;
+  if (g_list_find (screen->windows, window) == NULL)
+    return;
+
+  screen->windows = g_list_remove (screen->windows, window);
+  if (screen->active_window == window)
+    screen->active_window = NULL;
+
+  g_signal_emit (screen, screen_signals[SCREEN_WINDOW_CLOSED], 0, window);
+  g_object_unref (window);
+}
+
+
+
+void
+xfw_mock_window_set_name (XfwWindow *window,
+                          const gchar *name)
+{
+  g_return_if_fail (XFW_IS_WINDOW (window));
+
+  g_free (window->name);
+  window->name = g_strdup (name);
+  g_signal_emit (window, window_signals[WINDOW_NAME_CHANGED], 0);
+}
+
+
+
+void
+xfw_mock_window_set_state (XfwWindow *window,
+                           XfwWindowState state)
+{
+  XfwWindowState changed;
+
+  g_return_if_fail (XFW_IS_WINDOW (window));
+
+  changed = window->state ^ state;
+  if (changed == 0)
+    return;
+
+  window->state = state;
+  g_signal_emit (window, window_signals[WINDOW_STATE_CHANGED], 0, changed, state);
+}
+
+
+
+XfwWindowState
+xfw_mock_window_get_state (XfwWindow *window)
+{
+  g_return_val_if_fail (XFW_IS_WINDOW (window), XFW_WINDOW_STATE_NONE);
+  return window->state;
+}
+
+
+
+void
+xfw_mock_window_set_workspace (XfwWindow *window,
+                               guint workspace)
+{
+  XfwWorkspaceGroup *group;
+
+  g_return_if_fail (XFW_IS_WINDOW (window));
+
+  group = window->screen->manager->groups->data;
+  window->workspace = g_list_nth_data (group->workspaces, workspace % N_WORKSPACES);
+  g_signal_emit (window, window_signals[WINDOW_WORKSPACE_CHANGED], 0);
+}
+
+
+
+void
+xfw_mock_window_icon_changed (XfwWindow *window)
+{
+  g_return_if_fail (XFW_IS_WINDOW (window));
+
+  window->icon_serial++;
+  g_clear_object (&window->icon);
+  g_signal_emit (window, window_signals[WINDOW_ICON_CHANGED], 0);
+}
+
+
+
+void
+xfw_mock_screen_set_active_window (XfwWindow *window)
+{
+  XfwScreen *screen;
+  XfwWindow *previous;
+
+  g_return_if_fail (window == NULL || XFW_IS_WINDOW (window));
+
+  screen = xfw_screen_get_default ();
+  if (screen->active_window != window)
+    {
+      previous = screen->active_window;
+      screen->active_window = window;
+      g_signal_emit (screen, screen_signals[SCREEN_ACTIVE_WINDOW_CHANGED], 0, previous);
+    }
+  g_object_unref (screen);
+}
+
+
+
+guint
+xfw_mock_get_n_workspaces (void)
+{
+  return N_WORKSPACES;
+}
@@ -0,0 +1,585 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "tasklist-thumbnails.h"
+
+#include "common/panel-debug.h"
+#include "common/panel-private.h"
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+#include <cairo-xlib.h>
+#include <gdk/gdkx.h>
+
+
+
+#define THUMBNAIL_MAX_WIDTH (256)
+#define THUMBNAIL_MAX_HEIGHT (192)
+#define THUMBNAIL_REFRESH_RATE (1000) /* ms between captures of a window */
+#define THUMBNAILS_MAX_SIZE (16 * 1024 * 1024) /* memory budget of the snapshots */
+
+
+
+typedef struct _TasklistThumbnail TasklistThumbnail;
+
+static void
+tasklist_thumbnails_set_surface (TasklistThumbnails *thumbnails,
+                                 TasklistThumbnail *thumbnail,
+                                 cairo_surface_t *surface);
+static gboolean
+tasklist_thumbnails_refresh (gpointer data);
+
+
+
+struct _TasklistThumbnails
+{
+  GdkDisplay *display;
+  Display *xdisplay;
+  GdkScreen *screen;
+
+  /* damage extension event base */
+  gint damage_event_base;
+
+  /* watched windows, xid -> thumbnail */
+  GHashTable *thumbnails;
+
+  /* damaged drawables, frame -> thumbnail */
+  GHashTable *frames;
+
+  /* captured snapshots, most recently used first */
+  GQueue lru;
+
+  /* size of the snapshots and of the server pixmaps we hold */
+  gsize size;
+
+  /* rate limited capture of the damaged windows */
+  guint refresh_id;
+};
+
+struct _TasklistThumbnail
+{
+  Window xid;
+
+  /* toplevel frame of the window and its damage object */
+  Window frame;
+  Damage damage;
+
+  /* downscaled snapshot of the window, can be evicted */
+  cairo_surface_t *surface;
+  gsize size;
+  gint64 captured;
+
+  /* window contents changed since the last capture */
+  guint dirty : 1;
+
+  /* snapshot was evicted, it is not refreshed until requested again */
+  guint evicted : 1;
+
+  /* position in the lru queue */
+  GList link;
+};
+
+
+
+static void
+tasklist_thumbnails_evict (TasklistThumbnails *thumbnails,
+                           gsize needed)
+{
+  TasklistThumbnail *tail;
+
+  /* evict the least recently used snapshots, they are captured
+   * again when requested */
+  while (thumbnails->size + needed > THUMBNAILS_MAX_SIZE
+         && thumbnails->lru.tail != NULL)
+    {
+      tail = thumbnails->lru.tail->data;
+      panel_debug (PANEL_DEBUG_TASKLIST, "evicting thumbnail of window 0x%lx", tail->xid);
+      tasklist_thumbnails_set_surface (thumbnails, tail, NULL);
+      tail->evicted = TRUE;
+    }
+}
+
+
+
+static void
+tasklist_thumbnails_set_surface (TasklistThumbnails *thumbnails,
+                                 TasklistThumbnail *thumbnail,
+                                 cairo_surface_t *surface)
+{
+  gsize size;
+
+  if (thumbnail->surface != NULL)
+    {
+      g_queue_unlink (&thumbnails->lru, &thumbnail->link);
+      thumbnails->size -= thumbnail->size;
+      cairo_surface_destroy (thumbnail->surface);
+      thumbnail->surface = NULL;
+      thumbnail->size = 0;
+    }
+
+  if (surface == NULL)
+    return;
+
+  size = cairo_image_surface_get_stride (surface)
+         * cairo_image_surface_get_height (surface);
+  tasklist_thumbnails_evict (thumbnails, size);
+
+  thumbnail->surface = surface;
+  thumbnail->size = size;
+  thumbnail->evicted = FALSE;
+  thumbnail->link.data = thumbnail;
+  g_queue_push_head_link (&thumbnails->lru, &thumbnail->link);
+  thumbnails->size += thumbnail->size;
+}
+
+
+
+static Window
+tasklist_thumbnails_get_frame (TasklistThumbnails *thumbnails,
+                               Window xid)
+{
+  Window root, parent, *children;
+  guint n_children;
+
+  /* the compositor redirects the toplevel frame of the window, not
+   * the client window, so walk up to the child of the root window */
+  for (;;)
+    {
+      if (!XQueryTree (thumbnails->xdisplay, xid, &root, &parent, &children, &n_children))
+        return None;
+
+      if (children != NULL)
+        XFree (children);
+
+      if (parent == root || parent == None)
+        return xid;
+
+      xid = parent;
+    }
+}
+
+
+
+static void
+tasklist_thumbnails_set_frame (TasklistThumbnails *thumbnails,
+                               TasklistThumbnail *thumbnail,
+                               Window frame)
+{
+  /* must be called with an error trap pushed */
+  if (thumbnail->frame == frame)
+    return;
+
+  if (thumbnail->frame != None)
+    {
+      g_hash_table_remove (thumbnails->frames, GSIZE_TO_POINTER (thumbnail->frame));
+      XDamageDestroy (thumbnails->xdisplay, thumbnail->damage);
+      thumbnail->damage = None;
+    }
+
+  /* the window is not redirected, this only reports the damage the
+   * compositing manager (or the client) paints on the frame */
+  thumbnail->frame = frame;
+  if (frame != None)
+    {
+      thumbnail->damage = XDamageCreate (thumbnails->xdisplay, frame, XDamageReportNonEmpty);
+      g_hash_table_insert (thumbnails->frames, GSIZE_TO_POINTER (frame), thumbnail);
+    }
+}
+
+
+
+static void
+tasklist_thumbnails_capture (TasklistThumbnails *thumbnails,
+                             TasklistThumbnail *thumbnail)
+{
+  XWindowAttributes attrs;
+  Window frame;
+  Pixmap pixmap;
+  cairo_surface_t *source, *scaled, *surface = NULL;
+  cairo_t *cr;
+  gdouble scale;
+  gint width, height;
+  gsize scaled_size = 0;
+
+  thumbnail->dirty = FALSE;
+  thumbnail->captured = g_get_monotonic_time ();
+
+  gdk_x11_display_error_trap_push (thumbnails->display);
+
+  /* the window manager might have reparented the window since it was
+   * opened, follow its frame */
+  frame = tasklist_thumbnails_get_frame (thumbnails, thumbnail->xid);
+  tasklist_thumbnails_set_frame (thumbnails, thumbnail, frame);
+
+  /* rearm the damage notification */
+  if (thumbnail->damage != None)
+    XDamageSubtract (thumbnails->xdisplay, thumbnail->damage, None, None);
+
+  /* unmapped (minimized) windows have no contents, keep the last snapshot */
+  if (frame != None
+      && XGetWindowAttributes (thumbnails->xdisplay, frame, &attrs)
+      && attrs.map_state == IsViewable
+      && attrs.width > 0 && attrs.height > 0)
+    {
+      scale = MIN ((gdouble) THUMBNAIL_MAX_WIDTH / attrs.width,
+                   (gdouble) THUMBNAIL_MAX_HEIGHT / attrs.height);
+      scale = MIN (scale, 1.0);
+      width = MAX (attrs.width * scale, 1);
+      height = MAX (attrs.height * scale, 1);
+
+      /* the window is scaled down in a server pixmap, so only the small
+       * result is read back; the pixmap counts in the budget while we
+       * hold it */
+      scaled_size = (gsize) width * height * 4;
+      tasklist_thumbnails_evict (thumbnails, scaled_size);
+      thumbnails->size += scaled_size;
+
+      /* this names the pixmap the compositor already keeps for the frame,
+       * it does not allocate anything in the server */
+      pixmap = XCompositeNameWindowPixmap (thumbnails->xdisplay, frame);
+      source = cairo_xlib_surface_create (thumbnails->xdisplay, pixmap, attrs.visual,
+                                          attrs.width, attrs.height);
+      scaled = cairo_surface_create_similar (source, CAIRO_CONTENT_COLOR, width, height);
+
+      cr = cairo_create (scaled);
+      cairo_scale (cr, scale, scale);
+      cairo_set_source_surface (cr, source, 0, 0);
+      cairo_pattern_set_filter (cairo_get_source (cr), CAIRO_FILTER_GOOD);
+      cairo_paint (cr);
+      cairo_destroy (cr);
+
+      surface = cairo_image_surface_create (CAIRO_FORMAT_RGB24, width, height);
+      cr = cairo_create (surface);
+      cairo_set_source_surface (cr, scaled, 0, 0);
+      cairo_paint (cr);
+      cairo_destroy (cr);
+
+      cairo_surface_finish (scaled);
+      cairo_surface_destroy (scaled);
+      cairo_surface_finish (source);
+      cairo_surface_destroy (source);
+      XFreePixmap (thumbnails->xdisplay, pixmap);
+
+      thumbnails->size -= scaled_size;
+    }
+
+  if (gdk_x11_display_error_trap_pop (thumbnails->display) != 0
+      || (surface != NULL && cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS))
+    {
+      /* the window was probably destroyed in the meantime */
+      if (surface != NULL)
+        cairo_surface_destroy (surface);
+      return;
+    }
+
+  if (surface != NULL)
+    tasklist_thumbnails_set_surface (thumbnails, thumbnail, surface);
+}
+
+
+
+static void
+tasklist_thumbnails_queue_refresh (TasklistThumbnails *thumbnails,
+                                   guint interval)
+{
+  /* without a compositing manager there is no pixmap to capture, the
+   * refresh is queued again when one starts */
+  if (thumbnails->refresh_id == 0
+      && gdk_screen_is_composited (thumbnails->screen))
+    thumbnails->refresh_id = g_timeout_add_full (G_PRIORITY_LOW, interval,
+                                                 tasklist_thumbnails_refresh,
+                                                 thumbnails, NULL);
+}
+
+
+
+static gboolean
+tasklist_thumbnails_refresh (gpointer data)
+{
+  TasklistThumbnails *thumbnails = data;
+  TasklistThumbnail *thumbnail;
+  GHashTableIter iter;
+  gint64 now, elapsed, next = THUMBNAIL_REFRESH_RATE;
+  gboolean pending = FALSE;
+
+  thumbnails->refresh_id = 0;
+
+  if (!gdk_screen_is_composited (thumbnails->screen))
+    return FALSE;
+
+  now = g_get_monotonic_time ();
+
+  g_hash_table_iter_init (&iter, thumbnails->thumbnails);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &thumbnail))
+    {
+      if (!thumbnail->dirty || thumbnail->evicted)
+        continue;
+
+      /* capture each window at most once per interval */
+      elapsed = (now - thumbnail->captured) / 1000;
+      if (elapsed >= THUMBNAIL_REFRESH_RATE)
+        {
+          tasklist_thumbnails_capture (thumbnails, thumbnail);
+        }
+      else
+        {
+          next = MIN (next, THUMBNAIL_REFRESH_RATE - elapsed);
+          pending = TRUE;
+        }
+    }
+
+  if (pending)
+    tasklist_thumbnails_queue_refresh (thumbnails, next);
+
+  return FALSE;
+}
+
+
+
+static GdkFilterReturn
+tasklist_thumbnails_event_filter (GdkXEvent *gdk_xevent,
+                                  GdkEvent *event,
+                                  gpointer data)
+{
+  TasklistThumbnails *thumbnails = data;
+  XEvent *xevent = gdk_xevent;
+  XDamageNotifyEvent *damage_event;
+  TasklistThumbnail *thumbnail;
+
+  if (xevent->type != thumbnails->damage_event_base + XDamageNotify)
+    return GDK_FILTER_CONTINUE;
+
+  /* we only get a new notification after the damage is subtracted
+   * on the next capture, so this does not flood the refresh */
+  damage_event = (XDamageNotifyEvent *) xevent;
+  thumbnail = g_hash_table_lookup (thumbnails->frames, GSIZE_TO_POINTER (damage_event->drawable));
+  if (thumbnail != NULL)
+    {
+      thumbnail->dirty = TRUE;
+      tasklist_thumbnails_queue_refresh (thumbnails, THUMBNAIL_REFRESH_RATE);
+    }
+
+  return GDK_FILTER_CONTINUE;
+}
+
+
+
+static void
+tasklist_thumbnails_composited_changed (GdkScreen *screen,
+                                        TasklistThumbnails *thumbnails)
+{
+  TasklistThumbnail *thumbnail;
+  GHashTableIter iter;
+
+  if (!gdk_screen_is_composited (screen))
+    return;
+
+  /* a compositing manager started, prepare all the snapshots */
+  g_hash_table_iter_init (&iter, thumbnails->thumbnails);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &thumbnail))
+    thumbnail->dirty = TRUE;
+
+  tasklist_thumbnails_queue_refresh (thumbnails, THUMBNAIL_REFRESH_RATE);
+}
+
+
+
+static void
+tasklist_thumbnails_free_thumbnail (gpointer data)
+{
+  TasklistThumbnail *thumbnail = data;
+
+  panel_return_if_fail (thumbnail->surface == NULL);
+
+  g_slice_free (TasklistThumbnail, thumbnail);
+}
+
+
+
+gboolean
+tasklist_thumbnails_supported (GdkDisplay *display)
+{
+  Display *xdisplay;
+  gint event_base, error_base;
+  gint major = 0, minor = 0;
+
+  if (!GDK_IS_X11_DISPLAY (display))
+    return FALSE;
+
+  xdisplay = GDK_DISPLAY_XDISPLAY (display);
+
+  /* naming the window pixmap requires composite 0.2 */
+  if (!XCompositeQueryExtension (xdisplay, &event_base, &error_base)
+      || !XCompositeQueryVersion (xdisplay, &major, &minor)
+      || (major == 0 && minor < 2))
+    return FALSE;
+
+  return XDamageQueryExtension (xdisplay, &event_base, &error_base);
+}
+
+
+
+TasklistThumbnails *
+tasklist_thumbnails_new (GdkDisplay *display)
+{
+  TasklistThumbnails *thumbnails;
+  gint error_base;
+
+  panel_return_val_if_fail (tasklist_thumbnails_supported (display), NULL);
+
+  thumbnails = g_slice_new0 (TasklistThumbnails);
+  thumbnails->display = display;
+  thumbnails->xdisplay = GDK_DISPLAY_XDISPLAY (display);
+  thumbnails->screen = gdk_display_get_default_screen (display);
+  thumbnails->thumbnails = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                                  tasklist_thumbnails_free_thumbnail);
+  thumbnails->frames = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_queue_init (&thumbnails->lru);
+
+  XDamageQueryExtension (thumbnails->xdisplay, &thumbnails->damage_event_base, &error_base);
+  gdk_window_add_filter (NULL, tasklist_thumbnails_event_filter, thumbnails);
+  g_signal_connect (G_OBJECT (thumbnails->screen), "composited-changed",
+                    G_CALLBACK (tasklist_thumbnails_composited_changed), thumbnails);
+
+  return thumbnails;
+}
+
+
+
+void
+tasklist_thumbnails_free (TasklistThumbnails *thumbnails)
+{
+  GList *xids, *li;
+
+  if (thumbnails == NULL)
+    return;
+
+  gdk_window_remove_filter (NULL, tasklist_thumbnails_event_filter, thumbnails);
+  g_signal_handlers_disconnect_by_func (G_OBJECT (thumbnails->screen),
+                                        tasklist_thumbnails_composited_changed, thumbnails);
+
+  if (thumbnails->refresh_id != 0)
+    g_source_remove (thumbnails->refresh_id);
+
+  xids = g_hash_table_get_keys (thumbnails->thumbnails);
+  for (li = xids; li != NULL; li = li->next)
+    tasklist_thumbnails_unwatch (thumbnails, GPOINTER_TO_SIZE (li->data));
+  g_list_free (xids);
+
+  panel_return_if_fail (thumbnails->size == 0);
+
+  g_hash_table_destroy (thumbnails->frames);
+  g_hash_table_destroy (thumbnails->thumbnails);
+  g_slice_free (TasklistThumbnails, thumbnails);
+}
+
+
+
+void
+tasklist_thumbnails_watch (TasklistThumbnails *thumbnails,
+                           gulong xid)
+{
+  TasklistThumbnail *thumbnail;
+
+  panel_return_if_fail (thumbnails != NULL);
+
+  if (g_hash_table_contains (thumbnails->thumbnails, GSIZE_TO_POINTER (xid)))
+    return;
+
+  thumbnail = g_slice_new0 (TasklistThumbnail);
+  thumbnail->xid = xid;
+  g_hash_table_insert (thumbnails->thumbnails, GSIZE_TO_POINTER (xid), thumbnail);
+
+  /* track the damage of the frame, the window is not redirected so
+   * this allocates nothing but the damage object in the server */
+  gdk_x11_display_error_trap_push (thumbnails->display);
+  tasklist_thumbnails_set_frame (thumbnails, thumbnail,
+                                 tasklist_thumbnails_get_frame (thumbnails, xid));
+  gdk_x11_display_error_trap_pop_ignored (thumbnails->display);
+
+  /* prepare the snapshot in the background */
+  thumbnail->dirty = TRUE;
+  tasklist_thumbnails_queue_refresh (thumbnails, THUMBNAIL_REFRESH_RATE);
+}
+
+
+
+void
+tasklist_thumbnails_unwatch (TasklistThumbnails *thumbnails,
+                             gulong xid)
+{
+  TasklistThumbnail *thumbnail;
+
+  panel_return_if_fail (thumbnails != NULL);
+
+  thumbnail = g_hash_table_lookup (thumbnails->thumbnails, GSIZE_TO_POINTER (xid));
+  if (thumbnail == NULL)
+    return;
+
+  tasklist_thumbnails_set_surface (thumbnails, thumbnail, NULL);
+
+  /* the window might already be destroyed */
+  gdk_x11_display_error_trap_push (thumbnails->display);
+  tasklist_thumbnails_set_frame (thumbnails, thumbnail, None);
+  gdk_x11_display_error_trap_pop_ignored (thumbnails->display);
+
+  g_hash_table_remove (thumbnails->thumbnails, GSIZE_TO_POINTER (xid));
+}
+
+
+
+/*
+ * Returns the snapshot of the window, owned by the cache. This never
+ * captures: snapshots are prepared in the background when the window is
+ * opened or damaged, at most once per refresh interval, and only while a
+ * compositing manager keeps a pixmap of the window. If the snapshot was
+ * evicted or is not ready yet, NULL is returned and a capture is queued.
+ */
+cairo_surface_t *
+tasklist_thumbnails_get (TasklistThumbnails *thumbnails,
+                         gulong xid)
+{
+  TasklistThumbnail *thumbnail;
+
+  panel_return_val_if_fail (thumbnails != NULL, NULL);
+
+  thumbnail = g_hash_table_lookup (thumbnails->thumbnails, GSIZE_TO_POINTER (xid));
+  if (thumbnail == NULL)
+    return NULL;
+
+  if (thumbnail->surface != NULL)
+    {
+      /* mark as recently used */
+      g_queue_unlink (&thumbnails->lru, &thumbnail->link);
+      g_queue_push_head_link (&thumbnails->lru, &thumbnail->link);
+    }
+  else
+    {
+      /* requested again, refresh it in the background */
+      thumbnail->evicted = FALSE;
+      thumbnail->dirty = TRUE;
+      tasklist_thumbnails_queue_refresh (thumbnails, 0);
+    }
+
+  return thumbnail->surface;
+}
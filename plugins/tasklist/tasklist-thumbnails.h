@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 The Xfce Development Team
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef __TASKLIST_THUMBNAILS_H__
+#define __TASKLIST_THUMBNAILS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _TasklistThumbnails TasklistThumbnails;
+
+gboolean
+tasklist_thumbnails_supported (GdkDisplay *display);
+
+TasklistThumbnails *
+tasklist_thumbnails_new (GdkDisplay *display) G_GNUC_MALLOC;
+
+void
+tasklist_thumbnails_free (TasklistThumbnails *thumbnails);
+
+void
+tasklist_thumbnails_watch (TasklistThumbnails *thumbnails,
+                           gulong xid);
+
+void
+tasklist_thumbnails_unwatch (TasklistThumbnails *thumbnails,
+                             gulong xid);
+
+cairo_surface_t *
+tasklist_thumbnails_get (TasklistThumbnails *thumbnails,
+                         gulong xid);
+
+G_END_DECLS
+
+#endif /* !__TASKLIST_THUMBNAILS_H__ */
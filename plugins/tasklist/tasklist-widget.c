@@ -21,10 +21,14 @@
 #endif
 
 #include "tasklist-widget.h"
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+#include "tasklist-thumbnails.h"
+#endif
 
 #include "common/panel-debug.h"
 #include "common/panel-private.h"
 #include "common/panel-utils.h"
+#include "common/panel-xfw-icons.h"
 
 #include <libxfce4ui/libxfce4ui.h>
 #include <libxfce4windowing/libxfce4windowing.h>
@@ -66,6 +70,7 @@
 #define ARROW_BUTTON_SIZE (20)
 #define WIREFRAME_SIZE (5) /* same as xfwm4 */
 #define DRAG_ACTIVATE_TIMEOUT (500)
+#define UPDATE_RATE_LIMIT (250) /* ms between title or icon updates of a button */
 
 
 
@@ -84,7 +89,7 @@
   G_STMT_END
 #define xfce_taskbar_is_locked(tasklist) (XFCE_TASKLIST (tasklist)->locked > 0)
 
-#define xfce_tasklist_get_panel_plugin(tasklist) XFCE_PANEL_PLUGIN (gtk_widget_get_ancestor (GTK_WIDGET (tasklist), XFCE_TYPE_PANEL_PLUGIN))
+#define xfce_tasklist_get_panel_plugin(tasklist) ((tasklist)->plugin)
 #define xfce_tasklist_horizontal(tasklist) ((tasklist)->mode == XFCE_PANEL_PLUGIN_MODE_HORIZONTAL)
 #define xfce_tasklist_vertical(tasklist) ((tasklist)->mode == XFCE_PANEL_PLUGIN_MODE_VERTICAL)
 #define xfce_tasklist_deskbar(tasklist) ((tasklist)->mode == XFCE_PANEL_PLUGIN_MODE_DESKBAR)
@@ -128,6 +133,7 @@ enum
   PROP_SHOW_LABELS,
   PROP_SHOW_ONLY_MINIMIZED,
   PROP_SHOW_WIREFRAMES,
+  PROP_SHOW_THUMBNAILS,
   PROP_SHOW_HANDLE,
   PROP_SHOW_TOOLTIPS,
   PROP_SORT_ORDER,
@@ -145,6 +151,9 @@ struct _XfceTasklist
   /* lock counter */
   gint locked;
 
+  /* the plugin we're in, updated when the hierarchy changes */
+  XfcePanelPlugin *plugin;
+
   /* the screen of this tasklist */
   XfwScreen *screen;
   XfwWorkspaceGroup *workspace_group;
@@ -153,8 +162,11 @@ struct _XfceTasklist
   /* window children in the tasklist */
   GList *windows;
 
+  /* index of the window buttons in the list above */
+  GHashTable *window_children;
+
   /* windows we monitor, but that are excluded from the tasklist */
-  GSList *skipped_windows;
+  GHashTable *skipped_windows;
 
   /* arrow button of the overflow menu */
   GtkWidget *arrow_button;
@@ -213,6 +225,10 @@ struct _XfceTasklist
    * the tasklist */
   guint show_wireframes : 1;
 
+  /* whether we show a thumbnail of the window when hovering
+   * a button in the tasklist */
+  guint show_thumbnails : 1;
+
   /* icon geometries update timeout */
   guint update_icon_geometries_id;
 
@@ -234,6 +250,14 @@ struct _XfceTasklist
   Window wireframe_window;
 #endif
 
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  /* cached window snapshots and the popup showing them */
+  TasklistThumbnails *thumbnails;
+  GtkWidget *thumbnail_popup;
+  GtkWidget *thumbnail_image;
+  gulong thumbnail_wid;
+#endif
+
   /* gtk style properties */
   gint max_button_length;
   gint min_button_length;
@@ -243,6 +267,14 @@ struct _XfceTasklist
   gint menu_max_width_chars;
 
   gint n_windows;
+
+  /* the request and allocation of the last relayout, if they did not
+   * change the buttons keep their position, for example when only a
+   * window title changed that still fits in its button */
+  guint layout_valid : 1;
+  guint layout_hash;
+  guint request_hash;
+  GtkAllocation layout_allocation;
 };
 
 typedef enum
@@ -261,12 +293,18 @@ typedef struct _XfceTasklistChild
   /* pointer to the tasklist */
   XfceTasklist *tasklist;
 
-  /* button widgets */
+  /* button widgets, only created while the button is visible; windows
+   * that are filtered out are only kept as this record */
   GtkWidget *button;
   GtkWidget *box;
   GtkWidget *icon;
   GtkWidget *label;
 
+  /* visibility and urgency blinking of the button, also known
+   * while there is no button */
+  guint visible : 1;
+  guint blinking : 1;
+
   /* we use a surface for icon rendering so keep original pixbuf around */
   GdkPixbuf *pixbuf;
 
@@ -274,10 +312,22 @@ typedef struct _XfceTasklistChild
   guint motion_timeout_id;
   guint motion_timestamp;
 
+  /* rate limiting of title and icon updates, with a trailing update */
+  gint64 name_updated;
+  guint name_timeout_id;
+  gint64 icon_updated;
+  guint icon_timeout_id;
+
   /* unique id for sorting by insert time,
    * simply increased for each new button */
   guint unique_id;
 
+  /* link of the child in the tasklist and cached sort keys
+   * of the window (or group) and application names for sorting */
+  GList *link;
+  gchar *name_key;
+  gchar *group_key;
+
   /* last time this window was focused */
   gint64 last_focused;
 
@@ -285,6 +335,9 @@ typedef struct _XfceTasklistChild
   GSList *windows;
   gint n_windows;
 
+  /* group button of a window in case of grouping */
+  struct _XfceTasklistChild *group;
+
   /* xfw information */
   XfwWindow *window;
   XfwApplication *app;
@@ -324,11 +377,16 @@ static void
 xfce_tasklist_size_allocate (GtkWidget *widget,
                              GtkAllocation *allocation);
 static void
+xfce_tasklist_queue_relayout (XfceTasklist *tasklist);
+static void
 xfce_tasklist_style_updated (GtkWidget *widget);
 static void
 xfce_tasklist_realize (GtkWidget *widget);
 static void
 xfce_tasklist_unrealize (GtkWidget *widget);
+static void
+xfce_tasklist_hierarchy_changed (GtkWidget *widget,
+                                 GtkWidget *previous_toplevel);
 static gboolean
 xfce_tasklist_scroll_event (GtkWidget *widget,
                             GdkEventScroll *event);
@@ -343,6 +401,17 @@ xfce_tasklist_forall (GtkContainer *container,
 static GType
 xfce_tasklist_child_type (GtkContainer *container);
 static void
+xfce_tasklist_child_remove (XfceTasklist *tasklist,
+                            XfceTasklistChild *child);
+static void
+xfce_tasklist_child_destroy_button (XfceTasklistChild *child);
+static void
+xfce_tasklist_child_set_visible (XfceTasklistChild *child,
+                                 gboolean visible);
+static void
+xfce_tasklist_child_set_blinking (XfceTasklistChild *child,
+                                  gboolean blinking);
+static void
 xfce_tasklist_arrow_button_toggled (GtkWidget *button,
                                     XfceTasklist *tasklist);
 static void
@@ -386,6 +455,9 @@ static void
 xfce_tasklist_sort (XfceTasklist *tasklist,
                     gboolean sort_groups);
 static void
+xfce_tasklist_sort_child (XfceTasklist *tasklist,
+                          XfceTasklistChild *child);
+static void
 xfce_tasklist_group_button_sort (XfceTasklistChild *group_child);
 static gboolean
 xfce_tasklist_update_icon_geometries (gpointer data);
@@ -403,6 +475,12 @@ xfce_tasklist_wireframe_update (XfceTasklist *tasklist,
                                 XfceTasklistChild *child);
 #endif
 
+/* thumbnails */
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+static void
+xfce_tasklist_thumbnail_hide (XfceTasklist *tasklist);
+#endif
+
 /* tasklist buttons */
 static inline gboolean
 xfce_tasklist_button_visible (XfceTasklistChild *child,
@@ -420,6 +498,8 @@ xfce_tasklist_button_activate (XfceTasklistChild *child,
 static XfceTasklistChild *
 xfce_tasklist_button_new (XfwWindow *window,
                           XfceTasklist *tasklist);
+static void
+xfce_tasklist_button_setup (XfceTasklistChild *child);
 
 /* tasklist group buttons */
 static void
@@ -436,14 +516,26 @@ static void
 xfce_tasklist_group_button_add_window (XfceTasklistChild *group_child,
                                        XfceTasklistChild *window_child);
 static void
+xfce_tasklist_group_button_child_visible_changed (XfceTasklistChild *group_child);
+static void
+xfce_tasklist_group_button_child_destroyed (XfceTasklistChild *group_child,
+                                            XfceTasklistChild *window_child);
+static void
 xfce_tasklist_button_icon_changed (XfwWindow *window,
                                    XfceTasklistChild *child);
+static gboolean
+xfce_tasklist_button_label_fits (XfceTasklistChild *child,
+                                 const gchar *text);
+static void
+xfce_tasklist_button_update_label (XfceTasklistChild *child);
 static void
 xfce_tasklist_group_button_icon_changed (XfwApplication *app,
                                          XfceTasklistChild *group_child);
 static XfceTasklistChild *
 xfce_tasklist_group_button_new (XfwApplication *app,
                                 XfceTasklist *tasklist);
+static void
+xfce_tasklist_group_button_setup (XfceTasklistChild *group_child);
 
 /* potential public functions */
 static void
@@ -465,6 +557,9 @@ static void
 xfce_tasklist_set_show_wireframes (XfceTasklist *tasklist,
                                    gboolean show_wireframes);
 static void
+xfce_tasklist_set_show_thumbnails (XfceTasklist *tasklist,
+                                   gboolean show_thumbnails);
+static void
 xfce_tasklist_set_label_decorations (XfceTasklist *tasklist,
                                      gboolean label_decorations);
 static void
@@ -495,6 +590,7 @@ xfce_tasklist_class_init (XfceTasklistClass *klass)
   gtkwidget_class->style_updated = xfce_tasklist_style_updated;
   gtkwidget_class->realize = xfce_tasklist_realize;
   gtkwidget_class->unrealize = xfce_tasklist_unrealize;
+  gtkwidget_class->hierarchy_changed = xfce_tasklist_hierarchy_changed;
   gtkwidget_class->scroll_event = xfce_tasklist_scroll_event;
 
   gtkcontainer_class = GTK_CONTAINER_CLASS (klass);
@@ -559,6 +655,13 @@ xfce_tasklist_class_init (XfceTasklistClass *klass)
                                                          FALSE,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class,
+                                   PROP_SHOW_THUMBNAILS,
+                                   g_param_spec_boolean ("show-thumbnails",
+                                                         NULL, NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (gobject_class,
                                    PROP_SHOW_HANDLE,
                                    g_param_spec_boolean ("show-handle",
@@ -677,8 +780,10 @@ xfce_tasklist_init (XfceTasklist *tasklist)
   gtk_widget_set_has_window (GTK_WIDGET (tasklist), FALSE);
 
   tasklist->locked = 0;
+  tasklist->plugin = NULL;
   tasklist->screen = NULL;
   tasklist->windows = NULL;
+  tasklist->window_children = NULL;
   tasklist->skipped_windows = NULL;
   tasklist->mode = XFCE_PANEL_PLUGIN_MODE_HORIZONTAL;
   tasklist->nrows = 1;
@@ -689,6 +794,7 @@ xfce_tasklist_init (XfceTasklist *tasklist)
   tasklist->only_minimized = FALSE;
   tasklist->show_labels = TRUE;
   tasklist->show_wireframes = FALSE;
+  tasklist->show_thumbnails = FALSE;
   tasklist->show_handle = TRUE;
   tasklist->show_tooltips = TRUE;
   tasklist->all_monitors = TRUE;
@@ -700,6 +806,12 @@ xfce_tasklist_init (XfceTasklist *tasklist)
   tasklist->label_decorations = FALSE;
 #ifdef ENABLE_X11
   tasklist->wireframe_window = 0;
+#endif
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  tasklist->thumbnails = NULL;
+  tasklist->thumbnail_popup = NULL;
+  tasklist->thumbnail_image = NULL;
+  tasklist->thumbnail_wid = 0;
 #endif
   tasklist->update_icon_geometries_id = 0;
   tasklist->update_monitor_geometry_id = 0;
@@ -771,6 +883,10 @@ xfce_tasklist_get_property (GObject *object,
       g_value_set_boolean (value, tasklist->show_wireframes);
       break;
 
+    case PROP_SHOW_THUMBNAILS:
+      g_value_set_boolean (value, tasklist->show_thumbnails);
+      break;
+
     case PROP_SHOW_HANDLE:
       g_value_set_boolean (value, tasklist->show_handle);
       break;
@@ -855,6 +971,10 @@ xfce_tasklist_set_property (GObject *object,
       xfce_tasklist_set_show_wireframes (tasklist, WINDOWING_IS_X11 () && g_value_get_boolean (value));
       break;
 
+    case PROP_SHOW_THUMBNAILS:
+      xfce_tasklist_set_show_thumbnails (tasklist, WINDOWING_IS_X11 () && g_value_get_boolean (value));
+      break;
+
     case PROP_SHOW_HANDLE:
       tasklist->show_handle = g_value_get_boolean (value);
       break;
@@ -907,6 +1027,7 @@ xfce_tasklist_finalize (GObject *object)
 
   /* data that should already be freed when disconnecting the screen */
   panel_return_if_fail (tasklist->windows == NULL);
+  panel_return_if_fail (tasklist->window_children == NULL);
   panel_return_if_fail (tasklist->skipped_windows == NULL);
   panel_return_if_fail (tasklist->screen == NULL);
 
@@ -921,6 +1042,13 @@ xfce_tasklist_finalize (GObject *object)
   xfce_tasklist_wireframe_destroy (tasklist);
 #endif
 
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  /* release the window snapshots */
+  tasklist_thumbnails_free (tasklist->thumbnails);
+  if (tasklist->thumbnail_popup != NULL)
+    gtk_widget_destroy (tasklist->thumbnail_popup);
+#endif
+
   (*G_OBJECT_CLASS (xfce_tasklist_parent_class)->finalize) (object);
 }
 
@@ -987,14 +1115,21 @@ xfce_tasklist_get_preferred_length (GtkWidget *widget,
   gint child_size = tasklist->size / tasklist->nrows;
   gint child_length = 0;
   gdouble nrows_ratio = tasklist->nrows_ratio;
+  guint hash = gtk_widget_get_direction (widget);
 
   for (li = tasklist->windows, n_windows = 0; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button))
+      if (child->visible)
         {
           gtk_widget_get_preferred_size (child->button, NULL, &child_req);
           child_length = MAX (child_length, xfce_tasklist_horizontal (tasklist) ? child_req.width : child_req.height);
+
+          /* the visible buttons in their order, the overflow menu is
+           * decided again during the relayout */
+          hash = (hash << 5) + hash + GPOINTER_TO_UINT (child)
+                 + (child->type == CHILD_TYPE_GROUP_MENU);
+
           if (child->type == CHILD_TYPE_GROUP_MENU)
             continue;
 
@@ -1041,6 +1176,8 @@ xfce_tasklist_get_preferred_length (GtkWidget *widget,
           xfce_tasklist_button_icon_changed (child->window, child);
       }
 
+  tasklist->request_hash = (hash << 5) + hash + length;
+
   /* set the requested sizes */
   if (natural_length != NULL)
     *natural_length = length;
@@ -1129,7 +1266,7 @@ xfce_tasklist_size_layout (XfceTasklist *tasklist,
       for (li = tasklist->windows; li != NULL; li = li->next)
         {
           child = li->data;
-          if (child->type == CHILD_TYPE_WINDOW && gtk_widget_get_visible (child->button))
+          if (child->type == CHILD_TYPE_WINDOW && child->visible)
             {
               windows_scored = g_slist_insert_sorted (windows_scored, child,
                                                       xfce_tasklist_size_sort_window);
@@ -1203,20 +1340,49 @@ xfce_tasklist_size_allocate (GtkWidget *widget,
   gint area_x, area_width;
   gint arrow_position;
   GtkRequisition child_req;
+  XfcePanelPlugin *plugin = xfce_tasklist_get_panel_plugin (tasklist);
+  gint64 start;
 
   panel_return_if_fail (gtk_widget_get_visible (tasklist->arrow_button));
 
   /* set widget allocation */
   gtk_widget_set_allocation (widget, allocation);
 
+  /* nothing changed that moves the buttons, only allocate the buttons
+   * that queued a resize themselves at their current position */
+  if (tasklist->layout_valid
+      && tasklist->layout_hash == tasklist->request_hash
+      && gdk_rectangle_equal (&tasklist->layout_allocation, allocation))
+    {
+      for (li = tasklist->windows; li != NULL; li = li->next)
+        {
+          child = li->data;
+          if (child->visible)
+            {
+              gtk_widget_get_allocation (child->button, &child_alloc);
+              gtk_widget_size_allocate (child->button, &child_alloc);
+            }
+        }
+
+      gtk_widget_get_allocation (tasklist->arrow_button, &child_alloc);
+      gtk_widget_size_allocate (tasklist->arrow_button, &child_alloc);
+
+      xfce_panel_plugin_stats_add (plugin, "relayout-skipped", 1);
+
+      return;
+    }
+
+  start = xfce_panel_plugin_stats_timer_start (plugin);
+
+  tasklist->layout_valid = TRUE;
+  tasklist->layout_hash = tasklist->request_hash;
+  tasklist->layout_allocation = *allocation;
+
   /* swap integers with vertical orientation */
   if (!xfce_tasklist_horizontal (tasklist))
     TRANSPOSE_AREA (area);
   panel_return_if_fail (area.height == tasklist->size);
 
-  /* TODO if we compare the allocation with the requisition we can
-   * do a fast path to the child allocation, i think */
-
   /* useless but hides compiler warning */
   w = x = y = rows = cols = 0;
 
@@ -1259,7 +1425,7 @@ xfce_tasklist_size_allocate (GtkWidget *widget,
       child = li->data;
 
       /* skip hidden buttons */
-      if (!gtk_widget_get_visible (child->button))
+      if (!child->visible)
         continue;
 
       if (G_LIKELY (child->type == CHILD_TYPE_WINDOW || child->type == CHILD_TYPE_GROUP))
@@ -1324,6 +1490,9 @@ xfce_tasklist_size_allocate (GtkWidget *widget,
       gtk_widget_size_allocate (child->button, &child_alloc);
     }
 
+  xfce_panel_plugin_stats_timer_stop (plugin, "relayout", start);
+  xfce_panel_plugin_stats_record (plugin, "relayout-buttons", i);
+
   /* update icon geometries */
   if (tasklist->update_icon_geometries_id == 0)
     tasklist->update_icon_geometries_id = g_idle_add_full (G_PRIORITY_LOW, xfce_tasklist_update_icon_geometries,
@@ -1332,6 +1501,16 @@ xfce_tasklist_size_allocate (GtkWidget *widget,
 
 
 
+static void
+xfce_tasklist_queue_relayout (XfceTasklist *tasklist)
+{
+  /* the button positions depend on more than the request */
+  tasklist->layout_valid = FALSE;
+  gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+}
+
+
+
 static void
 xfce_tasklist_style_updated (GtkWidget *widget)
 {
@@ -1368,7 +1547,7 @@ xfce_tasklist_style_updated (GtkWidget *widget)
   if (tasklist->max_button_size == -1)
     tasklist->max_button_size = MAX_MAX_BUTTON_SIZE;
 
-  gtk_widget_queue_resize (widget);
+  xfce_tasklist_queue_relayout (tasklist);
 }
 
 
@@ -1399,6 +1578,19 @@ xfce_tasklist_unrealize (GtkWidget *widget)
 
 
 
+static void
+xfce_tasklist_hierarchy_changed (GtkWidget *widget,
+                                 GtkWidget *previous_toplevel)
+{
+  XfceTasklist *tasklist = XFCE_TASKLIST (widget);
+
+  /* cache the plugin, looking it up walks the ancestors and it is
+   * needed on every window event */
+  tasklist->plugin = XFCE_PANEL_PLUGIN (gtk_widget_get_ancestor (widget, XFCE_TYPE_PANEL_PLUGIN));
+}
+
+
+
 static gboolean
 xfce_tasklist_scroll_event (GtkWidget *widget,
                             GdkEventScroll *event)
@@ -1417,7 +1609,7 @@ xfce_tasklist_scroll_event (GtkWidget *widget,
     {
       child = li->data;
 
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->window != NULL && xfw_window_is_active (child->window))
         break;
     }
@@ -1463,7 +1655,7 @@ xfce_tasklist_scroll_event (GtkWidget *widget,
 
           child = lnew->data;
           if (child->window != NULL
-              && gtk_widget_get_visible (child->button))
+              && child->visible)
             break;
         }
 
@@ -1489,7 +1681,7 @@ xfce_tasklist_scroll_event (GtkWidget *widget,
 
           child = lnew->data;
           if (child->window != NULL
-              && gtk_widget_get_visible (child->button))
+              && child->visible)
             break;
         }
 
@@ -1530,7 +1722,6 @@ xfce_tasklist_remove (GtkContainer *container,
                       GtkWidget *widget)
 {
   XfceTasklist *tasklist = XFCE_TASKLIST (container);
-  gboolean was_visible;
   XfceTasklistChild *child;
   GList *li;
 
@@ -1540,30 +1731,53 @@ xfce_tasklist_remove (GtkContainer *container,
 
       if (child->button == widget)
         {
-          tasklist->windows = g_list_delete_link (tasklist->windows, li);
+          xfce_tasklist_child_remove (tasklist, child);
+          break;
+        }
+    }
+}
+
 
-          was_visible = gtk_widget_get_visible (widget);
 
-          gtk_widget_unparent (child->button);
+static void
+xfce_tasklist_child_remove (XfceTasklist *tasklist,
+                            XfceTasklistChild *child)
+{
+  gboolean was_visible = child->visible;
 
-          if (child->motion_timeout_id != 0)
-            g_source_remove (child->motion_timeout_id);
+  panel_return_if_fail (child->link != NULL && child->link->data == child);
 
-          if (child->pixbuf != NULL)
-            g_object_unref (child->pixbuf);
+  tasklist->windows = g_list_delete_link (tasklist->windows, child->link);
+  child->link = NULL;
+  if (child->window != NULL)
+    g_hash_table_remove (tasklist->window_children, child->window);
 
-          /* allow time for signal handlers connected to the destroy/dispose signals of
-           * child members to run, they could refer to these members via child, e.g.
-           * child->button as above to test for equality */
-          g_idle_add (xfce_tasklist_free_child, child);
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  if (tasklist->thumbnails != NULL && child->window != NULL)
+    tasklist_thumbnails_unwatch (tasklist->thumbnails, tasklist_window_get_wid (child->window));
+#endif
 
-          /* queue a resize if needed */
-          if (G_LIKELY (was_visible))
-            gtk_widget_queue_resize (GTK_WIDGET (container));
+  xfce_tasklist_child_destroy_button (child);
 
-          break;
-        }
-    }
+  if (child->name_timeout_id != 0)
+    g_source_remove (child->name_timeout_id);
+  if (child->icon_timeout_id != 0)
+    g_source_remove (child->icon_timeout_id);
+
+  g_free (child->name_key);
+  g_free (child->group_key);
+
+  /* the group button updates its visibility or is removed */
+  if (child->group != NULL)
+    xfce_tasklist_group_button_child_destroyed (child->group, child);
+
+  /* allow time for signal handlers connected to the destroy/dispose signals of
+   * child members to run, they could refer to these members via child */
+  g_idle_add (xfce_tasklist_free_child, child);
+
+  /* queue a resize if needed */
+  if (G_LIKELY (was_visible))
+    xfce_tasklist_queue_relayout (tasklist);
 }
 
 
@@ -1586,7 +1800,9 @@ xfce_tasklist_forall (GtkContainer *container,
       child = children->data;
       children = children->next;
 
-      (*callback) (child->button, callback_data);
+      /* filtered windows have no button */
+      if (child->button != NULL)
+        (*callback) (child->button, callback_data);
     }
 }
 
@@ -1673,6 +1889,9 @@ xfce_tasklist_connect_screen (XfceTasklist *tasklist)
     tasklist->apps = g_hash_table_new_full (g_direct_hash, g_direct_equal,
                                             NULL, (GDestroyNotify) xfce_tasklist_group_button_remove);
 
+  tasklist->window_children = g_hash_table_new (g_direct_hash, g_direct_equal);
+  tasklist->skipped_windows = g_hash_table_new (g_direct_hash, g_direct_equal);
+
   /* set the display and screen */
   tasklist->display = gtk_widget_get_display (GTK_WIDGET (tasklist));
   tasklist->screen = xfw_screen_get_default ();
@@ -1715,7 +1934,7 @@ xfce_tasklist_connect_screen (XfceTasklist *tasklist)
 static void
 xfce_tasklist_disconnect_screen (XfceTasklist *tasklist)
 {
-  GSList *li, *lnext;
+  GList *skipped, *li;
   GList *wi, *wnext;
   XfceTasklistChild *child;
   guint n;
@@ -1744,12 +1963,13 @@ xfce_tasklist_disconnect_screen (XfceTasklist *tasklist)
     }
 
   /* disconnect from all skipped windows */
-  for (li = tasklist->skipped_windows; li != NULL; li = lnext)
+  skipped = g_hash_table_get_keys (tasklist->skipped_windows);
+  for (li = skipped; li != NULL; li = li->next)
     {
-      lnext = li->next;
       panel_return_if_fail (xfw_window_is_skip_tasklist (XFW_WINDOW (li->data)));
       xfce_tasklist_window_removed (tasklist->screen, li->data, tasklist);
     }
+  g_list_free (skipped);
 
   /* remove all the windows */
   for (wi = tasklist->windows; wi != NULL; wi = wnext)
@@ -1764,7 +1984,13 @@ xfce_tasklist_disconnect_screen (XfceTasklist *tasklist)
     }
 
   panel_assert (tasklist->windows == NULL);
-  panel_assert (tasklist->skipped_windows == NULL);
+  panel_assert (g_hash_table_size (tasklist->window_children) == 0);
+  panel_assert (g_hash_table_size (tasklist->skipped_windows) == 0);
+
+  g_hash_table_destroy (tasklist->window_children);
+  tasklist->window_children = NULL;
+  g_hash_table_destroy (tasklist->skipped_windows);
+  tasklist->skipped_windows = NULL;
 
   g_clear_object (&tasklist->screen);
   tasklist->display = NULL;
@@ -1826,24 +2052,19 @@ xfce_tasklist_active_window_changed (XfwScreen *screen,
         }
 
       /* set the toggle button state */
-      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button),
-                                    child->window == active_window && active_window != NULL);
+      if (child->button != NULL)
+        gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button),
+                                      child->window == active_window && active_window != NULL);
     }
   /* set the toggle button state for the group button */
-  if (app)
+  if (app != NULL
+      && (child = g_hash_table_lookup (tasklist->apps, app)) != NULL)
     {
-      for (li = tasklist->windows; li != NULL; li = li->next)
-        {
-          child = li->data;
-          if (child->type == CHILD_TYPE_GROUP
-              && child->app == app)
-            {
-              /* update the button's state and icon, the latter makes sure it is rendered correctly
-                 if all previous group windows were minimized */
-              xfce_tasklist_group_button_icon_changed (child->app, child);
-              gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button), TRUE);
-            }
-        }
+      /* update the button's state and icon, the latter makes sure it is rendered correctly
+         if all previous group windows were minimized */
+      xfce_tasklist_group_button_icon_changed (child->app, child);
+      if (child->button != NULL)
+        gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button), TRUE);
     }
 
   /* release the lock */
@@ -1860,6 +2081,7 @@ xfce_tasklist_active_workspace_changed (XfwWorkspaceGroup *group,
   GList *windows, *li;
   XfwWorkspace *active_ws;
   XfceTasklistChild *child;
+  gint64 start;
 
   panel_return_if_fail (XFW_IS_WORKSPACE_GROUP (group));
   panel_return_if_fail (previous_workspace == NULL || XFW_IS_WORKSPACE (previous_workspace));
@@ -1874,6 +2096,8 @@ xfce_tasklist_active_workspace_changed (XfwWorkspaceGroup *group,
           && tasklist->all_workspaces))
     return;
 
+  start = xfce_panel_plugin_stats_timer_start (xfce_tasklist_get_panel_plugin (tasklist));
+
   /* walk all the children and update their visibility: make a copy of the window list
    * here because changing the buttons visibility can change the group buttons visibility,
    * which in turn can change the list order */
@@ -1885,13 +2109,13 @@ xfce_tasklist_active_workspace_changed (XfwWorkspaceGroup *group,
 
       if (child->type != CHILD_TYPE_GROUP)
         {
-          if (xfce_tasklist_button_visible (child, active_ws))
-            gtk_widget_show (child->button);
-          else
-            gtk_widget_hide (child->button);
+          xfce_tasklist_child_set_visible (child, xfce_tasklist_button_visible (child, active_ws));
         }
     }
   g_list_free (windows);
+
+  xfce_panel_plugin_stats_timer_stop (xfce_tasklist_get_panel_plugin (tasklist),
+                                      "workspace-switched", start);
 }
 
 
@@ -1902,6 +2126,7 @@ xfce_tasklist_window_added (XfwScreen *screen,
                             XfceTasklist *tasklist)
 {
   XfceTasklistChild *child;
+  gint64 start;
 
   panel_return_if_fail (XFW_IS_SCREEN (screen));
   panel_return_if_fail (XFW_IS_WINDOW (window));
@@ -1912,19 +2137,21 @@ xfce_tasklist_window_added (XfwScreen *screen,
   /* ignore this window, but watch it for state changes */
   if (xfw_window_is_skip_tasklist (window))
     {
-      tasklist->skipped_windows = g_slist_prepend (tasklist->skipped_windows, window);
+      g_hash_table_add (tasklist->skipped_windows, window);
       g_signal_connect (G_OBJECT (window), "state-changed",
                         G_CALLBACK (xfce_tasklist_skipped_windows_state_changed), tasklist);
 
       return;
     }
 
+  start = xfce_panel_plugin_stats_timer_start (xfce_tasklist_get_panel_plugin (tasklist));
+
   /* create new window button */
   child = xfce_tasklist_button_new (window, tasklist);
 
   /* initial visibility of the function */
   if (xfce_tasklist_button_visible (child, xfw_workspace_group_get_active_workspace (tasklist->workspace_group)))
-    gtk_widget_show (child->button);
+    xfce_tasklist_child_set_visible (child, TRUE);
 
   if (tasklist->grouping)
     {
@@ -1944,7 +2171,10 @@ xfce_tasklist_window_added (XfwScreen *screen,
   if (xfw_window_is_urgent (window))
     xfce_tasklist_button_state_changed (window, XFW_WINDOW_STATE_URGENT, XFW_WINDOW_STATE_URGENT, child);
 
-  gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+  xfce_tasklist_queue_relayout (tasklist);
+
+  xfce_panel_plugin_stats_timer_stop (xfce_tasklist_get_panel_plugin (tasklist),
+                                      "window-opened", start);
 }
 
 
@@ -1954,10 +2184,9 @@ xfce_tasklist_window_removed (XfwScreen *screen,
                               XfwWindow *window,
                               XfceTasklist *tasklist)
 {
-  GList *li;
-  GSList *lp;
   XfceTasklistChild *child;
   guint n;
+  gint64 start;
 
   panel_return_if_fail (XFW_IS_SCREEN (screen));
   panel_return_if_fail (XFW_IS_WINDOW (window));
@@ -1966,46 +2195,45 @@ xfce_tasklist_window_removed (XfwScreen *screen,
 
   /* check if the window is in our skipped window list */
   if (xfw_window_is_skip_tasklist (window)
-      && (lp = g_slist_find (tasklist->skipped_windows, window)) != NULL)
+      && g_hash_table_remove (tasklist->skipped_windows, window))
     {
-      tasklist->skipped_windows = g_slist_delete_link (tasklist->skipped_windows, lp);
       g_signal_handlers_disconnect_by_func (window, xfce_tasklist_skipped_windows_state_changed, tasklist);
 
       return;
     }
 
+  start = xfce_panel_plugin_stats_timer_start (xfce_tasklist_get_panel_plugin (tasklist));
+
   /* remove the child from the taskbar */
-  for (li = tasklist->windows; li != NULL; li = li->next)
+  child = g_hash_table_lookup (tasklist->window_children, window);
+  if (child != NULL)
     {
-      child = li->data;
-
-      if (child->window == window)
-        {
-          /* disconnect from all the window watch functions */
-          panel_return_if_fail (XFW_IS_WINDOW (window));
-          n = g_signal_handlers_disconnect_matched (G_OBJECT (window),
-                                                    G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, child);
+      /* disconnect from all the window watch functions */
+      n = g_signal_handlers_disconnect_matched (G_OBJECT (window),
+                                                G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, child);
 
 #ifdef ENABLE_X11
-          /* hide the wireframe */
-          if (G_UNLIKELY (n > 5 && tasklist->show_wireframes))
-            {
-              xfce_tasklist_wireframe_hide (tasklist);
-              n--;
-            }
+      /* hide the wireframe */
+      if (G_UNLIKELY (n > 5 && tasklist->show_wireframes))
+        {
+          xfce_tasklist_wireframe_hide (tasklist);
+          n--;
+        }
 #endif
 
-          panel_return_if_fail (n == 5);
+      panel_return_if_fail (n == 5);
 
-          /* destroy the button, this will free the child data in the
-           * container remove function */
-          gtk_widget_destroy (child->button);
+      if (child->app != NULL)
+        g_signal_handlers_disconnect_by_func (child->app, xfce_tasklist_button_app_name_changed, child);
 
-          break;
-        }
+      /* destroy the button and free the child data */
+      xfce_tasklist_child_remove (tasklist, child);
     }
 
-  gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+  xfce_tasklist_queue_relayout (tasklist);
+
+  xfce_panel_plugin_stats_timer_stop (xfce_tasklist_get_panel_plugin (tasklist),
+                                      "window-closed", start);
 }
 
 
@@ -2036,12 +2264,12 @@ xfce_tasklist_skipped_windows_state_changed (XfwWindow *window,
 {
   panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
   panel_return_if_fail (XFW_IS_WINDOW (window));
-  panel_return_if_fail (g_slist_find (tasklist->skipped_windows, window) != NULL);
+  panel_return_if_fail (g_hash_table_contains (tasklist->skipped_windows, window));
 
   if (PANEL_HAS_FLAG (changed_state, XFW_WINDOW_STATE_SKIP_TASKLIST))
     {
       /* remove from list */
-      tasklist->skipped_windows = g_slist_remove (tasklist->skipped_windows, window);
+      g_hash_table_remove (tasklist->skipped_windows, window);
       g_signal_handlers_disconnect_by_func (window, xfce_tasklist_skipped_windows_state_changed, tasklist);
 
       /* pretend a normal window insert */
@@ -2072,7 +2300,47 @@ xfce_tasklist_sort (XfceTasklist *tasklist,
           }
     }
 
-  gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+  xfce_tasklist_queue_relayout (tasklist);
+}
+
+
+
+static void
+xfce_tasklist_sort_child (XfceTasklist *tasklist,
+                          XfceTasklistChild *child)
+{
+  GList *sibling;
+
+  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+  panel_return_if_fail (child->link != NULL && child->link->data == child);
+
+  if (tasklist->sort_order == XFCE_TASKLIST_SORT_ORDER_DND)
+    return;
+
+  /* the rest of the list is still sorted, so look for the new position
+   * starting from the current one, first towards the start of the list */
+  sibling = child->link;
+  while (sibling->prev != NULL
+         && xfce_tasklist_button_compare (sibling->prev->data, child, tasklist) > 0)
+    sibling = sibling->prev;
+
+  if (sibling == child->link)
+    {
+      /* then towards the end */
+      sibling = child->link->next;
+      while (sibling != NULL
+             && xfce_tasklist_button_compare (child, sibling->data, tasklist) > 0)
+        sibling = sibling->next;
+
+      /* the button is still at the right position */
+      if (sibling == child->link->next)
+        return;
+    }
+
+  tasklist->windows = g_list_remove_link (tasklist->windows, child->link);
+  tasklist->windows = g_list_insert_before_link (tasklist->windows, sibling, child->link);
+
+  xfce_tasklist_queue_relayout (tasklist);
 }
 
 
@@ -2098,6 +2366,10 @@ xfce_tasklist_update_icon_geometries (gpointer data)
 
       child = li->data;
 
+      /* filtered windows have no button to minimize to */
+      if (child->button == NULL)
+        continue;
+
       switch (child->type)
         {
         case CHILD_TYPE_WINDOW:
@@ -2295,18 +2567,95 @@ xfce_tasklist_child_drag_end_event (GtkWidget *widget,
 
 
 
-static XfceTasklistChild *
-xfce_tasklist_child_new (XfceTasklist *tasklist)
+static gchar *
+xfce_tasklist_child_sort_key (const gchar *name)
 {
-  XfceTasklistChild *child;
+  /* comparing the keys with strcmp() gives the same order as
+   * strcasecmp() on the names did */
+  if (name == NULL)
+    return g_strdup ("");
+
+  return g_ascii_strdown (name, -1);
+}
+
+
+
+static gboolean
+xfce_tasklist_child_update_sort_keys (XfceTasklistChild *child)
+{
+  const gchar *name = NULL;
+  const gchar *group_name = NULL;
+  gchar *name_key, *group_key;
+  gboolean changed;
+
+  if (G_LIKELY (child->app != NULL))
+    group_name = xfw_application_get_name (child->app);
+
+  if (child->window != NULL)
+    {
+      name = xfw_window_get_name (child->window);
+
+      /* if there is no app name, use the window name */
+      if (xfce_str_is_empty (group_name))
+        group_name = name;
+    }
+  else
+    {
+      name = group_name;
+    }
+
+  name_key = xfce_tasklist_child_sort_key (name);
+  group_key = xfce_tasklist_child_sort_key (group_name);
+
+  changed = g_strcmp0 (name_key, child->name_key) != 0
+            || g_strcmp0 (group_key, child->group_key) != 0;
+
+  g_free (child->name_key);
+  child->name_key = name_key;
+  g_free (child->group_key);
+  child->group_key = group_key;
+
+  return changed;
+}
+
+
+
+static void
+xfce_tasklist_child_insert (XfceTasklist *tasklist,
+                            XfceTasklistChild *child)
+{
+  GList *sibling;
+
+  panel_return_if_fail (child->link == NULL);
+
+  /* insert before the first child that is not sorted before the new one,
+   * like g_list_insert_sorted_with_data() but keep the link in the child */
+  for (sibling = tasklist->windows; sibling != NULL; sibling = sibling->next)
+    if (xfce_tasklist_button_compare (child, sibling->data, tasklist) <= 0)
+      break;
+
+  child->link = g_list_alloc ();
+  child->link->data = child;
+  tasklist->windows = g_list_insert_before_link (tasklist->windows, sibling, child->link);
+}
+
+
+
+static void
+xfce_tasklist_child_ensure_button (XfceTasklistChild *child)
+{
+  XfceTasklist *tasklist = child->tasklist;
+  XfceTasklistChild *window_child;
   XfcePanelPlugin *plugin;
   GtkCssProvider *provider;
   gchar *css_string;
+  gboolean active = FALSE;
+  GSList *li;
 
-  panel_return_val_if_fail (XFCE_IS_TASKLIST (tasklist), NULL);
+  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
 
-  child = g_slice_new0 (XfceTasklistChild);
-  child->tasklist = tasklist;
+  if (child->button != NULL)
+    return;
 
   /* create the window button */
   child->button = xfce_arrow_button_new (GTK_ARROW_NONE);
@@ -2317,6 +2666,23 @@ xfce_tasklist_child_new (XfceTasklist *tasklist)
   g_object_bind_property (tasklist, "show_tooltips", child->button, "has-tooltip",
                           G_BINDING_SYNC_CREATE);
 
+  plugin = xfce_tasklist_get_panel_plugin (tasklist);
+  gtk_drag_dest_set (GTK_WIDGET (child->button), 0,
+                     NULL, 0, GDK_ACTION_DEFAULT);
+  g_signal_connect_swapped (G_OBJECT (child->button), "drag-motion",
+                            G_CALLBACK (xfce_tasklist_child_drag_motion), child);
+  g_signal_connect_swapped (G_OBJECT (child->button), "drag-leave",
+                            G_CALLBACK (xfce_tasklist_child_drag_leave), child);
+  g_signal_connect_after (G_OBJECT (child->button), "drag-begin",
+                          G_CALLBACK (xfce_tasklist_child_drag_begin_event), plugin);
+  g_signal_connect_after (G_OBJECT (child->button), "drag-end",
+                          G_CALLBACK (xfce_tasklist_child_drag_end_event), plugin);
+
+  if (child->type == CHILD_TYPE_GROUP)
+    xfce_tasklist_group_button_setup (child);
+  else
+    xfce_tasklist_button_setup (child);
+
   child->box = gtk_box_new (!xfce_tasklist_vertical (tasklist) ? GTK_ORIENTATION_HORIZONTAL
                                                                : GTK_ORIENTATION_VERTICAL,
                             6);
@@ -2331,7 +2697,6 @@ xfce_tasklist_child_new (XfceTasklist *tasklist)
                                 tasklist->minimized_icon_lucency % 100);
   gtk_css_provider_load_from_data (provider, css_string, -1, NULL);
   child->icon = gtk_image_new ();
-  child->pixbuf = NULL;
   gtk_style_context_add_provider (gtk_widget_get_style_context (child->icon),
                                   GTK_STYLE_PROVIDER (provider),
                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
@@ -2374,58 +2739,166 @@ xfce_tasklist_child_new (XfceTasklist *tasklist)
   if (tasklist->show_labels)
     gtk_widget_show (child->label);
 
-  plugin = xfce_tasklist_get_panel_plugin (tasklist);
-  gtk_drag_dest_set (GTK_WIDGET (child->button), 0,
-                     NULL, 0, GDK_ACTION_DEFAULT);
-  g_signal_connect_swapped (G_OBJECT (child->button), "drag-motion",
-                            G_CALLBACK (xfce_tasklist_child_drag_motion), child);
-  g_signal_connect_swapped (G_OBJECT (child->button), "drag-leave",
-                            G_CALLBACK (xfce_tasklist_child_drag_leave), child);
-  g_signal_connect_after (G_OBJECT (child->button), "drag-begin",
-                          G_CALLBACK (xfce_tasklist_child_drag_begin_event), plugin);
-  g_signal_connect_after (G_OBJECT (child->button), "drag-end",
-                          G_CALLBACK (xfce_tasklist_child_drag_end_event), plugin);
+  /* restore the state of the button from the window */
+  if (child->type == CHILD_TYPE_GROUP)
+    {
+      gtk_label_set_text (GTK_LABEL (child->label), xfw_application_get_name (child->app));
+      xfce_tasklist_group_button_icon_changed (child->app, child);
 
-  return child;
+      for (li = child->windows; li != NULL; li = li->next)
+        {
+          window_child = li->data;
+          if (window_child->visible && xfw_window_is_active (window_child->window))
+            active = TRUE;
+        }
+    }
+  else
+    {
+      gtk_widget_set_tooltip_text (child->button, xfw_window_get_name (child->window));
+      xfce_tasklist_button_update_label (child);
+      xfce_tasklist_button_icon_changed (child->window, child);
+      active = xfw_window_is_active (child->window);
+    }
+
+  gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button), active);
+  if (child->blinking)
+    xfce_arrow_button_set_blinking (XFCE_ARROW_BUTTON (child->button), TRUE);
+
+  xfce_panel_plugin_stats_add (plugin, "buttons-created", 1);
 }
 
 
 
-/**
- * Wire Frame
- **/
-#ifdef ENABLE_X11
 static void
-xfce_tasklist_wireframe_hide (XfceTasklist *tasklist)
+xfce_tasklist_child_destroy_button (XfceTasklistChild *child)
 {
-  GdkDisplay *dpy;
+  GtkWidget *button = child->button;
 
-  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+  if (button == NULL)
+    return;
 
-  if (tasklist->wireframe_window != 0)
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  /* the leave event of the button will not arrive anymore */
+  if (child->tasklist->thumbnails != NULL && child->window != NULL
+      && child->tasklist->thumbnail_wid == tasklist_window_get_wid (child->window))
+    xfce_tasklist_thumbnail_hide (child->tasklist);
+#endif
+
+  /* a drag over the button does not leave it anymore */
+  if (child->motion_timeout_id != 0)
+    g_source_remove (child->motion_timeout_id);
+
+  child->button = NULL;
+  child->box = NULL;
+  child->icon = NULL;
+  child->label = NULL;
+
+  if (child->pixbuf != NULL)
     {
-      /* unmap the window */
-      dpy = gtk_widget_get_display (GTK_WIDGET (tasklist));
-      XUnmapWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
+      g_object_unref (child->pixbuf);
+      child->pixbuf = NULL;
     }
+
+  /* this drops the last reference, the contents go with the button */
+  gtk_widget_unparent (button);
 }
 
 
 
 static void
-xfce_tasklist_wireframe_destroy (XfceTasklist *tasklist)
+xfce_tasklist_child_set_visible (XfceTasklistChild *child,
+                                 gboolean visible)
 {
-  GdkDisplay *dpy;
+  visible = !!visible;
+  if (child->visible == visible)
+    return;
 
-  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+  child->visible = visible;
 
-  if (tasklist->wireframe_window != 0)
+  /* windows on other workspaces or monitors are often the majority, so
+   * only visible buttons, in the tasklist or in the overflow and group
+   * menus, have widgets; they are created again when shown */
+  if (visible)
     {
-      /* unmap and destroy the window */
-      dpy = gtk_widget_get_display (GTK_WIDGET (tasklist));
-      XUnmapWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
-      XDestroyWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
-
+      xfce_tasklist_child_ensure_button (child);
+      gtk_widget_show (child->button);
+    }
+  else
+    {
+      xfce_tasklist_child_destroy_button (child);
+    }
+
+  xfce_tasklist_queue_relayout (child->tasklist);
+
+  if (child->group != NULL)
+    xfce_tasklist_group_button_child_visible_changed (child->group);
+}
+
+
+
+static void
+xfce_tasklist_child_set_blinking (XfceTasklistChild *child,
+                                  gboolean blinking)
+{
+  /* kept in the child so a button that is created later blinks too */
+  child->blinking = !!blinking;
+  if (child->button != NULL)
+    xfce_arrow_button_set_blinking (XFCE_ARROW_BUTTON (child->button), blinking);
+}
+
+
+
+static XfceTasklistChild *
+xfce_tasklist_child_new (XfceTasklist *tasklist)
+{
+  XfceTasklistChild *child;
+
+  panel_return_val_if_fail (XFCE_IS_TASKLIST (tasklist), NULL);
+
+  /* the button is only created when the child is shown */
+  child = g_slice_new0 (XfceTasklistChild);
+  child->tasklist = tasklist;
+
+  return child;
+}
+
+
+
+/**
+ * Wire Frame
+ **/
+#ifdef ENABLE_X11
+static void
+xfce_tasklist_wireframe_hide (XfceTasklist *tasklist)
+{
+  GdkDisplay *dpy;
+
+  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+
+  if (tasklist->wireframe_window != 0)
+    {
+      /* unmap the window */
+      dpy = gtk_widget_get_display (GTK_WIDGET (tasklist));
+      XUnmapWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
+    }
+}
+
+
+
+static void
+xfce_tasklist_wireframe_destroy (XfceTasklist *tasklist)
+{
+  GdkDisplay *dpy;
+
+  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+
+  if (tasklist->wireframe_window != 0)
+    {
+      /* unmap and destroy the window */
+      dpy = gtk_widget_get_display (GTK_WIDGET (tasklist));
+      XUnmapWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
+      XDestroyWindow (GDK_DISPLAY_XDISPLAY (dpy), tasklist->wireframe_window);
+
       tasklist->wireframe_window = 0;
     }
 }
@@ -2550,6 +3023,66 @@ xfce_tasklist_wireframe_update (XfceTasklist *tasklist,
 
 
 
+/**
+ * Thumbnails
+ **/
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+static void
+xfce_tasklist_thumbnail_hide (XfceTasklist *tasklist)
+{
+  tasklist->thumbnail_wid = 0;
+
+  if (tasklist->thumbnail_popup != NULL)
+    gtk_widget_hide (tasklist->thumbnail_popup);
+}
+
+
+
+static void
+xfce_tasklist_thumbnail_show (XfceTasklist *tasklist,
+                              XfceTasklistChild *child)
+{
+  cairo_surface_t *surface;
+  gint x, y;
+
+  panel_return_if_fail (tasklist->thumbnails != NULL);
+  panel_return_if_fail (XFW_IS_WINDOW (child->window));
+
+  /* the snapshot is prepared in the background, this only reads the cache */
+  surface = tasklist_thumbnails_get (tasklist->thumbnails, tasklist_window_get_wid (child->window));
+  if (surface == NULL)
+    {
+      xfce_tasklist_thumbnail_hide (tasklist);
+      return;
+    }
+
+  if (tasklist->thumbnail_popup == NULL)
+    {
+      tasklist->thumbnail_popup = gtk_window_new (GTK_WINDOW_POPUP);
+      gtk_window_set_type_hint (GTK_WINDOW (tasklist->thumbnail_popup), GDK_WINDOW_TYPE_HINT_TOOLTIP);
+      gtk_style_context_add_class (gtk_widget_get_style_context (tasklist->thumbnail_popup), "tooltip");
+
+      tasklist->thumbnail_image = gtk_image_new ();
+      gtk_container_set_border_width (GTK_CONTAINER (tasklist->thumbnail_popup), 4);
+      gtk_container_add (GTK_CONTAINER (tasklist->thumbnail_popup), tasklist->thumbnail_image);
+      gtk_widget_show (tasklist->thumbnail_image);
+    }
+
+  tasklist->thumbnail_wid = tasklist_window_get_wid (child->window);
+  gtk_window_set_screen (GTK_WINDOW (tasklist->thumbnail_popup), gtk_widget_get_screen (child->button));
+  gtk_image_set_from_surface (GTK_IMAGE (tasklist->thumbnail_image), surface);
+
+  /* shrink to the new snapshot and put it next to the button */
+  gtk_window_resize (GTK_WINDOW (tasklist->thumbnail_popup), 1, 1);
+  xfce_panel_plugin_position_widget (xfce_tasklist_get_panel_plugin (tasklist),
+                                     tasklist->thumbnail_popup, child->button, &x, &y);
+  gtk_window_move (GTK_WINDOW (tasklist->thumbnail_popup), x, y);
+  gtk_widget_show (tasklist->thumbnail_popup);
+}
+#endif
+
+
+
 /**
  * Tasklist Buttons
  **/
@@ -2578,8 +3111,7 @@ xfce_tasklist_button_visible (XfceTasklistChild *child,
           && (G_UNLIKELY (xfw_workspace_get_state (active_ws) & XFW_WORKSPACE_STATE_VIRTUAL)
                 ? xfw_window_is_in_viewport (child->window, active_ws)
                 : xfw_window_is_on_workspace (child->window, active_ws)))
-      || (tasklist->all_blinking
-          && xfce_arrow_button_get_blinking (XFCE_ARROW_BUTTON (child->button))))
+      || (tasklist->all_blinking && child->blinking))
     {
       return (!tasklist->only_minimized
               || xfw_window_is_minimized (child->window));
@@ -2599,7 +3131,6 @@ xfce_tasklist_button_compare (gconstpointer child_a,
   XfceTasklist *tasklist = XFCE_TASKLIST (user_data);
   gint retval;
   XfwApplication *app_a, *app_b;
-  const gchar *name_a, *name_b;
   XfwWorkspace *workspace_a, *workspace_b;
   gint num_a = -1, num_b = -1;
 
@@ -2648,29 +3179,8 @@ xfce_tasklist_button_compare (gconstpointer child_a,
       /* skip this if windows are in same group (or both NULL) */
       if (app_a != app_b)
         {
-          name_a = NULL;
-          name_b = NULL;
-
-          /* get the group name if available */
-          if (G_LIKELY (app_a != NULL))
-            name_a = xfw_application_get_name (app_a);
-          if (G_LIKELY (app_b != NULL))
-            name_b = xfw_application_get_name (app_b);
-
-          /* if there is no app name, use the window name */
-          if (xfce_str_is_empty (name_a)
-              && a->window != NULL)
-            name_a = xfw_window_get_name (a->window);
-          if (xfce_str_is_empty (name_b)
-              && b->window != NULL)
-            name_b = xfw_window_get_name (b->window);
-
-          if (name_a == NULL)
-            name_a = "";
-          if (name_b == NULL)
-            name_b = "";
-
-          retval = strcasecmp (name_a, name_b);
+          /* compare the cached sort keys of the group names */
+          retval = strcmp (a->group_key, b->group_key);
           if (retval != 0)
             return retval;
         }
@@ -2689,26 +3199,8 @@ xfce_tasklist_button_compare (gconstpointer child_a,
     }
   else
     {
-      if (a->window != NULL)
-        name_a = xfw_window_get_name (a->window);
-      else if (a->app != NULL)
-        name_a = xfw_application_get_name (a->app);
-      else
-        name_a = NULL;
-
-      if (b->window != NULL)
-        name_b = xfw_window_get_name (b->window);
-      else if (b->app != NULL)
-        name_b = xfw_application_get_name (b->app);
-      else
-        name_b = NULL;
-
-      if (name_a == NULL)
-        name_a = "";
-      if (name_b == NULL)
-        name_b = "";
-
-      return strcasecmp (name_a, name_b);
+      /* compare the cached sort keys of the window (or group) names */
+      return strcmp (a->name_key, b->name_key);
     }
 }
 
@@ -2741,12 +3233,12 @@ xfce_tasklist_button_icon_changed (XfwWindow *window,
   gint icon_size, scale_factor, old_width = -1, old_height = -1;
 
   panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
-  panel_return_if_fail (GTK_IS_WIDGET (child->icon));
   panel_return_if_fail (XFW_IS_WINDOW (window));
   panel_return_if_fail (child->window == window);
 
-  /* 0 means icons are disabled */
-  if (tasklist->minimized_icon_lucency == 0)
+  /* 0 means icons are disabled, and nothing to do if the button
+   * has never been shown */
+  if (tasklist->minimized_icon_lucency == 0 || child->icon == NULL)
     return;
 
   context = gtk_widget_get_style_context (GTK_WIDGET (child->icon));
@@ -2759,7 +3251,7 @@ xfce_tasklist_button_icon_changed (XfwWindow *window,
                 * child->tasklist->nrows_ratio;
 
   /* get the window icon */
-  pixbuf = xfw_window_get_icon (child->window, icon_size, scale_factor);
+  pixbuf = panel_xfw_icons_get_window_icon (child->window, icon_size, scale_factor);
 
   /* leave when there is no valid pixbuf */
   if (G_UNLIKELY (pixbuf == NULL))
@@ -2791,7 +3283,7 @@ xfce_tasklist_button_icon_changed (XfwWindow *window,
       g_object_unref (child->pixbuf);
     }
 
-  child->pixbuf = g_object_ref (pixbuf);
+  child->pixbuf = pixbuf;
   surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
   gtk_image_set_from_surface (GTK_IMAGE (child->icon), surface);
   cairo_surface_destroy (surface);
@@ -2802,21 +3294,42 @@ xfce_tasklist_button_icon_changed (XfwWindow *window,
 
 
 
+static gboolean
+xfce_tasklist_button_label_fits (XfceTasklistChild *child,
+                                 const gchar *text)
+{
+  PangoLayout *layout;
+  GtkAllocation alloc;
+  gint width, height;
+
+  gtk_widget_get_allocation (child->label, &alloc);
+  if (!gtk_widget_get_mapped (child->label) || alloc.width <= 1 || alloc.height <= 1)
+    return FALSE;
+
+  layout = gtk_widget_create_pango_layout (child->label, text);
+  pango_layout_get_pixel_size (layout, &width, &height);
+  g_object_unref (layout);
+
+  /* the label is rotated in deskbar mode */
+  if (gtk_label_get_angle (GTK_LABEL (child->label)) == 270)
+    return width <= alloc.height && height <= alloc.width;
+
+  return width <= alloc.width && height <= alloc.height;
+}
+
+
+
 static void
-xfce_tasklist_button_name_changed (XfwWindow *window,
-                                   XfceTasklistChild *child)
+xfce_tasklist_button_update_label (XfceTasklistChild *child)
 {
   const gchar *name;
   gchar *label = NULL;
   GtkStyleContext *ctx;
 
-  panel_return_if_fail (window == NULL || child->window == window);
   panel_return_if_fail (XFW_IS_WINDOW (child->window));
-  panel_return_if_fail (XFCE_IS_TASKLIST (child->tasklist));
+  panel_return_if_fail (GTK_IS_LABEL (child->label));
 
   name = xfw_window_get_name (child->window);
-  gtk_widget_set_tooltip_text (GTK_WIDGET (child->button), name);
-  gtk_widget_set_has_tooltip (GTK_WIDGET (child->button), child->tasklist->show_tooltips);
 
   ctx = gtk_widget_get_style_context (child->label);
   gtk_style_context_remove_class (ctx, "label-hidden");
@@ -2837,15 +3350,46 @@ xfce_tasklist_button_name_changed (XfwWindow *window,
         gtk_style_context_add_class (ctx, "label-hidden");
     }
 
-  gtk_label_set_text (GTK_LABEL (child->label), name);
+  /* a new label text always queues a resize of the whole panel, so avoid
+   * that when only the state changed and the text is the same */
+  if (g_strcmp0 (gtk_label_get_text (GTK_LABEL (child->label)), name) != 0)
+    {
+      /* the tasklist only has to move the buttons if the new text does
+       * not fit in the current allocation of the label */
+      if (!xfce_tasklist_button_label_fits (child, name))
+        child->tasklist->layout_valid = FALSE;
+
+      gtk_label_set_text (GTK_LABEL (child->label), name);
+    }
   gtk_label_set_ellipsize (GTK_LABEL (child->label), child->tasklist->ellipsize_mode);
 
   g_free (label);
+}
+
+
+
+static void
+xfce_tasklist_button_name_changed (XfwWindow *window,
+                                   XfceTasklistChild *child)
+{
+  panel_return_if_fail (window == NULL || child->window == window);
+  panel_return_if_fail (XFW_IS_WINDOW (child->window));
+  panel_return_if_fail (XFCE_IS_TASKLIST (child->tasklist));
 
-  /* if window is null, we have not inserted the button the in
-   * tasklist, so no need to sort, because we insert with sorting */
-  if (window != NULL)
-    xfce_tasklist_sort (child->tasklist, FALSE);
+  if (child->button != NULL)
+    {
+      gtk_widget_set_tooltip_text (GTK_WIDGET (child->button), xfw_window_get_name (child->window));
+      gtk_widget_set_has_tooltip (GTK_WIDGET (child->button), child->tasklist->show_tooltips);
+    }
+
+  if (child->label != NULL)
+    xfce_tasklist_button_update_label (child);
+
+  /* only move the button when its name changed, if window is null we
+   * have not inserted the button in the tasklist, so no need to sort,
+   * because we insert with sorting */
+  if (xfce_tasklist_child_update_sort_keys (child) && window != NULL)
+    xfce_tasklist_sort_child (child->tasklist, child);
 }
 
 
@@ -2861,6 +3405,7 @@ xfce_tasklist_button_state_changed (XfwWindow *window,
   XfceTasklist *tasklist;
   XfwWorkspace *active_ws;
   XfceTasklistChild *temp_child;
+  gint64 start;
 
   panel_return_if_fail (XFW_IS_WINDOW (window));
   panel_return_if_fail (child->window == window);
@@ -2881,6 +3426,8 @@ xfce_tasklist_button_state_changed (XfwWindow *window,
       return;
     }
 
+  start = xfce_panel_plugin_stats_timer_start (xfce_tasklist_get_panel_plugin (child->tasklist));
+
   /* update the button name */
   if (PANEL_HAS_FLAG (changed_state, XFW_WINDOW_STATE_SHADED | XFW_WINDOW_STATE_MINIMIZED)
       && !child->tasklist->only_minimized)
@@ -2891,10 +3438,7 @@ xfce_tasklist_button_state_changed (XfwWindow *window,
     {
       if (G_UNLIKELY (child->tasklist->only_minimized))
         {
-          if (PANEL_HAS_FLAG (new_state, XFW_WINDOW_STATE_MINIMIZED))
-            gtk_widget_show (child->button);
-          else
-            gtk_widget_hide (child->button);
+          xfce_tasklist_child_set_visible (child, PANEL_HAS_FLAG (new_state, XFW_WINDOW_STATE_MINIMIZED));
         }
       else
         {
@@ -2921,13 +3465,10 @@ xfce_tasklist_button_state_changed (XfwWindow *window,
           active_ws = xfw_workspace_group_get_active_workspace (child->tasklist->workspace_group);
           if (child->tasklist->all_blinking && blink
               && !xfce_tasklist_button_visible (child, active_ws))
-            {
-              gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button), FALSE);
-              gtk_widget_show (child->button);
-            }
+            xfce_tasklist_child_set_visible (child, TRUE);
 
           /* update button blinking even if grouped so it is in right state when ungrouped */
-          xfce_arrow_button_set_blinking (XFCE_ARROW_BUTTON (child->button), blink);
+          xfce_tasklist_child_set_blinking (child, blink);
 
           /* also update group button blinking if needed */
           if (child->tasklist->grouping)
@@ -2947,14 +3488,142 @@ xfce_tasklist_button_state_changed (XfwWindow *window,
                       }
                   }
 
-              xfce_arrow_button_set_blinking (XFCE_ARROW_BUTTON (group_child->button), blink);
+              xfce_tasklist_child_set_blinking (group_child, blink);
             }
 
           if (child->tasklist->all_blinking
               && !xfce_tasklist_button_visible (child, active_ws))
-            gtk_widget_hide (child->button);
+            xfce_tasklist_child_set_visible (child, FALSE);
         }
     }
+
+  xfce_panel_plugin_stats_timer_stop (xfce_tasklist_get_panel_plugin (child->tasklist),
+                                      "window-state-changed", start);
+}
+
+
+
+static gboolean
+xfce_tasklist_button_rate_limit (XfceTasklistChild *child,
+                                 gint64 *updated,
+                                 guint *timeout_id,
+                                 GSourceFunc update_func)
+{
+  gint64 now, elapsed;
+
+  now = g_get_monotonic_time ();
+  elapsed = (now - *updated) / 1000;
+
+  if (*timeout_id == 0 && elapsed >= UPDATE_RATE_LIMIT)
+    {
+      /* update right away */
+      *updated = now;
+      return FALSE;
+    }
+
+  /* the last change is applied when the interval is over */
+  if (*timeout_id == 0)
+    *timeout_id = gdk_threads_add_timeout_full (G_PRIORITY_DEFAULT_IDLE,
+                                                UPDATE_RATE_LIMIT - MAX (elapsed, 0),
+                                                update_func, child, NULL);
+
+  xfce_panel_plugin_stats_add (xfce_tasklist_get_panel_plugin (child->tasklist),
+                               "suppressed-updates", 1);
+
+  return TRUE;
+}
+
+
+
+static void
+xfce_tasklist_button_app_name_changed (XfwApplication *app,
+                                       GParamSpec *pspec,
+                                       XfceTasklistChild *child)
+{
+  panel_return_if_fail (child->app == app);
+  panel_return_if_fail (XFCE_IS_TASKLIST (child->tasklist));
+
+  /* the application name is part of the sort keys of the window */
+  if (xfce_tasklist_child_update_sort_keys (child))
+    xfce_tasklist_sort_child (child->tasklist, child);
+}
+
+
+
+static gboolean
+xfce_tasklist_button_name_timeout (gpointer data)
+{
+  XfceTasklistChild *child = data;
+  XfceTasklistChild *group_child;
+
+  child->name_timeout_id = 0;
+  child->name_updated = g_get_monotonic_time ();
+  xfce_tasklist_button_name_changed (child->window, child);
+
+  /* the group menu is sorted on the name-changed signal, right after the
+   * keys are updated, so only sort it again when the update was delayed */
+  if (child->tasklist->grouping
+      && (group_child = g_hash_table_lookup (child->tasklist->apps, child->app)) != NULL)
+    xfce_tasklist_group_button_sort (group_child);
+
+  return FALSE;
+}
+
+
+
+static void
+xfce_tasklist_button_queue_name_update (XfwWindow *window,
+                                        XfceTasklistChild *child)
+{
+  XfcePanelPlugin *plugin = xfce_tasklist_get_panel_plugin (child->tasklist);
+  gint64 start;
+
+  panel_return_if_fail (child->window == window);
+
+  start = xfce_panel_plugin_stats_timer_start (plugin);
+
+  if (!xfce_tasklist_button_rate_limit (child, &child->name_updated, &child->name_timeout_id,
+                                        xfce_tasklist_button_name_timeout))
+    xfce_tasklist_button_name_changed (window, child);
+
+  xfce_panel_plugin_stats_timer_stop (plugin, "window-renamed", start);
+}
+
+
+
+static gboolean
+xfce_tasklist_button_icon_timeout (gpointer data)
+{
+  XfceTasklistChild *child = data;
+
+  child->icon_timeout_id = 0;
+  child->icon_updated = g_get_monotonic_time ();
+  xfce_tasklist_button_icon_changed (child->window, child);
+
+  return FALSE;
+}
+
+
+
+static void
+xfce_tasklist_button_queue_icon_update (XfwWindow *window,
+                                        XfceTasklistChild *child)
+{
+  XfcePanelPlugin *plugin = xfce_tasklist_get_panel_plugin (child->tasklist);
+  gint64 start;
+
+  panel_return_if_fail (child->window == window);
+
+  start = xfce_panel_plugin_stats_timer_start (plugin);
+
+  /* drop the old icon of the window from the cache right away */
+  panel_xfw_icons_window_icon_changed (window);
+
+  if (!xfce_tasklist_button_rate_limit (child, &child->icon_updated, &child->icon_timeout_id,
+                                        xfce_tasklist_button_icon_timeout))
+    xfce_tasklist_button_icon_changed (window, child);
+
+  xfce_panel_plugin_stats_timer_stop (plugin, "window-icon-changed", start);
 }
 
 
@@ -2964,14 +3633,30 @@ xfce_tasklist_button_workspace_changed (XfwWindow *window,
                                         XfceTasklistChild *child)
 {
   XfceTasklist *tasklist = XFCE_TASKLIST (child->tasklist);
+  XfwWorkspace *active_ws;
+  gint64 start;
 
   panel_return_if_fail (child->window == window);
   panel_return_if_fail (XFCE_IS_TASKLIST (child->tasklist));
 
-  xfce_tasklist_sort (tasklist, FALSE);
-  xfce_tasklist_active_window_changed (tasklist->screen, window, tasklist);
-  if (!tasklist->all_workspaces)
-    xfce_tasklist_active_workspace_changed (tasklist->workspace_group, NULL, tasklist);
+  start = xfce_panel_plugin_stats_timer_start (xfce_tasklist_get_panel_plugin (tasklist));
+
+  xfce_tasklist_sort_child (tasklist, child);
+
+  /* only the state and visibility of this button changed */
+  if (child->button != NULL)
+    gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button),
+                                  xfw_window_is_active (window));
+  if (!tasklist->all_workspaces
+      && !xfce_taskbar_is_locked (tasklist)
+      && child->type != CHILD_TYPE_GROUP)
+    {
+      active_ws = xfw_workspace_group_get_active_workspace (tasklist->workspace_group);
+      xfce_tasklist_child_set_visible (child, xfce_tasklist_button_visible (child, active_ws));
+    }
+
+  xfce_panel_plugin_stats_timer_stop (xfce_tasklist_get_panel_plugin (tasklist),
+                                      "window-workspace-changed", start);
 }
 
 
@@ -2991,10 +3676,7 @@ xfce_tasklist_button_monitors_changed (XfwWindow *window,
     {
       /* check if we need to change the visibility of the button */
       active_ws = xfw_workspace_group_get_active_workspace (child->tasklist->workspace_group);
-      if (xfce_tasklist_button_visible (child, active_ws))
-        gtk_widget_show (child->button);
-      else
-        gtk_widget_hide (child->button);
+      xfce_tasklist_child_set_visible (child, xfce_tasklist_button_visible (child, active_ws));
     }
 }
 
@@ -3034,6 +3716,23 @@ xfce_tasklist_button_leave_notify_event (GtkWidget *button,
 
 
 
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+static gboolean
+xfce_tasklist_button_thumbnail_leave_notify_event (GtkWidget *button,
+                                                   GdkEventCrossing *event,
+                                                   XfceTasklistChild *child)
+{
+  panel_return_val_if_fail (XFCE_IS_TASKLIST (child->tasklist), FALSE);
+
+  g_signal_handlers_disconnect_by_func (button, xfce_tasklist_button_thumbnail_leave_notify_event, child);
+  xfce_tasklist_thumbnail_hide (child->tasklist);
+
+  return FALSE;
+}
+#endif
+
+
+
 static gboolean
 xfce_tasklist_button_enter_notify_event (GtkWidget *button,
                                          GdkEventCrossing *event,
@@ -3044,6 +3743,16 @@ xfce_tasklist_button_enter_notify_event (GtkWidget *button,
   panel_return_val_if_fail (GTK_IS_WIDGET (button), FALSE);
   panel_return_val_if_fail (XFW_IS_WINDOW (child->window), FALSE);
 
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  /* show the thumbnail when hovering the button, not the menu items */
+  if (child->tasklist->thumbnails != NULL && button == child->button)
+    {
+      xfce_tasklist_thumbnail_show (child->tasklist, child);
+      g_signal_connect (G_OBJECT (button), "leave-notify-event",
+                        G_CALLBACK (xfce_tasklist_button_thumbnail_leave_notify_event), child);
+    }
+#endif
+
 #ifdef ENABLE_X11
   /* leave when there is nothing to do */
   if (!child->tasklist->show_wireframes)
@@ -3158,11 +3867,12 @@ xfce_tasklist_button_menu_destroy (GtkWidget *menu,
                                    XfceTasklistChild *child)
 {
   panel_return_if_fail (XFCE_IS_TASKLIST (child->tasklist));
-  panel_return_if_fail (GTK_IS_TOGGLE_BUTTON (child->button));
   panel_return_if_fail (GTK_IS_WIDGET (menu));
 
   panel_utils_destroy_later (menu);
-  if (!xfw_window_is_active (child->window))
+
+  /* the button is gone if the window was filtered out meanwhile */
+  if (child->button != NULL && !xfw_window_is_active (child->window))
     gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (child->button), FALSE);
 }
 
@@ -3321,9 +4031,11 @@ xfce_tasklist_button_proxy_menu_item (XfceTasklistChild *child,
   panel_return_val_if_fail (child->type == CHILD_TYPE_OVERFLOW_MENU
                               || child->type == CHILD_TYPE_GROUP_MENU,
                             NULL);
-  panel_return_val_if_fail (GTK_IS_LABEL (child->label), NULL);
   panel_return_val_if_fail (XFW_IS_WINDOW (child->window), NULL);
 
+  /* only visible buttons are in the menus, so the button exists */
+  panel_return_val_if_fail (GTK_IS_LABEL (child->label), NULL);
+
   mi = panel_image_menu_item_new ();
   g_object_bind_property (G_OBJECT (child->label), "label",
                           G_OBJECT (mi), "label",
@@ -3435,8 +4147,7 @@ xfce_tasklist_button_activate (XfceTasklistChild *child,
        * and if all workspaces/viewports are shown or if we have
        * all blinking enabled and the current button is blinking */
       if ((child->tasklist->all_workspaces && !xfw_window_is_pinned (child->window))
-          || (child->tasklist->all_blinking
-              && xfce_arrow_button_get_blinking (XFCE_ARROW_BUTTON (child->button))))
+          || (child->tasklist->all_blinking && child->blinking))
         {
           screen = gtk_widget_get_screen (GTK_WIDGET (child->tasklist));
           scale_factor = gdk_window_get_scale_factor (gtk_widget_get_window (GTK_WIDGET (child->tasklist)));
@@ -3566,12 +4277,13 @@ xfce_tasklist_button_drag_begin (GtkWidget *button,
   if (!gtk_icon_size_lookup (GTK_ICON_SIZE_DND, &size, NULL))
     size = 32;
   scale_factor = gtk_widget_get_scale_factor (button);
-  pixbuf = xfw_window_get_icon (child->window, size, scale_factor);
+  pixbuf = panel_xfw_icons_get_window_icon (child->window, size, scale_factor);
   if (G_LIKELY (pixbuf != NULL))
     {
       cairo_surface_t *surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
       gtk_drag_set_icon_surface (context, surface);
       cairo_surface_destroy (surface);
+      g_object_unref (pixbuf);
     }
 }
 
@@ -3587,7 +4299,7 @@ xfce_tasklist_button_drag_data_received (GtkWidget *button,
                                          guint drag_time,
                                          XfceTasklistChild *child2)
 {
-  GList *li, *sibling;
+  GList *li, *sibling, *drag;
   gulong wid;
   XfceTasklistChild *child;
   XfceTasklist *tasklist = XFCE_TASKLIST (child2->tasklist);
@@ -3600,33 +4312,40 @@ xfce_tasklist_button_drag_data_received (GtkWidget *button,
 
   gtk_widget_get_allocation (button, &allocation);
 
-  sibling = g_list_find (tasklist->windows, child2);
+  sibling = child2->link;
   panel_return_if_fail (sibling != NULL);
 
-  if ((xfce_tasklist_horizontal (tasklist) && x >= allocation.width / 2)
-      || (!xfce_tasklist_horizontal (tasklist) && y >= allocation.height / 2))
-    sibling = g_list_next (sibling);
-
+  /* find the dragged button */
   wid = *((gulong *) (gpointer) gtk_selection_data_get_data (selection_data));
-  for (li = tasklist->windows; li != NULL; li = li->next)
+  for (li = tasklist->windows, drag = NULL; li != NULL; li = li->next)
     {
       child = li->data;
 
-      if (sibling != li /* drop on end previous button */
-          && child != child2 /* drop on the same button */
-          && g_list_next (li) != sibling /* drop start of next button */
+      if (child != child2 /* drop on the same button */
           && child->window != NULL
           && tasklist_window_get_wid (child->window) == wid)
         {
-          /* swap items */
-          tasklist->windows = g_list_delete_link (tasklist->windows, li);
-          tasklist->windows = g_list_insert_before (tasklist->windows, sibling, child);
-
-          gtk_widget_queue_resize (GTK_WIDGET (tasklist));
-
+          drag = li;
           break;
         }
     }
+
+  if (drag == NULL)
+    return;
+
+  if ((xfce_tasklist_horizontal (tasklist) && x >= allocation.width / 2)
+      || (!xfce_tasklist_horizontal (tasklist) && y >= allocation.height / 2))
+    sibling = g_list_next (sibling);
+
+  if (sibling != drag /* drop on end previous button */
+      && g_list_next (drag) != sibling) /* drop start of next button */
+    {
+      /* swap items */
+      tasklist->windows = g_list_remove_link (tasklist->windows, drag);
+      tasklist->windows = g_list_insert_before_link (tasklist->windows, sibling, drag);
+
+      xfce_tasklist_queue_relayout (tasklist);
+    }
 }
 
 
@@ -3651,6 +4370,46 @@ xfce_tasklist_button_new (XfwWindow *window,
   child->app = xfw_window_get_application (window);
   child->unique_id = unique_id_counter++;
 
+  /* monitor window changes */
+  g_signal_connect (G_OBJECT (window), "icon-changed",
+                    G_CALLBACK (xfce_tasklist_button_queue_icon_update), child);
+  g_signal_connect (G_OBJECT (window), "name-changed",
+                    G_CALLBACK (xfce_tasklist_button_queue_name_update), child);
+  g_signal_connect (G_OBJECT (window), "state-changed",
+                    G_CALLBACK (xfce_tasklist_button_state_changed), child);
+  g_signal_connect (G_OBJECT (window), "workspace-changed",
+                    G_CALLBACK (xfce_tasklist_button_workspace_changed), child);
+  g_signal_connect (G_OBJECT (window), "notify::monitors",
+                    G_CALLBACK (xfce_tasklist_button_monitors_changed), child);
+  if (child->app != NULL)
+    g_signal_connect (G_OBJECT (child->app), "notify::name",
+                      G_CALLBACK (xfce_tasklist_button_app_name_changed), child);
+
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  /* prepare a snapshot of the window for hovering */
+  if (tasklist->thumbnails != NULL)
+    tasklist_thumbnails_watch (tasklist->thumbnails, tasklist_window_get_wid (window));
+#endif
+
+  /* poke functions */
+  xfce_tasklist_button_icon_changed (window, child);
+  xfce_tasklist_button_name_changed (NULL, child);
+
+  /* insert */
+  xfce_tasklist_child_insert (tasklist, child);
+  g_hash_table_insert (tasklist->window_children, window, child);
+
+  return child;
+}
+
+
+
+static void
+xfce_tasklist_button_setup (XfceTasklistChild *child)
+{
+  panel_return_if_fail (XFW_IS_WINDOW (child->window));
+  panel_return_if_fail (GTK_IS_WIDGET (child->button));
+
   /* drag and drop to the pager */
   gtk_drag_source_set (child->button, GDK_BUTTON1_MASK,
                        source_targets, G_N_ELEMENTS (source_targets),
@@ -3672,29 +4431,6 @@ xfce_tasklist_button_new (XfwWindow *window,
                     G_CALLBACK (xfce_tasklist_button_button_press_event), child);
   g_signal_connect (G_OBJECT (child->button), "button-release-event",
                     G_CALLBACK (xfce_tasklist_button_button_release_event), child);
-
-  /* monitor window changes */
-  g_signal_connect (G_OBJECT (window), "icon-changed",
-                    G_CALLBACK (xfce_tasklist_button_icon_changed), child);
-  g_signal_connect (G_OBJECT (window), "name-changed",
-                    G_CALLBACK (xfce_tasklist_button_name_changed), child);
-  g_signal_connect (G_OBJECT (window), "state-changed",
-                    G_CALLBACK (xfce_tasklist_button_state_changed), child);
-  g_signal_connect (G_OBJECT (window), "workspace-changed",
-                    G_CALLBACK (xfce_tasklist_button_workspace_changed), child);
-  g_signal_connect (G_OBJECT (window), "notify::monitors",
-                    G_CALLBACK (xfce_tasklist_button_monitors_changed), child);
-
-  /* poke functions */
-  xfce_tasklist_button_icon_changed (window, child);
-  xfce_tasklist_button_name_changed (NULL, child);
-
-  /* insert */
-  tasklist->windows = g_list_insert_sorted_with_data (tasklist->windows, child,
-                                                      xfce_tasklist_button_compare,
-                                                      tasklist);
-
-  return child;
 }
 
 
@@ -3714,7 +4450,7 @@ xfce_tasklist_group_button_menu_minimize_all (XfceTasklistChild *group_child)
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           panel_return_if_fail (XFW_IS_WINDOW (child->window));
@@ -3737,7 +4473,7 @@ xfce_tasklist_group_button_menu_unminimize_all (XfceTasklistChild *group_child)
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           panel_return_if_fail (XFW_IS_WINDOW (child->window));
@@ -3760,7 +4496,7 @@ xfce_tasklist_group_button_menu_maximize_all (XfceTasklistChild *group_child)
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           panel_return_if_fail (XFW_IS_WINDOW (child->window));
@@ -3783,7 +4519,7 @@ xfce_tasklist_group_button_menu_unmaximize_all (XfceTasklistChild *group_child)
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           panel_return_if_fail (XFW_IS_WINDOW (child->window));
@@ -3805,7 +4541,7 @@ xfce_tasklist_group_button_menu_close_all (XfceTasklistChild *group_child)
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           panel_return_if_fail (XFW_IS_WINDOW (child->window));
@@ -3851,7 +4587,7 @@ xfce_tasklist_group_button_menu (XfceTasklistChild *group_child,
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         {
           mi = xfce_tasklist_button_proxy_menu_item (child, !action_menu_entries);
@@ -3926,7 +4662,6 @@ xfce_tasklist_group_button_menu_destroy (GtkWidget *menu,
   GSList *lp;
 
   panel_return_if_fail (XFCE_IS_TASKLIST (group_child->tasklist));
-  panel_return_if_fail (GTK_IS_TOGGLE_BUTTON (group_child->button));
   panel_return_if_fail (GTK_IS_WIDGET (menu));
 
   panel_utils_destroy_later (menu);
@@ -3938,7 +4673,7 @@ xfce_tasklist_group_button_menu_destroy (GtkWidget *menu,
       if (xfw_window_is_active (child->window))
         break;
     }
-  if (lp == NULL)
+  if (lp == NULL && group_child->button != NULL)
     gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (group_child->button), FALSE);
 
 #ifdef ENABLE_X11
@@ -3998,7 +4733,7 @@ xfce_tasklist_group_button_button_draw (GtkWidget *widget,
 
       pango_layout_get_pixel_extents (n_windows_layout, &ink_extent, &log_extent);
       radius = log_extent.height / 2;
-      if (group_child->tasklist->show_labels)
+      if (group_child->tasklist->show_labels && group_child->icon != NULL)
         {
           GdkPoint icon_coords = {};
           g_warn_if_fail (gtk_widget_translate_coordinates (group_child->icon, widget, 0, 0, &icon_coords.x, &icon_coords.y));
@@ -4183,19 +4918,20 @@ xfce_tasklist_group_button_name_changed (XfwApplication *app,
   for (li = group_child->windows, group_child->n_windows = 0; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button)
+      if (child->visible
           && child->type == CHILD_TYPE_GROUP_MENU)
         group_child->n_windows++;
     }
 
   /* create the button label */
   name = xfw_application_get_name (group_child->app);
-  gtk_label_set_text (GTK_LABEL (group_child->label), name);
+  if (group_child->label != NULL)
+    gtk_label_set_text (GTK_LABEL (group_child->label), name);
 
   /* don't sort if there is no need to update the sorting (ie. only number
    * of windows is changed or button is not inserted in the tasklist yet */
-  if (app != NULL)
-    xfce_tasklist_sort (group_child->tasklist, FALSE);
+  if (xfce_tasklist_child_update_sort_keys (group_child) && app != NULL)
+    xfce_tasklist_sort_child (group_child->tasklist, group_child);
 }
 
 
@@ -4214,11 +4950,10 @@ xfce_tasklist_group_button_icon_changed (XfwApplication *app,
   panel_return_if_fail (XFCE_IS_TASKLIST (group_child->tasklist));
   panel_return_if_fail (XFW_IS_APPLICATION (app));
   panel_return_if_fail (group_child->app == app);
-  panel_return_if_fail (GTK_IS_WIDGET (group_child->icon));
 
   /* 0 means icons are disabled, although the grouping button does
    * not use lucient icons */
-  if (group_child->tasklist->minimized_icon_lucency == 0)
+  if (group_child->tasklist->minimized_icon_lucency == 0 || group_child->icon == NULL)
     return;
 
   icon_size = xfce_panel_plugin_get_icon_size (xfce_tasklist_get_panel_plugin (group_child->tasklist))
@@ -4227,7 +4962,7 @@ xfce_tasklist_group_button_icon_changed (XfwApplication *app,
   context = gtk_widget_get_style_context (GTK_WIDGET (group_child->icon));
 
   /* get the app icon */
-  pixbuf = xfw_application_get_icon (app, icon_size, scale_factor);
+  pixbuf = panel_xfw_icons_get_application_icon (app, icon_size, scale_factor);
 
   /* check if all the windows in the group are minimized */
   for (li = group_child->windows; li != NULL; li = li->next)
@@ -4265,7 +5000,7 @@ xfce_tasklist_group_button_icon_changed (XfwApplication *app,
           g_object_unref (group_child->pixbuf);
         }
 
-      group_child->pixbuf = g_object_ref (pixbuf);
+      group_child->pixbuf = pixbuf;
       surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
       gtk_image_set_from_surface (GTK_IMAGE (group_child->icon), surface);
       cairo_surface_destroy (surface);
@@ -4283,6 +5018,16 @@ xfce_tasklist_group_button_icon_changed (XfwApplication *app,
 
 
 
+static void
+xfce_tasklist_group_button_app_icon_changed (XfwApplication *app,
+                                             XfceTasklistChild *group_child)
+{
+  panel_xfw_icons_application_icon_changed (app);
+  xfce_tasklist_group_button_icon_changed (app, group_child);
+}
+
+
+
 static void
 xfce_tasklist_group_button_remove (XfceTasklistChild *group_child)
 {
@@ -4305,14 +5050,12 @@ xfce_tasklist_group_button_remove (XfceTasklistChild *group_child)
                                             G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, group_child);
   panel_return_if_fail (n == 2);
 
-  /* disconnect from visible windows */
+  /* disconnect from the windows */
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      panel_return_if_fail (GTK_IS_BUTTON (child->button));
-      n = g_signal_handlers_disconnect_matched (G_OBJECT (child->button),
-                                                G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, group_child);
-      panel_return_if_fail (n == 2);
+      panel_return_if_fail (child->group == group_child);
+      child->group = NULL;
       n = g_signal_handlers_disconnect_matched (G_OBJECT (child->window),
                                                 G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, group_child);
       panel_return_if_fail (n == 2);
@@ -4321,9 +5064,8 @@ xfce_tasklist_group_button_remove (XfceTasklistChild *group_child)
   g_slist_free (group_child->windows);
   group_child->windows = NULL;
 
-  /* destroy the button, this will free the remaining child
-   * data in the container remove function */
-  gtk_widget_destroy (group_child->button);
+  /* destroy the button and free the remaining child data */
+  xfce_tasklist_child_remove (group_child->tasklist, group_child);
 }
 
 
@@ -4335,13 +5077,8 @@ xfce_tasklist_group_button_keep_dnd_position (XfceTasklistChild *group_child,
 {
   XfceTasklist *tasklist = group_child->tasklist;
 
-  tasklist->windows = g_list_remove (tasklist->windows, moved);
-  for (GList *lp = tasklist->windows; lp != NULL; lp = lp->next)
-    if (lp->data == sibling)
-      {
-        tasklist->windows = g_list_insert_before (tasklist->windows, lp, moved);
-        break;
-      }
+  tasklist->windows = g_list_remove_link (tasklist->windows, moved->link);
+  tasklist->windows = g_list_insert_before_link (tasklist->windows, sibling->link, moved->link);
 }
 
 
@@ -4366,7 +5103,7 @@ xfce_tasklist_group_button_child_visible_changed (XfceTasklistChild *group_child
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button))
+      if (child->visible)
         {
           visible_counter++;
           group_child->unique_id = MAX (group_child->unique_id, child->unique_id);
@@ -4376,30 +5113,30 @@ xfce_tasklist_group_button_child_visible_changed (XfceTasklistChild *group_child
   if (visible_counter > 1)
     {
       if (group_child->tasklist->sort_order == XFCE_TASKLIST_SORT_ORDER_DND
-          && !gtk_widget_get_visible (group_child->button))
+          && !group_child->visible)
         xfce_tasklist_group_button_keep_dnd_position (group_child, group_child->windows->data,
                                                       group_child);
 
       /* show the button and take the windows */
-      gtk_widget_show (group_child->button);
+      xfce_tasklist_child_set_visible (group_child, TRUE);
       type = CHILD_TYPE_GROUP_MENU;
     }
   else
     {
       if (group_child->tasklist->sort_order == XFCE_TASKLIST_SORT_ORDER_DND
-          && gtk_widget_get_visible (group_child->button))
+          && group_child->visible)
         xfce_tasklist_group_button_keep_dnd_position (group_child, group_child,
                                                       group_child->windows->data);
 
       /* hide the button and ungroup the buttons */
-      gtk_widget_hide (group_child->button);
+      xfce_tasklist_child_set_visible (group_child, FALSE);
       type = CHILD_TYPE_WINDOW;
     }
 
   for (li = group_child->windows; li != NULL; li = li->next)
     {
       child = li->data;
-      if (gtk_widget_get_visible (child->button))
+      if (child->visible)
         child->type = type;
     }
 
@@ -4417,14 +5154,14 @@ xfce_tasklist_group_button_child_visible_changed (XfceTasklistChild *group_child
 
 static void
 xfce_tasklist_group_button_child_destroyed (XfceTasklistChild *group_child,
-                                            GtkWidget *child_button)
+                                            XfceTasklistChild *window_child)
 {
   GSList *li, *lnext;
   XfceTasklistChild *child;
   guint n_children;
 
   panel_return_if_fail (group_child->type == CHILD_TYPE_GROUP);
-  panel_return_if_fail (GTK_IS_BUTTON (child_button));
+  panel_return_if_fail (window_child->group == group_child);
   panel_return_if_fail (group_child->windows != NULL);
   panel_return_if_fail (XFCE_IS_TASKLIST (group_child->tasklist));
   panel_return_if_fail (XFW_IS_APPLICATION (group_child->app));
@@ -4433,12 +5170,14 @@ xfce_tasklist_group_button_child_destroyed (XfceTasklistChild *group_child,
     {
       child = li->data;
       lnext = li->next;
-      if (G_UNLIKELY (child->button == child_button))
+      if (G_UNLIKELY (child == window_child))
         group_child->windows = g_slist_delete_link (group_child->windows, li);
       else
         n_children++;
     }
 
+  window_child->group = NULL;
+
   if (n_children > 0)
     {
       xfce_tasklist_group_button_child_visible_changed (group_child);
@@ -4476,11 +5215,8 @@ xfce_tasklist_group_button_add_window (XfceTasklistChild *group_child,
   panel_return_if_fail (XFCE_IS_TASKLIST (group_child->tasklist));
   panel_return_if_fail (g_slist_find (group_child->windows, window_child) == NULL);
 
-  /* watch child visibility changes */
-  g_signal_connect_swapped (G_OBJECT (window_child->button), "notify::visible",
-                            G_CALLBACK (xfce_tasklist_group_button_child_visible_changed), group_child);
-  g_signal_connect_swapped (G_OBJECT (window_child->button), "destroy",
-                            G_CALLBACK (xfce_tasklist_group_button_child_destroyed), group_child);
+  /* the window child reports its visibility changes and removal */
+  window_child->group = group_child;
   g_signal_connect_swapped (G_OBJECT (window_child->window), "name-changed",
                             G_CALLBACK (xfce_tasklist_group_button_sort), group_child);
   g_signal_connect_swapped (G_OBJECT (window_child->window), "workspace-changed",
@@ -4510,20 +5246,9 @@ xfce_tasklist_group_button_new (XfwApplication *app,
   child->type = CHILD_TYPE_GROUP;
   child->app = app;
 
-  gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (child->button)), "group-button");
-  g_signal_connect_after (G_OBJECT (child->button), "draw",
-                          G_CALLBACK (xfce_tasklist_group_button_button_draw), child);
-  /* note that the same signals should be in the proxy menu item too */
-  g_signal_connect (G_OBJECT (child->button), "button-press-event",
-                    G_CALLBACK (xfce_tasklist_group_button_button_press_event), child);
-  g_signal_connect (G_OBJECT (child->button), "button-release-event",
-                    G_CALLBACK (xfce_tasklist_group_button_button_release_event), child);
-  g_signal_connect (G_OBJECT (child->button), "size-allocate",
-                    G_CALLBACK (xfce_tasklist_group_button_button_size_allocate), child);
-
   /* monitor app changes */
   g_signal_connect (G_OBJECT (app), "icon-changed",
-                    G_CALLBACK (xfce_tasklist_group_button_icon_changed), child);
+                    G_CALLBACK (xfce_tasklist_group_button_app_icon_changed), child);
   g_signal_connect (G_OBJECT (app), "notify::name",
                     G_CALLBACK (xfce_tasklist_group_button_name_changed), child);
 
@@ -4532,15 +5257,33 @@ xfce_tasklist_group_button_new (XfwApplication *app,
   xfce_tasklist_group_button_name_changed (NULL, NULL, child);
 
   /* insert */
-  tasklist->windows = g_list_insert_sorted_with_data (tasklist->windows, child,
-                                                      xfce_tasklist_button_compare,
-                                                      tasklist);
+  xfce_tasklist_child_insert (tasklist, child);
 
   return child;
 }
 
 
 
+static void
+xfce_tasklist_group_button_setup (XfceTasklistChild *group_child)
+{
+  panel_return_if_fail (group_child->type == CHILD_TYPE_GROUP);
+  panel_return_if_fail (GTK_IS_WIDGET (group_child->button));
+
+  gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (group_child->button)), "group-button");
+  g_signal_connect_after (G_OBJECT (group_child->button), "draw",
+                          G_CALLBACK (xfce_tasklist_group_button_button_draw), group_child);
+  /* note that the same signals should be in the proxy menu item too */
+  g_signal_connect (G_OBJECT (group_child->button), "button-press-event",
+                    G_CALLBACK (xfce_tasklist_group_button_button_press_event), group_child);
+  g_signal_connect (G_OBJECT (group_child->button), "button-release-event",
+                    G_CALLBACK (xfce_tasklist_group_button_button_release_event), group_child);
+  g_signal_connect (G_OBJECT (group_child->button), "size-allocate",
+                    G_CALLBACK (xfce_tasklist_group_button_button_size_allocate), group_child);
+}
+
+
+
 /**
  * Potential Public Functions
  **/
@@ -4606,8 +5349,9 @@ xfce_tasklist_set_button_relief (XfceTasklist *tasklist,
       for (li = tasklist->windows; li != NULL; li = li->next)
         {
           child = li->data;
-          gtk_button_set_relief (GTK_BUTTON (child->button),
-                                 button_relief);
+          if (child->button != NULL)
+            gtk_button_set_relief (GTK_BUTTON (child->button),
+                                   button_relief);
         }
 
       /* arrow button for overflow menu */
@@ -4638,6 +5382,10 @@ xfce_tasklist_set_show_labels (XfceTasklist *tasklist,
         {
           child = li->data;
 
+          /* the button is set up right when it is shown */
+          if (child->box == NULL)
+            continue;
+
           /* show or hide the label */
           if (show_labels)
             {
@@ -4662,8 +5410,9 @@ xfce_tasklist_set_show_labels (XfceTasklist *tasklist,
             xfce_tasklist_group_button_icon_changed (child->app, child);
           else
             xfce_tasklist_button_icon_changed (child->window, child);
-          gtk_widget_queue_resize (GTK_WIDGET (tasklist));
         }
+
+      xfce_tasklist_queue_relayout (tasklist);
     }
 }
 
@@ -4705,6 +5454,49 @@ xfce_tasklist_set_show_wireframes (XfceTasklist *tasklist,
 
 
 
+static void
+xfce_tasklist_set_show_thumbnails (XfceTasklist *tasklist,
+                                   gboolean show_thumbnails)
+{
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  GdkDisplay *display;
+  GList *li;
+  XfceTasklistChild *child;
+#endif
+
+  panel_return_if_fail (XFCE_IS_TASKLIST (tasklist));
+
+  show_thumbnails = !!show_thumbnails;
+
+  if (tasklist->show_thumbnails == show_thumbnails)
+    return;
+
+  tasklist->show_thumbnails = show_thumbnails;
+
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  display = gtk_widget_get_display (GTK_WIDGET (tasklist));
+  if (show_thumbnails && tasklist_thumbnails_supported (display))
+    {
+      tasklist->thumbnails = tasklist_thumbnails_new (display);
+
+      /* watch the windows that are already in the tasklist */
+      for (li = tasklist->windows; li != NULL; li = li->next)
+        {
+          child = li->data;
+          if (child->window != NULL)
+            tasklist_thumbnails_watch (tasklist->thumbnails, tasklist_window_get_wid (child->window));
+        }
+    }
+  else
+    {
+      xfce_tasklist_thumbnail_hide (tasklist);
+      g_clear_pointer (&tasklist->thumbnails, tasklist_thumbnails_free);
+    }
+#endif
+}
+
+
+
 static void
 xfce_tasklist_set_label_decorations (XfceTasklist *tasklist,
                                      gboolean label_decorations)
@@ -4763,6 +5555,10 @@ xfce_tasklist_update_orientation (XfceTasklist *tasklist)
     {
       child = li->data;
 
+      /* the button is set up right when it is shown */
+      if (child->box == NULL)
+        continue;
+
       /* update task box */
       gtk_orientable_set_orientation (GTK_ORIENTABLE (child->box),
                                       horizontal ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL);
@@ -4784,7 +5580,7 @@ xfce_tasklist_update_orientation (XfceTasklist *tasklist)
         }
     }
 
-  gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+  xfce_tasklist_queue_relayout (tasklist);
 }
 
 
@@ -4799,7 +5595,7 @@ xfce_tasklist_set_nrows (XfceTasklist *tasklist,
   if (tasklist->nrows != nrows)
     {
       tasklist->nrows = nrows;
-      gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+      xfce_tasklist_queue_relayout (tasklist);
     }
 }
 
@@ -4831,7 +5627,7 @@ xfce_tasklist_set_size (XfceTasklist *tasklist,
   if (tasklist->size != size)
     {
       tasklist->size = size;
-      gtk_widget_queue_resize (GTK_WIDGET (tasklist));
+      xfce_tasklist_queue_relayout (tasklist);
     }
 
   for (li = tasklist->windows; li != NULL; li = li->next)
@@ -132,6 +132,7 @@ tasklist_plugin_construct (XfcePanelPlugin *panel_plugin)
     { "switch-workspace-on-unminimize", G_TYPE_BOOLEAN },
     { "show-only-minimized", G_TYPE_BOOLEAN },
     { "show-wireframes", G_TYPE_BOOLEAN },
+    { "show-thumbnails", G_TYPE_BOOLEAN },
     { "show-handle", G_TYPE_BOOLEAN },
     { "show-tooltips", G_TYPE_BOOLEAN },
     { "sort-order", G_TYPE_UINT },
@@ -248,6 +249,7 @@ tasklist_plugin_configure_plugin (XfcePanelPlugin *panel_plugin)
   TASKLIST_DIALOG_BIND_INV ("switch-workspace-on-unminimize", "active")
   TASKLIST_DIALOG_BIND ("show-only-minimized", "active")
   TASKLIST_DIALOG_BIND ("show-wireframes", "active")
+  TASKLIST_DIALOG_BIND ("show-thumbnails", "active")
   TASKLIST_DIALOG_BIND ("show-handle", "active")
   TASKLIST_DIALOG_BIND ("show-tooltips", "active")
   TASKLIST_DIALOG_BIND ("sort-order", "active")
@@ -261,6 +263,16 @@ tasklist_plugin_configure_plugin (XfcePanelPlugin *panel_plugin)
       gtk_widget_hide (GTK_WIDGET (object));
     }
 
+#ifdef ENABLE_TASKLIST_THUMBNAILS
+  if (!WINDOWING_IS_X11 ())
+#endif
+    {
+      /* thumbnails need the composite and damage extensions, and a
+       * compositing manager to capture anything */
+      object = gtk_builder_get_object (builder, "show-thumbnails");
+      gtk_widget_hide (GTK_WIDGET (object));
+    }
+
   gtk_widget_show (GTK_WIDGET (dialog));
 }
 
@@ -26,6 +26,7 @@
 #include "common/panel-private.h"
 #include "common/panel-utils.h"
 #include "common/panel-xfconf.h"
+#include "common/panel-xfw-icons.h"
 
 #include <exo/exo.h>
 #include <gdk/gdkkeysyms.h>
@@ -64,6 +65,19 @@ struct _WindowMenuPlugin
   /* urgent window counter */
   gint urgent_windows;
 
+  /* window list menu, kept up to date once it is built */
+  GtkWidget *menu;
+  GHashTable *window_items;
+  GHashTable *workspace_items;
+  GPtrArray *separators;
+  GtkWidget *no_windows_item;
+  GtkWidget *urgent_item;
+  GtkWidget *add_item;
+  GtkWidget *remove_item;
+  gint menu_scale_factor;
+  GtkIconTheme *menu_icon_theme;
+  guint menu_sync_id;
+
   /* gtk style properties */
   gint minimized_icon_lucency;
   PangoEllipsizeMode ellipsize_mode;
@@ -142,6 +156,13 @@ static void
 window_menu_plugin_windows_connect (WindowMenuPlugin *plugin,
                                     gboolean traverse_windows);
 static void
+window_menu_plugin_menu_window_changed (WindowMenuPlugin *plugin,
+                                        XfwWindow *window);
+static void
+window_menu_plugin_menu_queue_sync (WindowMenuPlugin *plugin);
+static void
+window_menu_plugin_menu_destroy (WindowMenuPlugin *plugin);
+static void
 window_menu_plugin_menu (GtkWidget *button,
                          WindowMenuPlugin *plugin);
 
@@ -350,10 +371,12 @@ window_menu_plugin_set_property (GObject *object,
 
     case PROP_WORKSPACE_ACTIONS:
       plugin->workspace_actions = g_value_get_boolean (value);
+      window_menu_plugin_menu_queue_sync (plugin);
       break;
 
     case PROP_WORKSPACE_NAMES:
       plugin->workspace_names = g_value_get_boolean (value);
+      window_menu_plugin_menu_queue_sync (plugin);
       break;
 
     case PROP_URGENTCY_NOTIFICATION:
@@ -370,11 +393,15 @@ window_menu_plugin_set_property (GObject *object,
               else
                 window_menu_plugin_windows_disconnect (plugin);
             }
+
+          /* the urgent windows section depends on this */
+          window_menu_plugin_menu_queue_sync (plugin);
         }
       break;
 
     case PROP_ALL_WORKSPACES:
       plugin->all_workspaces = g_value_get_boolean (value);
+      window_menu_plugin_menu_queue_sync (plugin);
       break;
 
     default:
@@ -389,6 +416,9 @@ static void
 window_menu_plugin_style_updated (GtkWidget *widget)
 {
   WindowMenuPlugin *plugin = WINDOW_MENU_PLUGIN (widget);
+  gint minimized_icon_lucency = plugin->minimized_icon_lucency;
+  PangoEllipsizeMode ellipsize_mode = plugin->ellipsize_mode;
+  gint max_width_chars = plugin->max_width_chars;
 
   /* let gtk update the widget style */
   (*GTK_WIDGET_CLASS (window_menu_plugin_parent_class)->style_updated) (widget);
@@ -403,6 +433,12 @@ window_menu_plugin_style_updated (GtkWidget *widget)
   /* GTK doesn't do this by itself unfortunately, unlike GObject */
   plugin->minimized_icon_lucency = CLAMP (plugin->minimized_icon_lucency, MIN_MINIMIZED_ICON_LUCENCY, MAX_MINIMIZED_ICON_LUCENCY);
   plugin->max_width_chars = CLAMP (plugin->max_width_chars, MIN_MINIMIZED_ICON_LUCENCY, MAX_MINIMIZED_ICON_LUCENCY);
+
+  /* the menu rows are styled when they are created */
+  if (plugin->minimized_icon_lucency != minimized_icon_lucency
+      || plugin->ellipsize_mode != ellipsize_mode
+      || plugin->max_width_chars != max_width_chars)
+    window_menu_plugin_menu_destroy (plugin);
 }
 
 
@@ -428,6 +464,9 @@ window_menu_plugin_screen_changed (GtkWidget *widget,
 
   if (G_UNLIKELY (plugin->screen != NULL))
     {
+      /* the menu shows the windows of the old screen */
+      window_menu_plugin_menu_destroy (plugin);
+
       /* disconnect from all windows on the old screen */
       window_menu_plugin_windows_disconnect (plugin);
 
@@ -498,6 +537,9 @@ window_menu_plugin_free_data (XfcePanelPlugin *panel_plugin)
   /* disconnect from the screen */
   if (G_LIKELY (plugin->screen != NULL))
     {
+      /* destroy the window list menu */
+      window_menu_plugin_menu_destroy (plugin);
+
       /* disconnect from all windows */
       window_menu_plugin_windows_disconnect (plugin);
 
@@ -648,6 +690,28 @@ window_menu_plugin_remote_event (XfcePanelPlugin *panel_plugin,
 
 
 
+static GdkPixbuf *
+window_menu_plugin_get_window_icon (WindowMenuPlugin *plugin,
+                                    XfwWindow *window,
+                                    gint size,
+                                    gint scale_factor)
+{
+  GdkPixbuf *pixbuf;
+
+  /* only use the shared cache when we watch the icon changes of the
+   * windows, or we could keep a stale icon in there */
+  if (plugin->urgentcy_notification || plugin->menu != NULL)
+    return panel_xfw_icons_get_window_icon (window, size, scale_factor);
+
+  pixbuf = xfw_window_get_icon (window, size, scale_factor);
+  if (pixbuf != NULL)
+    g_object_ref (pixbuf);
+
+  return pixbuf;
+}
+
+
+
 static void
 window_menu_plugin_set_icon (WindowMenuPlugin *plugin,
                              XfwWindow *window)
@@ -665,13 +729,14 @@ window_menu_plugin_set_icon (WindowMenuPlugin *plugin,
 
   icon_size = xfce_panel_plugin_get_icon_size (XFCE_PANEL_PLUGIN (plugin));
   scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
-  pixbuf = xfw_window_get_icon (window, icon_size, scale_factor);
+  pixbuf = window_menu_plugin_get_window_icon (plugin, window, icon_size, scale_factor);
 
   if (G_LIKELY (pixbuf != NULL))
     {
       cairo_surface_t *surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale_factor, NULL);
       gtk_image_set_from_surface (GTK_IMAGE (plugin->icon), surface);
       cairo_surface_destroy (surface);
+      g_object_unref (pixbuf);
     }
   else
     {
@@ -697,6 +762,17 @@ window_menu_plugin_active_window_changed (XfwScreen *screen,
   panel_return_if_fail (XFW_IS_SCREEN (screen));
   panel_return_if_fail (plugin->screen == screen);
 
+  /* update the rows of the previous and new active window */
+  if (plugin->menu != NULL)
+    {
+      if (previous_window != NULL)
+        window_menu_plugin_menu_window_changed (plugin, previous_window);
+
+      window = xfw_screen_get_active_window (screen);
+      if (window != NULL)
+        window_menu_plugin_menu_window_changed (plugin, window);
+    }
+
   /* only do this when the icon is visible */
   if (plugin->button_style == BUTTON_STYLE_ICON)
     {
@@ -754,6 +830,21 @@ window_menu_plugin_window_state_changed (XfwWindow *window,
 
 
 
+static void
+window_menu_plugin_window_icon_changed (WindowMenuPlugin *plugin,
+                                        XfwWindow *window)
+{
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  /* drop the old icon from the shared cache */
+  panel_xfw_icons_window_icon_changed (window);
+
+  window_menu_plugin_set_icon (plugin, window);
+}
+
+
+
 static void
 window_menu_plugin_window_opened (XfwScreen *screen,
                                   XfwWindow *window,
@@ -769,7 +860,7 @@ window_menu_plugin_window_opened (XfwScreen *screen,
   g_signal_connect (G_OBJECT (window), "state-changed",
                     G_CALLBACK (window_menu_plugin_window_state_changed), plugin);
   g_signal_connect_swapped (G_OBJECT (window), "icon-changed",
-                            G_CALLBACK (window_menu_plugin_set_icon), plugin);
+                            G_CALLBACK (window_menu_plugin_window_icon_changed), plugin);
 
   /* check if the window needs attention */
   if (xfw_window_is_urgent (window))
@@ -816,7 +907,10 @@ window_menu_plugin_windows_disconnect (WindowMenuPlugin *plugin)
     {
       panel_return_if_fail (XFW_IS_WINDOW (li->data));
       g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_window_state_changed, plugin);
-      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_set_icon, plugin);
+      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_window_icon_changed, plugin);
+
+      /* icon changes are not tracked anymore */
+      panel_xfw_icons_window_icon_changed (li->data);
     }
 
   /* stop blinking */
@@ -897,18 +991,19 @@ window_menu_plugin_menu_workspace_item_active (GtkWidget *mi,
 
 
 
-static GtkWidget *
-window_menu_plugin_menu_workspace_item_new (XfwWorkspace *workspace,
-                                            WindowMenuPlugin *plugin,
-                                            gboolean bold)
+static void
+window_menu_plugin_menu_workspace_item_update (WindowMenuPlugin *plugin,
+                                               GtkWidget *mi,
+                                               XfwWorkspace *workspace,
+                                               gboolean bold)
 {
   const gchar *name;
   gchar *label_text = NULL;
   gchar *utf8 = NULL, *name_num = NULL;
-  GtkWidget *mi, *label;
+  GtkWidget *label;
 
-  panel_return_val_if_fail (XFW_IS_WORKSPACE (workspace), NULL);
-  panel_return_val_if_fail (WINDOW_MENU_IS_PLUGIN (plugin), NULL);
+  panel_return_if_fail (XFW_IS_WORKSPACE (workspace));
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
 
   /* try to get a utf-8 valid name */
   name = xfw_workspace_get_name (workspace);
@@ -919,16 +1014,8 @@ window_menu_plugin_menu_workspace_item_new (XfwWorkspace *workspace,
   if (xfce_str_is_empty (name))
     name = name_num = g_strdup_printf (_("Workspace %d"), xfw_workspace_get_number (workspace) + 1);
 
-  mi = gtk_menu_item_new_with_label (name);
-  g_signal_connect (G_OBJECT (mi), "activate",
-                    G_CALLBACK (window_menu_plugin_menu_workspace_item_active), workspace);
-
-  /* make the label pretty on long workspace names */
   label = gtk_bin_get_child (GTK_BIN (mi));
-  panel_return_val_if_fail (GTK_IS_LABEL (label), NULL);
-  gtk_label_set_ellipsize (GTK_LABEL (label), plugin->ellipsize_mode);
-  gtk_label_set_max_width_chars (GTK_LABEL (label), plugin->max_width_chars);
-  gtk_label_set_xalign (GTK_LABEL (label), 0.5);
+  panel_return_if_fail (GTK_IS_LABEL (label));
 
   /* modify the label font if needed */
   if (bold)
@@ -943,6 +1030,29 @@ window_menu_plugin_menu_workspace_item_new (XfwWorkspace *workspace,
 
   g_free (utf8);
   g_free (name_num);
+}
+
+
+
+static GtkWidget *
+window_menu_plugin_menu_workspace_item_new (XfwWorkspace *workspace,
+                                            WindowMenuPlugin *plugin)
+{
+  GtkWidget *mi, *label;
+
+  panel_return_val_if_fail (XFW_IS_WORKSPACE (workspace), NULL);
+  panel_return_val_if_fail (WINDOW_MENU_IS_PLUGIN (plugin), NULL);
+
+  mi = gtk_menu_item_new_with_label ("");
+  g_signal_connect (G_OBJECT (mi), "activate",
+                    G_CALLBACK (window_menu_plugin_menu_workspace_item_active), workspace);
+
+  /* make the label pretty on long workspace names */
+  label = gtk_bin_get_child (GTK_BIN (mi));
+  panel_return_val_if_fail (GTK_IS_LABEL (label), NULL);
+  gtk_label_set_ellipsize (GTK_LABEL (label), plugin->ellipsize_mode);
+  gtk_label_set_max_width_chars (GTK_LABEL (label), plugin->max_width_chars);
+  gtk_label_set_xalign (GTK_LABEL (label), 0.5);
 
   return mi;
 }
@@ -1012,22 +1122,25 @@ window_menu_plugin_menu_window_item_activate (GtkWidget *mi,
 
 
 
-static GtkWidget *
-window_menu_plugin_menu_window_item_new (XfwWindow *window,
-                                         WindowMenuPlugin *plugin,
-                                         PangoFontDescription *italic,
-                                         PangoFontDescription *bold,
-                                         gint size)
+static void
+window_menu_plugin_menu_window_item_update (WindowMenuPlugin *plugin,
+                                            GtkWidget *mi,
+                                            gboolean update_icon)
 {
   const gchar *name, *tooltip;
   gchar *label_text = NULL;
   gchar *utf8 = NULL;
   gchar *decorated = NULL;
-  GtkWidget *mi, *label, *image;
-  GdkPixbuf *pixbuf, *lucent = NULL, *scaled = NULL;
-  gint scale_factor;
+  GtkWidget *label, *image;
+  GdkPixbuf *icon, *pixbuf, *lucent = NULL, *scaled = NULL;
+  XfwWindow *window;
+  gint size, scale_factor;
 
-  panel_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (GTK_IS_MENU_ITEM (mi));
+
+  window = g_object_get_qdata (G_OBJECT (mi), window_quark);
+  panel_return_if_fail (XFW_IS_WINDOW (window));
 
   /* try to get a utf-8 valid name */
   name = xfw_window_get_name (window);
@@ -1046,17 +1159,10 @@ window_menu_plugin_menu_window_item_new (XfwWindow *window,
   else if (xfw_window_is_minimized (window))
     name = decorated = g_strdup_printf ("[%s]", name);
 
-  /* create the menu item */
-  mi = panel_image_menu_item_new_with_label (name);
   gtk_widget_set_tooltip_text (mi, tooltip);
-  g_object_set_qdata (G_OBJECT (mi), window_quark, window);
-  g_signal_connect (G_OBJECT (mi), "button-release-event",
-                    G_CALLBACK (window_menu_plugin_menu_window_item_activate), plugin);
 
-
-  /* make the label pretty on long window names */
   label = gtk_bin_get_child (GTK_BIN (mi));
-  panel_return_val_if_fail (GTK_IS_LABEL (label), NULL);
+  panel_return_if_fail (GTK_IS_LABEL (label));
   /* modify the label font if needed */
   if (xfw_window_is_active (window))
     label_text = g_strdup_printf ("<b><i>%s</i></b>", name);
@@ -1067,23 +1173,29 @@ window_menu_plugin_menu_window_item_new (XfwWindow *window,
       gtk_label_set_markup (GTK_LABEL (label), label_text);
       g_free (label_text);
     }
+  else
+    {
+      gtk_label_set_text (GTK_LABEL (label), name);
+    }
 
   g_free (decorated);
   g_free (utf8);
 
-  gtk_label_set_ellipsize (GTK_LABEL (label), plugin->ellipsize_mode);
-  gtk_label_set_max_width_chars (GTK_LABEL (label), plugin->max_width_chars);
-
-  if (plugin->minimized_icon_lucency > 0)
+  if (update_icon && plugin->minimized_icon_lucency > 0)
     {
+      if (!gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, &size, NULL))
+        size = 16;
+
       /* get the window icon */
       scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
-      pixbuf = xfw_window_get_icon (window, size, scale_factor);
+      icon = window_menu_plugin_get_window_icon (plugin, window, size, scale_factor);
       size *= scale_factor;
-      if (pixbuf != NULL)
+      if (icon != NULL)
         {
           cairo_surface_t *surface;
 
+          pixbuf = icon;
+
           /* scale the icon if needed */
           if (gdk_pixbuf_get_width (pixbuf) > size
               || gdk_pixbuf_get_height (pixbuf) > size)
@@ -1113,8 +1225,38 @@ window_menu_plugin_menu_window_item_new (XfwWindow *window,
             g_object_unref (G_OBJECT (lucent));
           if (scaled != NULL)
             g_object_unref (G_OBJECT (scaled));
+          g_object_unref (G_OBJECT (icon));
+        }
+      else
+        {
+          panel_image_menu_item_set_image (mi, NULL);
         }
     }
+}
+
+
+
+static GtkWidget *
+window_menu_plugin_menu_window_item_new (XfwWindow *window,
+                                         WindowMenuPlugin *plugin)
+{
+  GtkWidget *mi, *label;
+
+  panel_return_val_if_fail (XFW_IS_WINDOW (window), NULL);
+
+  /* create the menu item */
+  mi = panel_image_menu_item_new_with_label ("");
+  g_object_set_qdata (G_OBJECT (mi), window_quark, window);
+  g_signal_connect (G_OBJECT (mi), "button-release-event",
+                    G_CALLBACK (window_menu_plugin_menu_window_item_activate), plugin);
+
+  /* make the label pretty on long window names */
+  label = gtk_bin_get_child (GTK_BIN (mi));
+  panel_return_val_if_fail (GTK_IS_LABEL (label), NULL);
+  gtk_label_set_ellipsize (GTK_LABEL (label), plugin->ellipsize_mode);
+  gtk_label_set_max_width_chars (GTK_LABEL (label), plugin->max_width_chars);
+
+  window_menu_plugin_menu_window_item_update (plugin, mi, TRUE);
 
   return mi;
 }
@@ -1128,11 +1270,9 @@ window_menu_plugin_menu_deactivate (GtkWidget *menu,
   panel_return_if_fail (plugin->button == NULL || GTK_IS_TOGGLE_BUTTON (plugin->button));
   panel_return_if_fail (GTK_IS_MENU (menu));
 
+  /* the menu is kept around, it is updated from the screen signals */
   if (plugin->button != NULL)
     gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (plugin->button), FALSE);
-
-  /* delay destruction so we can handle the activate event first */
-  panel_utils_destroy_later (GTK_WIDGET (menu));
 }
 
 
@@ -1206,34 +1346,92 @@ window_menu_plugin_menu_key_press_event (GtkWidget *menu,
 
 
 static GtkWidget *
-window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
+window_menu_plugin_menu_workspace_item_get (WindowMenuPlugin *plugin,
+                                            XfwWorkspace *workspace)
+{
+  GtkWidget *mi;
+
+  mi = g_hash_table_lookup (plugin->workspace_items, workspace);
+  if (mi == NULL)
+    {
+      mi = window_menu_plugin_menu_workspace_item_new (workspace, plugin);
+      gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), mi);
+      g_hash_table_insert (plugin->workspace_items, workspace, mi);
+
+      g_signal_connect_swapped (G_OBJECT (workspace), "name-changed",
+                                G_CALLBACK (window_menu_plugin_menu_queue_sync), plugin);
+    }
+
+  return mi;
+}
+
+
+
+static GtkWidget *
+window_menu_plugin_menu_window_item_get (WindowMenuPlugin *plugin,
+                                         XfwWindow *window)
+{
+  GtkWidget *mi;
+
+  mi = g_hash_table_lookup (plugin->window_items, window);
+  if (mi == NULL)
+    {
+      mi = window_menu_plugin_menu_window_item_new (window, plugin);
+      gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), mi);
+      g_hash_table_insert (plugin->window_items, window, mi);
+    }
+
+  return mi;
+}
+
+
+
+static GtkWidget *
+window_menu_plugin_menu_separator (WindowMenuPlugin *plugin,
+                                   guint n)
+{
+  GtkWidget *mi;
+
+  if (n >= plugin->separators->len)
+    {
+      mi = gtk_separator_menu_item_new ();
+      gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), mi);
+      g_ptr_array_add (plugin->separators, mi);
+    }
+
+  return g_ptr_array_index (plugin->separators, n);
+}
+
+
+
+static void
+window_menu_plugin_menu_sync (WindowMenuPlugin *plugin)
 {
-  GtkWidget *menu, *mi = NULL, *image;
   GList *workspaces, *lp, fake;
   GList *windows, *li;
+  GList *items = NULL, *children;
   XfwWorkspace *workspace = NULL;
   XfwWorkspace *active_workspace, *window_workspace;
   XfwWindow *window;
-  PangoFontDescription *italic, *bold;
-  gint urgent_windows = 0;
+  GtkWidget *mi;
   gboolean is_empty = TRUE;
+  gboolean has_urgent = FALSE;
   guint n_workspaces = 0;
+  guint n_separators = 0;
+  gint position, offset, index;
+  GHashTable *order, *pending;
   const gchar *name = NULL;
   gchar *utf8 = NULL, *label;
-  gint size;
-
-  panel_return_val_if_fail (WINDOW_MENU_IS_PLUGIN (plugin), NULL);
-  panel_return_val_if_fail (XFW_IS_SCREEN (plugin->screen), NULL);
-
-  italic = pango_font_description_from_string ("italic");
-  bold = pango_font_description_from_string ("bold");
 
-  if (!gtk_icon_size_lookup (GTK_ICON_SIZE_MENU, &size, NULL))
-    size = 16;
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (GTK_IS_MENU (plugin->menu));
+  panel_return_if_fail (XFW_IS_SCREEN (plugin->screen));
 
-  menu = gtk_menu_new ();
-  g_signal_connect (G_OBJECT (menu), "key-press-event",
-                    G_CALLBACK (window_menu_plugin_menu_key_press_event), plugin);
+  if (plugin->menu_sync_id != 0)
+    {
+      g_source_remove (plugin->menu_sync_id);
+      plugin->menu_sync_id = 0;
+    }
 
   /* get all the windows and the active workspace */
   windows = xfw_screen_get_windows_stacked (plugin->screen);
@@ -1252,17 +1450,18 @@ window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
       workspaces = &fake;
     }
 
+  /* collect the items in reverse order, the rows are reused so
+   * this does not create anything for known windows */
   for (lp = workspaces; lp != NULL; lp = lp->next, n_workspaces++)
     {
       workspace = XFW_WORKSPACE (lp->data);
 
-      if (plugin->workspace_names)
+      if (plugin->workspace_names && workspace != NULL)
         {
-          /* create the workspace menu item */
-          mi = window_menu_plugin_menu_workspace_item_new (workspace, plugin,
-                                                           workspace == active_workspace);
-          gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-          gtk_widget_show (mi);
+          mi = window_menu_plugin_menu_workspace_item_get (plugin, workspace);
+          window_menu_plugin_menu_workspace_item_update (plugin, mi, workspace,
+                                                         workspace == active_workspace);
+          items = g_list_prepend (items, mi);
 
           /* not empty anymore */
           is_empty = FALSE;
@@ -1287,56 +1486,29 @@ window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
                    && workspace == active_workspace))
             continue;
 
-          /* create the menu item */
-          mi = window_menu_plugin_menu_window_item_new (window, plugin, italic, bold, size);
-          gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-          gtk_widget_show (mi);
+          items = g_list_prepend (items, window_menu_plugin_menu_window_item_get (plugin, window));
 
           /* menu is not empty anymore */
           is_empty = FALSE;
-
-          /* count the urgent windows */
-          if (xfw_window_is_urgent (window))
-            urgent_windows++;
         }
 
-      mi = gtk_separator_menu_item_new ();
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-      gtk_widget_show (mi);
+      items = g_list_prepend (items, window_menu_plugin_menu_separator (plugin, n_separators++));
     }
 
-  /* destroy the last menu item if it's a separator */
-  if (mi != NULL && GTK_IS_SEPARATOR_MENU_ITEM (mi))
-    gtk_widget_destroy (mi);
+  /* drop the last item if it's a separator */
+  if (items != NULL && GTK_IS_SEPARATOR_MENU_ITEM (items->data))
+    {
+      items = g_list_delete_link (items, items);
+      n_separators--;
+    }
 
   /* add a menu item if there are not windows found */
   if (is_empty)
-    {
-      mi = gtk_menu_item_new_with_label (_("No Windows"));
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-      gtk_widget_set_sensitive (mi, FALSE);
-      gtk_widget_show (mi);
-    }
+    items = g_list_prepend (items, plugin->no_windows_item);
 
   /* check if we need to append the urgent windows on other workspaces */
-  if (!plugin->all_workspaces && plugin->urgent_windows > urgent_windows)
+  if (!plugin->all_workspaces && plugin->urgentcy_notification)
     {
-      if (plugin->workspace_names)
-        {
-          mi = gtk_separator_menu_item_new ();
-          gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-          gtk_widget_show (mi);
-
-          mi = gtk_menu_item_new_with_label (_("Urgent Windows"));
-          gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-          gtk_widget_set_sensitive (mi, FALSE);
-          gtk_widget_show (mi);
-        }
-
-      mi = gtk_separator_menu_item_new ();
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-      gtk_widget_show (mi);
-
       for (li = windows; li != NULL; li = li->next)
         {
           window = XFW_WINDOW (li->data);
@@ -1356,10 +1528,19 @@ window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
               || !xfw_window_is_urgent (window))
             continue;
 
-          /* create the menu item */
-          mi = window_menu_plugin_menu_window_item_new (window, plugin, italic, bold, size);
-          gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-          gtk_widget_show (mi);
+          if (!has_urgent)
+            {
+              if (plugin->workspace_names)
+                {
+                  items = g_list_prepend (items, window_menu_plugin_menu_separator (plugin, n_separators++));
+                  items = g_list_prepend (items, plugin->urgent_item);
+                }
+
+              items = g_list_prepend (items, window_menu_plugin_menu_separator (plugin, n_separators++));
+              has_urgent = TRUE;
+            }
+
+          items = g_list_prepend (items, window_menu_plugin_menu_window_item_get (plugin, window));
         }
     }
 
@@ -1368,21 +1549,11 @@ window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
       XfwWorkspaceGroupCapabilities gcapabilities;
       XfwWorkspaceCapabilities wcapabilities;
 
-      mi = gtk_separator_menu_item_new ();
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
-      gtk_widget_show (mi);
+      items = g_list_prepend (items, window_menu_plugin_menu_separator (plugin, n_separators++));
 
-      mi = panel_image_menu_item_new_with_label (_("Add Workspace"));
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
       gcapabilities = xfw_workspace_group_get_capabilities (plugin->workspace_group);
-      gtk_widget_set_sensitive (mi, gcapabilities & XFW_WORKSPACE_GROUP_CAPABILITIES_CREATE_WORKSPACE);
-      g_signal_connect (G_OBJECT (mi), "activate",
-                        G_CALLBACK (window_menu_plugin_workspace_add), plugin);
-      gtk_widget_show (mi);
-
-      image = gtk_image_new_from_icon_name ("list-add", GTK_ICON_SIZE_MENU);
-      panel_image_menu_item_set_image (mi, image);
-      gtk_widget_show (mi);
+      gtk_widget_set_sensitive (plugin->add_item, gcapabilities & XFW_WORKSPACE_GROUP_CAPABILITIES_CREATE_WORKSPACE);
+      items = g_list_prepend (items, plugin->add_item);
 
       if (G_LIKELY (workspace != NULL))
         {
@@ -1398,26 +1569,404 @@ window_menu_plugin_menu_new (WindowMenuPlugin *plugin)
       else
         label = g_strdup_printf (_("Remove Workspace %d"), n_workspaces);
 
-      mi = panel_image_menu_item_new_with_label (label);
-      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
+      gtk_menu_item_set_label (GTK_MENU_ITEM (plugin->remove_item), label);
       wcapabilities = xfw_workspace_get_capabilities (g_list_last (workspaces)->data);
-      gtk_widget_set_sensitive (mi, n_workspaces > 1 && wcapabilities & XFW_WORKSPACE_CAPABILITIES_REMOVE);
-      g_signal_connect (G_OBJECT (mi), "activate",
-                        G_CALLBACK (window_menu_plugin_workspace_remove), plugin);
-      gtk_widget_show (mi);
+      gtk_widget_set_sensitive (plugin->remove_item, n_workspaces > 1 && wcapabilities & XFW_WORKSPACE_CAPABILITIES_REMOVE);
+      items = g_list_prepend (items, plugin->remove_item);
 
       g_free (label);
       g_free (utf8);
+    }
+
+  items = g_list_reverse (items);
+
+  /* the final position of every row, offset by one */
+  order = g_hash_table_new (g_direct_hash, g_direct_equal);
+  for (li = items, position = 1; li != NULL; li = li->next, position++)
+    g_hash_table_insert (order, li->data, GINT_TO_POINTER (position));
+
+  /* move the items in place, most of the time nothing or only a single
+   * row changed position, so walk the current rows once and only move
+   * the rows that are out of place; offset is the menu position of lp
+   * and pending holds the rows we passed that still need to move down */
+  pending = g_hash_table_new (g_direct_hash, g_direct_equal);
+  children = gtk_container_get_children (GTK_CONTAINER (plugin->menu));
+  for (li = items, lp = children, position = 0, offset = 0; li != NULL; li = li->next, position++)
+    {
+      gtk_widget_show (GTK_WIDGET (li->data));
+
+      while (lp != NULL && lp->data != li->data)
+        {
+          index = GPOINTER_TO_INT (g_hash_table_lookup (order, lp->data)) - 1;
+          if (index < 0)
+            {
+              /* a row we do not need this time */
+              gtk_widget_hide (GTK_WIDGET (lp->data));
+              offset++;
+            }
+          else if (index >= position)
+            {
+              /* only skip the row if it is the one that moved down,
+               * otherwise the wanted row was inserted or moved up */
+              if (lp->next == NULL || lp->next->data != li->data)
+                break;
+
+              g_hash_table_add (pending, lp->data);
+              offset++;
+            }
+
+          /* rows that are already moved up are not here anymore */
+          lp = lp->next;
+        }
+
+      if (lp != NULL && lp->data == li->data)
+        {
+          lp = lp->next;
+          offset++;
+          continue;
+        }
+
+      /* a pending row is taken out before lp, so it ends up right before it */
+      if (g_hash_table_remove (pending, li->data))
+        gtk_menu_reorder_child (GTK_MENU (plugin->menu), GTK_WIDGET (li->data), offset - 1);
+      else
+        gtk_menu_reorder_child (GTK_MENU (plugin->menu), GTK_WIDGET (li->data), offset++);
+    }
+
+  /* hide everything we did not need this time */
+  for (; lp != NULL; lp = lp->next)
+    if (!g_hash_table_contains (order, lp->data))
+      gtk_widget_hide (GTK_WIDGET (lp->data));
+
+  g_hash_table_destroy (pending);
+  g_hash_table_destroy (order);
+  g_list_free (children);
+  g_list_free (items);
+}
+
+
+
+static gboolean
+window_menu_plugin_menu_sync_idle (gpointer data)
+{
+  WindowMenuPlugin *plugin = WINDOW_MENU_PLUGIN (data);
+
+  plugin->menu_sync_id = 0;
+  window_menu_plugin_menu_sync (plugin);
+
+  return FALSE;
+}
+
+
+
+static void
+window_menu_plugin_menu_queue_sync (WindowMenuPlugin *plugin)
+{
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+
+  /* nothing to do until the menu is built */
+  if (plugin->menu == NULL || plugin->menu_sync_id != 0)
+    return;
+
+  plugin->menu_sync_id = g_idle_add (window_menu_plugin_menu_sync_idle, plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_window_changed (WindowMenuPlugin *plugin,
+                                        XfwWindow *window)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  if (plugin->menu == NULL)
+    return;
+
+  mi = g_hash_table_lookup (plugin->window_items, window);
+  if (mi != NULL)
+    window_menu_plugin_menu_window_item_update (plugin, mi, FALSE);
+}
+
+
+
+static void
+window_menu_plugin_menu_window_icon_changed (WindowMenuPlugin *plugin,
+                                             XfwWindow *window)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+
+  /* drop the old icon from the shared cache */
+  panel_xfw_icons_window_icon_changed (window);
+
+  mi = g_hash_table_lookup (plugin->window_items, window);
+  if (mi != NULL)
+    window_menu_plugin_menu_window_item_update (plugin, mi, TRUE);
+}
+
+
+
+static void
+window_menu_plugin_menu_icon_theme_changed (WindowMenuPlugin *plugin)
+{
+  GHashTableIter iter;
+  gpointer window, mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+
+  /* the fallback icons come from the theme, render all the rows again */
+  g_hash_table_iter_init (&iter, plugin->window_items);
+  while (g_hash_table_iter_next (&iter, &window, &mi))
+    {
+      panel_xfw_icons_window_icon_changed (window);
+      window_menu_plugin_menu_window_item_update (plugin, mi, TRUE);
+    }
+}
+
+
+
+static void
+window_menu_plugin_menu_window_state_changed (XfwWindow *window,
+                                              XfwWindowState changed_mask,
+                                              XfwWindowState new_state,
+                                              WindowMenuPlugin *plugin)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
 
-      image = gtk_image_new_from_icon_name ("list-remove", GTK_ICON_SIZE_MENU);
-      panel_image_menu_item_set_image (mi, image);
-      gtk_widget_show (mi);
+  /* the icon is dimmed for minimized windows */
+  mi = g_hash_table_lookup (plugin->window_items, window);
+  if (mi != NULL)
+    window_menu_plugin_menu_window_item_update (plugin, mi,
+                                                PANEL_HAS_FLAG (changed_mask, XFW_WINDOW_STATE_MINIMIZED));
+
+  /* these states decide if and where the window is listed */
+  if (changed_mask & (XFW_WINDOW_STATE_URGENT
+                      | XFW_WINDOW_STATE_SKIP_PAGER
+                      | XFW_WINDOW_STATE_SKIP_TASKLIST))
+    window_menu_plugin_menu_queue_sync (plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_window_opened (XfwScreen *screen,
+                                       XfwWindow *window,
+                                       WindowMenuPlugin *plugin)
+{
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+  panel_return_if_fail (plugin->screen == screen);
+
+  /* monitor the window properties shown in the menu */
+  g_signal_connect_swapped (G_OBJECT (window), "name-changed",
+                            G_CALLBACK (window_menu_plugin_menu_window_changed), plugin);
+  g_signal_connect_swapped (G_OBJECT (window), "icon-changed",
+                            G_CALLBACK (window_menu_plugin_menu_window_icon_changed), plugin);
+  g_signal_connect (G_OBJECT (window), "state-changed",
+                    G_CALLBACK (window_menu_plugin_menu_window_state_changed), plugin);
+  g_signal_connect_swapped (G_OBJECT (window), "workspace-changed",
+                            G_CALLBACK (window_menu_plugin_menu_queue_sync), plugin);
+
+  /* the row is created when the menu is synced */
+  window_menu_plugin_menu_queue_sync (plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_window_closed (XfwScreen *screen,
+                                       XfwWindow *window,
+                                       WindowMenuPlugin *plugin)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WINDOW (window));
+  panel_return_if_fail (plugin->screen == screen);
+
+  g_signal_handlers_disconnect_by_func (window, window_menu_plugin_menu_window_changed, plugin);
+  g_signal_handlers_disconnect_by_func (window, window_menu_plugin_menu_window_icon_changed, plugin);
+  g_signal_handlers_disconnect_by_func (window, window_menu_plugin_menu_window_state_changed, plugin);
+  g_signal_handlers_disconnect_by_func (window, window_menu_plugin_menu_queue_sync, plugin);
+
+  /* remove the row */
+  mi = g_hash_table_lookup (plugin->window_items, window);
+  if (mi != NULL)
+    {
+      g_hash_table_remove (plugin->window_items, window);
+      gtk_widget_destroy (mi);
     }
 
-  pango_font_description_free (italic);
-  pango_font_description_free (bold);
+  /* the menu could be empty now */
+  window_menu_plugin_menu_queue_sync (plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_workspace_removed (XfwWorkspaceGroup *group,
+                                           XfwWorkspace *workspace,
+                                           WindowMenuPlugin *plugin)
+{
+  GtkWidget *mi;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_WORKSPACE (workspace));
+
+  mi = g_hash_table_lookup (plugin->workspace_items, workspace);
+  if (mi != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (workspace, window_menu_plugin_menu_queue_sync, plugin);
+      g_hash_table_remove (plugin->workspace_items, workspace);
+      gtk_widget_destroy (mi);
+    }
 
-  return menu;
+  window_menu_plugin_menu_queue_sync (plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_build (WindowMenuPlugin *plugin)
+{
+  GtkWidget *image;
+  GList *windows, *li;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+  panel_return_if_fail (XFW_IS_SCREEN (plugin->screen));
+  panel_return_if_fail (plugin->menu == NULL);
+
+  plugin->menu = gtk_menu_new ();
+  gtk_menu_attach_to_widget (GTK_MENU (plugin->menu), GTK_WIDGET (plugin), NULL);
+  g_signal_connect (G_OBJECT (plugin->menu), "key-press-event",
+                    G_CALLBACK (window_menu_plugin_menu_key_press_event), plugin);
+  g_signal_connect (G_OBJECT (plugin->menu), "deactivate",
+                    G_CALLBACK (window_menu_plugin_menu_deactivate), plugin);
+
+  plugin->window_items = g_hash_table_new (g_direct_hash, g_direct_equal);
+  plugin->workspace_items = g_hash_table_new (g_direct_hash, g_direct_equal);
+  plugin->separators = g_ptr_array_new ();
+  plugin->menu_scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (plugin));
+
+  /* static items, the sync shows the ones that are needed */
+  plugin->no_windows_item = gtk_menu_item_new_with_label (_("No Windows"));
+  gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), plugin->no_windows_item);
+  gtk_widget_set_sensitive (plugin->no_windows_item, FALSE);
+
+  plugin->urgent_item = gtk_menu_item_new_with_label (_("Urgent Windows"));
+  gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), plugin->urgent_item);
+  gtk_widget_set_sensitive (plugin->urgent_item, FALSE);
+
+  plugin->add_item = panel_image_menu_item_new_with_label (_("Add Workspace"));
+  gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), plugin->add_item);
+  g_signal_connect (G_OBJECT (plugin->add_item), "activate",
+                    G_CALLBACK (window_menu_plugin_workspace_add), plugin);
+
+  image = gtk_image_new_from_icon_name ("list-add", GTK_ICON_SIZE_MENU);
+  panel_image_menu_item_set_image (plugin->add_item, image);
+
+  plugin->remove_item = panel_image_menu_item_new_with_label ("");
+  gtk_menu_shell_append (GTK_MENU_SHELL (plugin->menu), plugin->remove_item);
+  g_signal_connect (G_OBJECT (plugin->remove_item), "activate",
+                    G_CALLBACK (window_menu_plugin_workspace_remove), plugin);
+
+  image = gtk_image_new_from_icon_name ("list-remove", GTK_ICON_SIZE_MENU);
+  panel_image_menu_item_set_image (plugin->remove_item, image);
+
+  /* keep the menu up to date from now on */
+  g_signal_connect (G_OBJECT (plugin->screen), "window-opened",
+                    G_CALLBACK (window_menu_plugin_menu_window_opened), plugin);
+  g_signal_connect (G_OBJECT (plugin->screen), "window-closed",
+                    G_CALLBACK (window_menu_plugin_menu_window_closed), plugin);
+  g_signal_connect_swapped (G_OBJECT (plugin->screen), "window-stacking-changed",
+                            G_CALLBACK (window_menu_plugin_menu_queue_sync), plugin);
+  g_signal_connect_swapped (G_OBJECT (plugin->workspace_group), "active-workspace-changed",
+                            G_CALLBACK (window_menu_plugin_menu_queue_sync), plugin);
+  g_signal_connect_swapped (G_OBJECT (plugin->workspace_group), "workspace-added",
+                            G_CALLBACK (window_menu_plugin_menu_queue_sync), plugin);
+  g_signal_connect (G_OBJECT (plugin->workspace_group), "workspace-removed",
+                    G_CALLBACK (window_menu_plugin_menu_workspace_removed), plugin);
+  plugin->menu_icon_theme = gtk_icon_theme_get_for_screen (gtk_widget_get_screen (GTK_WIDGET (plugin)));
+  g_signal_connect_swapped (G_OBJECT (plugin->menu_icon_theme), "changed",
+                            G_CALLBACK (window_menu_plugin_menu_icon_theme_changed), plugin);
+
+  windows = xfw_screen_get_windows (plugin->screen);
+  for (li = windows; li != NULL; li = li->next)
+    window_menu_plugin_menu_window_opened (plugin->screen, XFW_WINDOW (li->data), plugin);
+
+  window_menu_plugin_menu_sync (plugin);
+}
+
+
+
+static void
+window_menu_plugin_menu_destroy (WindowMenuPlugin *plugin)
+{
+  GHashTableIter iter;
+  gpointer workspace;
+  GList *windows, *li;
+
+  panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
+
+  if (plugin->menu == NULL)
+    return;
+
+  if (plugin->menu_sync_id != 0)
+    {
+      g_source_remove (plugin->menu_sync_id);
+      plugin->menu_sync_id = 0;
+    }
+
+  /* disconnect from the screen and workspace group */
+  g_signal_handlers_disconnect_by_func (plugin->screen, window_menu_plugin_menu_window_opened, plugin);
+  g_signal_handlers_disconnect_by_func (plugin->screen, window_menu_plugin_menu_window_closed, plugin);
+  g_signal_handlers_disconnect_by_func (plugin->screen, window_menu_plugin_menu_queue_sync, plugin);
+  g_signal_handlers_disconnect_by_func (plugin->workspace_group, window_menu_plugin_menu_queue_sync, plugin);
+  g_signal_handlers_disconnect_by_func (plugin->workspace_group, window_menu_plugin_menu_workspace_removed, plugin);
+  g_signal_handlers_disconnect_by_func (plugin->menu_icon_theme, window_menu_plugin_menu_icon_theme_changed, plugin);
+  plugin->menu_icon_theme = NULL;
+
+  /* disconnect from all windows */
+  windows = xfw_screen_get_windows (plugin->screen);
+  for (li = windows; li != NULL; li = li->next)
+    {
+      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_menu_window_changed, plugin);
+      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_menu_window_icon_changed, plugin);
+      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_menu_window_state_changed, plugin);
+      g_signal_handlers_disconnect_by_func (li->data, window_menu_plugin_menu_queue_sync, plugin);
+
+      /* icon changes might not be tracked anymore */
+      if (!plugin->urgentcy_notification)
+        panel_xfw_icons_window_icon_changed (li->data);
+    }
+
+  g_hash_table_iter_init (&iter, plugin->workspace_items);
+  while (g_hash_table_iter_next (&iter, &workspace, NULL))
+    g_signal_handlers_disconnect_by_func (workspace, window_menu_plugin_menu_queue_sync, plugin);
+
+  g_clear_pointer (&plugin->window_items, g_hash_table_destroy);
+  g_clear_pointer (&plugin->workspace_items, g_hash_table_destroy);
+  g_ptr_array_free (plugin->separators, TRUE);
+  plugin->separators = NULL;
+  plugin->no_windows_item = NULL;
+  plugin->urgent_item = NULL;
+  plugin->add_item = NULL;
+  plugin->remove_item = NULL;
+
+  /* close the menu if it is shown, this also takes care of the button */
+  gtk_menu_shell_deactivate (GTK_MENU_SHELL (plugin->menu));
+
+  /* this destroys all the rows too */
+  gtk_widget_destroy (plugin->menu);
+  plugin->menu = NULL;
 }
 
 
@@ -1426,7 +1975,6 @@ static void
 window_menu_plugin_menu (GtkWidget *button,
                          WindowMenuPlugin *plugin)
 {
-  GtkWidget *menu;
   GdkEvent *event = NULL;
 
   panel_return_if_fail (WINDOW_MENU_IS_PLUGIN (plugin));
@@ -1447,16 +1995,22 @@ window_menu_plugin_menu (GtkWidget *button,
       gdk_event_set_device (event, gdk_seat_get_pointer (seat));
     }
 
-  /* popup the menu */
-  menu = window_menu_plugin_menu_new (plugin);
-  g_signal_connect (G_OBJECT (menu), "deactivate",
-                    G_CALLBACK (window_menu_plugin_menu_deactivate), plugin);
+  /* the rows are rendered for a single scale factor */
+  if (plugin->menu != NULL
+      && plugin->menu_scale_factor != gtk_widget_get_scale_factor (GTK_WIDGET (plugin)))
+    window_menu_plugin_menu_destroy (plugin);
+
+  /* build the menu once, after that we only flush pending changes */
+  if (plugin->menu == NULL)
+    window_menu_plugin_menu_build (plugin);
+  else if (plugin->menu_sync_id != 0)
+    window_menu_plugin_menu_sync (plugin);
 
   /* do not block panel autohide if popup-command at pointer */
   if (button == NULL)
-    gtk_menu_popup_at_pointer (GTK_MENU (menu), event);
+    gtk_menu_popup_at_pointer (GTK_MENU (plugin->menu), event);
   else
-    xfce_panel_plugin_popup_menu (XFCE_PANEL_PLUGIN (plugin), GTK_MENU (menu), button, event);
+    xfce_panel_plugin_popup_menu (XFCE_PANEL_PLUGIN (plugin), GTK_MENU (plugin->menu), button, event);
 
   gdk_event_free (event);
 }
@@ -60,6 +60,17 @@ wrapper_gproxy_name_owner_changed (GDBusProxy *proxy,
 
 
 
+static void
+wrapper_provider_stats (XfcePanelPluginProvider *provider,
+                        GVariant *stats,
+                        GDBusProxy *proxy)
+{
+  wrapper_plug_proxy_method_call (proxy, "ProviderStats",
+                                  g_variant_new ("(@" PROVIDER_STATS_VARIANT_TYPE ")", stats));
+}
+
+
+
 static void
 wrapper_gproxy_set (GDBusProxy *proxy,
                     gchar *sender_name,
@@ -349,6 +360,8 @@ main (gint argc,
       /* monitor provider signals */
       g_signal_connect_swapped (G_OBJECT (provider), "provider-signal",
                                 G_CALLBACK (wrapper_plug_proxy_provider_signal), plug);
+      g_signal_connect_object (G_OBJECT (provider), "provider-stats",
+                               G_CALLBACK (wrapper_provider_stats), dbus_gproxy, 0);
 
       /* connect to service signals */
       g_signal_connect_object (dbus_gproxy, "g-signal::Set",